@@ -10,6 +10,7 @@
 cpp_examples = [
     ("star", "True", "True"),
     ("tcp-large-transfer", "True", "True"),
+    ("tcp-large-send-buffer", "True", "False"),
     ("tcp-nsc-lfn", "NSC_ENABLED == True", "False"),
     ("tcp-nsc-zoo", "NSC_ENABLED == True", "False"),
     ("tcp-star-server", "True", "True"),
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Network topology
+//
+//       n0 ----------- n1
+//            1 Gbps
+//             50 ms
+//
+// - Bulk transfer from n0 to n1 with a large TCP send buffer, so that the
+//   cost of building the segments from the send buffer (TcpTxBuffer)
+//   dominates the run time.
+// - Prints the number of bytes received, the time at which the last byte
+//   was received and the wall-clock time of the simulation.
+//
+// The transfers used to measure TcpTxBuffer were:
+//   ./waf --run "tcp-large-send-buffer --maxBytes=30000000 --sndBufSize=33554432"
+//   ./waf --run "tcp-large-send-buffer --dataRate=100Mbps --maxBytes=10000000 --sndBufSize=4194304"
+
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/network-module.h"
+#include "ns3/packet-sink.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpLargeSendBufferExample");
+
+static Time g_lastRx;
+
+static void
+SinkRx (Ptr<const Packet> packet, const Address &from)
+{
+  g_lastRx = Simulator::Now ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string dataRate = "1Gbps";
+  std::string delay = "50ms";
+  uint32_t maxBytes = 3000000;
+  uint32_t sndBufSize = 4194304;
+  double stopTime = 100;
+
+  CommandLine cmd;
+  cmd.AddValue ("dataRate", "Data rate of the link", dataRate);
+  cmd.AddValue ("delay", "Delay of the link", delay);
+  cmd.AddValue ("maxBytes", "Total number of bytes to send", maxBytes);
+  cmd.AddValue ("sndBufSize", "TCP send buffer size in bytes", sndBufSize);
+  cmd.AddValue ("stopTime", "Stop time of the simulation in seconds", stopTime);
+  cmd.Parse (argc, argv);
+
+  // The application writes the whole transfer into the send buffer, and
+  // the receive buffer does not limit the window.
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (sndBufSize));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (sndBufSize));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue (dataRate));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue (delay));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (devices);
+
+  uint16_t port = 9;
+  BulkSendHelper source ("ns3::TcpSocketFactory",
+                         InetSocketAddress (i.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (maxBytes));
+  source.SetAttribute ("SendSize", UintegerValue (sndBufSize));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0.0));
+
+  PacketSinkHelper sink ("ns3::TcpSocketFactory",
+                         InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (1));
+  sinkApps.Start (Seconds (0.0));
+  sinkApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&SinkRx));
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (Seconds (stopTime));
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+
+  Ptr<PacketSink> sink1 = DynamicCast<PacketSink> (sinkApps.Get (0));
+  std::cout << "Total Bytes Received: " << sink1->GetTotalRx () << std::endl;
+  std::cout << "Last byte received at: " << g_lastRx.GetSeconds () << " s" << std::endl;
+  std::cout << "Wall-clock time: " << elapsed / 1000.0 << " s" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
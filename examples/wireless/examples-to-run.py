@@ -41,6 +41,8 @@ cpp_examples = [
     ("wifi-spectrum-per-example --distance=24 --index=31 --wifiType=ns3::YansWifiPhy --simulationTime=1", "True", "True"),
     ("wifi-spectrum-per-interference --distance=24 --index=31 --simulationTime=1 --waveformPower=0.1", "True", "True"),
     ("wifi-spectrum-saturation-example --simulationTime=1 --index=63", "True", "True"),
+    ("wifi-islands --nBss=3 --simulationTime=2", "True", "True"),
+    ("wifi-islands --nBss=3 --simulationTime=2 --islands=0", "True", "True"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
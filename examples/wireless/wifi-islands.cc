@@ -0,0 +1,305 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Independent BSSs simulated in separate processes.
+ *
+ * Every BSS is made of an AP and nSta stations sending UDP packets to the
+ * AP, on its own YansWifiChannel: the BSSs share no channel and are thus
+ * islands which IslandHelper simulates in separate processes. Each
+ * process only builds its own BSS, and installs a FlowMonitor on its
+ * nodes. The flow statistics of every BSS are sent back to the calling
+ * process, which merges them into the statistics of the whole deployment.
+ *
+ * With --islands=0, all the BSSs are built and simulated in a single
+ * process, which gives the same statistics: the random variable streams
+ * of every BSS only depend on the index of the BSS.
+ *
+ * This example illustrates the use of
+ *  - IslandHelper with an island build callback
+ *  - the merging of per-island FlowMonitor statistics
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/island-helper.h"
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WifiIslands");
+
+/**
+ * Build the BSSs of the deployment and collect their flow statistics.
+ */
+class WifiIslands
+{
+public:
+  /**
+   * \param nSta the number of stations of every BSS
+   * \param simulationTime the duration of the simulation
+   */
+  WifiIslands (uint32_t nSta, Time simulationTime);
+
+  /**
+   * Build a BSS.
+   *
+   * \param index the index of the BSS
+   * \return the nodes of the BSS
+   */
+  NodeContainer BuildBss (uint32_t index);
+  /**
+   * Install a FlowMonitor on the nodes of a BSS.
+   *
+   * \param index the index of the BSS
+   * \param nodes the nodes of the BSS
+   */
+  void StartBss (uint32_t index, NodeContainer nodes);
+  /**
+   * \param index the index of the BSS
+   * \param nodes the nodes of the BSS
+   * \return the packets sent and received, the bytes received and the sum
+   *         of the delays of the flows of the BSS
+   */
+  std::string GetBssResults (uint32_t index, NodeContainer nodes);
+  /**
+   * Add the flow statistics of a BSS to those of the deployment.
+   *
+   * \param index the index of the BSS
+   * \param results the flow statistics of the BSS
+   */
+  void MergeBssResults (uint32_t index, std::string results);
+  /**
+   * Print the statistics of the deployment.
+   */
+  void Print (void) const;
+
+private:
+  /**
+   * \param index the index of a BSS
+   * \return the network address of the BSS
+   */
+  static Ipv4Address GetNetwork (uint32_t index);
+
+  uint32_t m_nSta;                    //!< number of stations of every BSS
+  Time m_simulationTime;              //!< duration of the simulation
+  FlowMonitorHelper m_flowmon;        //!< FlowMonitor of the BSSs built in this process
+  uint32_t m_nBss;                    //!< number of BSSs merged
+  uint64_t m_txPackets;               //!< packets sent in the merged BSSs
+  uint64_t m_rxPackets;               //!< packets received in the merged BSSs
+  uint64_t m_rxBytes;                 //!< bytes received in the merged BSSs
+  int64_t m_delaySum;                 //!< sum of the delays of the packets received, in nanoseconds
+};
+
+WifiIslands::WifiIslands (uint32_t nSta, Time simulationTime)
+  : m_nSta (nSta),
+    m_simulationTime (simulationTime),
+    m_nBss (0),
+    m_txPackets (0),
+    m_rxPackets (0),
+    m_rxBytes (0),
+    m_delaySum (0)
+{
+}
+
+Ipv4Address
+WifiIslands::GetNetwork (uint32_t index)
+{
+  return Ipv4Address (Ipv4Address ("10.0.0.0").Get () + ((index + 1) << 8));
+}
+
+NodeContainer
+WifiIslands::BuildBss (uint32_t index)
+{
+  NodeContainer ap;
+  ap.Create (1);
+  NodeContainer stas;
+  stas.Create (m_nSta);
+  NodeContainer nodes (ap, stas);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate24Mbps"),
+                                "ControlMode", StringValue ("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  std::ostringstream ssid;
+  ssid << "bss-" << index;
+  mac.SetType ("ns3::ApWifiMac",
+               "Ssid", SsidValue (Ssid (ssid.str ())));
+  NetDeviceContainer devices = wifi.Install (phy, mac, ap);
+  mac.SetType ("ns3::StaWifiMac",
+               "Ssid", SsidValue (Ssid (ssid.str ())));
+  devices.Add (wifi.Install (phy, mac, stas));
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (5.0),
+                                 "GridWidth", UintegerValue (4));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase (GetNetwork (index), "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  // The streams of a BSS do not depend on the BSSs built before it.
+  int64_t stream = 1000 * index;
+  stream += wifi.AssignStreams (devices, stream);
+  internet.AssignStreams (nodes, stream);
+
+  uint16_t port = 9;
+  UdpServerHelper server (port);
+  ApplicationContainer apps = server.Install (ap);
+  UdpClientHelper client (interfaces.GetAddress (0), port);
+  client.SetAttribute ("MaxPackets", UintegerValue (4294967295u));
+  client.SetAttribute ("Interval", TimeValue (MicroSeconds (1000)));
+  client.SetAttribute ("PacketSize", UintegerValue (1000));
+  apps.Add (client.Install (stas));
+  apps.Start (Seconds (1.0));
+  apps.Stop (m_simulationTime);
+  return nodes;
+}
+
+void
+WifiIslands::StartBss (uint32_t index, NodeContainer nodes)
+{
+  m_flowmon.Install (nodes);
+}
+
+std::string
+WifiIslands::GetBssResults (uint32_t index, NodeContainer nodes)
+{
+  Ptr<FlowMonitor> monitor = m_flowmon.GetMonitor ();
+  monitor->CheckForLostPackets ();
+  Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (m_flowmon.GetClassifier ());
+  uint64_t txPackets = 0;
+  uint64_t rxPackets = 0;
+  uint64_t rxBytes = 0;
+  int64_t delaySum = 0;
+  // The monitor holds the flows of every BSS built in this process.
+  FlowMonitor::FlowStatsContainer stats = monitor->GetFlowStats ();
+  for (FlowMonitor::FlowStatsContainerCI i = stats.begin (); i != stats.end (); ++i)
+    {
+      Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (i->first);
+      if (t.destinationAddress.CombineMask (Ipv4Mask ("255.255.255.0")) != GetNetwork (index))
+        {
+          continue;
+        }
+      txPackets += i->second.txPackets;
+      rxPackets += i->second.rxPackets;
+      rxBytes += i->second.rxBytes;
+      delaySum += i->second.delaySum.GetNanoSeconds ();
+    }
+  std::ostringstream oss;
+  oss << txPackets << " " << rxPackets << " " << rxBytes << " " << delaySum;
+  return oss.str ();
+}
+
+void
+WifiIslands::MergeBssResults (uint32_t index, std::string results)
+{
+  uint64_t txPackets;
+  uint64_t rxPackets;
+  uint64_t rxBytes;
+  int64_t delaySum;
+  std::istringstream iss (results);
+  iss >> txPackets >> rxPackets >> rxBytes >> delaySum;
+  NS_ABORT_MSG_IF (iss.fail (), "Invalid results for BSS " << index << ": " << results);
+  NS_LOG_INFO ("BSS " << index << ": " << rxBytes * 8.0 / (m_simulationTime - Seconds (1.0)).GetSeconds () / 1e6 << " Mbit/s");
+  m_nBss++;
+  m_txPackets += txPackets;
+  m_rxPackets += rxPackets;
+  m_rxBytes += rxBytes;
+  m_delaySum += delaySum;
+}
+
+void
+WifiIslands::Print (void) const
+{
+  std::cout << "BSSs:                " << m_nBss << std::endl;
+  std::cout << "Tx packets:          " << m_txPackets << std::endl;
+  std::cout << "Rx packets:          " << m_rxPackets << std::endl;
+  std::cout << "Aggregate throughput: " << m_rxBytes * 8.0 / (m_simulationTime - Seconds (1.0)).GetSeconds () / 1e6 << " Mbit/s" << std::endl;
+  if (m_rxPackets > 0)
+    {
+      std::cout << "Mean delay:          " << m_delaySum / 1e6 / m_rxPackets << " ms" << std::endl;
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nBss = 8;
+  uint32_t nSta = 4;
+  double simulationTime = 5; //seconds
+  bool islands = true;
+  uint32_t maxProcesses = 0;
+
+  CommandLine cmd;
+  cmd.AddValue ("nBss", "Number of BSSs", nBss);
+  cmd.AddValue ("nSta", "Number of stations per BSS", nSta);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
+  cmd.AddValue ("islands", "Simulate every BSS in a separate process", islands);
+  cmd.AddValue ("maxProcesses", "Maximum number of concurrent processes (0: number of processors)", maxProcesses);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (nBss > 254, "At most 254 BSSs are supported");
+
+  WifiIslands scenario (nSta, Seconds (simulationTime));
+  if (islands)
+    {
+      IslandHelper islandHelper;
+      islandHelper.SetMaxProcesses (maxProcesses);
+      islandHelper.SetIslandBuildCallback (MakeCallback (&WifiIslands::BuildBss, &scenario));
+      islandHelper.SetIslandStartCallback (MakeCallback (&WifiIslands::StartBss, &scenario));
+      islandHelper.SetIslandResultsCallback (MakeCallback (&WifiIslands::GetBssResults, &scenario));
+      islandHelper.SetMergeCallback (MakeCallback (&WifiIslands::MergeBssResults, &scenario));
+      if (!islandHelper.Run (nBss, Seconds (simulationTime)))
+        {
+          std::cerr << "The simulation of a BSS failed" << std::endl;
+        }
+    }
+  else
+    {
+      std::vector<NodeContainer> bss;
+      for (uint32_t i = 0; i < nBss; i++)
+        {
+          bss.push_back (scenario.BuildBss (i));
+          scenario.StartBss (i, bss[i]);
+        }
+      Simulator::Stop (Seconds (simulationTime));
+      Simulator::Run ();
+      for (uint32_t i = 0; i < nBss; i++)
+        {
+          scenario.MergeBssResults (i, scenario.GetBssResults (i, bss[i]));
+        }
+    }
+  scenario.Print ();
+  Simulator::Destroy ();
+  return 0;
+}
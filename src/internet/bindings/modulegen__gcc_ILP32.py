@@ -2149,10 +2149,6 @@ def register_Ns3GlobalRouteManagerLSDB_methods(root_module, cls):
                    'ns3::GlobalRoutingLSA *', 
                    [param('ns3::Ipv4Address', 'addr')], 
                    is_const=True)
-    ## global-route-manager-impl.h (module 'internet'): void ns3::GlobalRouteManagerLSDB::Initialize() [member function]
-    cls.add_method('Initialize', 
-                   'void', 
-                   [])
     ## global-route-manager-impl.h (module 'internet'): ns3::GlobalRoutingLSA * ns3::GlobalRouteManagerLSDB::GetExtLSA(uint32_t index) const [member function]
     cls.add_method('GetExtLSA', 
                    'ns3::GlobalRoutingLSA *', 
@@ -2169,8 +2165,8 @@ def register_Ns3GlobalRoutingLSA_methods(root_module, cls):
     cls.add_output_stream_operator()
     ## global-router-interface.h (module 'internet'): ns3::GlobalRoutingLSA::GlobalRoutingLSA() [constructor]
     cls.add_constructor([])
-    ## global-router-interface.h (module 'internet'): ns3::GlobalRoutingLSA::GlobalRoutingLSA(ns3::GlobalRoutingLSA::SPFStatus status, ns3::Ipv4Address linkStateId, ns3::Ipv4Address advertisingRtr) [constructor]
-    cls.add_constructor([param('ns3::GlobalRoutingLSA::SPFStatus', 'status'), param('ns3::Ipv4Address', 'linkStateId'), param('ns3::Ipv4Address', 'advertisingRtr')])
+    ## global-router-interface.h (module 'internet'): ns3::GlobalRoutingLSA::GlobalRoutingLSA(ns3::Ipv4Address linkStateId, ns3::Ipv4Address advertisingRtr) [constructor]
+    cls.add_constructor([param('ns3::Ipv4Address', 'linkStateId'), param('ns3::Ipv4Address', 'advertisingRtr')])
     ## global-router-interface.h (module 'internet'): ns3::GlobalRoutingLSA::GlobalRoutingLSA(ns3::GlobalRoutingLSA & lsa) [constructor]
     cls.add_constructor([param('ns3::GlobalRoutingLSA &', 'lsa')])
     ## global-router-interface.h (module 'internet'): uint32_t ns3::GlobalRoutingLSA::AddAttachedRouter(ns3::Ipv4Address addr) [member function]
@@ -2199,6 +2195,11 @@ def register_Ns3GlobalRoutingLSA_methods(root_module, cls):
                    'ns3::Ipv4Address', 
                    [param('uint32_t', 'n')], 
                    is_const=True)
+    ## global-router-interface.h (module 'internet'): uint32_t ns3::GlobalRoutingLSA::GetIndex() const [member function]
+    cls.add_method('GetIndex', 
+                   'uint32_t', 
+                   [], 
+                   is_const=True)
     ## global-router-interface.h (module 'internet'): ns3::GlobalRoutingLSA::LSType ns3::GlobalRoutingLSA::GetLSType() const [member function]
     cls.add_method('GetLSType', 
                    'ns3::GlobalRoutingLSA::LSType', 
@@ -2234,11 +2235,6 @@ def register_Ns3GlobalRoutingLSA_methods(root_module, cls):
                    'ns3::Ptr< ns3::Node >', 
                    [], 
                    is_const=True)
-    ## global-router-interface.h (module 'internet'): ns3::GlobalRoutingLSA::SPFStatus ns3::GlobalRoutingLSA::GetStatus() const [member function]
-    cls.add_method('GetStatus', 
-                   'ns3::GlobalRoutingLSA::SPFStatus', 
-                   [], 
-                   is_const=True)
     ## global-router-interface.h (module 'internet'): bool ns3::GlobalRoutingLSA::IsEmpty() const [member function]
     cls.add_method('IsEmpty', 
                    'bool', 
@@ -2253,6 +2249,10 @@ def register_Ns3GlobalRoutingLSA_methods(root_module, cls):
     cls.add_method('SetAdvertisingRouter', 
                    'void', 
                    [param('ns3::Ipv4Address', 'rtr')])
+    ## global-router-interface.h (module 'internet'): void ns3::GlobalRoutingLSA::SetIndex(uint32_t index) [member function]
+    cls.add_method('SetIndex', 
+                   'void', 
+                   [param('uint32_t', 'index')])
     ## global-router-interface.h (module 'internet'): void ns3::GlobalRoutingLSA::SetLSType(ns3::GlobalRoutingLSA::LSType typ) [member function]
     cls.add_method('SetLSType', 
                    'void', 
@@ -2269,10 +2269,6 @@ def register_Ns3GlobalRoutingLSA_methods(root_module, cls):
     cls.add_method('SetNode', 
                    'void', 
                    [param('ns3::Ptr< ns3::Node >', 'node')])
-    ## global-router-interface.h (module 'internet'): void ns3::GlobalRoutingLSA::SetStatus(ns3::GlobalRoutingLSA::SPFStatus status) [member function]
-    cls.add_method('SetStatus', 
-                   'void', 
-                   [param('ns3::GlobalRoutingLSA::SPFStatus', 'status')])
     return
 
 def register_Ns3GlobalRoutingLinkRecord_methods(root_module, cls):
@@ -0,0 +1,238 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <map>
+#include <vector>
+
+#include "neighbor-cache-helper.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/ndisc-cache.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NeighborCacheHelper");
+
+namespace {
+
+/**
+ * \brief Sets of channels forming the same link, i.e. joined by bridges
+ */
+class LinkMap
+{
+public:
+  /**
+   * \brief Add the channel of a device, and join it to the channels of
+   * the devices it reaches.
+   * \param device the device
+   */
+  void AddDevice (Ptr<NetDevice> device)
+  {
+    Ptr<Channel> channel = device->GetChannel ();
+    if (channel == 0)
+      {
+        return;
+      }
+    for (uint32_t i = 0; i < channel->GetNDevices (); i++)
+      {
+        Ptr<NetDevice> peer = channel->GetDevice (i);
+        if (peer != 0 && peer->GetChannel () != 0)
+          {
+            Join (PeekPointer (channel), PeekPointer (peer->GetChannel ()));
+          }
+      }
+  }
+  /**
+   * \param device the device
+   * \returns the link of the device, or 0 if it has no channel
+   */
+  Channel* GetLink (Ptr<NetDevice> device)
+  {
+    Ptr<Channel> channel = device->GetChannel ();
+    return channel == 0 ? 0 : Find (PeekPointer (channel));
+  }
+
+private:
+  /**
+   * \param channel a channel
+   * \returns the representative of the link of the channel
+   */
+  Channel* Find (Channel *channel)
+  {
+    std::map<Channel *, Channel *>::iterator it = m_parent.find (channel);
+    if (it == m_parent.end ())
+      {
+        m_parent[channel] = channel;
+        return channel;
+      }
+    if (it->second != channel)
+      {
+        it->second = Find (it->second);
+      }
+    return it->second;
+  }
+  /**
+   * \brief Put two channels on the same link
+   * \param a a channel
+   * \param b another channel
+   */
+  void Join (Channel *a, Channel *b)
+  {
+    a = Find (a);
+    b = Find (b);
+    if (a != b)
+      {
+        m_parent[b] = a;
+      }
+  }
+
+  std::map<Channel *, Channel *> m_parent; //!< parent of each channel in its link
+};
+
+/**
+ * \brief Addresses and caches of a device
+ */
+struct Neighbor
+{
+  Neighbor () : link (0) {}
+
+  Ptr<NetDevice> device;           //!< the device
+  Channel *link;                   //!< the link of the device
+  std::vector<Ipv4Address> ipv4;   //!< the IPv4 addresses of the device
+  std::vector<Ipv6Address> ipv6;   //!< the IPv6 addresses of the device
+  Ptr<ArpCache> arpCache;          //!< the ARP cache of the device, if any
+  Ptr<NdiscCache> ndiscCache;      //!< the NDISC cache of the device, if any
+};
+
+} // anonymous namespace
+
+void
+NeighborCacheHelper::PopulateNeighborCache (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  LinkMap links;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); i++)
+    {
+      for (uint32_t j = 0; j < (*i)->GetNDevices (); j++)
+        {
+          links.AddDevice ((*i)->GetDevice (j));
+        }
+    }
+
+  // The devices resolving addresses, by node and device index
+  std::map<std::pair<uint32_t, uint32_t>, Neighbor> devices;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); i++)
+    {
+      Ptr<Ipv4L3Protocol> ipv4 = (*i)->GetObject<Ipv4L3Protocol> ();
+      for (uint32_t j = 0; ipv4 != 0 && j < ipv4->GetNInterfaces (); j++)
+        {
+          Ptr<Ipv4Interface> interface = ipv4->GetInterface (j);
+          if (interface->GetArpCache () == 0)
+            {
+              continue;
+            }
+          Neighbor &neighbor = devices[std::make_pair ((*i)->GetId (), interface->GetDevice ()->GetIfIndex ())];
+          neighbor.device = interface->GetDevice ();
+          neighbor.arpCache = interface->GetArpCache ();
+          for (uint32_t k = 0; k < interface->GetNAddresses (); k++)
+            {
+              neighbor.ipv4.push_back (interface->GetAddress (k).GetLocal ());
+            }
+        }
+
+      Ptr<Ipv6L3Protocol> ipv6 = (*i)->GetObject<Ipv6L3Protocol> ();
+      for (uint32_t j = 0; ipv6 != 0 && j < ipv6->GetNInterfaces (); j++)
+        {
+          Ptr<Ipv6Interface> interface = ipv6->GetInterface (j);
+          if (interface->GetNdiscCache () == 0)
+            {
+              continue;
+            }
+          Neighbor &neighbor = devices[std::make_pair ((*i)->GetId (), interface->GetDevice ()->GetIfIndex ())];
+          neighbor.device = interface->GetDevice ();
+          neighbor.ndiscCache = interface->GetNdiscCache ();
+          for (uint32_t k = 0; k < interface->GetNAddresses (); k++)
+            {
+              neighbor.ipv6.push_back (interface->GetAddress (k).GetAddress ());
+            }
+        }
+    }
+
+  std::map<Channel *, std::vector<Neighbor *> > neighbors;
+  for (std::map<std::pair<uint32_t, uint32_t>, Neighbor>::iterator i = devices.begin (); i != devices.end (); i++)
+    {
+      i->second.link = links.GetLink (i->second.device);
+      if (i->second.link != 0)
+        {
+          neighbors[i->second.link].push_back (&i->second);
+        }
+    }
+
+  for (std::map<std::pair<uint32_t, uint32_t>, Neighbor>::iterator i = devices.begin (); i != devices.end (); i++)
+    {
+      Neighbor &local = i->second;
+      if (local.link == 0)
+        {
+          continue;
+        }
+      std::vector<Neighbor *> &remotes = neighbors[local.link];
+      for (std::vector<Neighbor *>::iterator j = remotes.begin (); j != remotes.end (); j++)
+        {
+          Neighbor &remote = **j;
+          if (&remote == &local)
+            {
+              continue;
+            }
+          Address mac = remote.device->GetAddress ();
+          for (std::vector<Ipv4Address>::iterator k = remote.ipv4.begin ();
+               local.arpCache != 0 && k != remote.ipv4.end (); k++)
+            {
+              ArpCache::Entry *entry = local.arpCache->Lookup (*k);
+              if (entry == 0)
+                {
+                  entry = local.arpCache->Add (*k);
+                }
+              NS_LOG_LOGIC ("Node " << local.device->GetNode ()->GetId () << " ARP " << *k << " -> " << mac);
+              entry->SetMacAddresss (mac);
+              entry->MarkPermanent ();
+            }
+          for (std::vector<Ipv6Address>::iterator k = remote.ipv6.begin ();
+               local.ndiscCache != 0 && k != remote.ipv6.end (); k++)
+            {
+              NdiscCache::Entry *entry = local.ndiscCache->Lookup (*k);
+              if (entry == 0)
+                {
+                  entry = local.ndiscCache->Add (*k);
+                }
+              NS_LOG_LOGIC ("Node " << local.device->GetNode ()->GetId () << " NDISC " << *k << " -> " << mac);
+              entry->SetMacAddress (mac);
+              entry->MarkPermanent ();
+            }
+        }
+    }
+}
+
+} // namespace ns3
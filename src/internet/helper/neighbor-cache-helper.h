@@ -0,0 +1,49 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef NEIGHBOR_CACHE_HELPER_H
+#define NEIGHBOR_CACHE_HELPER_H
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Helper class that fills the ARP and NDISC caches of the nodes
+ * with static entries.
+ *
+ * The caches are filled from the nodes of the NodeList, so that the
+ * nodes sharing a link never need address resolution.  The devices on
+ * channels joined by a bridge are considered to be on the same link.
+ */
+class NeighborCacheHelper
+{
+public:
+  /**
+   * \brief Add to the ARP and NDISC caches of every interface a permanent
+   * entry for each address of the other interfaces on the same link.
+   *
+   * This function must be called once the addresses have been assigned
+   * to the interfaces.  The entries are static: they are not updated if
+   * the addresses or the topology change afterwards.
+   */
+  static void PopulateNeighborCache (void);
+};
+
+} // namespace ns3
+
+#endif /* NEIGHBOR_CACHE_HELPER_H */
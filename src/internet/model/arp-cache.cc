@@ -197,40 +197,39 @@ ArpCache::HandleWaitReplyTimeout (void)
   NS_LOG_FUNCTION (this);
   ArpCache::Entry* entry;
   bool restartWaitReplyTimer = false;
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++) 
+  EntryList::iterator i = m_waitReplyEntries.begin ();
+  while (i != m_waitReplyEntries.end ())
     {
-      entry = (*i).second;
-      if (entry != 0 && entry->IsWaitReply ())
+      // the entry leaves the list if it is marked dead
+      entry = *i++;
+      NS_ASSERT (entry->IsWaitReply ());
+      if (entry->GetRetries () < m_maxRetries)
         {
-          if (entry->GetRetries () < m_maxRetries)
-            {
-              NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
-                            ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
-                            " expired -- retransmitting arp request since retries = " <<
-                            entry->GetRetries ());
-              m_arpRequestCallback (this, entry->GetIpv4Address ());
-              restartWaitReplyTimer = true;
-              entry->IncrementRetries ();
-            }
-          else
+          NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
+                        ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
+                        " expired -- retransmitting arp request since retries = " <<
+                        entry->GetRetries ());
+          m_arpRequestCallback (this, entry->GetIpv4Address ());
+          restartWaitReplyTimer = true;
+          entry->IncrementRetries ();
+        }
+      else
+        {
+          NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
+                        ", wait reply for " << entry->GetIpv4Address () <<
+                        " expired -- drop since max retries exceeded: " <<
+                        entry->GetRetries ());
+          entry->MarkDead ();
+          entry->ClearRetries ();
+          Ipv4PayloadHeaderPair pending = entry->DequeuePending ();
+          while (pending.first != 0)
             {
-              NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
-                            ", wait reply for " << entry->GetIpv4Address () <<
-                            " expired -- drop since max retries exceeded: " <<
-                            entry->GetRetries ());
-              entry->MarkDead ();
-              entry->ClearRetries ();
-              Ipv4PayloadHeaderPair pending = entry->DequeuePending ();
-              while (pending.first != 0)
-                {
-                  // add the Ipv4 header for tracing purposes
-                  pending.first->AddHeader (pending.second);
-                  m_dropTrace (pending.first);
-                  pending = entry->DequeuePending ();
-                }
+              // add the Ipv4 header for tracing purposes
+              pending.first->AddHeader (pending.second);
+              m_dropTrace (pending.first);
+              pending = entry->DequeuePending ();
             }
         }
-
     }
   if (restartWaitReplyTimer)
     {
@@ -249,6 +248,7 @@ ArpCache::Flush (void)
       delete (*i).second;
     }
   m_arpCache.erase (m_arpCache.begin (), m_arpCache.end ());
+  m_waitReplyEntries.clear ();
   if (m_waitReplyTimer.IsRunning ())
     {
       NS_LOG_LOGIC ("Stopping WaitReplyTimer at " << Simulator::Now ().GetSeconds () << " due to ArpCache flush");
@@ -342,20 +342,36 @@ void
 ArpCache::Remove (ArpCache::Entry *entry)
 {
   NS_LOG_FUNCTION (this << entry);
-  
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++)
+
+  CacheI i = m_arpCache.find (entry->GetIpv4Address ());
+  if (i != m_arpCache.end () && (*i).second == entry)
     {
-      if ((*i).second == entry)
+      m_arpCache.erase (i);
+      if (entry->IsWaitReply ())
         {
-          m_arpCache.erase (i);
-          entry->ClearPendingPacket (); //clear the pending packets for entry's ipaddress
-          delete entry;
-          return;
+          RemoveWaitReply (entry);
         }
+      entry->ClearPendingPacket (); //clear the pending packets for entry's ipaddress
+      delete entry;
+      return;
     }
   NS_LOG_WARN ("Entry not found in this ARP Cache");
 }
 
+void
+ArpCache::AddWaitReply (ArpCache::Entry *entry)
+{
+  NS_LOG_FUNCTION (this << entry);
+  entry->m_waitReply = m_waitReplyEntries.insert (m_waitReplyEntries.end (), entry);
+}
+
+void
+ArpCache::RemoveWaitReply (ArpCache::Entry *entry)
+{
+  NS_LOG_FUNCTION (this << entry);
+  m_waitReplyEntries.erase (entry->m_waitReply);
+}
+
 ArpCache::Entry::Entry (ArpCache *arp)
   : m_arp (arp),
     m_state (ALIVE),
@@ -396,6 +412,10 @@ ArpCache::Entry::MarkDead (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_state == ALIVE || m_state == WAIT_REPLY || m_state == DEAD);
+  if (m_state == WAIT_REPLY)
+    {
+      m_arp->RemoveWaitReply (this);
+    }
   m_state = DEAD;
   ClearRetries ();
   UpdateSeen ();
@@ -405,6 +425,7 @@ ArpCache::Entry::MarkAlive (Address macAddress)
 {
   NS_LOG_FUNCTION (this << macAddress);
   NS_ASSERT (m_state == WAIT_REPLY);
+  m_arp->RemoveWaitReply (this);
   m_macAddress = macAddress;
   m_state = ALIVE;
   ClearRetries ();
@@ -416,6 +437,10 @@ ArpCache::Entry::MarkPermanent (void)
   NS_LOG_FUNCTION (this << m_macAddress);
   NS_ASSERT (!m_macAddress.IsInvalid ());
 
+  if (m_state == WAIT_REPLY)
+    {
+      m_arp->RemoveWaitReply (this);
+    }
   m_state = PERMANENT;
   ClearRetries ();
   UpdateSeen ();
@@ -445,6 +470,7 @@ ArpCache::Entry::MarkWaitReply (Ipv4PayloadHeaderPair waiting)
   NS_ASSERT_MSG (waiting.first, "Can not add a null packet to the ARP queue");
 
   m_state = WAIT_REPLY;
+  m_arp->AddWaitReply (this);
   m_pending.push_back (waiting);
   UpdateSeen ();
   m_arp->StartWaitReplyTimer ();
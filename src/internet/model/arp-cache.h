@@ -298,6 +298,8 @@ private:
      */
     Time GetTimeout (void) const;
 
+    friend class ArpCache;
+
     ArpCache *m_arp; //!< pointer to the ARP cache owning the entry
     ArpCacheEntryState_e m_state; //!< state of the entry
     Time m_lastSeen; //!< last moment a packet from that address has been seen
@@ -305,6 +307,7 @@ private:
     Ipv4Address m_ipv4Address; //!< entry's IP address
     std::list<Ipv4PayloadHeaderPair> m_pending; //!< list of pending packets for the entry's IP
     uint32_t m_retries; //!< rerty counter
+    std::list<ArpCache::Entry *>::iterator m_waitReply; //!< position in the WAIT_REPLY list of the cache
   };
 
 private:
@@ -317,8 +320,24 @@ private:
    */
   typedef sgi::hash_map<Ipv4Address, ArpCache::Entry *, Ipv4AddressHash>::iterator CacheI;
 
+  /**
+   * \brief List of entries
+   */
+  typedef std::list<ArpCache::Entry *> EntryList;
+
   virtual void DoDispose (void);
 
+  /**
+   * \brief Add an entry to the list of the entries in WAIT_REPLY state
+   * \param entry the entry entering the WAIT_REPLY state
+   */
+  void AddWaitReply (ArpCache::Entry *entry);
+  /**
+   * \brief Remove an entry from the list of the entries in WAIT_REPLY state
+   * \param entry the entry leaving the WAIT_REPLY state
+   */
+  void RemoveWaitReply (ArpCache::Entry *entry);
+
   Ptr<NetDevice> m_device; //!< NetDevice associated with the cache
   Ptr<Ipv4Interface> m_interface; //!< Ipv4Interface associated with the cache
   Time m_aliveTimeout; //!< cache alive state timeout
@@ -332,10 +351,14 @@ private:
    * This function is an event handler for the event that the
    * ArpCache wants to check whether it must retry any Arp requests.
    * If there are no Arp requests pending, this event is not scheduled.
+   *
+   * Only the entries in WAIT_REPLY state are visited, and they are all
+   * processed by the same event.
    */
   void HandleWaitReplyTimeout (void);
   uint32_t m_pendingQueueSize; //!< number of packets waiting for a resolution
   Cache m_arpCache; //!< the ARP cache
+  EntryList m_waitReplyEntries; //!< the entries in WAIT_REPLY state, in the order they entered it
   TracedCallback<Ptr<const Packet> > m_dropTrace; //!< trace for packets dropped by the ARP cache queue
 };
 
@@ -49,9 +49,9 @@ operator<< (std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream& 
 operator<< (std::ostream& os, const CandidateQueue& q)
 {
-  typedef CandidateQueue::CandidateList_t List_t;
+  typedef std::vector<SPFVertex*> List_t;
   typedef List_t::const_iterator CIter_t;
-  const CandidateQueue::CandidateList_t& list = q.m_candidates;
+  const List_t list = q.GetSortedVertices ();
 
   os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
   for (CIter_t iter = list.begin (); iter != list.end (); iter++)
@@ -66,7 +66,10 @@ operator<< (std::ostream& os, const CandidateQueue& q)
 }
 
 CandidateQueue::CandidateQueue()
-  : m_candidates ()
+  : m_heap (),
+    m_orders (),
+    m_vertexIds (),
+    m_nextOrder (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -81,7 +84,7 @@ void
 CandidateQueue::Clear (void)
 {
   NS_LOG_FUNCTION (this);
-  while (!m_candidates.empty ())
+  while (!m_orders.empty ())
     {
       SPFVertex *p = Pop ();
       delete p;
@@ -89,29 +92,69 @@ CandidateQueue::Clear (void)
     }
 }
 
+void
+CandidateQueue::PushCandidate (SPFVertex *v)
+{
+  NS_LOG_FUNCTION (this << v);
+  Candidate c;
+  c.vertex = v;
+  c.distance = v->GetDistanceFromRoot ();
+  c.network = (v->GetVertexType () == SPFVertex::VertexNetwork);
+  c.order = m_nextOrder++;
+  m_orders[v] = c.order;
+  m_heap.push_back (c);
+  std::push_heap (m_heap.begin (), m_heap.end (), &CandidateQueue::IsPoppedAfter);
+}
+
+void
+CandidateQueue::PopStale (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_heap.empty ())
+    {
+      std::map<SPFVertex*, uint64_t>::const_iterator it = m_orders.find (m_heap.front ().vertex);
+      if (it != m_orders.end () && it->second == m_heap.front ().order)
+        {
+          return;
+        }
+      std::pop_heap (m_heap.begin (), m_heap.end (), &CandidateQueue::IsPoppedAfter);
+      m_heap.pop_back ();
+    }
+}
+
 void
 CandidateQueue::Push (SPFVertex *vNew)
 {
   NS_LOG_FUNCTION (this << vNew);
 
-  CandidateList_t::iterator i = std::upper_bound (
-      m_candidates.begin (), m_candidates.end (), vNew,
-      &CandidateQueue::CompareSPFVertex
-      );
-  m_candidates.insert (i, vNew);
+  PushCandidate (vNew);
+  m_vertexIds.insert (std::make_pair (vNew->GetVertexId (), vNew));
 }
 
 SPFVertex *
 CandidateQueue::Pop (void)
 {
   NS_LOG_FUNCTION (this);
-  if (m_candidates.empty ())
+  if (m_orders.empty ())
     {
       return 0;
     }
 
-  SPFVertex *v = m_candidates.front ();
-  m_candidates.pop_front ();
+  SPFVertex *v = m_heap.front ().vertex;
+  std::pop_heap (m_heap.begin (), m_heap.end (), &CandidateQueue::IsPoppedAfter);
+  m_heap.pop_back ();
+  m_orders.erase (v);
+  typedef std::multimap<Ipv4Address, SPFVertex*>::iterator IdIter_t;
+  std::pair<IdIter_t, IdIter_t> range = m_vertexIds.equal_range (v->GetVertexId ());
+  for (IdIter_t i = range.first; i != range.second; i++)
+    {
+      if (i->second == v)
+        {
+          m_vertexIds.erase (i);
+          break;
+        }
+    }
+  PopStale ();
   return v;
 }
 
@@ -119,35 +162,46 @@ SPFVertex *
 CandidateQueue::Top (void) const
 {
   NS_LOG_FUNCTION (this);
-  if (m_candidates.empty ())
+  if (m_orders.empty ())
     {
       return 0;
     }
 
-  return m_candidates.front ();
+  return m_heap.front ().vertex;
 }
 
 bool
 CandidateQueue::Empty (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_candidates.empty ();
+  return m_orders.empty ();
 }
 
 uint32_t
 CandidateQueue::Size (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_candidates.size ();
+  return m_orders.size ();
 }
 
 SPFVertex *
 CandidateQueue::Find (const Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this);
-  CandidateList_t::const_iterator i = m_candidates.begin ();
+  typedef std::multimap<Ipv4Address, SPFVertex*>::const_iterator IdIter_t;
+  std::pair<IdIter_t, IdIter_t> range = m_vertexIds.equal_range (addr);
+  if (range.first == range.second)
+    {
+      return 0;
+    }
+  if (++IdIter_t (range.first) == range.second)
+    {
+      return range.first->second;
+    }
 
-  for (; i != m_candidates.end (); i++)
+  // Several vertices with the same ID: return the first one to be popped
+  std::vector<SPFVertex*> list = GetSortedVertices ();
+  for (std::vector<SPFVertex*>::const_iterator i = list.begin (); i != list.end (); i++)
     {
       SPFVertex *v = *i;
       if (v->GetVertexId () == addr)
@@ -159,42 +213,96 @@ CandidateQueue::Find (const Ipv4Address addr) const
   return 0;
 }
 
+std::vector<SPFVertex*>
+CandidateQueue::GetSortedVertices (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Candidate> current;
+  for (std::vector<Candidate>::const_iterator i = m_heap.begin (); i != m_heap.end (); i++)
+    {
+      std::map<SPFVertex*, uint64_t>::const_iterator it = m_orders.find (i->vertex);
+      if (it != m_orders.end () && it->second == i->order)
+        {
+          current.push_back (*i);
+        }
+    }
+  std::sort (current.begin (), current.end (), &CandidateQueue::CompareCandidate);
+  std::vector<SPFVertex*> list;
+  for (std::vector<Candidate>::const_iterator i = current.begin (); i != current.end (); i++)
+    {
+      list.push_back (i->vertex);
+    }
+  return list;
+}
+
 void
 CandidateQueue::Reorder (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_candidates.sort (&CandidateQueue::CompareSPFVertex);
+  // Sort the vertices by their current distance, keeping the previous
+  // order of the vertices of equal priority, and push them again in
+  // that order.
+  std::vector<SPFVertex*> list = GetSortedVertices ();
+  std::vector<Candidate> current;
+  for (std::vector<SPFVertex*>::const_iterator i = list.begin (); i != list.end (); i++)
+    {
+      Candidate c;
+      c.vertex = *i;
+      c.distance = (*i)->GetDistanceFromRoot ();
+      c.network = ((*i)->GetVertexType () == SPFVertex::VertexNetwork);
+      c.order = 0;
+      current.push_back (c);
+    }
+  std::stable_sort (current.begin (), current.end (), &CandidateQueue::CompareCandidate);
+  m_heap.clear ();
+  for (std::vector<Candidate>::const_iterator i = current.begin (); i != current.end (); i++)
+    {
+      PushCandidate (i->vertex);
+    }
   NS_LOG_LOGIC ("After reordering the CandidateQueue");
   NS_LOG_LOGIC (*this);
 }
 
+void
+CandidateQueue::Reorder (SPFVertex *v)
+{
+  NS_LOG_FUNCTION (this << v);
+  NS_ASSERT_MSG (m_orders.find (v) != m_orders.end (), "Vertex not in the CandidateQueue");
+
+  // In a sorted list, the vertex would move before the vertices of greater
+  // distance and after the ones of equal priority, which were all before it.
+  PushCandidate (v);
+  PopStale ();
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
  * In case of a tie, NetworkLSA is always ranked before RouterLSA.
  *
  * This ordering is necessary for implementing ECMP
+ *
+ * Candidates of equal priority are ranked in the order of their entries.
  */
 bool 
-CandidateQueue::CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2)
+CandidateQueue::CompareCandidate (const Candidate &c1, const Candidate &c2)
 {
-  NS_LOG_FUNCTION (&v1 << &v2);
-
-  bool result = false;
-  if (v1->GetDistanceFromRoot () < v2->GetDistanceFromRoot ())
+  if (c1.distance != c2.distance)
     {
-      result = true;
+      return c1.distance < c2.distance;
     }
-  else if (v1->GetDistanceFromRoot () == v2->GetDistanceFromRoot ())
+  if (c1.network != c2.network)
     {
-      if (v1->GetVertexType () == SPFVertex::VertexNetwork 
-          && v2->GetVertexType () == SPFVertex::VertexRouter)
-        {
-          result = true;
-        }
+      return c1.network;
     }
-  return result;
+  return c1.order < c2.order;
+}
+
+bool
+CandidateQueue::IsPoppedAfter (const Candidate &c1, const Candidate &c2)
+{
+  return CompareCandidate (c2, c1);
 }
 
 } // namespace ns3
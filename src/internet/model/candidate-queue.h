@@ -22,7 +22,8 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <map>
+#include <vector>
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -47,6 +48,13 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple 
  * enhanced priority queue.
+ *
+ * The vertices are kept in a binary heap, so that Push () and Pop () take
+ * a logarithmic time in the number of candidates.  Vertices of equal
+ * priority are popped in the order in which they were pushed, or in which
+ * their distance was last decreased, as if they were kept in a sorted list.
+ * A vertex whose distance decreased is pushed again; its previous entry in
+ * the heap is skipped when it reaches the top.
  */
 class CandidateQueue
 {
@@ -154,6 +162,17 @@ public:
  */
   void Reorder (void);
 
+/**
+ * @brief Reorders the Candidate Queue after the m_distanceFromRoot field of
+ * a single vertex of the queue decreased.
+ *
+ * This is equivalent to Reorder (), but takes a logarithmic time.
+ *
+ * @see SPFVertex
+ * @param v The Shortest Path First Vertex whose distance decreased.
+ */
+  void Reorder (SPFVertex *v);
+
 private:
 /**
  * Candidate Queue copy construction is disallowed (not implemented) to 
@@ -172,20 +191,56 @@ private:
  */
   CandidateQueue& operator= (CandidateQueue& sr);
 /**
- * \brief return true if v1 < v2
+ * \brief An entry of the heap.
+ */
+  struct Candidate
+  {
+    SPFVertex *vertex;  //!< the vertex
+    uint32_t distance;  //!< the distance of the vertex when the entry was pushed
+    bool network;       //!< whether the vertex is a network vertex
+    uint64_t order;     //!< the order in which the entry was pushed
+  };
+
+/**
+ * \brief return true if c1 < c2
  *
  * SPFVertexes are added into the queue according to the ordering
- * defined by this method. If v1 should be popped before v2, this 
+ * defined by this method. If c1 should be popped before c2, this 
  * method return true; false otherwise
  *
- * \param v1 first operand
- * \param v2 second operand
- * \return True if v1 should be popped before v2; false otherwise
+ * \param c1 first operand
+ * \param c2 second operand
+ * \return True if c1 should be popped before c2; false otherwise
+ */
+  static bool CompareCandidate (const Candidate &c1, const Candidate &c2);
+/**
+ * \brief return true if c1 should be popped after c2, i.e. the ordering
+ * of the heap, whose top is its greatest element
+ *
+ * \param c1 first operand
+ * \param c2 second operand
+ * \return True if c1 should be popped after c2; false otherwise
+ */
+  static bool IsPoppedAfter (const Candidate &c1, const Candidate &c2);
+/**
+ * \brief Push a heap entry for a vertex at its current distance.
+ *
+ * \param v the vertex
+ */
+  void PushCandidate (SPFVertex *v);
+/**
+ * \brief Remove the outdated entries from the top of the heap.
+ */
+  void PopStale (void);
+/**
+ * \return the vertices of the queue in the order in which they are popped
  */
-  static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
+  std::vector<SPFVertex*> GetSortedVertices (void) const;
 
-  typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-  CandidateList_t m_candidates;  //!< SPFVertex candidates
+  std::vector<Candidate> m_heap;  //!< heap of candidates, possibly outdated
+  std::map<SPFVertex*, uint64_t> m_orders; //!< the order of the current entry of every vertex
+  std::multimap<Ipv4Address, SPFVertex*> m_vertexIds; //!< the vertices by ID
+  uint64_t m_nextOrder; //!< the order of the next entry
 
   /**
    * \brief Stream insertion operator.
@@ -35,6 +35,12 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
 #include "global-router-interface.h"
 #include "global-route-manager-impl.h"
 #include "candidate-queue.h"
@@ -44,6 +50,21 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("GlobalRouteManagerImpl");
 
+/**
+ * \brief Number of threads running the SPF calculations of the routers.
+ */
+static GlobalValue g_globalRoutingNumThreads ("GlobalRoutingNumThreads",
+                                              "The number of threads used to compute the global routes "
+                                              "of the routers",
+                                              UintegerValue (1),
+                                              MakeUintegerChecker<uint32_t> (1, 256));
+
+/**
+ * \brief Number of routers computed by every worker thread before the
+ * routes are added to the routing tables.
+ */
+static const uint32_t SPF_ROUTERS_PER_THREAD_PER_ROUND = 64;
+
 /**
  * \brief Stream insertion operator.
  *
@@ -423,6 +444,7 @@ SPFVertex::ClearVertexProcessed (void)
 GlobalRouteManagerLSDB::GlobalRouteManagerLSDB ()
   :
     m_database (),
+    m_linkDataIndex (),
     m_extdatabase ()
 {
   NS_LOG_FUNCTION (this);
@@ -446,18 +468,7 @@ GlobalRouteManagerLSDB::~GlobalRouteManagerLSDB ()
     }
   NS_LOG_LOGIC ("clear map");
   m_database.clear ();
-}
-
-void
-GlobalRouteManagerLSDB::Initialize ()
-{
-  NS_LOG_FUNCTION (this);
-  LSDBMap_t::iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
-    {
-      GlobalRoutingLSA* temp = i->second;
-      temp->SetStatus (GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
-    }
+  m_linkDataIndex.clear ();
 }
 
 void
@@ -470,7 +481,29 @@ GlobalRouteManagerLSDB::Insert (Ipv4Address addr, GlobalRoutingLSA* lsa)
     } 
   else
     {
-      m_database.insert (LSDBPair_t (addr, lsa));
+      if (!m_database.insert (LSDBPair_t (addr, lsa)).second)
+        {
+          return;
+        }
+      lsa->SetIndex (m_database.size () - 1);
+//
+// Index the LSA by the link data of its transit network link records.  If
+// several LSAs share a link data, the one with the lowest address is kept,
+// which is the first one a scan of the database would find.
+//
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+          if (lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              std::pair<LinkDataMap_t::iterator, bool> result =
+                m_linkDataIndex.insert (std::make_pair (lr->GetLinkData (), addr));
+              if (!result.second && addr < result.first->second)
+                {
+                  result.first->second = addr;
+                }
+            }
+        }
     }
 }
 
@@ -495,13 +528,10 @@ GlobalRouteManagerLSDB::GetLSA (Ipv4Address addr) const
 //
 // Look up an LSA by its address.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_database.find (addr);
+  if (i != m_database.end ())
     {
-      if (i->first == addr)
-        {
-          return i->second;
-        }
+      return i->second;
     }
   return 0;
 }
@@ -511,22 +541,12 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this << addr);
 //
-// Look up an LSA by its address.
+// Look up an LSA by the link data of its transit network link records.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LinkDataMap_t::const_iterator i = m_linkDataIndex.find (addr);
+  if (i != m_linkDataIndex.end ())
     {
-      GlobalRoutingLSA* temp = i->second;
-// Iterate among temp's Link Records
-      for (uint32_t j = 0; j < temp->GetNLinkRecords (); j++)
-        {
-          GlobalRoutingLinkRecord *lr = temp->GetLinkRecord (j);
-          if ( lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork &&
-               lr->GetLinkData () == addr)
-            {
-              return temp;
-            }
-        }
+      return GetLSA (i->second);
     }
   return 0;
 }
@@ -539,16 +559,28 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_spfroot (0),
+    m_spfrootNode (0),
+    m_lsdbOwner (true)
 {
   NS_LOG_FUNCTION (this);
   m_lsdb = new GlobalRouteManagerLSDB ();
 }
 
+GlobalRouteManagerImpl::GlobalRouteManagerImpl (GlobalRouteManagerLSDB* lsdb)
+  :
+    m_spfroot (0),
+    m_spfrootNode (0),
+    m_lsdb (lsdb),
+    m_lsdbOwner (false)
+{
+  NS_LOG_FUNCTION (this << lsdb);
+}
+
 GlobalRouteManagerImpl::~GlobalRouteManagerImpl ()
 {
   NS_LOG_FUNCTION (this);
-  if (m_lsdb)
+  if (m_lsdb && m_lsdbOwner)
     {
       delete m_lsdb;
     }
@@ -700,6 +732,16 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 // Walk the list of nodes in the system.
 //
   NS_LOG_INFO ("About to start SPF calculation");
+  UintegerValue numThreads;
+  g_globalRoutingNumThreads.GetValue (numThreads);
+#ifndef HAVE_PTHREAD_H
+  if (numThreads.Get () > 1)
+    {
+      NS_LOG_WARN ("threads are not supported in this build, using a single thread");
+      numThreads.Set (1);
+    }
+#endif
+  std::vector<std::pair<Ipv4Address, Ptr<Node> > > roots;
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -724,12 +766,97 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 //
       if (rtr && rtr->GetNumLSAs () )
         {
-          SPFCalculate (rtr->GetRouterId ());
+          if (numThreads.Get () == 1)
+            {
+              SPFCalculate (rtr->GetRouterId ());
+            }
+          else
+            {
+              roots.push_back (std::make_pair (rtr->GetRouterId (),
+                                               FindRouterNode (rtr->GetRouterId ())));
+            }
         }
     }
+  if (!roots.empty ())
+    {
+      SPFCalculateParallel (roots, numThreads.Get ());
+    }
   NS_LOG_INFO ("Finished SPF calculation");
 }
 
+//
+// The SPF calculations of the routers are independent: each one reads the
+// link state database and the node at the root of its tree only.  They are
+// spread over worker threads, each one with its own GlobalRouteManagerImpl
+// sharing our database, and the routes are added to the routing tables by
+// this thread once a round of calculations is over.  The routes are added in
+// the order of the routers, so the routing tables are the same as with a
+// single thread.
+//
+void
+GlobalRouteManagerImpl::SPFCalculateParallel (const std::vector<std::pair<Ipv4Address, Ptr<Node> > > &roots,
+                                              uint32_t numThreads)
+{
+  NS_LOG_FUNCTION (this << roots.size () << numThreads);
+  std::vector<SPFWorker> workers (numThreads);
+  for (uint32_t t = 0; t < numThreads; ++t)
+    {
+      workers[t].m_impl = new GlobalRouteManagerImpl (m_lsdb);
+      workers[t].m_roots = &roots;
+      workers[t].m_step = numThreads;
+    }
+  uint32_t roundSize = numThreads * SPF_ROUTERS_PER_THREAD_PER_ROUND;
+  std::vector<SPFRouteList_t> routes (std::min<uint32_t> (roots.size (), roundSize));
+  for (uint32_t first = 0; first < roots.size (); first += roundSize)
+    {
+      uint32_t end = std::min<uint32_t> (roots.size (), first + roundSize);
+      for (uint32_t t = 0; t < numThreads; ++t)
+        {
+          workers[t].m_routes = routes.data ();
+          workers[t].m_first = first;
+          workers[t].m_begin = first + t;
+          workers[t].m_end = end;
+        }
+#ifdef HAVE_PTHREAD_H
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t t = 0; t < numThreads; ++t)
+        {
+          threads.push_back (Create<SystemThread> (MakeCallback (&SPFWorker::Run, &workers[t])));
+          threads.back ()->Start ();
+        }
+      for (uint32_t t = 0; t < numThreads; ++t)
+        {
+          threads[t]->Join ();
+        }
+#else
+      for (uint32_t t = 0; t < numThreads; ++t)
+        {
+          workers[t].Run ();
+        }
+#endif
+      for (uint32_t i = first; i < end; ++i)
+        {
+          InstallRoutes (roots[i].second, routes[i - first]);
+          routes[i - first].clear ();
+        }
+    }
+  for (uint32_t t = 0; t < numThreads; ++t)
+    {
+      delete workers[t].m_impl;
+    }
+}
+
+void
+GlobalRouteManagerImpl::SPFWorker::Run ()
+{
+  for (uint32_t i = m_begin; i < m_end; i += m_step)
+    {
+      m_impl->SPFCalculate ((*m_roots)[i].first, (*m_roots)[i].second);
+      m_routes[i - m_first].swap (m_impl->m_spfRoutes);
+      m_impl->m_spfRoutes.clear ();
+    }
+}
+
 //
 // This method is derived from quagga ospf_spf_next ().  See RFC2328 Section 
 // 16.1 (2) for further details.
@@ -836,7 +963,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 // If the link is to a router that is already in the shortest path first tree
 // then we have it covered -- ignore it.
 //
-      if (w_lsa->GetStatus () == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE) 
+      if (GetSPFStatus (w_lsa) == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE) 
         {
           NS_LOG_LOGIC ("Skipping ->  LSA "<< 
                         w_lsa->GetLinkStateId () << " already in SPF tree");
@@ -861,7 +988,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
       NS_LOG_LOGIC ("Considering w_lsa " << w_lsa->GetLinkStateId ());
 
 // Is there already vertex w in candidate list?
-      if (w_lsa->GetStatus () == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
+      if (GetSPFStatus (w_lsa) == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
         {
 // Calculate nexthop to w
 // We need to figure out how to actually get to the new router represented
@@ -873,7 +1000,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
           w = new SPFVertex (w_lsa);
           if (SPFNexthopCalculation (v, w, l, distance))
             {
-              w_lsa->SetStatus (GlobalRoutingLSA::LSA_SPF_CANDIDATE);
+              SetSPFStatus (w_lsa, GlobalRoutingLSA::LSA_SPF_CANDIDATE);
 //
 // Push this new vertex onto the priority queue (ordered by distance from the
 // root node).
@@ -888,7 +1015,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
             NS_ASSERT_MSG (0, "SPFNexthopCalculation never " 
                            << "return false, but it does now!");
         }
-      else if (w_lsa->GetStatus () == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
+      else if (GetSPFStatus (w_lsa) == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
         {
 //
 // We have already considered the link represented by <w>.  What wse have to
@@ -960,7 +1087,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 // If we've changed the cost to get to the vertex represented by <w>, we 
 // must reorder the priority queue keyed to that cost.
 //
-                  candidate.Reorder ();
+                  candidate.Reorder (cw);
                 }
             } // new lower cost path found
         } // end W is already on the candidate list
@@ -1320,12 +1447,8 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
               if (lr->GetLinkId () == myRouterId)
                 {
                   // Next hop is stored in the LinkID field of lr
-                  Ptr<GlobalRouter> router = rlsa->GetNode ()->GetObject<GlobalRouter> ();
-                  NS_ASSERT (router);
-                  Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-                  NS_ASSERT (gr);
-                  gr->AddNetworkRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), lr->GetLinkData (), 
-                                         FindOutgoingInterfaceId (transitLink->GetLinkData ()));
+                  AddSPFRoute (SPFRoute::NETWORK, Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), lr->GetLinkData (),
+                               FindOutgoingInterfaceId (transitLink->GetLinkData ()));
                   NS_LOG_LOGIC ("Inserting default route for node " << myRouterId << " to next hop " << 
                                 lr->GetLinkData () << " via interface " << 
                                 FindOutgoingInterfaceId (transitLink->GetLinkData ()));
@@ -1337,17 +1460,29 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
   return false;
 }
 
-// quagga ospf_spf_calculate
 void
 GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 {
   NS_LOG_FUNCTION (this << root);
+  Ptr<Node> node = FindRouterNode (root);
+  SPFCalculate (root, node);
+  InstallRoutes (node, m_spfRoutes);
+  m_spfRoutes.clear ();
+}
+
+// quagga ospf_spf_calculate
+void
+GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root, Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << root << node);
 
   SPFVertex *v;
 //
-// Initialize the Link State Database.
+// Every LSA is unexplored before the calculation starts.  The status of the
+// LSAs is kept here rather than in the Link State Database, which is shared
+// by the calculations run in parallel.
 //
-  m_lsdb->Initialize ();
+  m_spfStatus.assign (m_spfStatus.size (), GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
 //
 // The candidate queue is a priority queue of SPFVertex objects, with the top
 // of the queue being the closest vertex in terms of distance from the root
@@ -1367,7 +1502,7 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 //
   m_spfroot= v;
   v->SetDistanceFromRoot (0);
-  v->GetLSA ()->SetStatus (GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+  SetSPFStatus (v->GetLSA (), GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
   NS_LOG_LOGIC ("Starting SPFCalculate for node " << root);
 
 //
@@ -1377,10 +1512,17 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // reached.  Instead, short-circuit this computation and just install
 // a default route in the CheckForStubNode() method.
 //
-  if (NodeList::GetNNodes () > 0 && CheckForStubNode (root))
+//
+// The node whose routing tables are going to be written is found by the
+// caller once, rather than every time a route is added.
+//
+  m_spfrootNode = node;
+  if (m_spfrootNode != 0 && CheckForStubNode (root))
     {
       NS_LOG_LOGIC ("SPFCalculate truncated for stub node " << root);
       delete m_spfroot;
+      m_spfroot = 0;
+      m_spfrootNode = 0;
       return;
     }
 
@@ -1428,7 +1570,7 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // Update the status field of the vertex to indicate that it is in the SPF
 // tree.
 //
-      v->GetLSA ()->SetStatus (GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+      SetSPFStatus (v->GetLSA (), GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
 //
 // The current vertex has a parent pointer.  By calling this rather oddly 
 // named method (blame quagga) we add the current vertex to the list of 
@@ -1502,6 +1644,108 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 //
   delete m_spfroot;
   m_spfroot = 0;
+  m_spfrootNode = 0;
+}
+
+GlobalRoutingLSA::SPFStatus
+GlobalRouteManagerImpl::GetSPFStatus (GlobalRoutingLSA* lsa) const
+{
+  uint32_t index = lsa->GetIndex ();
+  if (index >= m_spfStatus.size ())
+    {
+      return GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED;
+    }
+  return m_spfStatus[index];
+}
+
+void
+GlobalRouteManagerImpl::SetSPFStatus (GlobalRoutingLSA* lsa, GlobalRoutingLSA::SPFStatus status)
+{
+  uint32_t index = lsa->GetIndex ();
+  if (index >= m_spfStatus.size ())
+    {
+      m_spfStatus.resize (index + 1, GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
+    }
+  m_spfStatus[index] = status;
+}
+
+void
+GlobalRouteManagerImpl::AddSPFRoute (SPFRoute::Type type, Ipv4Address dest, Ipv4Mask mask,
+                                     Ipv4Address nextHop, uint32_t interface)
+{
+  SPFRoute route;
+  route.type = type;
+  route.dest = dest;
+  route.mask = mask;
+  route.nextHop = nextHop;
+  route.interface = interface;
+  m_spfRoutes.push_back (route);
+}
+
+void
+GlobalRouteManagerImpl::InstallRoutes (Ptr<Node> node, const SPFRouteList_t &routes)
+{
+  NS_LOG_FUNCTION (node << routes.size ());
+  if (node == 0 || routes.empty ())
+    {
+      return;
+    }
+  Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
+  if (router == 0)
+    {
+      return;
+    }
+  Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
+  NS_ASSERT (gr);
+  for (SPFRouteList_t::const_iterator i = routes.begin (); i != routes.end (); i++)
+    {
+      switch (i->type)
+        {
+        case SPFRoute::HOST:
+          gr->AddHostRouteTo (i->dest, i->nextHop, i->interface);
+          break;
+        case SPFRoute::NETWORK:
+          gr->AddNetworkRouteTo (i->dest, i->mask, i->nextHop, i->interface);
+          break;
+        case SPFRoute::EXTERNAL:
+          gr->AddASExternalRouteTo (i->dest, i->mask, i->nextHop, i->interface);
+          break;
+        }
+    }
+}
+
+Ptr<Node>
+GlobalRouteManagerImpl::FindRouterNode (Ipv4Address routerId) const
+{
+  NS_LOG_FUNCTION (this << routerId);
+  if (NodeList::GetNNodes () == 0)
+    {
+      return 0;
+    }
+  GlobalRoutingLSA *lsa = m_lsdb->GetLSA (routerId);
+  if (lsa != 0)
+    {
+      Ptr<GlobalRouter> rtr = lsa->GetNode ()->GetObject<GlobalRouter> ();
+      if (rtr != 0 && rtr->GetRouterId () == routerId)
+        {
+          return lsa->GetNode ();
+        }
+    }
+//
+// The LSA was not built from a node (e.g., it was supplied by the unit
+// tests): walk the list of nodes looking for the one that has the router ID.
+//
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
+      if (rtr != 0 && rtr->GetRouterId () == routerId)
+        {
+          return node;
+        }
+    }
+  return 0;
 }
 
 void
@@ -1560,58 +1804,37 @@ GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// The node at the root of the SPF tree, found when the calculation started,
+// is the one we're going to write the routing information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  Ptr<Node> node = m_spfrootNode;
+  if (node == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
+      NS_LOG_LOGIC ("Can't find root node " << routerId);
+      return;
+    }
+  NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
 //
 // Routing information is updated using the Ipv4 interface.  We need to QI
 // for that interface.  If the node is acting as an IP version 4 router, it
 // should absolutely have an Ipv4 interface.
 //
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4, 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "QI for <Ipv4> interface failed");
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = extlsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
+  NS_ASSERT_MSG (v->GetLSA (), 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = extlsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
 
 //
 // Here's why we did all of that work.  We're going to add a host route to the
@@ -1626,39 +1849,29 @@ GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v
 // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
 // which the packets should be send for forwarding.
 //
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddASExternalRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add external network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
+        {
+          AddSPFRoute (SPFRoute::EXTERNAL, tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " add external network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative");
+        }
+    }
 }
 
 
@@ -1729,60 +1942,37 @@ GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex*
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// The node at the root of the SPF tree, found when the calculation started,
+// is the one we're going to write the routing information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  Ptr<Node> node = m_spfrootNode;
+  if (node == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
+      NS_LOG_LOGIC ("Can't find root node " << routerId);
+      return;
+    }
+  NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
 //
 // Routing information is updated using the Ipv4 interface.  We need to QI
 // for that interface.  If the node is acting as an IP version 4 router, it
 // should absolutely have an Ipv4 interface.
 //
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4, 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "QI for <Ipv4> interface failed");
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask (l->GetLinkData ().Get ());
-          Ipv4Address tempip = l->GetLinkId ();
-          tempip = tempip.CombineMask (tempmask);
+  NS_ASSERT_MSG (v->GetLSA (), 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask (l->GetLinkData ().Get ());
+  Ipv4Address tempip = l->GetLinkId ();
+  tempip = tempip.CombineMask (tempmask);
 //
 // Here's why we did all of that work.  We're going to add a host route to the
 // host address found in the m_linkData field of the point-to-point link
@@ -1797,39 +1987,29 @@ GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex*
 // which the packets should be send for forwarding.
 //
 
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
+        {
+          AddSPFRoute (SPFRoute::NETWORK, tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative");
+        }
+    }
 }
 
 //
@@ -1853,61 +2033,40 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId (Ipv4Address a, Ipv4Mask amask)
 //
   Ipv4Address routerId = m_spfroot->GetVertexId ();
 //
-// Walk the list of nodes in the system looking for the one corresponding to
-// the node at the root of the SPF tree.  This is the node for which we are
-// building the routing table.
+// The node at the root of the SPF tree, found when the calculation started,
+// is the node for which we are building the routing table.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  Ptr<Node> node = m_spfrootNode;
+  if (node == 0)
     {
-      Ptr<Node> node = *i;
-
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-//
-// If the node doesn't have a GlobalRouter interface it can't be the one
-// we're interested in.
-//
-      if (rtr == 0)
-        {
-          continue;
-        }
-
-      if (rtr->GetRouterId () == routerId)
-        {
+      NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find root node " << routerId);
+      return -1;
+    }
 //
 // This is the node we're building the routing table for.  We're going to need
 // the Ipv4 interface to look for the ipv4 interface index.  Since this node
 // is participating in routing IP version 4 packets, it certainly must have 
 // an Ipv4 interface.
 //
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                         "GetObject for <Ipv4> interface failed");
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4, 
+                 "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
+                 "GetObject for <Ipv4> interface failed");
 //
 // Look through the interfaces on this node for one that has the IP address
 // we're looking for.  If we find one, return the corresponding interface
 // index, or -1 if not found.
 //
-          int32_t interface = ipv4->GetInterfaceForPrefix (a, amask);
+  int32_t interface = ipv4->GetInterfaceForPrefix (a, amask);
 
 #if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif 
-          return interface;
-        }
+  if (interface < 0)
+    {
+      NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
+                      "Expected an interface associated with address a:" << a);
     }
-//
-// Couldn't find it.
-//
-  NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find root node " << routerId);
-  return -1;
+#endif 
+  return interface;
 }
 
 //
@@ -1944,60 +2103,37 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// The node at the root of the SPF tree, found when the calculation started,
+// is the one we're going to write the routing information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  Ptr<Node> node = m_spfrootNode;
+  if (node == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
+      NS_LOG_LOGIC ("Can't find root node " << routerId);
+      return;
+    }
+  NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
 //
 // Routing information is updated using the Ipv4 interface.  We need to 
 // GetObject for that interface.  If the node is acting as an IP version 4 
 // router, it should absolutely have an Ipv4 interface.
 //
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "GetObject for <Ipv4> interface failed");
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4, 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "GetObject for <Ipv4> interface failed");
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
+  GlobalRoutingLSA *lsa = v->GetLSA ();
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
 
-          uint32_t nLinkRecords = lsa->GetNLinkRecords ();
+  uint32_t nLinkRecords = lsa->GetNLinkRecords ();
 //
 // Iterate through the link records on the vertex to which we're going to add
 // routes.  To make sure we're being clear, we're going to add routing table
@@ -2006,18 +2142,18 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // the local side of the point-to-point links found on the node described by
 // the vertex <v>.
 //
-          NS_LOG_LOGIC (" Node " << node->GetId () <<
-                        " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
-          for (uint32_t j = 0; j < nLinkRecords; ++j)
-            {
+  NS_LOG_LOGIC (" Node " << node->GetId () <<
+                " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
+  for (uint32_t j = 0; j < nLinkRecords; ++j)
+    {
 //
 // We are only concerned about point-to-point links
 //
-              GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
-              if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                  continue;
-                }
+      GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+      if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
+        {
+          continue;
+        }
 //
 // Here's why we did all of that work.  We're going to add a host route to the
 // host address found in the m_linkData field of the point-to-point link
@@ -2031,44 +2167,31 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
 // which the packets should be send for forwarding.
 //
-              Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-              if (router == 0)
-                {
-                  continue;
-                }
-              Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-              NS_ASSERT (gr);
-              // walk through all available exit directions due to ECMP,
-              // and add host route for each of the exit direction toward
-              // the vertex 'v'
-              for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-                {
-                  SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-                  Ipv4Address nextHop = exit.first;
-                  int32_t outIf = exit.second;
-                  if (outIf >= 0)
-                    {
-                      gr->AddHostRouteTo (lr->GetLinkData (), nextHop,
-                                          outIf);
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " adding host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " and outgoing interface " << outIf);
-                    }
-                  else
-                    {
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " NOT able to add host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " since outgoing interface id is negative " << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
+      // walk through all available exit directions due to ECMP,
+      // and add host route for each of the exit direction toward
+      // the vertex 'v'
+      for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+        {
+          SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+          Ipv4Address nextHop = exit.first;
+          int32_t outIf = exit.second;
+          if (outIf >= 0)
+            {
+              AddSPFRoute (SPFRoute::HOST, lr->GetLinkData (), Ipv4Mask::GetOnes (),
+                           nextHop, outIf);
+              NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                            " adding host route to " << lr->GetLinkData () <<
+                            " using next hop " << nextHop <<
+                            " and outgoing interface " << outIf);
             }
-//
-// Done adding the routes for the selected node.
-//
-          return;
-        }
+          else
+            {
+              NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                            " NOT able to add host route to " << lr->GetLinkData () <<
+                            " using next hop " << nextHop <<
+                            " since outgoing interface id is negative " << outIf);
+            }
+        } // for all routes from the root the vertex 'v'
     }
 }
 void
@@ -2089,95 +2212,63 @@ GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// The node at the root of the SPF tree, found when the calculation started,
+// is the one we're going to write the routing information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  Ptr<Node> node = m_spfrootNode;
+  if (node == 0)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("setting routes for node " << node->GetId ());
+      NS_LOG_LOGIC ("Can't find root node " << routerId);
+      return;
+    }
+  NS_LOG_LOGIC ("setting routes for node " << node->GetId ());
 //
 // Routing information is updated using the Ipv4 interface.  We need to 
 // GetObject for that interface.  If the node is acting as an IP version 4 
 // router, it should absolutely have an Ipv4 interface.
 //
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "GetObject for <Ipv4> interface failed");
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4, 
+                 "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                 "GetObject for <Ipv4> interface failed");
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = lsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all available exit directions due to ECMP,
-          // and add host route for each of the exit direction toward
-          // the vertex 'v'
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
+  GlobalRoutingLSA *lsa = v->GetLSA ();
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = lsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
+  // walk through all available exit directions due to ECMP,
+  // and add host route for each of the exit direction toward
+  // the vertex 'v'
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
 
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative " << outIf);
-                }
-            }
+      if (outIf >= 0)
+        {
+          AddSPFRoute (SPFRoute::NETWORK, tempip, tempmask, nextHop, outIf);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
         }
-    } 
+      else
+        {
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative " << outIf);
+        }
+    }
 }
 
 // Derived from quagga ospf_vertex_add_parents ()
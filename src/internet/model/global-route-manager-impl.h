@@ -602,7 +602,8 @@ public:
  * State Database.
  *
  * The IPV4 address and the GlobalRoutingLSA given as parameters are converted
- * to an STL pair and are inserted into the database map.
+ * to an STL pair and are inserted into the database map.  The LSA is given
+ * the next index, which the SPF calculations use to keep its status.
  *
  * @see GlobalRoutingLSA
  * @see Ipv4Address
@@ -641,19 +642,6 @@ public:
  */
   GlobalRoutingLSA* GetLSAByLinkData (Ipv4Address addr) const;
 
-/**
- * @brief Set all LSA flags to an initialized state, for SPF computation
- *
- * This function walks the database and resets the status flags of all of the
- * contained Link State Advertisements to LSA_SPF_NOT_EXPLORED.  This is done
- * prior to each SPF calculation to reset the state of the SPFVertex structures
- * that will reference the LSAs during the calculation.
- *
- * @see GlobalRoutingLSA
- * @see SPFVertex
- */
-  void Initialize ();
-
   /**
    * @brief Look up the External Link State Advertisement associated with the given
    * index.
@@ -679,7 +667,10 @@ private:
   typedef std::map<Ipv4Address, GlobalRoutingLSA*> LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
   typedef std::pair<Ipv4Address, GlobalRoutingLSA*> LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
 
+  typedef std::map<Ipv4Address, Ipv4Address> LinkDataMap_t; //!< container of link data / addresses of Link State Advertisements
+
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
+  LinkDataMap_t m_linkDataIndex; //!< addresses of the Link State Advertisements, by the link data of their transit network link records
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
 
 /**
@@ -732,6 +723,9 @@ public:
 /**
  * @brief Compute routes using a Dijkstra SPF computation and populate
  * per-node forwarding tables
+ *
+ * The computations of the routers are run by the number of threads set by
+ * the GlobalRoutingNumThreads global value.
  */
   virtual void InitializeRoutes ();
 
@@ -766,8 +760,116 @@ private:
  */
   GlobalRouteManagerImpl& operator= (GlobalRouteManagerImpl& srmi);
 
+/**
+ * @brief Construct the SPF calculations of a worker thread, which share
+ * the Link State DataBase of another GlobalRouteManagerImpl.
+ *
+ * @param lsdb the Link State DataBase, which is not deleted with this object
+ */
+  GlobalRouteManagerImpl (GlobalRouteManagerLSDB* lsdb);
+
+  /**
+   * \brief A route computed for the node at the root of the SPF tree
+   */
+  struct SPFRoute
+  {
+    /// The kind of route, i.e., the Ipv4GlobalRouting method which adds it
+    enum Type
+    {
+      HOST,      //!< host route
+      NETWORK,   //!< network route
+      EXTERNAL   //!< Autonomous System external route
+    };
+    Type type;             //!< the kind of route
+    Ipv4Address dest;      //!< the destination host or network
+    Ipv4Mask mask;         //!< the network mask
+    Ipv4Address nextHop;   //!< the next hop
+    uint32_t interface;    //!< the outgoing interface
+  };
+
+  typedef std::vector<SPFRoute> SPFRouteList_t; //!< list of routes computed for a node
+  typedef std::vector<GlobalRoutingLSA::SPFStatus> SPFStatusList_t; //!< SPF status of the LSAs, by LSA index
+
+  /**
+   * \brief A worker thread computing the routes of a share of the routers
+   *
+   * The worker runs the SPF calculations with its own GlobalRouteManagerImpl,
+   * which reads the Link State DataBase without modifying it, and only
+   * accesses the node at the root of the SPF tree.
+   */
+  struct SPFWorker
+  {
+    /// Compute the routes of the routers m_begin, m_begin + m_step, ... before m_end
+    void Run ();
+
+    GlobalRouteManagerImpl *m_impl;  //!< the SPF calculations of the worker
+    const std::vector<std::pair<Ipv4Address, Ptr<Node> > > *m_roots; //!< the router IDs, and their nodes
+    SPFRouteList_t *m_routes;        //!< output, the routes of every router from m_first
+    uint32_t m_first;                //!< index of the first router of the current round
+    uint32_t m_begin;                //!< index of the first router computed by the worker
+    uint32_t m_end;                  //!< index past the last router of the current round
+    uint32_t m_step;                 //!< distance between two routers computed by the worker
+  };
+
   SPFVertex* m_spfroot; //!< the root node
+  Ptr<Node> m_spfrootNode; //!< the node at the root of the SPF tree, if any
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+  bool m_lsdbOwner; //!< true if the LSDB is deleted with this object
+  SPFStatusList_t m_spfStatus; //!< the SPF status of the LSAs in the current calculation
+  SPFRouteList_t m_spfRoutes; //!< the routes found by the current calculation
+
+  /**
+   * \brief Get the SPF status of an LSA in the current calculation
+   *
+   * The status is kept by the calculation rather than by the LSA, so that
+   * the Link State DataBase is not modified by the SPF calculations.  It is
+   * addressed by the index of the LSA in the database.
+   *
+   * \param lsa the LSA
+   * \returns the status of the LSA
+   */
+  GlobalRoutingLSA::SPFStatus GetSPFStatus (GlobalRoutingLSA* lsa) const;
+
+  /**
+   * \brief Set the SPF status of an LSA in the current calculation
+   *
+   * \param lsa the LSA
+   * \param status the status of the LSA
+   */
+  void SetSPFStatus (GlobalRoutingLSA* lsa, GlobalRoutingLSA::SPFStatus status);
+
+  /**
+   * \brief Record a route for the node at the root of the SPF tree
+   *
+   * \param type the kind of route
+   * \param dest the destination host or network
+   * \param mask the network mask
+   * \param nextHop the next hop
+   * \param interface the outgoing interface
+   */
+  void AddSPFRoute (SPFRoute::Type type, Ipv4Address dest, Ipv4Mask mask,
+                    Ipv4Address nextHop, uint32_t interface);
+
+  /**
+   * \brief Add routes to the Ipv4GlobalRouting of a node
+   *
+   * \param node the node, possibly 0
+   * \param routes the routes, in the order they are added
+   */
+  static void InstallRoutes (Ptr<Node> node, const SPFRouteList_t &routes);
+
+  /**
+   * \brief Run the SPF calculations of several routers in worker threads
+   *
+   * The routers are processed in rounds.  After each round, once all the
+   * workers are done, the routes are added to the routing tables in the
+   * order of the routers.
+   *
+   * \param roots the router IDs, and their nodes
+   * \param numThreads the number of worker threads
+   */
+  void SPFCalculateParallel (const std::vector<std::pair<Ipv4Address, Ptr<Node> > > &roots,
+                             uint32_t numThreads);
 
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
@@ -782,13 +884,35 @@ private:
   bool CheckForStubNode (Ipv4Address root);
 
   /**
-   * \brief Calculate the shortest path first (SPF) tree
+   * \brief Find the node whose GlobalRouter has a given router ID.
+   *
+   * The node is normally the one of the router LSA of the router ID;
+   * all the nodes are only searched when the LSA was not built for a node.
+   *
+   * \param routerId the router ID
+   * \returns the node, or 0 if no node has this router ID
+   */
+  Ptr<Node> FindRouterNode (Ipv4Address routerId) const;
+
+  /**
+   * \brief Calculate the shortest path first (SPF) tree, and add the
+   * routes to the routing table of the root node
    *
    * Equivalent to quagga ospf_spf_calculate
    * \param root the root node
    */
   void SPFCalculate (Ipv4Address root);
 
+  /**
+   * \brief Calculate the shortest path first (SPF) tree
+   *
+   * The routes are left in m_spfRoutes.
+   *
+   * \param root the root node
+   * \param node the node of the root, or 0 if there is none
+   */
+  void SPFCalculate (Ipv4Address root, Ptr<Node> node);
+
   /**
    * \brief Process Stub nodes
    *
@@ -142,14 +142,13 @@ GlobalRoutingLSA::GlobalRoutingLSA()
     m_linkRecords (),
     m_networkLSANetworkMask ("0.0.0.0"),
     m_attachedRouters (),
-    m_status (GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED),
+    m_index (0),
     m_node_id (0)
 {
   NS_LOG_FUNCTION (this);
 }
 
 GlobalRoutingLSA::GlobalRoutingLSA (
-  GlobalRoutingLSA::SPFStatus status,
   Ipv4Address linkStateId, 
   Ipv4Address advertisingRtr)
   :
@@ -159,17 +158,17 @@ GlobalRoutingLSA::GlobalRoutingLSA (
     m_linkRecords (),
     m_networkLSANetworkMask ("0.0.0.0"),
     m_attachedRouters (),
-    m_status (status),
+    m_index (0),
     m_node_id (0)
 {
-  NS_LOG_FUNCTION (this << status << linkStateId << advertisingRtr);
+  NS_LOG_FUNCTION (this << linkStateId << advertisingRtr);
 }
 
 GlobalRoutingLSA::GlobalRoutingLSA (GlobalRoutingLSA& lsa)
   : m_lsType (lsa.m_lsType), m_linkStateId (lsa.m_linkStateId),
     m_advertisingRtr (lsa.m_advertisingRtr),
     m_networkLSANetworkMask (lsa.m_networkLSANetworkMask),
-    m_status (lsa.m_status),
+    m_index (lsa.m_index),
     m_node_id (lsa.m_node_id)
 {
   NS_LOG_FUNCTION (this << &lsa);
@@ -186,7 +185,7 @@ GlobalRoutingLSA::operator= (const GlobalRoutingLSA& lsa)
   m_linkStateId = lsa.m_linkStateId;
   m_advertisingRtr = lsa.m_advertisingRtr;
   m_networkLSANetworkMask = lsa.m_networkLSANetworkMask, 
-  m_status = lsa.m_status;
+  m_index = lsa.m_index;
   m_node_id = lsa.m_node_id;
 
   ClearLinkRecords ();
@@ -339,11 +338,11 @@ GlobalRoutingLSA::GetNetworkLSANetworkMask (void) const
   return m_networkLSANetworkMask;
 }
 
-GlobalRoutingLSA::SPFStatus
-GlobalRoutingLSA::GetStatus (void) const
+uint32_t
+GlobalRoutingLSA::GetIndex (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_status;
+  return m_index;
 }
 
 uint32_t
@@ -380,10 +379,10 @@ GlobalRoutingLSA::GetAttachedRouter (uint32_t n) const
 }
 
 void
-GlobalRoutingLSA::SetStatus (GlobalRoutingLSA::SPFStatus status)
+GlobalRoutingLSA::SetIndex (uint32_t index)
 {
-  NS_LOG_FUNCTION (this << status);
-  m_status = status;
+  NS_LOG_FUNCTION (this << index);
+  m_index = index;
 }
 
 Ptr<Node>
@@ -621,7 +620,6 @@ GlobalRouter::DiscoverLSAs ()
   pLSA->SetLSType (GlobalRoutingLSA::RouterLSA);
   pLSA->SetLinkStateId (m_routerId);
   pLSA->SetAdvertisingRouter (m_routerId);
-  pLSA->SetStatus (GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
   pLSA->SetNode (node);
 
   //
@@ -736,7 +734,6 @@ GlobalRouter::DiscoverLSAs ()
       pLSA->SetLinkStateId ((*i)->GetDestNetwork ());
       pLSA->SetAdvertisingRouter (m_routerId);
       pLSA->SetNetworkLSANetworkMask ((*i)->GetDestNetworkMask ());
-      pLSA->SetStatus (GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
       m_LSAs.push_back (pLSA); 
     }
   return m_LSAs.size ();
@@ -1190,7 +1187,6 @@ GlobalRouter::BuildNetworkLSAs (NetDeviceContainer c)
       pLSA->SetLinkStateId (addrLocal);
       pLSA->SetAdvertisingRouter (m_routerId);
       pLSA->SetNetworkLSANetworkMask (maskLocal);
-      pLSA->SetStatus (GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
       pLSA->SetNode (node);
 
       //
@@ -267,8 +267,8 @@ public:
   };
 /**
  * @enum SPFStatus
- * @brief Enumeration of the possible values of the status flag in the Routing 
- * Link State Advertisements.
+ * @brief Enumeration of the possible status of the Routing Link State
+ * Advertisements in an SPF calculation.
  */
   enum SPFStatus {
     LSA_SPF_NOT_EXPLORED = 0,   /**< New vertex not yet considered */
@@ -288,12 +288,10 @@ public:
  *
  * On completion the list of Link State Records is empty.
  *
- * @param status The status to of the new LSA.
  * @param linkStateId The Ipv4Address for the link state ID field.
  * @param advertisingRtr The Ipv4Address for the advertising router field.
  */
-  GlobalRoutingLSA(SPFStatus status, Ipv4Address linkStateId, 
-                   Ipv4Address advertisingRtr);
+  GlobalRoutingLSA(Ipv4Address linkStateId, Ipv4Address advertisingRtr);
 
 /**
  * @brief Copy constructor for a Global Routing Link State Advertisement.
@@ -468,19 +466,23 @@ public:
   Ipv4Address GetAttachedRouter (uint32_t n) const;
 
 /**
- * @brief Get the SPF status of the advertisement.
+ * @brief Get the index of the advertisement in the Link State DataBase.
  *
- * @see SPFStatus
- * @returns The SPFStatus of the LSA.
+ * The SPF calculations keep the status of the LSAs in a vector addressed
+ * by this index.
+ *
+ * @returns The index of the LSA.
  */
-  SPFStatus GetStatus (void) const;
+  uint32_t GetIndex (void) const;
 
 /**
- * @brief Set the SPF status of the advertisement
- * @param status SPF status to set
- * @see SPFStatus
+ * @brief Set the index of the advertisement in the Link State DataBase.
+ *
+ * This is done by GlobalRouteManagerLSDB::Insert.
+ *
+ * @param index The index of the LSA.
  */
-  void SetStatus (SPFStatus status);
+  void SetIndex (uint32_t index);
 
 /**
  * @brief Get the Node pointer of the node that originated this LSA
@@ -555,13 +557,7 @@ private:
  */
   ListOfAttachedRouters_t m_attachedRouters;
 
-/**
- * This is a tristate flag used internally in the SPF computation to mark
- * if an SPFVertex (a data structure representing a vertex in the SPF tree
- * -- a router) is new, is a candidate for a shortest path, or is in its
- * proper position in the tree.
- */
-  SPFStatus m_status;
+  uint32_t m_index; //!< index of the LSA in the Link State DataBase
   uint32_t m_node_id; //!< node ID
 };
 
@@ -29,7 +29,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
-  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
+  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152), m_nextOrder (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -37,36 +37,37 @@ Ipv4EndPointDemux::Ipv4EndPointDemux ()
 Ipv4EndPointDemux::~Ipv4EndPointDemux ()
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (OrderedEndPoints::iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
-      Ipv4EndPoint *endPoint = *i;
+      Ipv4EndPoint *endPoint = i->second;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_orders.clear ();
+  m_ports.clear ();
+  m_fourTuples.clear ();
 }
 
 bool
 Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort  () == port) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<uint16_t, OrderedEndPoints>::const_iterator bucket = m_ports.find (port);
+  if (bucket == m_ports.end ())
+    {
+      return false;
+    }
+  for (OrderedEndPoints::const_iterator i = bucket->second.begin (); i != bucket->second.end (); i++) 
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr) 
+      if (i->second->GetLocalAddress () == addr) 
         {
           return true;
         }
@@ -84,10 +85,7 @@ Ipv4EndPointDemux::Allocate (void)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (Ipv4Address::GetAny (), port));
 }
 
 Ipv4EndPoint *
@@ -100,10 +98,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -123,10 +118,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address, uint16_t port)
       NS_LOG_WARN ("Duplicate address/port; failing.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -134,39 +126,77 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  FourTuple tuple = { localAddress, localPort, peerAddress, peerPort };
+  if (m_fourTuples.find (tuple) != m_fourTuples.end ())
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress) 
-        {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
-        }
+      NS_LOG_WARN ("No way we can allocate this end-point.");
+      /* no way we can allocate this end-point. */
+      return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
+  return Insert (endPoint);
+}
 
+Ipv4EndPoint *
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint64_t order = m_nextOrder++;
+  m_endPoints[order] = endPoint;
+  m_orders[endPoint] = order;
+  Index (endPoint);
+  endPoint->m_demux = this;
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
   return endPoint;
 }
 
+void
+Ipv4EndPointDemux::Index (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint64_t order = m_orders[endPoint];
+  FourTuple tuple = { endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                      endPoint->GetPeerAddress (), endPoint->GetPeerPort () };
+  m_ports[tuple.localPort][order] = endPoint;
+  m_fourTuples[tuple][order] = endPoint;
+}
+
+void
+Ipv4EndPointDemux::Unindex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint64_t order = m_orders[endPoint];
+  FourTuple tuple = { endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                      endPoint->GetPeerAddress (), endPoint->GetPeerPort () };
+  std::unordered_map<uint16_t, OrderedEndPoints>::iterator bucket = m_ports.find (tuple.localPort);
+  NS_ASSERT (bucket != m_ports.end ());
+  bucket->second.erase (order);
+  if (bucket->second.empty ())
+    {
+      m_ports.erase (bucket);
+    }
+  std::unordered_map<FourTuple, OrderedEndPoints, FourTupleHash>::iterator exact = m_fourTuples.find (tuple);
+  NS_ASSERT (exact != m_fourTuples.end ());
+  exact->second.erase (order);
+  if (exact->second.empty ())
+    {
+      m_fourTuples.erase (exact);
+    }
+}
+
 void 
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<Ipv4EndPoint *, uint64_t>::iterator i = m_orders.find (endPoint);
+  if (i != m_orders.end ())
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      Unindex (endPoint);
+      m_endPoints.erase (i->second);
+      m_orders.erase (i);
+      endPoint->m_demux = 0;
+      delete endPoint;
     }
 }
 
@@ -179,14 +209,40 @@ Ipv4EndPointDemux::GetAllEndPoints (void)
   NS_LOG_FUNCTION (this);
   EndPoints ret;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (OrderedEndPoints::iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
-      Ipv4EndPoint* endP = *i;
+      Ipv4EndPoint* endP = i->second;
       ret.push_back (endP);
     }
   return ret;
 }
 
+void
+Ipv4EndPointDemux::LookupFourTuple (Ipv4Address localAddress, uint16_t localPort,
+                                    Ipv4Address peerAddress, uint16_t peerPort,
+                                    Ptr<Ipv4Interface> incomingInterface, EndPoints &endPoints)
+{
+  NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort << incomingInterface);
+  FourTuple tuple = { localAddress, localPort, peerAddress, peerPort };
+  std::unordered_map<FourTuple, OrderedEndPoints, FourTupleHash>::const_iterator exact = m_fourTuples.find (tuple);
+  if (exact == m_fourTuples.end ())
+    {
+      return;
+    }
+  for (OrderedEndPoints::const_iterator i = exact->second.begin (); i != exact->second.end (); i++)
+    {
+      Ipv4EndPoint* endP = i->second;
+      if (!endP->IsRxEnabled ())
+        {
+          continue;
+        }
+      if (endP->GetBoundNetDevice () && endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
+        {
+          continue;
+        }
+      endPoints.push_back (endP);
+    }
+}
 
 /*
  * If we have an exact match, we return it.
@@ -206,9 +262,46 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
+  for (uint32_t i = 0; incomingInterface && i < incomingInterface->GetNAddresses (); i++)
     {
-      Ipv4EndPoint* endP = *i;
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+          daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+        {
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
+        }
+    }
+  bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+  NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
+
+  // Unless the packet is a broadcast or its source is a wildcard, every
+  // kind of match is an exact match of the four-tuple of the endpoint
+  // with the packet four-tuple, in which the local address, or the peer
+  // address and port, or both, are replaced by wildcards.
+  if (!isBroadcast && sport != 0 && saddr != Ipv4Address::GetAny ())
+    {
+      LookupFourTuple (daddr, dport, saddr, sport, incomingInterface, retval4);
+      if (!retval4.empty ()) return retval4;
+      LookupFourTuple (Ipv4Address::GetAny (), dport, saddr, sport, incomingInterface, retval3);
+      if (!retval3.empty ()) return retval3;
+      LookupFourTuple (daddr, dport, Ipv4Address::GetAny (), 0, incomingInterface, retval2);
+      if (!retval2.empty ()) return retval2;
+      LookupFourTuple (Ipv4Address::GetAny (), dport, Ipv4Address::GetAny (), 0, incomingInterface, retval1);
+      return retval1;  // might be empty if no matches
+    }
+
+  std::unordered_map<uint16_t, OrderedEndPoints>::const_iterator bucket = m_ports.find (dport);
+  if (bucket == m_ports.end ())
+    {
+      NS_LOG_LOGIC ("No endpoint with dport " << dport);
+      return retval1;
+    }
+  for (OrderedEndPoints::const_iterator i = bucket->second.begin (); i != bucket->second.end (); i++) 
+    {
+      Ipv4EndPoint* endP = i->second;
 
       NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
                                                  << " daddr=" << endP->GetLocalAddress ()
@@ -222,14 +315,6 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
           continue;
         }
 
-      if (endP->GetLocalPort () != dport) 
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
       if (endP->GetBoundNetDevice ())
         {
           if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
@@ -241,20 +326,6 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
               continue;
             }
         }
-      bool subnetDirected = false;
-      Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
-      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
-        {
-          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
-              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
-            {
-              subnetDirected = true;
-              incomingInterfaceAddr = addr.GetLocal ();
-            }
-        }
-      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
-      NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
       bool localAddressMatchesWildCard = 
         endP->GetLocalAddress () == Ipv4Address::GetAny ();
       bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
@@ -330,31 +401,33 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
   // function.
   uint32_t genericity = 3;
   Ipv4EndPoint *generic = 0;
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<uint16_t, OrderedEndPoints>::const_iterator bucket = m_ports.find (dport);
+  if (bucket == m_ports.end ())
     {
-      if ((*i)->GetLocalPort () != dport) 
-        {
-          continue;
-        }
-      if ((*i)->GetLocalAddress () == daddr &&
-          (*i)->GetPeerPort () == sport &&
-          (*i)->GetPeerAddress () == saddr) 
+      return 0;
+    }
+  for (OrderedEndPoints::const_iterator i = bucket->second.begin (); i != bucket->second.end (); i++) 
+    {
+      Ipv4EndPoint *endP = i->second;
+      if (endP->GetLocalAddress () == daddr &&
+          endP->GetPeerPort () == sport &&
+          endP->GetPeerAddress () == saddr) 
         {
           /* this is an exact match. */
-          return *i;
+          return endP;
         }
       uint32_t tmp = 0;
-      if ((*i)->GetLocalAddress () == Ipv4Address::GetAny ()) 
+      if (endP->GetLocalAddress () == Ipv4Address::GetAny ()) 
         {
           tmp++;
         }
-      if ((*i)->GetPeerAddress () == Ipv4Address::GetAny ()) 
+      if (endP->GetPeerAddress () == Ipv4Address::GetAny ()) 
         {
           tmp++;
         }
       if (tmp < genericity) 
         {
-          generic = (*i);
+          generic = endP;
           genericity = tmp;
         }
     }
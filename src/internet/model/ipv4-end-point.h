@@ -32,6 +32,7 @@ namespace ns3 {
 
 class Header;
 class Packet;
+class Ipv4EndPointDemux;
 
 /**
  * \ingroup ipv4
@@ -44,6 +45,9 @@ class Packet;
  * layers that a packet from a lower layer was received.  In the ns3
  * internet-stack, these notifications are automatically registered to be
  * received by the corresponding socket.
+ *
+ * The demux which allocated an endpoint indexes it by its four-tuple, and
+ * is notified when the four-tuple changes.
  */
 
 class Ipv4EndPoint {
@@ -183,6 +187,13 @@ public:
   bool IsRxEnabled (void);
 
 private:
+  friend class Ipv4EndPointDemux;
+
+  /**
+   * \brief The demux which indexes the endpoint (if any).
+   */
+  Ipv4EndPointDemux *m_demux;
+
   /**
    * \brief The local address.
    */
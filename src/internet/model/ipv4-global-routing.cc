@@ -29,6 +29,7 @@
 #include "ns3/boolean.h"
 #include "ns3/node.h"
 #include "ipv4-global-routing.h"
+#include "ipv4-l3-protocol.h"
 #include "global-route-manager.h"
 
 namespace ns3 {
@@ -80,6 +81,8 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  m_hostTrie.Insert (route);
+  InvalidateForwardingCache ();
 }
 
 void 
@@ -90,6 +93,8 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  m_hostTrie.Insert (route);
+  InvalidateForwardingCache ();
 }
 
 void 
@@ -105,6 +110,8 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_networkTrie.Insert (route);
+  InvalidateForwardingCache ();
 }
 
 void 
@@ -118,6 +125,8 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_networkTrie.Insert (route);
+  InvalidateForwardingCache ();
 }
 
 void 
@@ -133,6 +142,8 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  m_ASexternalTrie.Insert (route);
+  InvalidateForwardingCache ();
 }
 
 
@@ -146,72 +157,65 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
 
+  // the routes matching the destination, in the order of their list
+  std::vector<Ipv4RouteTrie::Route> matches;
+
   NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
+  m_hostTrie.Lookup (dest, matches);
+  for (std::vector<Ipv4RouteTrie::Route>::const_iterator i = matches.begin (); 
+       i != matches.end (); 
        i++) 
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest ().IsEqual (dest)) 
+      NS_ASSERT (i->entry->IsHost ());
+      if (oif != 0)
         {
-          if (oif != 0)
+          if (oif != m_ipv4->GetNetDevice (i->entry->GetInterface ()))
             {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
-                {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
-                  continue;
-                }
+              NS_LOG_LOGIC ("Not on requested interface, skipping");
+              continue;
             }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
         }
+      allRoutes.push_back (i->entry);
+      NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << i->entry); 
     }
   if (allRoutes.size () == 0) // if no host route is found
     {
       NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
+      m_networkTrie.Lookup (dest, matches);
+      for (std::vector<Ipv4RouteTrie::Route>::const_iterator j = matches.begin (); 
+           j != matches.end (); 
            j++) 
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
+          if (oif != 0)
             {
-              if (oif != 0)
+              if (oif != m_ipv4->GetNetDevice (j->entry->GetInterface ()))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
+                  NS_LOG_LOGIC ("Not on requested interface, skipping");
+                  continue;
                 }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
             }
+          allRoutes.push_back (j->entry);
+          NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << j->entry);
         }
     }
   if (allRoutes.size () == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
+      m_ASexternalTrie.Lookup (dest, matches);
+      for (std::vector<Ipv4RouteTrie::Route>::const_iterator k = matches.begin ();
+           k != matches.end ();
            k++)
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
+          NS_LOG_LOGIC ("Found external route" << k->entry);
+          if (oif != 0)
             {
-              NS_LOG_LOGIC ("Found external route" << *k);
-              if (oif != 0)
+              if (oif != m_ipv4->GetNetDevice (k->entry->GetInterface ()))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
+                  NS_LOG_LOGIC ("Not on requested interface, skipping");
+                  continue;
                 }
-              allRoutes.push_back (*k);
-              break;
             }
+          allRoutes.push_back (k->entry);
+          break;
         }
     }
   if (allRoutes.size () > 0 ) // if route(s) is found
@@ -319,8 +323,10 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           if (tmp  == index)
             {
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
+              m_hostTrie.Remove (*i);
               delete *i;
               m_hostRoutes.erase (i);
+              InvalidateForwardingCache ();
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
               return;
             }
@@ -336,8 +342,10 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
+          m_networkTrie.Remove (*j);
           delete *j;
           m_networkRoutes.erase (j);
+          InvalidateForwardingCache ();
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
           return;
         }
@@ -352,8 +360,10 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
+          m_ASexternalTrie.Remove (*k);
           delete *k;
           m_ASexternalRoutes.erase (k);
+          InvalidateForwardingCache ();
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
           return;
         }
@@ -362,6 +372,17 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
   NS_ASSERT (false);
 }
 
+void
+Ipv4GlobalRouting::InvalidateForwardingCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<Ipv4L3Protocol> ipv4 = DynamicCast<Ipv4L3Protocol> (m_ipv4);
+  if (ipv4 != 0)
+    {
+      ipv4->InvalidateForwardingCache ();
+    }
+}
+
 int64_t
 Ipv4GlobalRouting::AssignStreams (int64_t stream)
 {
@@ -392,6 +413,9 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostTrie.Clear ();
+  m_networkTrie.Clear ();
+  m_ASexternalTrie.Clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
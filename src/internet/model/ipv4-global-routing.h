@@ -28,6 +28,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/ipv4-route-trie.h"
 
 namespace ns3 {
 
@@ -63,7 +64,9 @@ class Node;
  * and rebuilt in the middle of the simulation, while manually entered
  * routes into the Ipv4StaticRouting may need to be kept distinct.
  *
- * This class deals with Ipv4 unicast routes only.
+ * This class deals with Ipv4 unicast routes only. The routes are indexed
+ * by destination prefix (see Ipv4RouteTrie), so that looking up a route
+ * does not depend on the number of routes of the node.
  *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
@@ -268,9 +271,18 @@ private:
    */
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
+  /**
+   * \brief Invalidate the forwarding cache of the node after a change
+   * of the routes.
+   */
+  void InvalidateForwardingCache (void);
+
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
+  Ipv4RouteTrie m_hostTrie;            //!< Index of the routes to hosts
+  Ipv4RouteTrie m_networkTrie;         //!< Index of the routes to networks
+  Ipv4RouteTrie m_ASexternalTrie;      //!< Index of the external routes
 
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
@@ -21,6 +21,7 @@
 #include "ns3/packet.h"
 #include "ns3/log.h"
 #include "ns3/callback.h"
+#include "ns3/abort.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/node.h"
@@ -41,6 +42,7 @@
 #include "icmpv4-l4-protocol.h"
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
+#include "super-segment-tag.h"
 
 namespace ns3 {
 
@@ -69,6 +71,17 @@ Ipv4L3Protocol::GetTypeId (void)
                    TimeValue (Seconds (30)),
                    MakeTimeAccessor (&Ipv4L3Protocol::m_fragmentExpirationTimeout),
                    MakeTimeChecker ())
+    .AddAttribute ("ForwardingCache",
+                   "Cache the route of the forwarded packets by input interface "
+                   "and destination, and bypass the routing protocol for the next "
+                   "packets. The cache is invalidated by any change of the "
+                   "interfaces and of the Ipv4StaticRouting and Ipv4GlobalRouting "
+                   "routes: it must not be enabled with routing protocols whose "
+                   "routes change otherwise, or vary from packet to packet "
+                   "(e.g., Ipv4GlobalRouting::RandomEcmpRouting).",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4L3Protocol::m_forwardingCache),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Tx",
                      "Send ipv4 packet to outgoing interface.",
                      MakeTraceSourceAccessor (&Ipv4L3Protocol::m_txTrace),
@@ -108,8 +121,14 @@ Ipv4L3Protocol::GetTypeId (void)
 }
 
 Ipv4L3Protocol::Ipv4L3Protocol()
+  : m_forwardingCache (false),
+    m_forwardingCacheIif (-1)
 {
   NS_LOG_FUNCTION (this);
+  m_ucb = MakeCallback (&Ipv4L3Protocol::IpForward, this);
+  m_mcb = MakeCallback (&Ipv4L3Protocol::IpMulticastForward, this);
+  m_lcb = MakeCallback (&Ipv4L3Protocol::LocalDeliver, this);
+  m_ecb = MakeCallback (&Ipv4L3Protocol::RouteInputError, this);
 }
 
 Ipv4L3Protocol::~Ipv4L3Protocol ()
@@ -212,6 +231,13 @@ Ipv4L3Protocol::GetProtocol (int protocolNumber, int32_t interfaceIndex) const
   return 0;
 }
 
+void
+Ipv4L3Protocol::SetSegmentCallback (uint8_t protocolNumber, SegmentCallback cb)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (protocolNumber));
+  m_segmentCallbacks[protocolNumber] = cb;
+}
+
 void
 Ipv4L3Protocol::SetNode (Ptr<Node> node)
 {
@@ -271,6 +297,19 @@ Ipv4L3Protocol::SetRoutingProtocol (Ptr<Ipv4RoutingProtocol> routingProtocol)
   NS_LOG_FUNCTION (this << routingProtocol);
   m_routingProtocol = routingProtocol;
   m_routingProtocol->SetIpv4 (this);
+  InvalidateForwardingCache ();
+}
+
+void
+Ipv4L3Protocol::InvalidateForwardingCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the maps are emptied rather than dropped, to keep their buckets
+  for (std::vector<ForwardingCache>::iterator it = m_forwardingCacheEntries.begin ();
+       it != m_forwardingCacheEntries.end (); ++it)
+    {
+      it->clear ();
+    }
 }
 
 
@@ -290,6 +329,7 @@ Ipv4L3Protocol::DoDispose (void)
       i->second = 0;
     }
   m_protocols.clear ();
+  m_segmentCallbacks.clear ();
 
   for (Ipv4InterfaceList::iterator i = m_interfaces.begin (); i != m_interfaces.end (); ++i)
     {
@@ -299,6 +339,7 @@ Ipv4L3Protocol::DoDispose (void)
   m_reverseInterfacesContainer.clear ();
 
   m_sockets.clear ();
+  m_forwardingCacheEntries.clear ();
   m_node = 0;
   m_routingProtocol = 0;
 
@@ -399,6 +440,7 @@ Ipv4L3Protocol::AddIpv4Interface (Ptr<Ipv4Interface>interface)
   uint32_t index = m_interfaces.size ();
   m_interfaces.push_back (interface);
   m_reverseInterfacesContainer[interface->GetDevice ()] = index;
+  InvalidateForwardingCache ();
   return index;
 }
 
@@ -630,19 +672,46 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
       socket->ForwardUp (packet, ipHeader, ipv4Interface);
     }
 
+  if (m_forwardingCache)
+    {
+      // a cached destination is neither local nor multicast
+      Ptr<Ipv4Route> route = LookupForwardingCache (interface, ipHeader.GetDestination ());
+      if (route != 0)
+        {
+          NS_LOG_LOGIC ("Forwarding cache hit for " << ipHeader.GetDestination ());
+          IpForward (route, packet, ipHeader);
+          return;
+        }
+      // the routes passed back synchronously by the routing protocol are cached
+      m_forwardingCacheIif = interface;
+    }
+
   NS_ASSERT_MSG (m_routingProtocol != 0, "Need a routing protocol object to process packets");
-  if (!m_routingProtocol->RouteInput (packet, ipHeader, device,
-                                      MakeCallback (&Ipv4L3Protocol::IpForward, this),
-                                      MakeCallback (&Ipv4L3Protocol::IpMulticastForward, this),
-                                      MakeCallback (&Ipv4L3Protocol::LocalDeliver, this),
-                                      MakeCallback (&Ipv4L3Protocol::RouteInputError, this)
-                                      ))
+  bool found = m_routingProtocol->RouteInput (packet, ipHeader, device, m_ucb, m_mcb, m_lcb, m_ecb);
+  m_forwardingCacheIif = -1;
+  if (!found)
     {
       NS_LOG_WARN ("No route found for forwarding packet.  Drop.");
       m_dropTrace (ipHeader, packet, DROP_NO_ROUTE, m_node->GetObject<Ipv4> (), interface);
     }
 }
 
+Ptr<Ipv4Route>
+Ipv4L3Protocol::LookupForwardingCache (uint32_t iif, Ipv4Address destination) const
+{
+  NS_LOG_FUNCTION (this << iif << destination);
+  if (iif >= m_forwardingCacheEntries.size ())
+    {
+      return 0;
+    }
+  ForwardingCache::const_iterator it = m_forwardingCacheEntries[iif].find (destination);
+  if (it == m_forwardingCacheEntries[iif].end ())
+    {
+      return 0;
+    }
+  return it->second;
+}
+
 Ptr<Icmpv4L4Protocol> 
 Ipv4L3Protocol::GetIcmp (void) const
 {
@@ -925,6 +994,33 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   Ptr<Ipv4Interface> outInterface = GetInterface (interface);
   NS_LOG_LOGIC ("Send via NetDevice ifIndex " << outDev->GetIfIndex () << " ipv4InterfaceIndex " << interface);
 
+  // A super-segment is split by its transport protocol into the segments
+  // it carries before it reaches the queue discs and the device, which see
+  // the same packets as without super-segments
+  SuperSegmentTag superSegmentTag;
+  if (packet->PeekPacketTag (superSegmentTag))
+    {
+      std::map<uint8_t, SegmentCallback>::const_iterator cb = m_segmentCallbacks.find (ipHeader.GetProtocol ());
+      NS_ABORT_MSG_IF (cb == m_segmentCallbacks.end (),
+                       "No segmentation callback for protocol " << static_cast<uint32_t> (ipHeader.GetProtocol ()));
+      std::list<Ptr<Packet> > segments = cb->second (packet, ipHeader.GetSource (), ipHeader.GetDestination ());
+      NS_LOG_LOGIC ("Split a super-segment into " << segments.size () << " segments");
+      Ipv4Header segmentHeader = ipHeader;
+      for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); ++it)
+        {
+          if (it != segments.begin ())
+            {
+              segmentHeader = BuildHeader (ipHeader.GetSource (), ipHeader.GetDestination (),
+                                           ipHeader.GetProtocol (), (*it)->GetSize (),
+                                           ipHeader.GetTtl (), ipHeader.GetTos (),
+                                           !ipHeader.IsDontFragment ());
+            }
+          segmentHeader.SetPayloadSize ((*it)->GetSize ());
+          SendRealOut (route, *it, segmentHeader);
+        }
+      return;
+    }
+
   if (!route->GetGateway ().IsEqual (Ipv4Address ("0.0.0.0")))
     {
       if (outInterface->IsUp ())
@@ -1023,6 +1119,15 @@ Ipv4L3Protocol::IpForward (Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ip
 {
   NS_LOG_FUNCTION (this << rtentry << p << header);
   NS_LOG_LOGIC ("Forwarding logic for node: " << m_node->GetId ());
+  if (m_forwardingCacheIif >= 0)
+    {
+      uint32_t iif = m_forwardingCacheIif;
+      if (iif >= m_forwardingCacheEntries.size ())
+        {
+          m_forwardingCacheEntries.resize (iif + 1);
+        }
+      m_forwardingCacheEntries[iif][header.GetDestination ()] = rtentry;
+    }
   // Forwarding
   Ipv4Header ipHeader = header;
   Ptr<Packet> packet = p->Copy ();
@@ -1130,6 +1235,7 @@ Ipv4L3Protocol::AddAddress (uint32_t i, Ipv4InterfaceAddress address)
     {
       m_routingProtocol->NotifyAddAddress (i, address);
     }
+  InvalidateForwardingCache ();
   return retVal;
 }
 
@@ -1161,6 +1267,7 @@ Ipv4L3Protocol::RemoveAddress (uint32_t i, uint32_t addressIndex)
         {
           m_routingProtocol->NotifyRemoveAddress (i, address);
         }
+      InvalidateForwardingCache ();
       return true;
     }
   return false;
@@ -1184,6 +1291,7 @@ Ipv4L3Protocol::RemoveAddress (uint32_t i, Ipv4Address address)
         {
           m_routingProtocol->NotifyRemoveAddress (i, ifAddr);
         }
+      InvalidateForwardingCache ();
       return true;
     }
   return false;
@@ -1319,6 +1427,7 @@ Ipv4L3Protocol::SetUp (uint32_t i)
         {
           m_routingProtocol->NotifyInterfaceUp (i);
         }
+      InvalidateForwardingCache ();
     }
   else
     {
@@ -1337,6 +1446,7 @@ Ipv4L3Protocol::SetDown (uint32_t ifaceIndex)
     {
       m_routingProtocol->NotifyInterfaceDown (ifaceIndex);
     }
+  InvalidateForwardingCache ();
 }
 
 bool 
@@ -1354,6 +1464,7 @@ Ipv4L3Protocol::SetForwarding (uint32_t i, bool val)
   NS_LOG_FUNCTION (this << i);
   Ptr<Ipv4Interface> interface = GetInterface (i);
   interface->SetForwarding (val);
+  InvalidateForwardingCache ();
 }
 
 Ptr<NetDevice>
@@ -1372,6 +1483,7 @@ Ipv4L3Protocol::SetIpForward (bool forward)
     {
       (*i)->SetForwarding (forward);
     }
+  InvalidateForwardingCache ();
 }
 
 bool 
@@ -1386,6 +1498,7 @@ Ipv4L3Protocol::SetWeakEsModel (bool model)
 {
   NS_LOG_FUNCTION (this << model);
   m_weakEsModel = model;
+  InvalidateForwardingCache ();
 }
 
 bool 
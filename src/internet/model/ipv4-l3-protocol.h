@@ -26,6 +26,7 @@
 #include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "ns3/ptr.h"
 #include "ns3/net-device.h"
 #include "ns3/ipv4.h"
@@ -128,6 +129,27 @@ public:
   virtual Ptr<IpL4Protocol> GetProtocol (int protocolNumber) const;
   virtual Ptr<IpL4Protocol> GetProtocol (int protocolNumber, int32_t interfaceIndex) const;
 
+  /**
+   * \brief Callback splitting a packet that carries several segments of a
+   * transport protocol into these segments (see SuperSegmentTag)
+   *
+   * The arguments are the packet, starting with its transport header, and
+   * its source and destination addresses. The segments, each starting with
+   * its own transport header, are returned in sequence order.
+   */
+  typedef Callback<std::list<Ptr<Packet> >, Ptr<const Packet>, const Address &, const Address &> SegmentCallback;
+
+  /**
+   * \brief Register the segmentation callback of a transport protocol
+   *
+   * The packets of this protocol that carry a SuperSegmentTag are split
+   * by the callback before they reach the queue discs and the device.
+   *
+   * \param protocolNumber the transport protocol number
+   * \param cb the segmentation callback
+   */
+  void SetSegmentCallback (uint8_t protocolNumber, SegmentCallback cb);
+
   virtual Ipv4Address SourceAddressSelection (uint32_t interface, Ipv4Address dest);
 
   /**
@@ -222,6 +244,16 @@ public:
    */
   bool IsUnicast (Ipv4Address ad) const;
 
+  /**
+   * \brief Invalidate the routes in the forwarding cache.
+   *
+   * The routing protocols must call this function whenever they change
+   * their routes, for the forwarding cache (ForwardingCache attribute) not
+   * to use outdated routes. The changes of the interfaces invalidate the
+   * forwarding cache by themselves.
+   */
+  void InvalidateForwardingCache (void);
+
   /**
    * TracedCallback signature for packet send, forward, or local deliver events.
    *
@@ -362,6 +394,14 @@ private:
    */
   void RouteInputError (Ptr<const Packet> p, const Ipv4Header & ipHeader, Socket::SocketErrno sockErrno);
 
+  /**
+   * \brief Look up the forwarding cache.
+   * \param iif input interface
+   * \param destination destination address
+   * \return the cached route, or 0 if none
+   */
+  Ptr<Ipv4Route> LookupForwardingCache (uint32_t iif, Ipv4Address destination) const;
+
   /**
    * \brief Add an IPv4 interface to the stack.
    * \param interface interface to add
@@ -454,15 +494,30 @@ private:
    */
   typedef std::map<L4ListKey_t, Ptr<IpL4Protocol> > L4List_t;
 
+  /**
+   * \brief Cached routes of an interface, by destination.
+   */
+  typedef sgi::hash_map<Ipv4Address, Ptr<Ipv4Route>, Ipv4AddressHash> ForwardingCache;
+
   bool m_ipForward;      //!< Forwarding packets (i.e. router mode) state.
   bool m_weakEsModel;    //!< Weak ES model state
   L4List_t m_protocols;  //!< List of transport protocol.
+  std::map<uint8_t, SegmentCallback> m_segmentCallbacks; //!< Segmentation callbacks, by transport protocol number.
   Ipv4InterfaceList m_interfaces; //!< List of IPv4 interfaces.
   Ipv4InterfaceReverseContainer m_reverseInterfacesContainer; //!< Container of NetDevice / Interface index associations.
   uint8_t m_defaultTtl;  //!< Default TTL
   std::map<std::pair<uint64_t, uint8_t>, uint16_t> m_identification; //!< Identification (for each {src, dst, proto} tuple)
   Ptr<Node> m_node; //!< Node attached to stack.
 
+  bool m_forwardingCache; //!< Whether the routes of the forwarded packets are cached
+  int32_t m_forwardingCacheIif; //!< Input interface of the route being looked up, or -1
+  std::vector<ForwardingCache> m_forwardingCacheEntries; //!< Cached routes, by input interface
+
+  Ipv4RoutingProtocol::UnicastForwardCallback m_ucb; //!< Unicast forward callback passed to the routing protocol
+  Ipv4RoutingProtocol::MulticastForwardCallback m_mcb; //!< Multicast forward callback passed to the routing protocol
+  Ipv4RoutingProtocol::LocalDeliverCallback m_lcb; //!< Local delivery callback passed to the routing protocol
+  Ipv4RoutingProtocol::ErrorCallback m_ecb; //!< Error callback passed to the routing protocol
+
   /// Trace of sent packets
   TracedCallback<const Ipv4Header &, Ptr<const Packet>, uint32_t> m_sendOutgoingTrace;
   /// Trace of unicast forwarded packets
@@ -0,0 +1,234 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ipv4-route-trie.h"
+#include "ipv4-routing-table-entry.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4RouteTrie");
+
+/**
+ * \param a a route
+ * \param b another route
+ * \return true if the first route was inserted before the other one
+ */
+static bool
+IsInsertedBefore (const Ipv4RouteTrie::Route &a, const Ipv4RouteTrie::Route &b)
+{
+  return a.order < b.order;
+}
+
+Ipv4RouteTrie::Ipv4RouteTrie ()
+  : m_root (0),
+    m_order (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ipv4RouteTrie::~Ipv4RouteTrie ()
+{
+  NS_LOG_FUNCTION (this);
+  Delete (m_root);
+}
+
+uint32_t
+Ipv4RouteTrie::GetMask (uint8_t length)
+{
+  return length == 0 ? 0 : 0xffffffff << (32 - length);
+}
+
+uint32_t
+Ipv4RouteTrie::GetBit (uint32_t address, uint8_t index)
+{
+  NS_ASSERT (index < 32);
+  return (address >> (31 - index)) & 1;
+}
+
+uint8_t
+Ipv4RouteTrie::GetLeadingOnes (uint32_t mask)
+{
+  uint8_t length = 0;
+  while (length < 32 && GetBit (mask, length))
+    {
+      length++;
+    }
+  return length;
+}
+
+void
+Ipv4RouteTrie::Insert (Ipv4RoutingTableEntry *entry, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << entry << metric);
+  Item item;
+  item.route.entry = entry;
+  item.route.metric = metric;
+  item.route.order = m_order++;
+  item.mask = entry->GetDestNetworkMask ().Get ();
+  item.network = entry->GetDestNetwork ().Get () & item.mask;
+  uint8_t length = GetLeadingOnes (item.mask);
+  uint32_t prefix = item.network & GetMask (length);
+
+  // Walk down the trie until the node of the prefix is found or a node
+  // must be inserted above the current one.
+  Node **link = &m_root;
+  while (true)
+    {
+      Node *node = *link;
+      if (node == 0)
+        {
+          node = new Node;
+          node->prefix = prefix;
+          node->length = length;
+          node->child[0] = 0;
+          node->child[1] = 0;
+          node->items.push_back (item);
+          *link = node;
+          return;
+        }
+      uint8_t common = std::min (node->length, length);
+      while (common > 0 && (node->prefix & GetMask (common)) != (prefix & GetMask (common)))
+        {
+          common--;
+        }
+      if (common < node->length)
+        {
+          // The prefix of the route and the one of the node diverge (or
+          // the former is a prefix of the latter): the node moves below
+          // a new node for their common prefix.
+          Node *parent = new Node;
+          parent->prefix = prefix & GetMask (common);
+          parent->length = common;
+          parent->child[0] = 0;
+          parent->child[1] = 0;
+          parent->child[GetBit (node->prefix, common)] = node;
+          *link = parent;
+          if (common == length)
+            {
+              parent->items.push_back (item);
+              return;
+            }
+          link = &parent->child[GetBit (prefix, common)];
+          continue;
+        }
+      if (node->length == length)
+        {
+          node->items.push_back (item);
+          return;
+        }
+      link = &node->child[GetBit (prefix, node->length)];
+    }
+}
+
+void
+Ipv4RouteTrie::Remove (Ipv4RoutingTableEntry *entry)
+{
+  NS_LOG_FUNCTION (this << entry);
+  uint32_t mask = entry->GetDestNetworkMask ().Get ();
+  uint8_t length = GetLeadingOnes (mask);
+  uint32_t prefix = entry->GetDestNetwork ().Get () & GetMask (length);
+  m_root = Remove (m_root, prefix, length, entry);
+}
+
+Ipv4RouteTrie::Node *
+Ipv4RouteTrie::Remove (Node *node, uint32_t prefix, uint8_t length, Ipv4RoutingTableEntry *entry)
+{
+  NS_ASSERT_MSG (node != 0 && node->length <= length
+                 && (prefix & GetMask (node->length)) == node->prefix,
+                 "Route not found");
+  if (node->length < length)
+    {
+      Node **link = &node->child[GetBit (prefix, node->length)];
+      *link = Remove (*link, prefix, length, entry);
+    }
+  else
+    {
+      std::vector<Item>::iterator it = node->items.begin ();
+      while (it != node->items.end () && it->route.entry != entry)
+        {
+          it++;
+        }
+      NS_ASSERT_MSG (it != node->items.end (), "Route not found");
+      node->items.erase (it);
+    }
+  if (!node->items.empty () || (node->child[0] != 0 && node->child[1] != 0))
+    {
+      return node;
+    }
+  // A node without routes is only kept to separate two subtries.
+  Node *child = node->child[0] != 0 ? node->child[0] : node->child[1];
+  delete node;
+  return child;
+}
+
+void
+Ipv4RouteTrie::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  Delete (m_root);
+  m_root = 0;
+}
+
+void
+Ipv4RouteTrie::Delete (Node *node)
+{
+  if (node != 0)
+    {
+      Delete (node->child[0]);
+      Delete (node->child[1]);
+      delete node;
+    }
+}
+
+void
+Ipv4RouteTrie::Lookup (Ipv4Address dest, std::vector<Route> &routes) const
+{
+  NS_LOG_FUNCTION (this << dest);
+  routes.clear ();
+  uint32_t address = dest.Get ();
+  uint32_t nodes = 0;
+  const Node *node = m_root;
+  while (node != 0 && (address & GetMask (node->length)) == node->prefix)
+    {
+      for (std::vector<Item>::const_iterator it = node->items.begin (); it != node->items.end (); it++)
+        {
+          if ((address & it->mask) == it->network)
+            {
+              routes.push_back (it->route);
+            }
+        }
+      if (!node->items.empty ())
+        {
+          nodes++;
+        }
+      if (node->length == 32)
+        {
+          break;
+        }
+      node = node->child[GetBit (address, node->length)];
+    }
+  // The routes of every node are in insertion order; only the routes of
+  // distinct prefixes must be merged.
+  if (nodes > 1)
+    {
+      std::sort (routes.begin (), routes.end (), &IsInsertedBefore);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_ROUTE_TRIE_H
+#define IPV4_ROUTE_TRIE_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+class Ipv4RoutingTableEntry;
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief A path-compressed binary trie (Patricia trie) indexing unicast
+ * routing table entries by destination prefix.
+ *
+ * The routing protocols keep their routes in lists, whose order is
+ * visible through GetRoute () and breaks the ties between equivalent
+ * routes. The trie does not own the entries: it is an index over such a
+ * list, which finds the routes matching a destination in a time that
+ * depends on the prefix length and not on the size of the table.
+ *
+ * Lookup () returns every route whose destination network matches the
+ * address, whatever its prefix length, in the order in which the routes
+ * were inserted (i.e., in the order of the list they index). The caller
+ * then applies its own selection rule (longest prefix, metric, ECMP) to
+ * these few routes exactly as it did when it scanned the whole list.
+ *
+ * A route is stored in the node of the prefix made of the leading ones of
+ * its network mask; a route with a non-contiguous mask is checked against
+ * its whole mask during the lookup.
+ */
+class Ipv4RouteTrie
+{
+public:
+  /**
+   * A route matching a destination.
+   */
+  struct Route
+  {
+    Ipv4RoutingTableEntry *entry; //!< the routing table entry
+    uint32_t metric;              //!< the metric given at insertion
+    uint64_t order;               //!< the insertion order of the route
+  };
+
+  Ipv4RouteTrie ();
+  ~Ipv4RouteTrie ();
+
+  /**
+   * Index a route by its destination network and network mask. Routes
+   * must be inserted in the order of the list they index.
+   *
+   * \param entry the routing table entry, which must outlive its insertion
+   * \param metric the metric of the route
+   */
+  void Insert (Ipv4RoutingTableEntry *entry, uint32_t metric = 0);
+  /**
+   * Remove a route from the index. The destination network and network
+   * mask of the entry must not have changed since its insertion.
+   *
+   * \param entry the routing table entry
+   */
+  void Remove (Ipv4RoutingTableEntry *entry);
+  /**
+   * Remove all the routes from the index.
+   */
+  void Clear (void);
+  /**
+   * \param dest the destination address
+   * \param routes filled with the routes whose destination network
+   *        matches the address, in insertion order
+   */
+  void Lookup (Ipv4Address dest, std::vector<Route> &routes) const;
+
+private:
+  /// Copy constructor, disabled
+  Ipv4RouteTrie (const Ipv4RouteTrie &);
+  /**
+   * Assignment operator, disabled
+   * \returns this object
+   */
+  Ipv4RouteTrie &operator = (const Ipv4RouteTrie &);
+
+  /**
+   * A route stored in a node.
+   */
+  struct Item
+  {
+    Route route;      //!< the route
+    uint32_t network; //!< the destination network of the route, masked
+    uint32_t mask;    //!< the network mask of the route
+  };
+
+  /**
+   * A node of the trie, i.e., a prefix with routes or with two children.
+   */
+  struct Node
+  {
+    uint32_t prefix;          //!< the prefix, with the bits past its length cleared
+    uint8_t length;           //!< the prefix length
+    Node *child[2];           //!< the subtries, by the bit following the prefix
+    std::vector<Item> items;  //!< the routes of this prefix, in insertion order
+  };
+
+  /**
+   * \param length a prefix length
+   * \return the network mask made of length leading ones
+   */
+  static uint32_t GetMask (uint8_t length);
+  /**
+   * \param address an address or prefix
+   * \param index the index of a bit, from the most significant one
+   * \return the value of the bit
+   */
+  static uint32_t GetBit (uint32_t address, uint8_t index);
+  /**
+   * \param mask a network mask
+   * \return the number of leading ones of the mask
+   */
+  static uint8_t GetLeadingOnes (uint32_t mask);
+  /**
+   * Remove a route from a subtrie and compress the path to its node.
+   *
+   * \param node the root of the subtrie
+   * \param prefix the prefix of the route
+   * \param length the prefix length of the route
+   * \param entry the entry of the route
+   * \return the new root of the subtrie
+   */
+  static Node *Remove (Node *node, uint32_t prefix, uint8_t length, Ipv4RoutingTableEntry *entry);
+  /**
+   * Delete a subtrie.
+   *
+   * \param node the root of the subtrie
+   */
+  static void Delete (Node *node);
+
+  Node *m_root;     //!< the root of the trie
+  uint64_t m_order; //!< the insertion order of the next route
+};
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTE_TRIE_H */
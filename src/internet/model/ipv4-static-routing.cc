@@ -32,6 +32,7 @@
 #include "ns3/ipv4-route.h"
 #include "ns3/output-stream-wrapper.h"
 #include "ipv4-static-routing.h"
+#include "ipv4-l3-protocol.h"
 #include "ipv4-routing-table-entry.h"
 
 using std::make_pair;
@@ -73,6 +74,8 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (make_pair (route,metric));
+  m_networkTrie.Insert (route, metric);
+  InvalidateForwardingCache ();
 }
 
 void 
@@ -87,6 +90,8 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (make_pair (route,metric));
+  m_networkTrie.Insert (route, metric);
+  InvalidateForwardingCache ();
 }
 
 void 
@@ -144,6 +149,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
                                                         networkMask,
                                                         outputInterface);
   m_networkRoutes.push_back (make_pair (route,0));
+  m_networkTrie.Insert (route, 0);
 }
 
 uint32_t 
@@ -240,12 +246,15 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 
 
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
+  // the routes matching the destination, in the order of m_networkRoutes
+  std::vector<Ipv4RouteTrie::Route> matches;
+  m_networkTrie.Lookup (dest, matches);
+  for (std::vector<Ipv4RouteTrie::Route>::const_iterator i = matches.begin (); 
+       i != matches.end (); 
        i++) 
     {
-      Ipv4RoutingTableEntry *j=i->first;
-      uint32_t metric =i->second;
+      Ipv4RoutingTableEntry *j=i->entry;
+      uint32_t metric =i->metric;
       Ipv4Mask mask = (j)->GetDestNetworkMask ();
       uint16_t masklen = mask.GetPrefixLength ();
       Ipv4Address entry = (j)->GetDestNetwork ();
@@ -447,8 +456,10 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
+          m_networkTrie.Remove (j->first);
           delete j->first;
           m_networkRoutes.erase (j);
+          InvalidateForwardingCache ();
           return;
         }
       tmp++;
@@ -575,6 +586,7 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (j->first);
     }
+  m_networkTrie.Clear ();
   for (MulticastRoutesI i = m_multicastRoutes.begin (); 
        i != m_multicastRoutes.end (); 
        i = m_multicastRoutes.erase (i)) 
@@ -613,6 +625,7 @@ Ipv4StaticRouting::NotifyInterfaceDown (uint32_t i)
     {
       if (it->first->GetInterface () == i)
         {
+          m_networkTrie.Remove (it->first);
           delete it->first;
           it = m_networkRoutes.erase (it);
         }
@@ -660,6 +673,7 @@ Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkMask () == networkMask)
         {
+          m_networkTrie.Remove (it->first);
           delete it->first;
           it = m_networkRoutes.erase (it);
         }
@@ -670,6 +684,17 @@ Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
     }
 }
 
+void
+Ipv4StaticRouting::InvalidateForwardingCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<Ipv4L3Protocol> ipv4 = DynamicCast<Ipv4L3Protocol> (m_ipv4);
+  if (ipv4 != 0)
+    {
+      ipv4->InvalidateForwardingCache ();
+    }
+}
+
 void 
 Ipv4StaticRouting::SetIpv4 (Ptr<Ipv4> ipv4)
 {
@@ -31,6 +31,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-route-trie.h"
 
 namespace ns3 {
 
@@ -58,6 +59,10 @@ class Node;
  * Ipv4RoutingProtocol that defines the interface methods that a routing 
  * protocol must support.
  *
+ * The unicast routes are indexed by destination prefix (see
+ * Ipv4RouteTrie), so that looking up a route does not depend on the
+ * number of routes of the node.
+ *
  * \see Ipv4RoutingProtocol
  * \see Ipv4ListRouting
  * \see Ipv4ListRouting::AddRoutingProtocol
@@ -413,11 +418,22 @@ private:
   Ptr<Ipv4MulticastRoute> LookupStatic (Ipv4Address origin, Ipv4Address group,
                                         uint32_t interface);
 
+  /**
+   * \brief Invalidate the forwarding cache of the node after a change
+   * of the unicast routes.
+   */
+  void InvalidateForwardingCache (void);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the index of the forwarding table for network, by destination prefix.
+   */
+  Ipv4RouteTrie m_networkTrie;
+
   /**
    * \brief the forwarding table for multicast.
    */
@@ -29,7 +29,8 @@ NS_LOG_COMPONENT_DEFINE ("Ipv6EndPointDemux");
 Ipv6EndPointDemux::Ipv6EndPointDemux ()
   : m_ephemeral (49152),
     m_portFirst (49152),
-    m_portLast (65535)
+    m_portLast (65535),
+    m_nextOrder (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -37,34 +38,35 @@ Ipv6EndPointDemux::Ipv6EndPointDemux ()
 Ipv6EndPointDemux::~Ipv6EndPointDemux ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (OrderedEndPoints::iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
-      Ipv6EndPoint *endPoint = *i;
+      Ipv6EndPoint *endPoint = i->second;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_orders.clear ();
+  m_ports.clear ();
+  m_fourTuples.clear ();
 }
 
 bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
-    {
-      if ((*i)->GetLocalPort  () == port)
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::unordered_map<uint16_t, OrderedEndPoints>::const_iterator bucket = m_ports.find (port);
+  if (bucket == m_ports.end ())
+    {
+      return false;
+    }
+  for (OrderedEndPoints::const_iterator i = bucket->second.begin (); i != bucket->second.end (); i++)
     {
-      if ((*i)->GetLocalPort () == port
-          && (*i)->GetLocalAddress () == addr)
+      if (i->second->GetLocalAddress () == addr)
         {
           return true;
         }
@@ -81,10 +83,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (Ipv6Address::GetAny (), port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
@@ -96,10 +95,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (uint16_t port)
@@ -117,48 +113,107 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address, uint16_t port)
       NS_LOG_WARN ("Duplicate address/port; failing.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t localPort,
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  FourTuple tuple = { localAddress, localPort, peerAddress, peerPort };
+  if (m_fourTuples.find (tuple) != m_fourTuples.end ())
     {
-      if ((*i)->GetLocalPort () == localPort
-          && (*i)->GetLocalAddress () == localAddress
-          && (*i)->GetPeerPort () == peerPort
-          && (*i)->GetPeerAddress () == peerAddress)
-        {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
-        }
+      NS_LOG_WARN ("No way we can allocate this end-point.");
+      /* no way we can allocate this end-point. */
+      return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
+  return Insert (endPoint);
+}
 
+Ipv6EndPoint* Ipv6EndPointDemux::Insert (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint64_t order = m_nextOrder++;
+  m_endPoints[order] = endPoint;
+  m_orders[endPoint] = order;
+  Index (endPoint);
+  endPoint->m_demux = this;
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
   return endPoint;
 }
 
+void Ipv6EndPointDemux::Index (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint64_t order = m_orders[endPoint];
+  FourTuple tuple = { endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                      endPoint->GetPeerAddress (), endPoint->GetPeerPort () };
+  m_ports[tuple.localPort][order] = endPoint;
+  m_fourTuples[tuple][order] = endPoint;
+}
+
+void Ipv6EndPointDemux::Unindex (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint64_t order = m_orders[endPoint];
+  FourTuple tuple = { endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                      endPoint->GetPeerAddress (), endPoint->GetPeerPort () };
+  std::unordered_map<uint16_t, OrderedEndPoints>::iterator bucket = m_ports.find (tuple.localPort);
+  NS_ASSERT (bucket != m_ports.end ());
+  bucket->second.erase (order);
+  if (bucket->second.empty ())
+    {
+      m_ports.erase (bucket);
+    }
+  std::unordered_map<FourTuple, OrderedEndPoints, FourTupleHash>::iterator exact = m_fourTuples.find (tuple);
+  NS_ASSERT (exact != m_fourTuples.end ());
+  exact->second.erase (order);
+  if (exact->second.empty ())
+    {
+      m_fourTuples.erase (exact);
+    }
+}
+
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::unordered_map<Ipv6EndPoint *, uint64_t>::iterator i = m_orders.find (endPoint);
+  if (i != m_orders.end ())
     {
-      if (*i == endPoint)
+      Unindex (endPoint);
+      m_endPoints.erase (i->second);
+      m_orders.erase (i);
+      endPoint->m_demux = 0;
+      delete endPoint;
+    }
+}
+
+void Ipv6EndPointDemux::LookupFourTuple (Ipv6Address localAddress, uint16_t localPort,
+                                         Ipv6Address peerAddress, uint16_t peerPort,
+                                         Ptr<Ipv6Interface> incomingInterface, EndPoints &endPoints)
+{
+  NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort << incomingInterface);
+  FourTuple tuple = { localAddress, localPort, peerAddress, peerPort };
+  std::unordered_map<FourTuple, OrderedEndPoints, FourTupleHash>::const_iterator exact = m_fourTuples.find (tuple);
+  if (exact == m_fourTuples.end ())
+    {
+      return;
+    }
+  for (OrderedEndPoints::const_iterator i = exact->second.begin (); i != exact->second.end (); i++)
+    {
+      Ipv6EndPoint* endP = i->second;
+      if (!endP->IsRxEnabled ())
         {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
+          continue;
         }
+      if (endP->GetBoundNetDevice ()
+          && (!incomingInterface || endP->GetBoundNetDevice () != incomingInterface->GetDevice ()))
+        {
+          continue;
+        }
+      endPoints.push_back (endP);
     }
 }
 
@@ -179,9 +234,41 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval4; /* Exact match on all 4 */
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+
+  /* Unless the source of the packet is a wildcard, every kind of match is
+     an exact match of the four-tuple of the endpoint with the packet
+     four-tuple, in which the local address, or the peer address and port,
+     or both, are replaced by wildcards. */
+  if (sport != 0 && saddr != Ipv6Address::GetAny ())
     {
-      Ipv6EndPoint* endP = *i;
+      LookupFourTuple (daddr, dport, saddr, sport, incomingInterface, retval4);
+      if (!retval4.empty ())
+        {
+          return retval4;
+        }
+      LookupFourTuple (Ipv6Address::GetAny (), dport, saddr, sport, incomingInterface, retval3);
+      if (!retval3.empty ())
+        {
+          return retval3;
+        }
+      LookupFourTuple (daddr, dport, Ipv6Address::GetAny (), 0, incomingInterface, retval2);
+      if (!retval2.empty ())
+        {
+          return retval2;
+        }
+      LookupFourTuple (Ipv6Address::GetAny (), dport, Ipv6Address::GetAny (), 0, incomingInterface, retval1);
+      return retval1;  /* might be empty if no matches */
+    }
+
+  std::unordered_map<uint16_t, OrderedEndPoints>::const_iterator bucket = m_ports.find (dport);
+  if (bucket == m_ports.end ())
+    {
+      NS_LOG_LOGIC ("No endpoint with dport " << dport);
+      return retval1;
+    }
+  for (OrderedEndPoints::const_iterator i = bucket->second.begin (); i != bucket->second.end (); i++)
+    {
+      Ipv6EndPoint* endP = i->second;
 
       NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
                                                  << " daddr=" << endP->GetLocalAddress ()
@@ -195,15 +282,6 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
           continue;
         }
 
-      if (endP->GetLocalPort () != dport)
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
-
       if (endP->GetBoundNetDevice ())
         {
           if (!incomingInterface)
@@ -295,36 +373,36 @@ Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport,
 {
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
-
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::unordered_map<uint16_t, OrderedEndPoints>::const_iterator bucket = m_ports.find (dport);
+  if (bucket == m_ports.end ())
     {
+      return 0;
+    }
+  for (OrderedEndPoints::const_iterator i = bucket->second.begin (); i != bucket->second.end (); i++)
+    {
+      Ipv6EndPoint *endP = i->second;
       uint32_t tmp = 0;
 
-      if ((*i)->GetLocalPort () != dport)
-        {
-          continue;
-        }
-
-      if ((*i)->GetLocalAddress () == dst && (*i)->GetPeerPort () == sport
-          && (*i)->GetPeerAddress () == src)
+      if (endP->GetLocalAddress () == dst && endP->GetPeerPort () == sport
+          && endP->GetPeerAddress () == src)
         {
           /* this is an exact match. */
-          return *i;
+          return endP;
         }
 
-      if ((*i)->GetLocalAddress () == Ipv6Address::GetAny ())
+      if (endP->GetLocalAddress () == Ipv6Address::GetAny ())
         {
           tmp++;
         }
 
-      if ((*i)->GetPeerAddress () == Ipv6Address::GetAny ())
+      if (endP->GetPeerAddress () == Ipv6Address::GetAny ())
         {
           tmp++;
         }
 
       if (tmp < genericity)
         {
-          generic = (*i);
+          generic = endP;
           genericity = tmp;
         }
     }
@@ -355,7 +433,12 @@ uint16_t Ipv6EndPointDemux::AllocateEphemeralPort ()
 
 Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::GetEndPoints () const
 {
-  return m_endPoints;
+  EndPoints ret;
+  for (OrderedEndPoints::const_iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+    {
+      ret.push_back (i->second);
+    }
+  return ret;
 }
 
 } /* namespace ns3 */
@@ -23,6 +23,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <map>
+#include <unordered_map>
 #include "ns3/ipv6-address.h"
 #include "ipv6-interface.h"
 
@@ -34,6 +36,10 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The endpoints are indexed by local port and by four-tuple, so that a
+ * lookup does not depend on the number of connections of the node.  The
+ * endpoints notify their demux when their four-tuple changes.
  */
 class Ipv6EndPointDemux
 {
@@ -147,6 +153,87 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief Endpoints in allocation order.
+   */
+  typedef std::map<uint64_t, Ipv6EndPoint *> OrderedEndPoints;
+
+  /**
+   * \brief The four-tuple (local address and port, peer address and port)
+   * of an endpoint.
+   */
+  struct FourTuple
+  {
+    Ipv6Address localAddress; //!< the local address
+    uint16_t localPort;       //!< the local port
+    Ipv6Address peerAddress;  //!< the peer address
+    uint16_t peerPort;        //!< the peer port
+
+    /**
+     * \param o the other four-tuple
+     * \return true if both four-tuples are equal
+     */
+    bool operator == (const FourTuple &o) const
+    {
+      return localAddress == o.localAddress && localPort == o.localPort
+             && peerAddress == o.peerAddress && peerPort == o.peerPort;
+    }
+  };
+
+  /**
+   * \brief Hash function of the four-tuples.
+   */
+  struct FourTupleHash
+  {
+    /**
+     * \param t the four-tuple
+     * \return the hash of the four-tuple
+     */
+    size_t operator () (const FourTuple &t) const
+    {
+      Ipv6AddressHash hash;
+      uint64_t h = hash (t.localAddress) * 0x9e3779b97f4a7c15ULL ^ hash (t.peerAddress);
+      h ^= ((static_cast<uint64_t> (t.localPort) << 16) | t.peerPort) * 0x9e3779b97f4a7c15ULL;
+      return std::hash<uint64_t> () (h);
+    }
+  };
+
+  /**
+   * \brief Add an endpoint to the demux.
+   * \param endPoint the endpoint
+   * \return the endpoint
+   */
+  Ipv6EndPoint *Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Index an endpoint by its current local port and four-tuple.
+   * \param endPoint the endpoint
+   */
+  void Index (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an endpoint from the indexes, before its local port or
+   * four-tuple changes.
+   * \param endPoint the endpoint
+   */
+  void Unindex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add the endpoints with a given four-tuple which can receive a
+   * packet from an interface to a list, in allocation order.
+   * \param localAddress local address
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \param incomingInterface the incoming interface
+   * \param endPoints the list
+   */
+  void LookupFourTuple (Ipv6Address localAddress, uint16_t localPort,
+                        Ipv6Address peerAddress, uint16_t peerPort,
+                        Ptr<Ipv6Interface> incomingInterface, EndPoints &endPoints);
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
@@ -169,9 +256,29 @@ private:
   uint16_t m_portLast;
 
   /**
-   * \brief A list of IPv6 end points.
+   * \brief The IPv6 end points, in allocation order.
+   */
+  OrderedEndPoints m_endPoints;
+
+  /**
+   * \brief The allocation order of the IPv6 end points.
+   */
+  std::unordered_map<Ipv6EndPoint *, uint64_t> m_orders;
+
+  /**
+   * \brief The allocation order of the next end point.
+   */
+  uint64_t m_nextOrder;
+
+  /**
+   * \brief The IPv6 end points, by local port.
+   */
+  std::unordered_map<uint16_t, OrderedEndPoints> m_ports;
+
+  /**
+   * \brief The IPv6 end points, by four-tuple.
    */
-  EndPoints m_endPoints;
+  std::unordered_map<FourTuple, OrderedEndPoints, FourTupleHash> m_fourTuples;
 };
 
 } /* namespace ns3 */
@@ -34,6 +34,7 @@ namespace ns3
 
 class Header;
 class Packet;
+class Ipv6EndPointDemux;
 
 /**
  * \ingroup ipv6
@@ -46,6 +47,9 @@ class Packet;
  * layers that a packet from a lower layer was received.  In the ns3
  * internet-stack, these notifications are automatically registered to be
  * received by the corresponding socket.
+ *
+ * The demux which allocated an endpoint indexes it by its four-tuple, and
+ * is notified when the four-tuple changes.
  */
 class Ipv6EndPoint
 {
@@ -192,6 +196,13 @@ public:
   bool IsRxEnabled (void);
 
 private:
+  friend class Ipv6EndPointDemux;
+
+  /**
+   * \brief The demux which indexes the endpoint (if any).
+   */
+  Ipv6EndPointDemux *m_demux;
+
   /**
    * \brief The local address.
    */
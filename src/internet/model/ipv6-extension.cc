@@ -32,6 +32,7 @@
 #include "ns3/ipv6-list-routing.h"
 #include "ns3/ipv6-route.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/simulator.h"
 #include "icmpv6-l4-protocol.h"
 #include "ipv6-extension-demux.h"
 #include "ipv6-extension.h"
@@ -24,6 +24,7 @@
 #include "ns3/vector.h"
 #include "ns3/boolean.h"
 #include "ns3/callback.h"
+#include "ns3/abort.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object-vector.h"
 #include "ns3/ipv6-routing-protocol.h"
@@ -44,6 +45,7 @@
 #include "ipv6-option.h"
 #include "icmpv6-l4-protocol.h"
 #include "ndisc-cache.h"
+#include "super-segment-tag.h"
 
 /// Minimum IPv6 MTU, as defined by \RFC{2460}
 #define IPV6_MIN_MTU 1280
@@ -144,6 +146,7 @@ void Ipv6L3Protocol::DoDispose ()
       it->second = 0;
     }
   m_protocols.clear ();
+  m_segmentCallbacks.clear ();
 
   /* remove interfaces */
   for (Ipv6InterfaceList::iterator it = m_interfaces.begin (); it != m_interfaces.end (); ++it)
@@ -803,6 +806,12 @@ Ptr<IpL4Protocol> Ipv6L3Protocol::GetProtocol (int protocolNumber, int32_t inter
   return 0;
 }
 
+void Ipv6L3Protocol::SetSegmentCallback (uint8_t protocolNumber, SegmentCallback cb)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (protocolNumber));
+  m_segmentCallbacks[protocolNumber] = cb;
+}
+
 Ptr<Socket> Ipv6L3Protocol::CreateRawSocket ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -1116,6 +1125,27 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
   Ptr<Ipv6Interface> outInterface = GetInterface (interface);
   NS_LOG_LOGIC ("Send via NetDevice ifIndex " << dev->GetIfIndex () << " Ipv6InterfaceIndex " << interface);
 
+  // A super-segment is split by its transport protocol into the segments
+  // it carries before it reaches the queue discs and the device, which see
+  // the same packets as without super-segments
+  SuperSegmentTag superSegmentTag;
+  if (packet->PeekPacketTag (superSegmentTag))
+    {
+      std::map<uint8_t, SegmentCallback>::const_iterator cb = m_segmentCallbacks.find (ipHeader.GetNextHeader ());
+      NS_ABORT_MSG_IF (cb == m_segmentCallbacks.end (),
+                       "No segmentation callback for protocol " << static_cast<uint32_t> (ipHeader.GetNextHeader ()));
+      std::list<Ptr<Packet> > segments = cb->second (packet, ipHeader.GetSourceAddress (),
+                                                     ipHeader.GetDestinationAddress ());
+      NS_LOG_LOGIC ("Split a super-segment into " << segments.size () << " segments");
+      for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); ++it)
+        {
+          Ipv6Header segmentHeader = ipHeader;
+          segmentHeader.SetPayloadLength ((*it)->GetSize ());
+          SendRealOut (route, *it, segmentHeader);
+        }
+      return;
+    }
+
   // Check packet size
   std::list<Ipv6ExtensionFragment::Ipv6PayloadHeaderPair> fragments;
 
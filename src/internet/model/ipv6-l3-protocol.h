@@ -114,6 +114,27 @@ public:
   virtual Ptr<IpL4Protocol> GetProtocol (int protocolNumber) const;
   virtual Ptr<IpL4Protocol> GetProtocol (int protocolNumber, int32_t interfaceIndex) const;
 
+  /**
+   * \brief Callback splitting a packet that carries several segments of a
+   * transport protocol into these segments (see SuperSegmentTag)
+   *
+   * The arguments are the packet, starting with its transport header, and
+   * its source and destination addresses. The segments, each starting with
+   * its own transport header, are returned in sequence order.
+   */
+  typedef Callback<std::list<Ptr<Packet> >, Ptr<const Packet>, const Address &, const Address &> SegmentCallback;
+
+  /**
+   * \brief Register the segmentation callback of a transport protocol
+   *
+   * The packets of this protocol that carry a SuperSegmentTag are split
+   * by the callback before they reach the queue discs and the device.
+   *
+   * \param protocolNumber the transport protocol number
+   * \param cb the segmentation callback
+   */
+  void SetSegmentCallback (uint8_t protocolNumber, SegmentCallback cb);
+
   /**
    * \brief Create raw IPv6 socket.
    * \return newly raw socket
@@ -684,6 +705,11 @@ private:
    */
   L4List_t m_protocols;
 
+  /**
+   * \brief Segmentation callbacks, by transport protocol number.
+   */
+  std::map<uint8_t, SegmentCallback> m_segmentCallbacks;
+
   /**
    * \brief List of IPv6 interfaces.
    */
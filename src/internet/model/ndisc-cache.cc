@@ -19,6 +19,7 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 #include "ns3/uinteger.h"
 #include "ns3/node.h"
 #include "ns3/names.h"
@@ -132,15 +133,13 @@ void NdiscCache::Remove (NdiscCache::Entry* entry)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); i++)
+  CacheI i = m_ndCache.find (entry->m_ipv6Address);
+  if (i != m_ndCache.end () && (*i).second == entry)
     {
-      if ((*i).second == entry)
-        {
-          m_ndCache.erase (i);
-          entry->ClearWaitingPacket ();
-          delete entry;
-          return;
-        }
+      m_ndCache.erase (i);
+      entry->CancelNudTimer ();
+      entry->ClearWaitingPacket ();
+      delete entry;
     }
 }
 
@@ -154,6 +153,41 @@ void NdiscCache::Flush ()
     }
 
   m_ndCache.erase (m_ndCache.begin (), m_ndCache.end ());
+  m_nudTimers.clear ();
+  m_nudEvent.Cancel ();
+}
+
+void NdiscCache::UpdateNudEvent ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  if (m_nudTimers.empty ())
+    {
+      m_nudEvent.Cancel ();
+      return;
+    }
+
+  Time next = m_nudTimers.begin ()->first;
+  if (!m_nudEvent.IsRunning () || next < TimeStep (m_nudEvent.GetTs ()))
+    {
+      m_nudEvent.Cancel ();
+      m_nudEvent = Simulator::Schedule (next - Simulator::Now (), &NdiscCache::HandleNudTimeout, this);
+    }
+}
+
+void NdiscCache::HandleNudTimeout ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  /* the handlers may arm, cancel or delete any entry, including the next ones */
+  while (!m_nudTimers.empty () && m_nudTimers.begin ()->first <= Simulator::Now ())
+    {
+      NdiscCache::Entry* entry = m_nudTimers.begin ()->second;
+      m_nudTimers.erase (m_nudTimers.begin ());
+      entry->m_nudRunning = false;
+      (entry->*(entry->m_nudFunction))();
+    }
+  UpdateNudEvent ();
 }
 
 void NdiscCache::SetUnresQlen (uint32_t unresQlen)
@@ -223,7 +257,8 @@ NdiscCache::Entry::Entry (NdiscCache* nd)
   : m_ndCache (nd),
     m_waiting (),
     m_router (false),
-    m_nudTimer (Timer::CANCEL_ON_DESTROY),
+    m_nudRunning (false),
+    m_nudFunction (0),
     m_lastReachabilityConfirmation (Seconds (0.0)),
     m_nsRetransmit (0)
 {
@@ -265,6 +300,14 @@ void NdiscCache::Entry::ClearWaitingPacket ()
 void NdiscCache::Entry::FunctionReachableTimeout ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  /* the reachability confirmations only record their time, the timer is
+   * pushed back lazily when it expires */
+  Time expiration = m_lastReachabilityConfirmation + MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME);
+  if (expiration > Simulator::Now ())
+    {
+      ScheduleNudTimer (&NdiscCache::Entry::FunctionReachableTimeout, expiration - Simulator::Now ());
+      return;
+    }
   this->MarkStale ();
 }
 
@@ -414,18 +457,35 @@ Time NdiscCache::Entry::GetLastReachabilityConfirmation () const
   return m_lastReachabilityConfirmation;
 }
 
-void NdiscCache::Entry::StartReachableTimer ()
+void NdiscCache::Entry::ScheduleNudTimer (void (NdiscCache::Entry::*function)(), Time delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  CancelNudTimer ();
+  m_nudFunction = function;
+  m_nudTimer = m_ndCache->m_nudTimers.insert (std::make_pair (Simulator::Now () + delay, this));
+  m_nudRunning = true;
+  m_ndCache->UpdateNudEvent ();
+}
+
+void NdiscCache::Entry::CancelNudTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
+  if (m_nudRunning)
     {
-      m_nudTimer.Cancel ();
+      m_ndCache->m_nudTimers.erase (m_nudTimer);
+      m_nudRunning = false;
+      if (m_ndCache->m_nudTimers.empty ())
+        {
+          m_ndCache->m_nudEvent.Cancel ();
+        }
     }
+}
 
+void NdiscCache::Entry::StartReachableTimer ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
   m_lastReachabilityConfirmation = Simulator::Now ();
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionReachableTimeout, this);
-  m_nudTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME));
-  m_nudTimer.Schedule ();
+  ScheduleNudTimer (&NdiscCache::Entry::FunctionReachableTimeout, MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME));
 }
 
 void NdiscCache::Entry::UpdateReachableTimer ()
@@ -435,54 +495,35 @@ void NdiscCache::Entry::UpdateReachableTimer ()
   if (m_state == REACHABLE)
     {
       m_lastReachabilityConfirmation = Simulator::Now ();
-      if (m_nudTimer.IsRunning ())
+      if (!m_nudRunning || m_nudFunction != &NdiscCache::Entry::FunctionReachableTimeout)
         {
-          m_nudTimer.Cancel ();
+          ScheduleNudTimer (&NdiscCache::Entry::FunctionReachableTimeout, MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME));
         }
-      m_nudTimer.Schedule ();
     }
 }
 
 void NdiscCache::Entry::StartProbeTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionProbeTimeout, this);
-  m_nudTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
-  m_nudTimer.Schedule ();
+  ScheduleNudTimer (&NdiscCache::Entry::FunctionProbeTimeout, MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
 }
 
 void NdiscCache::Entry::StartDelayTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionDelayTimeout, this);
-  m_nudTimer.SetDelay (Seconds (Icmpv6L4Protocol::DELAY_FIRST_PROBE_TIME));
-  m_nudTimer.Schedule ();
+  ScheduleNudTimer (&NdiscCache::Entry::FunctionDelayTimeout, Seconds (Icmpv6L4Protocol::DELAY_FIRST_PROBE_TIME));
 }
 
 void NdiscCache::Entry::StartRetransmitTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionRetransmitTimeout, this);
-  m_nudTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
-  m_nudTimer.Schedule ();
+  ScheduleNudTimer (&NdiscCache::Entry::FunctionRetransmitTimeout, MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
 }
 
 void NdiscCache::Entry::StopNudTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_nudTimer.Cancel ();
+  CancelNudTimer ();
   m_nsRetransmit = 0;
 }
 
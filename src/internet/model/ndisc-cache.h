@@ -23,13 +23,14 @@
 
 #include <stdint.h>
 #include <list>
+#include <map>
 
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
+#include "ns3/event-id.h"
 #include "ns3/net-device.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/ptr.h"
-#include "ns3/timer.h"
 #include "ns3/sgi-hashmap.h"
 #include "ns3/output-stream-wrapper.h"
 
@@ -340,6 +341,20 @@ public:
     void SetIpv6Address (Ipv6Address ipv6Address);
 
 private:
+    friend class NdiscCache;
+
+    /**
+     * \brief Arm the NUD timer of this entry, replacing the pending one if any.
+     * \param function the function to call when the timer expires
+     * \param delay the delay before the timer expires
+     */
+    void ScheduleNudTimer (void (NdiscCache::Entry::*function)(), Time delay);
+
+    /**
+     * \brief Disarm the NUD timer of this entry.
+     */
+    void CancelNudTimer ();
+
     /**
      * \brief The IPv6 address.
      */
@@ -384,9 +399,19 @@ private:
     bool m_router;
 
     /**
-     * \brief Timer (used for NUD).
+     * \brief Is the NUD timer armed.
      */
-    Timer m_nudTimer;
+    bool m_nudRunning;
+
+    /**
+     * \brief Function called when the NUD timer expires.
+     */
+    void (NdiscCache::Entry::*m_nudFunction)();
+
+    /**
+     * \brief Position of the NUD timer in the timers of the cache.
+     */
+    std::multimap<Time, NdiscCache::Entry *>::iterator m_nudTimer;
 
     /**
      * \brief Last time we see a reachability confirmation.
@@ -409,6 +434,11 @@ private:
    */
   typedef sgi::hash_map<Ipv6Address, NdiscCache::Entry *, Ipv6AddressHash>::iterator CacheI;
 
+  /**
+   * \brief NUD timers of the entries, by expiration time
+   */
+  typedef std::multimap<Time, NdiscCache::Entry *> NudTimers;
+
   /**
    * \brief Copy constructor.
    *
@@ -429,6 +459,20 @@ private:
    */
   void DoDispose ();
 
+  /**
+   * \brief Make sure that the NUD event expires with the earliest NUD timer.
+   */
+  void UpdateNudEvent ();
+
+  /**
+   * \brief Process all the NUD timers that have expired.
+   *
+   * The NUD timers of all the entries share a single event, so that
+   * arming, refreshing or cancelling the timer of an entry does not touch
+   * the simulator event queue.
+   */
+  void HandleNudTimeout ();
+
   /**
    * \brief The NetDevice.
    */
@@ -444,6 +488,16 @@ private:
    */
   Cache m_ndCache;
 
+  /**
+   * \brief The armed NUD timers.
+   */
+  NudTimers m_nudTimers;
+
+  /**
+   * \brief Event of the earliest NUD timer.
+   */
+  EventId m_nudEvent;
+
   /**
    * \brief Max number of packet stored in m_waiting.
    */
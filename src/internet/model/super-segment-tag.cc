@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "super-segment-tag.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SuperSegmentTag);
+
+SuperSegmentTag::SuperSegmentTag ()
+  : m_segmentSize (0)
+{
+}
+
+TypeId
+SuperSegmentTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SuperSegmentTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<SuperSegmentTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+SuperSegmentTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+SuperSegmentTag::GetSerializedSize (void) const
+{
+  return 2;
+}
+
+void
+SuperSegmentTag::Serialize (TagBuffer i) const
+{
+  i.WriteU16 (m_segmentSize);
+}
+
+void
+SuperSegmentTag::Deserialize (TagBuffer i)
+{
+  m_segmentSize = i.ReadU16 ();
+}
+
+void
+SuperSegmentTag::Print (std::ostream &os) const
+{
+  os << "SegmentSize=" << m_segmentSize;
+}
+
+void
+SuperSegmentTag::SetSegmentSize (uint16_t segmentSize)
+{
+  m_segmentSize = segmentSize;
+}
+
+uint16_t
+SuperSegmentTag::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+
+} // namespace ns3
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SUPER_SEGMENT_TAG_H
+#define SUPER_SEGMENT_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Mark a packet that carries several segments of a transport flow
+ *
+ * A transport protocol may hand down the data of several segments in a
+ * single packet, in the spirit of the generic segmentation offload of the
+ * real network stacks, to save the per segment processing of the socket
+ * and of the IP layer. When the IPv4 and IPv6 layers send a packet
+ * carrying this tag, they split it into the segments it carries with the
+ * segmentation callback registered by its transport protocol (see
+ * Ipv4L3Protocol::SetSegmentCallback) before handing it to the queue discs
+ * and the outgoing device, so that the network only sees segments of at
+ * most the segment size, fragmented as usual if they exceed the MTU.
+ */
+class SuperSegmentTag : public Tag
+{
+public:
+  SuperSegmentTag ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+  /**
+   * \brief Set the size of the segments carried by the packet
+   * \param segmentSize the segment size, in bytes
+   */
+  void SetSegmentSize (uint16_t segmentSize);
+
+  /**
+   * \brief Get the size of the segments carried by the packet
+   * \return the segment size, in bytes
+   */
+  uint16_t GetSegmentSize (void) const;
+
+private:
+  uint16_t m_segmentSize; //!< Size of the segments carried by the packet
+};
+
+} // namespace ns3
+
+#endif /* SUPER_SEGMENT_TAG_H */
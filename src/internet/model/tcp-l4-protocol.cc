@@ -43,6 +43,7 @@
 #include "tcp-socket-base.h"
 #include "tcp-congestion-ops.h"
 #include "rtt-estimator.h"
+#include "super-segment-tag.h"
 
 #include <vector>
 #include <sstream>
@@ -135,11 +136,21 @@ TcpL4Protocol::NotifyNewAggregate ()
     {
       ipv4->Insert (this);
       this->SetDownTarget (MakeCallback (&Ipv4::Send, ipv4));
+      Ptr<Ipv4L3Protocol> ipv4l3 = DynamicCast<Ipv4L3Protocol> (ipv4);
+      if (ipv4l3 != 0)
+        {
+          ipv4l3->SetSegmentCallback (PROT_NUMBER, MakeCallback (&TcpL4Protocol::SplitSuperSegment, this));
+        }
     }
   if (ipv6 != 0 && m_downTarget6.IsNull ())
     {
       ipv6->Insert (this);
       this->SetDownTarget6 (MakeCallback (&Ipv6::Send, ipv6));
+      Ptr<Ipv6L3Protocol> ipv6l3 = DynamicCast<Ipv6L3Protocol> (ipv6);
+      if (ipv6l3 != 0)
+        {
+          ipv6l3->SetSegmentCallback (PROT_NUMBER, MakeCallback (&TcpL4Protocol::SplitSuperSegment, this));
+        }
     }
   IpL4Protocol::NotifyNewAggregate ();
 }
@@ -636,6 +647,44 @@ TcpL4Protocol::SendPacketV6 (Ptr<Packet> packet, const TcpHeader &outgoing,
     }
 }
 
+std::list<Ptr<Packet> >
+TcpL4Protocol::SplitSuperSegment (Ptr<const Packet> packet, const Address &saddr,
+                                  const Address &daddr) const
+{
+  NS_LOG_FUNCTION (this << packet << saddr << daddr);
+
+  Ptr<Packet> p = packet->Copy ();
+  TcpHeader header;
+  p->RemoveHeader (header);
+  SuperSegmentTag superSegmentTag;
+  p->RemovePacketTag (superSegmentTag);
+  uint16_t segmentSize = superSegmentTag.GetSegmentSize ();
+  NS_ASSERT (segmentSize > 0);
+
+  std::list<Ptr<Packet> > segments;
+
+  uint32_t size = p->GetSize ();
+  for (uint32_t offset = 0; offset < size; offset += segmentSize)
+    {
+      uint32_t length = std::min (size - offset, static_cast<uint32_t> (segmentSize));
+      Ptr<Packet> segment = p->CreateFragment (offset, length);
+      TcpHeader segmentHeader = header;
+      segmentHeader.SetSequenceNumber (header.GetSequenceNumber () + SequenceNumber32 (offset));
+      if (offset + length < size)
+        {
+          segmentHeader.SetFlags (header.GetFlags () & ~(TcpHeader::FIN | TcpHeader::PSH));
+        }
+      if (Node::ChecksumEnabled ())
+        {
+          segmentHeader.EnableChecksums ();
+        }
+      segmentHeader.InitializeChecksum (saddr, daddr, PROT_NUMBER);
+      segment->AddHeader (segmentHeader);
+      segments.push_back (segment);
+    }
+  return segments;
+}
+
 void
 TcpL4Protocol::SendPacket (Ptr<Packet> pkt, const TcpHeader &outgoing,
                            const Address &saddr, const Address &daddr,
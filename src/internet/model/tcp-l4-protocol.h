@@ -22,6 +22,7 @@
 #define TCP_L4_PROTOCOL_H
 
 #include <stdint.h>
+#include <list>
 
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
@@ -292,6 +293,24 @@ protected:
   void NoEndPointsFound (const TcpHeader &incomingHeader, const Address &incomingSAddr,
                          const Address &incomingDAddr);
 
+  /**
+   * \brief Split a super-segment into the segments it carries
+   *
+   * Registered as the segmentation callback of the IPv4 and IPv6 layers.
+   * Each segment gets a copy of the TCP header of the super-segment, with
+   * its own sequence number; the FIN and PSH flags are kept on the last
+   * segment only. The checksum is computed again if checksums are enabled.
+   *
+   * \param packet the super-segment, starting with its TCP header
+   * \param saddr the source address, for the checksum
+   * \param daddr the destination address, for the checksum
+   * \returns the segments, in sequence order
+   *
+   * \see SuperSegmentTag
+   */
+  std::list<Ptr<Packet> > SplitSuperSegment (Ptr<const Packet> packet, const Address &saddr,
+                                             const Address &daddr) const;
+
 private:
   Ptr<Node> m_node;                //!< the node this stack is associated with
   Ipv4EndPointDemux *m_endPoints;  //!< A list of IPv4 end points.
@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-option-sack.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpOptionSack");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpOptionSack);
+
+TcpOptionSack::TcpOptionSack ()
+  : TcpOption ()
+{
+}
+
+TcpOptionSack::~TcpOptionSack ()
+{
+}
+
+TypeId
+TcpOptionSack::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpOptionSack")
+    .SetParent<TcpOption> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpOptionSack> ()
+  ;
+  return tid;
+}
+
+TypeId
+TcpOptionSack::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+TcpOptionSack::Print (std::ostream &os) const
+{
+  for (SackList::const_iterator it = m_sackList.begin (); it != m_sackList.end (); ++it)
+    {
+      os << "[" << it->first << ";" << it->second << "]";
+    }
+}
+
+uint32_t
+TcpOptionSack::GetSerializedSize (void) const
+{
+  return 2 + 8 * m_sackList.size ();
+}
+
+void
+TcpOptionSack::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteU8 (GetKind ()); // Kind
+  i.WriteU8 (GetSerializedSize ()); // Length
+  for (SackList::const_iterator it = m_sackList.begin (); it != m_sackList.end (); ++it)
+    {
+      i.WriteHtonU32 (it->first.GetValue ());
+      i.WriteHtonU32 (it->second.GetValue ());
+    }
+}
+
+uint32_t
+TcpOptionSack::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+
+  uint8_t readKind = i.ReadU8 ();
+  if (readKind != GetKind ())
+    {
+      NS_LOG_WARN ("Malformed SACK option");
+      return 0;
+    }
+  uint8_t size = i.ReadU8 ();
+  if (size < 10 || size > 34 || (size - 2) % 8 != 0)
+    {
+      NS_LOG_WARN ("Malformed SACK option");
+      return 0;
+    }
+  m_sackList.clear ();
+  for (uint8_t n = 0; n < (size - 2) / 8; ++n)
+    {
+      SequenceNumber32 left = SequenceNumber32 (i.ReadNtohU32 ());
+      SequenceNumber32 right = SequenceNumber32 (i.ReadNtohU32 ());
+      m_sackList.push_back (SackBlock (left, right));
+    }
+  return GetSerializedSize ();
+}
+
+uint8_t
+TcpOptionSack::GetKind (void) const
+{
+  return TcpOption::SACK;
+}
+
+void
+TcpOptionSack::AddSackBlock (SackBlock block)
+{
+  NS_ASSERT (m_sackList.size () < 4);
+  m_sackList.push_back (block);
+}
+
+uint32_t
+TcpOptionSack::GetNumSackBlocks (void) const
+{
+  return m_sackList.size ();
+}
+
+void
+TcpOptionSack::ClearSackList (void)
+{
+  m_sackList.clear ();
+}
+
+TcpOptionSack::SackList
+TcpOptionSack::GetSackList (void) const
+{
+  return m_sackList;
+}
+
+} // namespace ns3
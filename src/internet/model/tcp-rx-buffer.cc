@@ -131,6 +131,12 @@ TcpRxBuffer::SetFinSequence (const SequenceNumber32& s)
   if (m_nextRxSeq == m_finSeq) ++m_nextRxSeq;
 }
 
+SequenceNumber32
+TcpRxBuffer::GetEnd (IntervalMap::const_iterator i)
+{
+  return i->first + SequenceNumber32 (i->second.size);
+}
+
 bool
 TcpRxBuffer::Finished (void)
 {
@@ -156,61 +162,79 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end () && i->first <= tailSeq)
+  if (headSeq >= tailSeq)
     {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      if (lastByteSeq > headSeq)
+      NS_LOG_LOGIC ("Nothing to buffer");
+      return false; // Nothing to buffer anyway
+    }
+  // Find the first interval overlapping or adjacent to the packet
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      BufIterator prev = i;
+      --prev;
+      if (GetEnd (prev) >= headSeq)
         {
-          if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
-              m_data.erase (i++);
-              continue;
-            }
-          if (i->first <= headSeq)
-            { // Incoming head is overlapped
-              headSeq = lastByteSeq;
-            }
-          if (lastByteSeq >= tailSeq)
-            { // Incoming tail is overlapped
-              tailSeq = i->first;
-            }
+          i = prev;
         }
-      ++i;
     }
-  // We now know how much we are going to store, trim the packet
-  if (headSeq >= tailSeq)
+  if (i != m_data.end () && i->first <= headSeq && GetEnd (i) >= tailSeq)
     {
       NS_LOG_LOGIC ("Nothing to buffer");
-      return false; // Nothing to buffer anyway
+      return false; // All the bytes are already buffered
     }
-  else
+  // Fill the holes between the intervals the packet overlaps with fragments
+  // of the packet, and merge them all in a single interval
+  SequenceNumber32 startSeq = headSeq;
+  if (i != m_data.end () && i->first < headSeq)
     {
-      uint32_t start = headSeq - tcph.GetSequenceNumber ();
-      uint32_t length = tailSeq - headSeq;
-      p = p->CreateFragment (start, length);
-      NS_ASSERT (length == p->GetSize ());
+      startSeq = i->first;
     }
-  // Insert packet into buffer
-  NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
-  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
-  // Update variables
-  m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  SequenceNumber32 endSeq = startSeq;
+  Interval merged;
+  merged.size = 0;
+  uint32_t added = 0;
+  while (true)
     {
-      if (i->first < m_nextRxSeq)
+      bool last = (i == m_data.end () || i->first > tailSeq);
+      SequenceNumber32 holeEnd = last ? tailSeq : i->first;
+      if (endSeq < holeEnd)
         {
-          continue;
+          uint32_t length = holeEnd - endSeq;
+          merged.packets.push_back (p->CreateFragment (endSeq - tcph.GetSequenceNumber (), length));
+          merged.size += length;
+          added += length;
+          endSeq = holeEnd;
         }
-      else if (i->first > m_nextRxSeq)
+      if (last)
         {
           break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+        }
+      NS_ASSERT (i->first == endSeq);
+      merged.size += i->second.size;
+      merged.packets.splice (merged.packets.end (), i->second.packets);
+      endSeq = GetEnd (i);
+      m_sackRecent.remove (i->first);
+      m_data.erase (i++);
+    }
+  Interval &interval = m_data[startSeq];
+  interval.size = merged.size;
+  interval.packets.swap (merged.packets);
+  NS_LOG_LOGIC ("Buffered " << added << " bytes in interval of seqno=" << startSeq << " len=" << interval.size);
+  // Update variables
+  m_size += added;      // Occupancy
+  if (startSeq <= m_nextRxSeq && m_nextRxSeq < endSeq)
+    {
+      m_availBytes += endSeq - m_nextRxSeq.Get ();
+      m_nextRxSeq = endSeq;
+    }
+  else if (startSeq > m_nextRxSeq)
+    { // Out-of-order data: this interval is the first one to report (RFC 2018)
+      m_sackRecent.push_front (startSeq);
+      if (m_sackRecent.size () > 4)
+        {
+          m_sackRecent.pop_back ();
+        }
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -230,30 +254,42 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   if (extractSize == 0) return 0;  // No contiguous block to return
   NS_ASSERT (m_data.size ()); // At least we have something to extract
   Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
-  BufIterator i;
   while (extractSize)
     { // Check the buffered data for delivery
-      i = m_data.begin ();
+      BufIterator i = m_data.begin ();
       NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
-      // Check if we send the whole pkt or just a partial
-      uint32_t pktSize = i->second->GetSize ();
-      if (pktSize <= extractSize)
-        { // Whole packet is extracted
-          outPkt->AddAtEnd (i->second);
-          m_data.erase (i);
-          m_size -= pktSize;
-          m_availBytes -= pktSize;
-          extractSize -= pktSize;
+      Interval &interval = i->second;
+      uint32_t extracted = 0;
+      while (extractSize && !interval.packets.empty ())
+        {
+          Ptr<Packet> p = interval.packets.front ();
+          // Check if we send the whole pkt or just a partial
+          uint32_t pktSize = p->GetSize ();
+          if (pktSize <= extractSize)
+            { // Whole packet is extracted
+              outPkt->AddAtEnd (p);
+              interval.packets.pop_front ();
+              extracted += pktSize;
+              extractSize -= pktSize;
+            }
+          else
+            { // Partial is extracted and done
+              outPkt->AddAtEnd (p->CreateFragment (0, extractSize));
+              interval.packets.front () = p->CreateFragment (extractSize, pktSize - extractSize);
+              extracted += extractSize;
+              extractSize = 0;
+            }
         }
-      else
-        { // Partial is extracted and done
-          outPkt->AddAtEnd (i->second->CreateFragment (0, extractSize));
-          m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
-          m_data.erase (i);
-          m_size -= extractSize;
-          m_availBytes -= extractSize;
-          extractSize = 0;
+      m_size -= extracted;
+      m_availBytes -= extracted;
+      interval.size -= extracted;
+      if (interval.size != 0)
+        { // The rest of the interval starts after the extracted data
+          Interval &rest = m_data[i->first + SequenceNumber32 (extracted)];
+          rest.size = interval.size;
+          rest.packets.swap (interval.packets);
         }
+      m_data.erase (i);
     }
   if (outPkt->GetSize () == 0)
     {
@@ -261,8 +297,21 @@ TcpRxBuffer::Extract (uint32_t maxSize)
       return 0;
     }
   NS_LOG_LOGIC ("Extracted " << outPkt->GetSize ( ) << " bytes, bufsize=" << m_size
-                             << ", num pkts in buffer=" << m_data.size ());
+                             << ", num intervals in buffer=" << m_data.size ());
   return outPkt;
 }
 
+TcpOptionSack::SackList
+TcpRxBuffer::GetSackList (void) const
+{
+  TcpOptionSack::SackList list;
+  for (std::list<SequenceNumber32>::const_iterator it = m_sackRecent.begin (); it != m_sackRecent.end (); ++it)
+    {
+      IntervalMap::const_iterator i = m_data.find (*it);
+      NS_ASSERT (i != m_data.end ());
+      list.push_back (TcpOptionSack::SackBlock (i->first, GetEnd (i)));
+    }
+  return list;
+}
+
 } //namepsace ns3
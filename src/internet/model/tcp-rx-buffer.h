@@ -21,12 +21,14 @@
 #ifndef TCP_RX_BUFFER_H
 #define TCP_RX_BUFFER_H
 
+#include <list>
 #include <map>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
 #include "ns3/tcp-header.h"
+#include "ns3/tcp-option-sack.h"
 
 namespace ns3 {
 class Packet;
@@ -36,6 +38,15 @@ class Packet;
  *
  * \brief class for the reordering buffer that keeps the data from lower layer, i.e.
  *        TcpL4Protocol, sent to the application
+ *
+ * The buffered data is kept as a set of disjoint intervals of sequence
+ * numbers, each one holding the packets (or fragments of packets) that
+ * cover it in sequence. A received packet only fills the holes of the
+ * intervals it overlaps and merges them with itself and with its adjacent
+ * intervals, so that the cost of Add () depends on the number of holes it
+ * fills and not on the amount of buffered data. The packets are never
+ * copied: they are trimmed with Packet::CreateFragment and joined in a
+ * single packet by Extract ().
  */
 class TcpRxBuffer : public Object
 {
@@ -125,16 +136,45 @@ public:
    */
   Ptr<Packet> Extract (uint32_t maxSize);
 
+  /**
+   * \brief Get the blocks of out-of-order data to report in a SACK option
+   *
+   * As required by \RFC{2018}, the first block holds the most recently
+   * received segment and the next ones are the other blocks most recently
+   * updated.
+   *
+   * \returns at most four SACK blocks, the most recent first
+   */
+  TcpOptionSack::SackList GetSackList (void) const;
+
 private:
-  /// container for data stored in the buffer
-  typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
+  /**
+   * \brief A contiguous interval of buffered data
+   */
+  struct Interval
+  {
+    uint32_t size;                   //!< Number of bytes of the interval
+    std::list<Ptr<Packet> > packets; //!< Packets holding the data, in sequence
+  };
+  /// container for data stored in the buffer, by the first sequence number of each interval
+  typedef std::map<SequenceNumber32, Interval> IntervalMap;
+  /// iterator over the data stored in the buffer
+  typedef IntervalMap::iterator BufIterator;
+
+  /**
+   * \param i an interval of the buffer
+   * \returns the sequence number following the last byte of the interval
+   */
+  static SequenceNumber32 GetEnd (IntervalMap::const_iterator i);
+
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //!< Seqnum of the FIN packet
   bool m_gotFin;                             //!< Did I received FIN packet?
   uint32_t m_size;                           //!< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
-  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  IntervalMap m_data;                        //!< Corresponding data, as disjoint intervals
+  std::list<SequenceNumber32> m_sackRecent;  //!< First seqnums of the out-of-order intervals last updated, most recent first
 };
 
 } //namepsace ns3
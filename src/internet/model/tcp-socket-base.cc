@@ -49,6 +49,9 @@
 #include "tcp-header.h"
 #include "tcp-option-winscale.h"
 #include "tcp-option-ts.h"
+#include "tcp-option-sack-permitted.h"
+#include "tcp-option-sack.h"
+#include "super-segment-tag.h"
 #include "rtt-estimator.h"
 #include "tcp-congestion-ops.h"
 
@@ -98,6 +101,36 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_timestampEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("Sack", "Enable or disable the SACK option (RFC 2018) "
+                   "and the SACK based loss recovery (RFC 6675)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SegmentBatch",
+                   "Maximum number of segments handed down to IP in a single "
+                   "packet (GSO-like super-segment, split into segments "
+                   "before the queue discs and the device)",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TcpSocketBase::m_segmentBatch),
+                   MakeUintegerChecker<uint32_t> (1, 64))
+    .AddAttribute ("Pacing", "Enable or disable the pacing of the segments",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_pacing),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxPacingRate", "Maximum pacing rate",
+                   DataRateValue (DataRate ("4Gb/s")),
+                   MakeDataRateAccessor (&TcpSocketBase::m_maxPacingRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("PacingSsRatio",
+                   "Pacing rate in slow start, in percent of cwnd/RTT",
+                   UintegerValue (200),
+                   MakeUintegerAccessor (&TcpSocketBase::m_pacingSsRatio),
+                   MakeUintegerChecker<uint16_t> (1))
+    .AddAttribute ("PacingCaRatio",
+                   "Pacing rate in congestion avoidance, in percent of cwnd/RTT",
+                   UintegerValue (120),
+                   MakeUintegerAccessor (&TcpSocketBase::m_pacingCaRatio),
+                   MakeUintegerChecker<uint16_t> (1))
     .AddAttribute ("MinRto",
                    "Minimum retransmit timeout value",
                    TimeValue (Seconds (1.0)), // RFC 6298 says min RTO=1 sec, but Linux uses 200ms.
@@ -311,9 +344,16 @@ TcpSocketBase::TcpSocketBase (void)
     m_sndWindShift (0),
     m_timestampEnabled (true),
     m_timestampToEcho (0),
+    m_sackEnabled (false),
+    m_segmentBatch (1),
+    m_pacing (false),
+    m_maxPacingRate (DataRate ("4Gb/s")),
+    m_pacingSsRatio (200),
+    m_pacingCaRatio (120),
     m_sendPendingDataEvent (),
     // Set m_recover to the initial sequence number
     m_recover (0),
+    m_rescueRxt (false),
     m_retxThresh (3),
     m_limitedTx (false),
     m_retransOut (0),
@@ -389,7 +429,14 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_sndWindShift (sock.m_sndWindShift),
     m_timestampEnabled (sock.m_timestampEnabled),
     m_timestampToEcho (sock.m_timestampToEcho),
+    m_sackEnabled (sock.m_sackEnabled),
+    m_segmentBatch (sock.m_segmentBatch),
+    m_pacing (sock.m_pacing),
+    m_maxPacingRate (sock.m_maxPacingRate),
+    m_pacingSsRatio (sock.m_pacingSsRatio),
+    m_pacingCaRatio (sock.m_pacingCaRatio),
     m_recover (sock.m_recover),
+    m_rescueRxt (sock.m_rescueRxt),
     m_retxThresh (sock.m_retxThresh),
     m_limitedTx (sock.m_limitedTx),
     m_retransOut (sock.m_retransOut),
@@ -1255,6 +1302,15 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
           m_timestampEnabled = false;
         }
 
+      if (tcpHeader.HasOption (TcpOption::SACKPERMITTED) && m_sackEnabled)
+        {
+          NS_LOG_INFO ("SACK permitted by the other end");
+        }
+      else
+        {
+          m_sackEnabled = false;
+        }
+
       // Initialize cWnd and ssThresh
       m_tcb->m_cWnd = GetInitialCwnd () * GetSegSize ();
       m_tcb->m_ssThresh = GetInitialSSThresh ();
@@ -1460,17 +1516,32 @@ TcpSocketBase::FastRetransmit ()
   NS_ASSERT (m_tcb->m_congState != TcpSocketState::CA_RECOVERY);
 
   m_recover = m_tcb->m_highTxMark;
+  m_rescueRxt = false;
   m_congestionControl->CongestionStateSet (m_tcb, TcpSocketState::CA_RECOVERY);
   m_tcb->m_congState = TcpSocketState::CA_RECOVERY;
 
-  m_tcb->m_ssThresh = m_congestionControl->GetSsThresh (m_tcb,
-                                                        BytesInFlight ());
-  m_tcb->m_cWnd = m_tcb->m_ssThresh + m_dupAckCount * m_tcb->m_segmentSize;
+  if (m_sackEnabled)
+    { // The pipe already excludes the SACKed and lost data, so ssthresh is
+      // computed on the FlightSize and the window is not inflated (RFC 6675)
+      m_tcb->m_ssThresh = m_congestionControl->GetSsThresh (m_tcb,
+                                                            m_tcb->m_highTxMark.Get () - m_txBuffer->HeadSequence ());
+      m_tcb->m_cWnd = m_tcb->m_ssThresh;
+    }
+  else
+    {
+      m_tcb->m_ssThresh = m_congestionControl->GetSsThresh (m_tcb,
+                                                            BytesInFlight ());
+      m_tcb->m_cWnd = m_tcb->m_ssThresh + m_dupAckCount * m_tcb->m_segmentSize;
+    }
 
   NS_LOG_INFO (m_dupAckCount << " dupack. Enter fast recovery mode." <<
                "Reset cwnd to " << m_tcb->m_cWnd << ", ssthresh to " <<
                m_tcb->m_ssThresh << " at fast recovery seqnum " << m_recover);
   DoRetransmit ();
+  if (m_sackEnabled)
+    {
+      SendPendingData (m_connected);
+    }
 }
 
 void
@@ -1493,9 +1564,13 @@ TcpSocketBase::DupAck ()
 
   if (m_tcb->m_congState == TcpSocketState::CA_DISORDER)
     {
-      if ((m_dupAckCount == m_retxThresh) && (m_highRxAckMark >= m_recover))
+      if ((m_dupAckCount == m_retxThresh
+           || (m_sackEnabled && m_txBuffer->IsLost (m_txBuffer->HeadSequence (),
+                                                    m_retxThresh, m_tcb->m_segmentSize)))
+          && (m_highRxAckMark >= m_recover))
         {
-          // triple duplicate ack triggers fast retransmit (RFC2582 sec.3 bullet #1)
+          // triple duplicate ack triggers fast retransmit (RFC2582 sec.3 bullet #1),
+          // as well as enough SACKed data above the first unacked byte (RFC 6675 sec.5)
           NS_LOG_DEBUG (TcpSocketState::TcpCongStateName[m_tcb->m_congState] <<
                         " -> RECOVERY");
           FastRetransmit ();
@@ -1507,10 +1582,13 @@ TcpSocketBase::DupAck ()
         }
     }
   else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
-    { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
-      m_tcb->m_cWnd += m_tcb->m_segmentSize;
-      NS_LOG_INFO (m_dupAckCount << " Dupack received in fast recovery mode."
-                   "Increase cwnd to " << m_tcb->m_cWnd);
+    {
+      if (!m_sackEnabled)
+        { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
+          m_tcb->m_cWnd += m_tcb->m_segmentSize;
+          NS_LOG_INFO (m_dupAckCount << " Dupack received in fast recovery mode."
+                       "Increase cwnd to " << m_tcb->m_cWnd);
+        }
       SendPendingData (m_connected);
     }
 
@@ -1529,6 +1607,11 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 
   SequenceNumber32 ackNumber = tcpHeader.GetAckNumber ();
 
+  if (m_sackEnabled && tcpHeader.HasOption (TcpOption::SACK))
+    {
+      ProcessOptionSack (tcpHeader.GetOption (TcpOption::SACK));
+    }
+
   NS_LOG_DEBUG ("ACK of " << ackNumber <<
                 " SND.UNA=" << m_txBuffer->HeadSequence () <<
                 " SND.NXT=" << m_tcb->m_nextTxSequence);
@@ -1604,7 +1687,22 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         }
       else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
         {
-          if (ackNumber < m_recover)
+          if (ackNumber < m_recover && m_sackEnabled)
+            {
+              /* Partial ACK with SACK (RFC 6675).
+               * The congestion window stays at ssthresh for the whole
+               * recovery; the next holes are retransmitted from the
+               * scoreboard as the pipe drains.
+               */
+              callCongestionControl = false;
+              m_dupAckCount = SafeSubtraction (m_dupAckCount, segsAcked);
+              m_congestionControl->PktsAcked (m_tcb, segsAcked, m_lastRtt);
+
+              NS_LOG_INFO ("Partial ACK for seq " << ackNumber <<
+                           " in SACK recovery: cwnd " << m_tcb->m_cWnd <<
+                           " recover seq: " << m_recover);
+            }
+          else if (ackNumber < m_recover)
             {
               /* Partial ACK.
                * In case of partial ACK, retransmit the first unacknowledged
@@ -2252,6 +2350,11 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
           AddOptionWScale (header);
         }
 
+      if (m_sackEnabled)
+        { // So is the SACK permitted option
+          AddOptionSackPermitted (header);
+        }
+
       if (m_synCount == 0)
         { // No more connection retries, give up
           NS_LOG_LOGIC ("Connection failed.");
@@ -2521,6 +2624,13 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       p->ReplacePacketTag (priorityTag);
     }
 
+  if (sz > m_tcb->m_segmentSize)
+    {
+      SuperSegmentTag superSegmentTag;
+      superSegmentTag.SetSegmentSize (m_tcb->m_segmentSize);
+      p->AddPacketTag (superSegmentTag);
+    }
+
   if (m_closeOnEmpty && (remainingData == 0))
     {
       flags |= TcpHeader::FIN;
@@ -2642,9 +2752,18 @@ TcpSocketBase::SendPendingData (bool withAck)
       NS_LOG_INFO ("TcpSocketBase::SendPendingData: No endpoint; m_shutdownSend=" << m_shutdownSend);
       return false; // Is this the right way to handle this condition?
     }
+  if (m_sackEnabled && m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
+    {
+      return SendRecoveryData (withAck);
+    }
   uint32_t nPacketsSent = 0;
   while (m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence))
     {
+      if (m_pacing && m_pacingEvent.IsRunning ())
+        {
+          NS_LOG_LOGIC ("Pacing is enabled. Wait for the pacing timer.");
+          break;
+        }
       uint32_t w = AvailableWindow (); // Get available window size
       // Stop sending if we need to wait for a larger Tx window (prevent silly window syndrome)
       if (w < m_tcb->m_segmentSize && m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence) > w)
@@ -2673,10 +2792,20 @@ TcpSocketBase::SendPendingData (bool withAck)
                     " cWnd: " << m_tcb->m_cWnd <<
                     " unAck: " << UnAckDataCount ());
 
-      uint32_t s = std::min (w, m_tcb->m_segmentSize);  // Send no more than window
+      uint32_t s = std::min (w, GetMaxSendSize ());  // Send no more than window
+      if (s > m_tcb->m_segmentSize)
+        {
+          // A super-segment only carries full segments, as the segments
+          // sent one by one would
+          s -= s % m_tcb->m_segmentSize;
+        }
       uint32_t sz = SendDataPacket (m_tcb->m_nextTxSequence, s, withAck);
       nPacketsSent++;                             // Count sent this loop
       m_tcb->m_nextTxSequence += sz;                     // Advance next tx sequence
+      if (m_pacing)
+        {
+          SchedulePacing (sz);
+        }
     }
   if (nPacketsSent > 0)
     {
@@ -2685,6 +2814,111 @@ TcpSocketBase::SendPendingData (bool withAck)
   return (nPacketsSent > 0);
 }
 
+/* Loss recovery with SACK (RFC 6675 sec.5 step C): fill the room left by
+ * the pipe in the congestion window with the lost holes first, then with
+ * new data, then with the other holes below the highest SACKed byte, and
+ * last with a single rescue retransmission of the highest unSACKed data.
+ */
+bool
+TcpSocketBase::SendRecoveryData (bool withAck)
+{
+  NS_LOG_FUNCTION (this << withAck);
+  uint32_t nPacketsSent = 0;
+  while (m_tcb->m_cWnd.Get () >= BytesInFlight () + m_tcb->m_segmentSize)
+    {
+      if (m_pacing && m_pacingEvent.IsRunning ())
+        {
+          NS_LOG_LOGIC ("Pacing is enabled. Wait for the pacing timer.");
+          break;
+        }
+      SequenceNumber32 seq;
+      uint32_t length;
+      bool isLost;
+      bool hasHole = m_txBuffer->NextSeg (m_tcb->m_nextTxSequence, m_retxThresh,
+                                          m_tcb->m_segmentSize, seq, length, isLost);
+      uint32_t newData = std::min (m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence),
+                                   m_tcb->m_segmentSize);
+      uint32_t sz;
+      if (!(hasHole && isLost) && newData > 0 && UnAckDataCount () + newData <= m_rWnd.Get ())
+        {
+          sz = SendDataPacket (m_tcb->m_nextTxSequence, newData, withAck);
+          m_tcb->m_nextTxSequence += sz;
+        }
+      else if (hasHole)
+        {
+          NS_LOG_INFO ("Retransmit " << (isLost ? "lost" : "unSACKed") << " data at seq " << seq);
+          sz = SendDataPacket (seq, length, withAck);
+          m_txBuffer->MarkRetransmitted (seq, sz);
+        }
+      else if (!m_rescueRxt
+               && m_txBuffer->RescueSeg (m_tcb->m_nextTxSequence, m_tcb->m_segmentSize, seq, length))
+        { // HighRxt is not moved by the rescue retransmission
+          NS_LOG_INFO ("Rescue retransmission at seq " << seq);
+          sz = SendDataPacket (seq, length, withAck);
+          m_rescueRxt = true;
+        }
+      else
+        {
+          break;
+        }
+      nPacketsSent++;
+      if (m_pacing)
+        {
+          SchedulePacing (sz);
+        }
+    }
+  if (nPacketsSent > 0)
+    {
+      NS_LOG_DEBUG ("SendRecoveryData sent " << nPacketsSent << " segments");
+    }
+  return (nPacketsSent > 0);
+}
+
+uint32_t
+TcpSocketBase::GetMaxSendSize (void) const
+{
+  // The IP payload length of a super-segment must fit in 16 bits, with
+  // room for the largest IP and TCP headers
+  static const uint32_t maxSuperSegmentSize = 65535 - 60 - 60;
+
+  if (m_segmentBatch == 1)
+    {
+      return m_tcb->m_segmentSize;
+    }
+  return std::min (m_segmentBatch * m_tcb->m_segmentSize,
+                   std::max (maxSuperSegmentSize / m_tcb->m_segmentSize, 1u) * m_tcb->m_segmentSize);
+}
+
+DataRate
+TcpSocketBase::GetPacingRate (void) const
+{
+  Time rtt = m_rtt->GetEstimate ();
+  if (rtt.IsZero ())
+    {
+      return m_maxPacingRate;
+    }
+  // As Linux, pace faster in slow start to leave room for the window growth
+  uint16_t ratio = m_tcb->m_cWnd < m_tcb->m_ssThresh ? m_pacingSsRatio : m_pacingCaRatio;
+  double rate = m_tcb->m_cWnd.Get () * 8.0 * ratio / 100 / rtt.GetSeconds ();
+  return DataRate (static_cast<uint64_t> (std::min (rate, static_cast<double> (m_maxPacingRate.GetBitRate ()))));
+}
+
+void
+TcpSocketBase::SchedulePacing (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  Time delay = GetPacingRate ().CalculateBytesTxTime (size);
+  NS_LOG_LOGIC ("Next segment paced in " << delay.GetSeconds () << " s");
+  m_pacingEvent = Simulator::Schedule (delay, &TcpSocketBase::PacingTimeout, this);
+}
+
+void
+TcpSocketBase::PacingTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+  SendPendingData (m_connected);
+}
+
 uint32_t
 TcpSocketBase::UnAckDataCount () const
 {
@@ -2706,7 +2940,12 @@ TcpSocketBase::BytesInFlight ()
   uint32_t duplicatedSize;
   uint32_t bytesInFlight;
 
-  if (m_retransOut > m_dupAckCount)
+  if (m_sackEnabled && m_tcb->m_congState != TcpSocketState::CA_LOSS)
+    { // RFC 6675 pipe, from the SACK scoreboard
+      bytesInFlight = m_txBuffer->BytesInFlight (m_tcb->m_nextTxSequence, m_retxThresh,
+                                                 m_tcb->m_segmentSize);
+    }
+  else if (m_retransOut > m_dupAckCount)
     {
       duplicatedSize = (m_retransOut - m_dupAckCount)*m_tcb->m_segmentSize;
       bytesInFlight = flightSize + duplicatedSize;
@@ -3062,6 +3301,10 @@ TcpSocketBase::Retransmit ()
 
   m_tcb->m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
   m_dupAckCount = 0;
+  if (m_sackEnabled)
+    { // The receiver may have discarded the SACKed data (RFC 2018 sec.8)
+      m_txBuffer->ResetScoreboard ();
+    }
 
   NS_LOG_DEBUG ("RTO. Reset cwnd to " <<  m_tcb->m_cWnd << ", ssthresh to " <<
                 m_tcb->m_ssThresh << ", restart from seqnum " << m_tcb->m_nextTxSequence);
@@ -3111,6 +3354,10 @@ TcpSocketBase::DoRetransmit ()
   // Retransmit a data packet: Call SendDataPacket
   uint32_t sz = SendDataPacket (m_txBuffer->HeadSequence (), m_tcb->m_segmentSize, true);
   ++m_retransOut;
+  if (m_sackEnabled && m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
+    {
+      m_txBuffer->MarkRetransmitted (m_txBuffer->HeadSequence (), sz);
+    }
 
   // In case of RTO, advance m_tcb->m_nextTxSequence
   m_tcb->m_nextTxSequence = std::max (m_tcb->m_nextTxSequence.Get (), m_txBuffer->HeadSequence () + sz);
@@ -3127,6 +3374,7 @@ TcpSocketBase::CancelAllTimers ()
   m_lastAckEvent.Cancel ();
   m_timewaitEvent.Cancel ();
   m_sendPendingDataEvent.Cancel ();
+  m_pacingEvent.Cancel ();
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -3309,6 +3557,11 @@ TcpSocketBase::AddOptions (TcpHeader& header)
     {
       AddOptionTimestamp (header);
     }
+
+  if (m_sackEnabled)
+    {
+      AddOptionSack (header);
+    }
 }
 
 void
@@ -3408,6 +3661,53 @@ TcpSocketBase::AddOptionTimestamp (TcpHeader& header)
                option->GetTimestamp () << " echo=" << m_timestampToEcho);
 }
 
+void
+TcpSocketBase::AddOptionSackPermitted (TcpHeader &header)
+{
+  NS_LOG_FUNCTION (this << header);
+  NS_ASSERT (header.GetFlags () & TcpHeader::SYN);
+
+  header.AppendOption (CreateObject<TcpOptionSackPermitted> ());
+}
+
+void
+TcpSocketBase::ProcessOptionSack (const Ptr<const TcpOption> option)
+{
+  NS_LOG_FUNCTION (this << option);
+
+  Ptr<const TcpOptionSack> sack = DynamicCast<const TcpOptionSack> (option);
+  uint32_t sacked = m_txBuffer->Update (sack->GetSackList ());
+
+  NS_LOG_INFO (m_node->GetId () << " Received " << sack->GetNumSackBlocks () <<
+               " SACK blocks, newly SACKed bytes " << sacked);
+}
+
+void
+TcpSocketBase::AddOptionSack (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+
+  TcpOptionSack::SackList list = m_rxBuffer->GetSackList ();
+  if (list.empty ()
+      || header.GetOptionLength () + 10 > header.GetMaxOptionLength ())
+    {
+      return;
+    }
+
+  // Report as many blocks as the remaining option space allows
+  uint32_t maxBlocks = (header.GetMaxOptionLength () - header.GetOptionLength () - 2) / 8;
+  Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack> ();
+  for (TcpOptionSack::SackList::const_iterator it = list.begin ();
+       it != list.end () && option->GetNumSackBlocks () < maxBlocks; ++it)
+    {
+      option->AddSackBlock (*it);
+    }
+
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK with " <<
+               option->GetNumSackBlocks () << " blocks");
+}
+
 void TcpSocketBase::UpdateWindowSize (const TcpHeader &header)
 {
   NS_LOG_FUNCTION (this << header);
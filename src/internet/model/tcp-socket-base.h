@@ -33,6 +33,7 @@
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-interface.h"
 #include "ns3/event-id.h"
+#include "ns3/data-rate.h"
 #include "tcp-tx-buffer.h"
 #include "tcp-rx-buffer.h"
 #include "rtt-estimator.h"
@@ -607,6 +608,53 @@ protected:
    */
   bool SendPendingData (bool withAck = false);
 
+  /**
+   * \brief Send data during a SACK based loss recovery (RFC 6675)
+   *
+   * Called by SendPendingData in the CA_RECOVERY state when SACK is
+   * enabled. While the congestion window leaves room for a segment above
+   * the pipe, send the next lost hole, else new data, else the next
+   * hole below the highest SACKed byte, else, once per recovery, the
+   * last unSACKed segment (rescue retransmission).
+   *
+   * \param withAck forces an ACK to be sent
+   * \returns true if some data have been sent
+   */
+  bool SendRecoveryData (bool withAck);
+
+  /**
+   * \brief Get the largest amount of data to send in a single packet
+   *
+   * One segment, or up to SegmentBatch segments as a super-segment,
+   * which the IP layers split into segments before the queue discs.
+   *
+   * \returns the maximum size of the data of a packet
+   */
+  uint32_t GetMaxSendSize (void) const;
+
+  /**
+   * \brief Get the current pacing rate
+   *
+   * The rate is the congestion window per RTT, scaled by PacingSsRatio in
+   * slow start and by PacingCaRatio in congestion avoidance, and capped by
+   * MaxPacingRate.
+   *
+   * \returns the pacing rate
+   */
+  DataRate GetPacingRate (void) const;
+
+  /**
+   * \brief Arm the pacing timer after sending some data
+   *
+   * \param size the size of the data just sent
+   */
+  void SchedulePacing (uint32_t size);
+
+  /**
+   * \brief Send the pending data when the pacing timer expires
+   */
+  void PacingTimeout (void);
+
   /**
    * \brief Extract at most maxSize bytes from the TxBuffer at sequence seq, add the
    *        TCP header, and send to TcpL4Protocol
@@ -963,6 +1011,32 @@ protected:
    */
   void AddOptionTimestamp (TcpHeader& header);
 
+  /**
+   * \brief Add the SACK permitted option to the header
+   *
+   * Only valid on SYN segments.
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSackPermitted (TcpHeader& header);
+
+  /**
+   * \brief Read the SACK option and update the scoreboard of the TxBuffer
+   *
+   * \param option SACK option read from the header
+   */
+  void ProcessOptionSack (const Ptr<const TcpOption> option);
+
+  /**
+   * \brief Add the SACK option to the header
+   *
+   * Report the out-of-order data held by the RxBuffer, most recently
+   * received first, with as many blocks as the option space left allows.
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSack (TcpHeader& header);
+
   /**
    * \brief Performs a safe subtraction between a and b (a-b)
    *
@@ -1039,10 +1113,21 @@ protected:
   bool     m_timestampEnabled;    //!< Timestamp option enabled
   uint32_t m_timestampToEcho;     //!< Timestamp to echo
 
+  bool     m_sackEnabled;         //!< SACK option enabled (RFC 2018)
+
+  // Super-segments and pacing
+  uint32_t m_segmentBatch;        //!< Max number of segments sent in a single packet
+  bool     m_pacing;              //!< Pacing of the segments enabled
+  DataRate m_maxPacingRate;       //!< Max pacing rate
+  uint16_t m_pacingSsRatio;       //!< Pacing rate in slow start, in percent of cwnd/RTT
+  uint16_t m_pacingCaRatio;       //!< Pacing rate in congestion avoidance, in percent of cwnd/RTT
+  EventId  m_pacingEvent;         //!< Pacing timer: next paced send
+
   EventId m_sendPendingDataEvent; //!< micro-delay event to send pending data
 
   // Fast Retransmit and Recovery
   SequenceNumber32       m_recover;      //!< Previous highest Tx seqnum for fast recovery
+  bool                   m_rescueRxt;    //!< Rescue retransmission sent in this recovery (RFC 6675)
   uint32_t               m_retxThresh;   //!< Fast Retransmit threshold
   bool                   m_limitedTx;    //!< perform limited transmit
   uint32_t               m_retransOut;   //!< Number of retransmission in this window
@@ -57,7 +57,8 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_firstByteOffset (0), m_data (),
+    m_sackedBytes (0), m_highRxt (0), m_sackedBelowRxt (0)
 {
 }
 
@@ -111,7 +112,10 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          Chunk chunk;
+          chunk.packet = p;
+          chunk.offset = m_firstByteOffset + m_size;
+          m_data.push_back (chunk);
           m_size += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
@@ -133,6 +137,21 @@ TcpTxBuffer::SizeFromSequence (const SequenceNumber32& seq) const
   return lastSeq - seq;
 }
 
+bool
+TcpTxBuffer::StartsAfter (uint64_t offset, const Chunk &chunk)
+{
+  return offset < chunk.offset;
+}
+
+TcpTxBuffer::ChunkList::const_iterator
+TcpTxBuffer::FindChunk (uint64_t offset) const
+{
+  NS_ASSERT (!m_data.empty () && offset >= m_data.front ().offset);
+  // The last packet which starts at or before the offset
+  ChunkList::const_iterator i = std::upper_bound (m_data.begin (), m_data.end (), offset, &StartsAfter);
+  return --i;
+}
+
 Ptr<Packet>
 TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
 {
@@ -148,54 +167,34 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
     }
 
   // Extract data from the buffer and return
-  uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
-  Ptr<Packet> outPacket;
-  NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  uint64_t offset = m_firstByteOffset + (seq - m_firstByteSeq.Get ());
+  ChunkList::const_iterator i = FindChunk (offset);
+  uint32_t pktSize = i->packet->GetSize ();
+  uint32_t packetOffset = offset - i->offset;
+  uint32_t fragmentLength = pktSize - packetOffset;
+  NS_LOG_LOGIC ("First byte found at offset " << packetOffset << " of a packet of size " << pktSize);
+  if (fragmentLength >= s)
+    { // Data to be copied falls entirely in this packet
+      return i->packet->CreateFragment (packetOffset, s);
+    }
+  // This packet only fulfills part of the request
+  Ptr<Packet> outPacket = i->packet->CreateFragment (packetOffset, fragmentLength);
+  uint32_t remaining = s - fragmentLength;
+  for (++i; remaining > 0; ++i)
     {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
-        }
-      else if (count + pktSize >= offset + s)
+      NS_ASSERT (i != m_data.end ());
+      pktSize = i->packet->GetSize ();
+      if (pktSize >= remaining)
         { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
-                                                      << ", packet len=" << pktSize);
-          uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
-          outPacket->AddAtEnd (endFragment);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-          break;
+          outPacket->AddAtEnd (i->packet->CreateFragment (0, remaining));
+          remaining = 0;
         }
       else
         {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+          outPacket->AddAtEnd (i->packet);
+          remaining -= pktSize;
         }
-      count += pktSize;
+      NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
     }
   NS_ASSERT (outPacket->GetSize () == s);
   return outPacket;
@@ -217,31 +216,43 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   // Cases do not need to scan the buffer
   if (m_firstByteSeq >= seq) return;
 
-  // Scan the buffer and discard packets
-  uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
-  uint32_t pktSize;
+  // Discard the bytes behind the seqnum, and the packets made only of them.
+  // A packet partly behind the seqnum is kept whole.
+  uint32_t offset = std::min (m_size, static_cast<uint32_t> (seq - m_firstByteSeq.Get ()));  // Number of bytes to remove
   NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
+  m_size -= offset;
+  m_firstByteSeq += offset;
+  m_firstByteOffset += offset;
+  while (!m_data.empty ()
+         && m_data.front ().offset + m_data.front ().packet->GetSize () <= m_firstByteOffset)
     {
-      if (offset > (*i)->GetSize ())
-        { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
-          m_size -= pktSize;
-          offset -= pktSize;
-          m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
-          NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
-        }
-      else if (offset > 0)
-        { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
-          m_size -= offset;
-          m_firstByteSeq += offset;
-          NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
+      NS_LOG_LOGIC ("Removed one packet of size " << m_data.front ().packet->GetSize ());
+      m_data.pop_front ();
+    }
+  // Forget the scoreboard of the discarded bytes
+  uint32_t sackedDiscarded = 0;
+  while (!m_sacked.empty () && m_sacked.begin ()->first < m_firstByteOffset)
+    {
+      uint64_t start = m_sacked.begin ()->first;
+      uint64_t end = m_sacked.begin ()->second;
+      m_sacked.erase (m_sacked.begin ());
+      if (end > m_firstByteOffset)
+        { // Partly acknowledged block
+          sackedDiscarded += m_firstByteOffset - start;
+          m_sacked[m_firstByteOffset] = end;
           break;
         }
+      sackedDiscarded += end - start;
+    }
+  m_sackedBytes -= sackedDiscarded;
+  if (m_highRxt <= m_firstByteOffset)
+    {
+      m_highRxt = m_firstByteOffset;
+      m_sackedBelowRxt = 0;
+    }
+  else
+    {
+      m_sackedBelowRxt -= sackedDiscarded;
     }
   // Catching the case of ACKing a FIN
   if (m_size == 0)
@@ -253,4 +264,241 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   NS_ASSERT (m_firstByteSeq == seq);
 }
 
+uint64_t
+TcpTxBuffer::GetOffset (const SequenceNumber32 &seq) const
+{
+  NS_ASSERT (seq >= m_firstByteSeq);
+  return m_firstByteOffset + static_cast<uint32_t> (seq - m_firstByteSeq.Get ());
+}
+
+TcpTxBuffer::SackedMap::const_iterator
+TcpTxBuffer::FindSacked (uint64_t offset) const
+{
+  SackedMap::const_iterator i = m_sacked.upper_bound (offset);
+  if (i != m_sacked.begin ())
+    {
+      SackedMap::const_iterator prev = i;
+      --prev;
+      if (prev->second > offset)
+        {
+          return prev;
+        }
+    }
+  return i;
+}
+
+uint32_t
+TcpTxBuffer::Update (const TcpOptionSack::SackList &list)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t sacked = 0;
+  SequenceNumber32 tail = TailSequence ();
+  for (TcpOptionSack::SackList::const_iterator it = list.begin (); it != list.end (); ++it)
+    {
+      SequenceNumber32 left = std::max (it->first, m_firstByteSeq.Get ());
+      SequenceNumber32 right = std::min (it->second, tail);
+      if (left >= right)
+        {
+          NS_LOG_LOGIC ("Ignored SACK block [" << it->first << ";" << it->second << ")");
+          continue;
+        }
+      sacked += AddSacked (GetOffset (left), GetOffset (right));
+    }
+  NS_LOG_LOGIC ("Newly SACKed bytes=" << sacked << ", SACKed bytes=" << m_sackedBytes <<
+                ", blocks=" << m_sacked.size ());
+  return sacked;
+}
+
+uint32_t
+TcpTxBuffer::AddSacked (uint64_t start, uint64_t end)
+{
+  // Find the first block overlapping or adjacent to the range
+  SackedMap::iterator i = m_sacked.upper_bound (start);
+  if (i != m_sacked.begin ())
+    {
+      SackedMap::iterator prev = i;
+      --prev;
+      if (prev->second >= start)
+        {
+          i = prev;
+        }
+    }
+  // Count the bytes of the holes filled by the range, and merge the blocks
+  uint64_t blockStart = start;
+  uint64_t blockEnd = end;
+  uint64_t next = start;
+  uint32_t sacked = 0;
+  while (true)
+    {
+      bool last = (i == m_sacked.end () || i->first > end);
+      uint64_t holeEnd = last ? end : i->first;
+      if (next < holeEnd)
+        {
+          sacked += holeEnd - next;
+          if (next < m_highRxt)
+            {
+              m_sackedBelowRxt += std::min (holeEnd, m_highRxt) - next;
+            }
+        }
+      if (last)
+        {
+          break;
+        }
+      blockStart = std::min (blockStart, i->first);
+      blockEnd = std::max (blockEnd, i->second);
+      next = std::max (next, i->second);
+      m_sacked.erase (i++);
+    }
+  m_sacked[blockStart] = blockEnd;
+  m_sackedBytes += sacked;
+  return sacked;
+}
+
+void
+TcpTxBuffer::ResetScoreboard (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sacked.clear ();
+  m_sackedBytes = 0;
+  m_highRxt = m_firstByteOffset;
+  m_sackedBelowRxt = 0;
+}
+
+uint32_t
+TcpTxBuffer::GetSacked (void) const
+{
+  return m_sackedBytes;
+}
+
+uint64_t
+TcpTxBuffer::GetLostEdge (uint32_t dupThresh, uint32_t segmentSize, uint32_t &sackedAbove) const
+{
+  // The bytes below a block are lost when the block and the ones above it
+  // are DupThresh blocks or more than (DupThresh - 1) * SMSS bytes
+  uint32_t blocks = 0;
+  sackedAbove = 0;
+  for (SackedMap::const_reverse_iterator i = m_sacked.rbegin (); i != m_sacked.rend (); ++i)
+    {
+      ++blocks;
+      sackedAbove += i->second - i->first;
+      if (blocks >= dupThresh || sackedAbove > (dupThresh - 1) * segmentSize)
+        {
+          return i->first;
+        }
+    }
+  sackedAbove = m_sackedBytes;
+  return m_firstByteOffset;
+}
+
+bool
+TcpTxBuffer::IsLost (const SequenceNumber32 &seq, uint32_t dupThresh, uint32_t segmentSize) const
+{
+  if (seq < m_firstByteSeq || seq >= TailSequence ())
+    {
+      return false;
+    }
+  uint64_t offset = GetOffset (seq);
+  SackedMap::const_iterator i = FindSacked (offset);
+  if (i != m_sacked.end () && i->first <= offset)
+    {
+      return false; // SACKed
+    }
+  uint32_t sackedAbove;
+  return offset < GetLostEdge (dupThresh, segmentSize, sackedAbove);
+}
+
+uint32_t
+TcpTxBuffer::BytesInFlight (const SequenceNumber32 &highData, uint32_t dupThresh, uint32_t segmentSize) const
+{
+  if (highData <= m_firstByteSeq)
+    {
+      return 0;
+    }
+  uint32_t sackedAbove;
+  uint64_t lostEdge = GetLostEdge (dupThresh, segmentSize, sackedAbove);
+  int64_t flight = GetOffset (highData) - m_firstByteOffset;
+  int64_t lost = (lostEdge - m_firstByteOffset) - (m_sackedBytes - sackedAbove);
+  int64_t retransmitted = (m_highRxt - m_firstByteOffset) - m_sackedBelowRxt;
+  int64_t pipe = flight - m_sackedBytes - lost + retransmitted;
+  NS_LOG_LOGIC ("Flight=" << flight << " SACKed=" << m_sackedBytes << " lost=" << lost <<
+                " retransmitted=" << retransmitted << " pipe=" << pipe);
+  return pipe > 0 ? pipe : 0;
+}
+
+bool
+TcpTxBuffer::NextSeg (const SequenceNumber32 &highData, uint32_t dupThresh, uint32_t segmentSize,
+                      SequenceNumber32 &seq, uint32_t &length, bool &isLost) const
+{
+  if (m_sacked.empty () || highData <= m_firstByteSeq)
+    {
+      return false;
+    }
+  // The first unSACKed byte following HighRxt
+  uint64_t offset = std::max (m_highRxt, m_firstByteOffset);
+  SackedMap::const_iterator i = FindSacked (offset);
+  if (i != m_sacked.end () && i->first <= offset)
+    {
+      offset = i->second;
+      ++i;
+    }
+  uint64_t high = GetOffset (highData);
+  if (offset >= m_sacked.rbegin ()->second || offset >= high)
+    {
+      return false;
+    }
+  NS_ASSERT (i != m_sacked.end ());
+  length = std::min (static_cast<uint64_t> (segmentSize), std::min (i->first, high) - offset);
+  uint32_t sackedAbove;
+  isLost = offset < GetLostEdge (dupThresh, segmentSize, sackedAbove);
+  seq = m_firstByteSeq + SequenceNumber32 (offset - m_firstByteOffset);
+  return true;
+}
+
+bool
+TcpTxBuffer::RescueSeg (const SequenceNumber32 &highData, uint32_t segmentSize,
+                        SequenceNumber32 &seq, uint32_t &length) const
+{
+  if (highData <= m_firstByteSeq)
+    {
+      return false;
+    }
+  // The segment ends with the highest unSACKed byte below highData
+  uint64_t end = GetOffset (highData);
+  SackedMap::const_iterator i = FindSacked (end - 1);
+  if (i != m_sacked.end () && i->first < end)
+    {
+      end = i->first;
+    }
+  if (end <= m_firstByteOffset)
+    {
+      return false;
+    }
+  uint64_t start = end > segmentSize ? std::max (end - segmentSize, m_firstByteOffset) : m_firstByteOffset;
+  for (i = FindSacked (start); i != m_sacked.end () && i->first < end; ++i)
+    {
+      start = i->second;
+    }
+  length = end - start;
+  seq = m_firstByteSeq + SequenceNumber32 (start - m_firstByteOffset);
+  return true;
+}
+
+void
+TcpTxBuffer::MarkRetransmitted (const SequenceNumber32 &seq, uint32_t length)
+{
+  NS_LOG_FUNCTION (this << seq << length);
+  uint64_t end = GetOffset (seq) + length;
+  uint64_t start = std::max (m_highRxt, m_firstByteOffset);
+  if (end <= start)
+    {
+      return;
+    }
+  // The SACKed bytes skipped by HighRxt
+  for (SackedMap::const_iterator i = FindSacked (start); i != m_sacked.end () && i->first < end; ++i)
+    {
+      m_sackedBelowRxt += std::min (i->second, end) - std::max (i->first, start);
+    }
+  m_highRxt = end;
+}
+
 } // namepsace ns3
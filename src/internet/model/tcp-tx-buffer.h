@@ -21,12 +21,14 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
-#include <list>
+#include <deque>
+#include <map>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
+#include "ns3/tcp-option-sack.h"
 
 namespace ns3 {
 class Packet;
@@ -36,6 +38,21 @@ class Packet;
  *
  * \brief class for keeping the data sent by the application to the TCP socket, i.e.
  *        the sending buffer.
+ *
+ * The packets added by the application are kept, without copy, in a deque
+ * together with the offset of their first byte in the data stream. A range
+ * of sequence numbers is found by a binary search on these offsets, so the
+ * cost of CopyFromSequence does not depend on the amount of data in the
+ * buffer, and the returned packet is made of fragments of the stored
+ * packets, which share their buffers.
+ *
+ * The buffer also keeps the scoreboard of \RFC{6675} when SACK is in use:
+ * the data reported by the receiver, as sorted disjoint blocks of stream
+ * offsets with the count of their bytes, and the highest retransmitted
+ * byte (HighRxt). The lost bytes are the unSACKed ones below the block
+ * from which DupThresh blocks or more than (DupThresh - 1) * SMSS bytes
+ * are SACKed, which is found from the highest block down; the pipe is
+ * then derived from these counters without walking the scoreboard.
  */
 class TcpTxBuffer : public Object
 {
@@ -127,14 +144,163 @@ public:
    */
   void DiscardUpTo (const SequenceNumber32& seq);
 
+  /**
+   * \brief Add the blocks of a SACK option to the scoreboard
+   *
+   * The parts of the blocks outside of the buffer are ignored.
+   *
+   * \param list the SACK blocks
+   * \returns the number of bytes newly SACKed
+   */
+  uint32_t Update (const TcpOptionSack::SackList &list);
+
+  /**
+   * \brief Forget the SACKed data and the retransmissions
+   *
+   * The SACK information must not be trusted after a retransmission
+   * timeout (\RFC{2018} section 8).
+   */
+  void ResetScoreboard (void);
+
+  /**
+   * \brief Get the number of SACKed bytes in the buffer
+   * \returns the number of SACKed bytes
+   */
+  uint32_t GetSacked (void) const;
+
+  /**
+   * \brief Check whether a byte is considered lost (IsLost () of \RFC{6675})
+   *
+   * \param seq the sequence number of the byte
+   * \param dupThresh the number of duplicate acknowledgments of a loss
+   * \param segmentSize the sender maximum segment size
+   * \returns true if the byte is not SACKed and enough data is SACKed above it
+   */
+  bool IsLost (const SequenceNumber32 &seq, uint32_t dupThresh, uint32_t segmentSize) const;
+
+  /**
+   * \brief Get the data in flight (pipe of \RFC{6675})
+   *
+   * \param highData the sequence number following the last byte sent
+   * \param dupThresh the number of duplicate acknowledgments of a loss
+   * \param segmentSize the sender maximum segment size
+   * \returns the unSACKed bytes below highData which are not lost, plus
+   *          the ones retransmitted
+   */
+  uint32_t BytesInFlight (const SequenceNumber32 &highData, uint32_t dupThresh, uint32_t segmentSize) const;
+
+  /**
+   * \brief Find the next data to retransmit (rules 1 and 3 of NextSeg () of \RFC{6675})
+   *
+   * \param highData the sequence number following the last byte sent
+   * \param dupThresh the number of duplicate acknowledgments of a loss
+   * \param segmentSize the sender maximum segment size
+   * \param seq set to the first unSACKed byte following HighRxt
+   * \param length set to the number of bytes to retransmit from seq, at
+   *        most one segment and not beyond the next SACKed block
+   * \param isLost set to true if the byte is considered lost
+   * \returns false if no unSACKed byte following HighRxt is below the
+   *          highest SACKed byte
+   */
+  bool NextSeg (const SequenceNumber32 &highData, uint32_t dupThresh, uint32_t segmentSize,
+                SequenceNumber32 &seq, uint32_t &length, bool &isLost) const;
+
+  /**
+   * \brief Find the rescue retransmission (rule 4 of NextSeg () of \RFC{6675})
+   *
+   * \param highData the sequence number following the last byte sent
+   * \param segmentSize the sender maximum segment size
+   * \param seq set to the first byte of the segment
+   * \param length set to the number of bytes of the segment, at most one
+   *        segment and not below the previous SACKed block
+   * \returns false if all the bytes below highData are SACKed
+   */
+  bool RescueSeg (const SequenceNumber32 &highData, uint32_t segmentSize,
+                  SequenceNumber32 &seq, uint32_t &length) const;
+
+  /**
+   * \brief Record the retransmission of data during a loss recovery
+   *
+   * HighRxt is moved to the end of the data, if it is not already past it.
+   *
+   * \param seq the sequence number of the first retransmitted byte
+   * \param length the number of retransmitted bytes
+   */
+  void MarkRetransmitted (const SequenceNumber32 &seq, uint32_t length);
+
 private:
+  /**
+   * \brief A packet of the buffer.
+   */
+  struct Chunk
+  {
+    Ptr<Packet> packet; //!< the packet
+    uint64_t offset;    //!< offset of the first byte of the packet in the data stream
+  };
+
   /// container for data stored in the buffer
-  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+  typedef std::deque<Chunk> ChunkList;
+
+  /**
+   * \param offset an offset in the data stream
+   * \param chunk a packet of the buffer
+   * \returns true if the packet starts after the offset
+   */
+  static bool StartsAfter (uint64_t offset, const Chunk &chunk);
+
+  /**
+   * Find the packet holding a byte of the buffer.
+   *
+   * \param offset offset of the byte in the data stream
+   * \returns the packet holding the byte
+   */
+  ChunkList::const_iterator FindChunk (uint64_t offset) const;
+
+  /// SACKed data: the offset following the last byte of each block, by the offset of its first byte
+  typedef std::map<uint64_t, uint64_t> SackedMap;
+
+  /**
+   * \param seq a sequence number, not below the first byte of the buffer
+   * \returns the offset of the sequence number in the data stream
+   */
+  uint64_t GetOffset (const SequenceNumber32 &seq) const;
+
+  /**
+   * \brief Find the SACKed block containing an offset or following it
+   *
+   * \param offset an offset in the data stream
+   * \returns the block
+   */
+  SackedMap::const_iterator FindSacked (uint64_t offset) const;
+
+  /**
+   * \brief Mark a range of the buffer as SACKed
+   *
+   * \param start the offset of the first byte
+   * \param end the offset following the last byte
+   * \returns the number of bytes newly SACKed
+   */
+  uint32_t AddSacked (uint64_t start, uint64_t end);
+
+  /**
+   * \brief Find the offset below which the unSACKed bytes are lost
+   *
+   * \param dupThresh the number of duplicate acknowledgments of a loss
+   * \param segmentSize the sender maximum segment size
+   * \param sackedAbove set to the number of SACKed bytes above the offset
+   * \returns the offset, or the one of the first byte if no byte is lost
+   */
+  uint64_t GetLostEdge (uint32_t dupThresh, uint32_t segmentSize, uint32_t &sackedAbove) const;
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
-  std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+  uint64_t m_firstByteOffset;                   //!< Offset of the first byte in data in the data stream
+  ChunkList m_data;                             //!< Corresponding data, in stream order
+  SackedMap m_sacked;                           //!< SACKed data, as disjoint blocks of stream offsets
+  uint32_t m_sackedBytes;                       //!< Number of SACKed bytes
+  uint64_t m_highRxt;                           //!< Offset following the highest retransmitted byte (HighRxt)
+  uint32_t m_sackedBelowRxt;                    //!< Number of SACKed bytes below HighRxt
 };
 
 } // namepsace ns3
@@ -27,6 +27,7 @@
 #include "ns3/candidate-queue.h"
 #include "ns3/simulator.h"
 #include <cstdlib> // for rand()
+#include <vector>
 
 using namespace ns3;
 
@@ -53,13 +54,42 @@ GlobalRouteManagerImplTestCase::DoRun (void)
       candidate.Push (v);
     }
 
+  uint32_t lastDistance = 0;
   for (int i = 0; i < 100; ++i)
     {
       SPFVertex *v = candidate.Pop ();
+      NS_TEST_EXPECT_MSG_GT_OR_EQ (v->GetDistanceFromRoot (), lastDistance,
+                                   "Vertices not popped in order of distance");
+      lastDistance = v->GetDistanceFromRoot ();
       delete v;
       v = 0;
     }
 
+  // Vertices of equal distance are popped in the order in which they were
+  // pushed, or in which their distance was decreased.
+  SPFVertex *vertices[10];
+  for (int i = 0; i < 10; ++i)
+    {
+      vertices[i] = new SPFVertex;
+      vertices[i]->SetVertexId (Ipv4Address (i + 1));
+      vertices[i]->SetDistanceFromRoot (10 * (i % 5));
+      candidate.Push (vertices[i]);
+    }
+  NS_TEST_EXPECT_MSG_EQ (candidate.Find (Ipv4Address (7)), vertices[6], "Vertex not found");
+  vertices[8]->SetDistanceFromRoot (10);
+  candidate.Reorder (vertices[8]);
+  vertices[3]->SetDistanceFromRoot (0);
+  candidate.Reorder (vertices[3]);
+  int expected[10] = { 0, 5, 3, 1, 6, 8, 2, 7, 4, 9 };
+  for (int i = 0; i < 10; ++i)
+    {
+      SPFVertex *v = candidate.Pop ();
+      NS_TEST_EXPECT_MSG_EQ (v, vertices[expected[i]], "Wrong vertex popped at position " << i);
+      delete v;
+      v = 0;
+    }
+  NS_TEST_EXPECT_MSG_EQ (candidate.Empty (), true, "Candidate queue not empty");
+
   // Build fake link state database; four routers (0-3), 3 point-to-point
   // links
   //
@@ -214,6 +244,202 @@ GlobalRouteManagerImplTestCase::DoRun (void)
 }
 
 
+class CandidateQueueTestCase : public TestCase
+{
+public:
+  CandidateQueueTestCase();
+  virtual void DoRun (void);
+private:
+  /**
+   * \param id the vertex ID
+   * \param distance the distance from the root
+   * \param network whether the vertex is a network vertex
+   * \return a new vertex
+   */
+  static SPFVertex* CreateVertex (uint32_t id, uint32_t distance, bool network);
+};
+
+CandidateQueueTestCase::CandidateQueueTestCase()
+  : TestCase ("CandidateQueue tie-breaking and decrease-key")
+{
+}
+
+SPFVertex*
+CandidateQueueTestCase::CreateVertex (uint32_t id, uint32_t distance, bool network)
+{
+  SPFVertex *v = new SPFVertex;
+  v->SetVertexId (Ipv4Address (id));
+  v->SetDistanceFromRoot (distance);
+  v->SetVertexType (network ? SPFVertex::VertexNetwork : SPFVertex::VertexRouter);
+  return v;
+}
+
+void
+CandidateQueueTestCase::DoRun (void)
+{
+  // At equal distance, the network vertices are popped before the router
+  // vertices, whatever the order in which they were pushed; a vertex whose
+  // distance decreased goes after the vertices of equal priority, and the
+  // outdated entries of a vertex decreased several times are not popped.
+  CandidateQueue candidate;
+  candidate.Push (CreateVertex (1, 10, false));
+  candidate.Push (CreateVertex (2, 10, true));
+  candidate.Push (CreateVertex (3, 10, false));
+  candidate.Push (CreateVertex (4, 10, true));
+  candidate.Push (CreateVertex (5, 20, false));
+  candidate.Push (CreateVertex (6, 20, true));
+  candidate.Push (CreateVertex (7, 30, false));
+  candidate.Push (CreateVertex (8, 40, true));
+
+  SPFVertex *v = candidate.Find (Ipv4Address (5));
+  v->SetDistanceFromRoot (10);
+  candidate.Reorder (v);
+  v = candidate.Find (Ipv4Address (6));
+  v->SetDistanceFromRoot (10);
+  candidate.Reorder (v);
+  v = candidate.Find (Ipv4Address (7));
+  v->SetDistanceFromRoot (20);
+  candidate.Reorder (v);
+  v->SetDistanceFromRoot (5);
+  candidate.Reorder (v);
+  v = candidate.Find (Ipv4Address (8));
+  v->SetDistanceFromRoot (5);
+  candidate.Reorder (v);
+  NS_TEST_EXPECT_MSG_EQ (candidate.Size (), 8, "Outdated entries counted in the size");
+  NS_TEST_EXPECT_MSG_EQ (candidate.Find (Ipv4Address (7))->GetDistanceFromRoot (), 5, "Vertex not found after its distance decreased");
+  NS_TEST_EXPECT_MSG_EQ (candidate.Top ()->GetVertexId (), Ipv4Address (8), "Wrong vertex at the top");
+
+  uint32_t expected[8] = { 8, 7, 2, 4, 6, 1, 3, 5 };
+  for (int i = 0; i < 8; ++i)
+    {
+      v = candidate.Pop ();
+      NS_TEST_EXPECT_MSG_EQ (v->GetVertexId (), Ipv4Address (expected[i]), "Wrong vertex popped at position " << i);
+      delete v;
+    }
+  NS_TEST_EXPECT_MSG_EQ (candidate.Empty (), true, "Candidate queue not empty");
+  NS_TEST_EXPECT_MSG_EQ (candidate.Top (), 0, "Top of an empty queue");
+
+  // Decreasing the distance of a single vertex and reordering it gives the
+  // same order as reordering the whole queue, as SPFNext used to do.
+  std::srand (1);
+  for (int run = 0; run < 20; ++run)
+    {
+      CandidateQueue single;
+      CandidateQueue full;
+      std::vector<uint32_t> distances;
+      for (uint32_t id = 1; id <= 50; ++id)
+        {
+          uint32_t distance = 10 * (1 + std::rand () % 10);
+          bool network = (std::rand () % 3 == 0);
+          distances.push_back (distance);
+          single.Push (CreateVertex (id, distance, network));
+          full.Push (CreateVertex (id, distance, network));
+        }
+      for (int i = 0; i < 100; ++i)
+        {
+          uint32_t id = 1 + std::rand () % 50;
+          uint32_t step = 1 + std::rand () % 5;
+          if (distances[id - 1] < step)
+            {
+              continue;
+            }
+          distances[id - 1] -= step;
+          SPFVertex *s = single.Find (Ipv4Address (id));
+          s->SetDistanceFromRoot (distances[id - 1]);
+          single.Reorder (s);
+          SPFVertex *f = full.Find (Ipv4Address (id));
+          f->SetDistanceFromRoot (distances[id - 1]);
+          full.Reorder ();
+          // pop some vertices on the way, as the SPF calculation does
+          if (i % 10 == 9)
+            {
+              SPFVertex *ps = single.Pop ();
+              SPFVertex *pf = full.Pop ();
+              NS_TEST_EXPECT_MSG_EQ (ps->GetVertexId (), pf->GetVertexId (), "Different vertex popped in run " << run);
+              distances[ps->GetVertexId ().Get () - 1] = 0;
+              delete ps;
+              delete pf;
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (single.Size (), full.Size (), "Different sizes in run " << run);
+      while (!full.Empty ())
+        {
+          SPFVertex *ps = single.Pop ();
+          SPFVertex *pf = full.Pop ();
+          NS_TEST_EXPECT_MSG_EQ (ps->GetVertexId (), pf->GetVertexId (), "Different vertex popped in run " << run);
+          delete ps;
+          delete pf;
+        }
+      NS_TEST_EXPECT_MSG_EQ (single.Empty (), true, "Candidate queue not empty in run " << run);
+    }
+}
+
+class GlobalRouteManagerLSDBTestCase : public TestCase
+{
+public:
+  GlobalRouteManagerLSDBTestCase();
+  virtual void DoRun (void);
+};
+
+GlobalRouteManagerLSDBTestCase::GlobalRouteManagerLSDBTestCase()
+  : TestCase ("GlobalRouteManagerLSDB lookup by link data")
+{
+}
+
+void
+GlobalRouteManagerLSDBTestCase::DoRun (void)
+{
+  // Three routers on a transit network whose designated router is
+  // 10.1.1.1; router 0.0.0.2 also has a stub network and a second transit
+  // network, 10.1.2.1. The LSAs are inserted in a different order than
+  // their addresses.
+  GlobalRouteManagerLSDB* srmlsdb = new GlobalRouteManagerLSDB ();
+  GlobalRoutingLSA* lsas[3];
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      lsas[i] = new GlobalRoutingLSA ();
+      lsas[i]->SetLSType (GlobalRoutingLSA::RouterLSA);
+      lsas[i]->SetLinkStateId (Ipv4Address (i + 1));
+      lsas[i]->SetAdvertisingRouter (Ipv4Address (i + 1));
+      lsas[i]->AddLinkRecord (new GlobalRoutingLinkRecord (
+          GlobalRoutingLinkRecord::TransitNetwork, "10.1.1.1", "10.1.1.1", 1));
+    }
+  lsas[1]->AddLinkRecord (new GlobalRoutingLinkRecord (
+      GlobalRoutingLinkRecord::StubNetwork, "10.1.3.0", "255.255.255.0", 1));
+  lsas[1]->AddLinkRecord (new GlobalRoutingLinkRecord (
+      GlobalRoutingLinkRecord::TransitNetwork, "10.1.2.1", "10.1.2.1", 1));
+  srmlsdb->Insert (lsas[2]->GetLinkStateId (), lsas[2]);
+  srmlsdb->Insert (lsas[1]->GetLinkStateId (), lsas[1]);
+  srmlsdb->Insert (lsas[0]->GetLinkStateId (), lsas[0]);
+
+  // the LSA with the lowest address, which a scan of the database finds
+  // first, whatever the insertion order
+  NS_TEST_EXPECT_MSG_EQ (srmlsdb->GetLSAByLinkData ("10.1.1.1"), lsas[0], "Wrong LSA for a shared link data");
+  NS_TEST_EXPECT_MSG_EQ (srmlsdb->GetLSAByLinkData ("10.1.2.1"), lsas[1], "Wrong LSA for a transit network link record");
+  // the link data of the stub network records are not indexed
+  NS_TEST_EXPECT_MSG_EQ (srmlsdb->GetLSAByLinkData ("255.255.255.0"), 0, "Stub network link data indexed");
+  NS_TEST_EXPECT_MSG_EQ (srmlsdb->GetLSAByLinkData ("10.1.4.1"), 0, "Unknown link data found");
+  NS_TEST_EXPECT_MSG_EQ (srmlsdb->GetLSA (Ipv4Address (2)), lsas[1], "Wrong LSA by address");
+  // the LSAs are indexed in their insertion order
+  NS_TEST_EXPECT_MSG_EQ (lsas[2]->GetIndex (), 0, "Wrong index of the first LSA inserted");
+  NS_TEST_EXPECT_MSG_EQ (lsas[0]->GetIndex (), 2, "Wrong index of the last LSA inserted");
+
+  // inserting an LSA again keeps the first one and its index entries
+  GlobalRoutingLSA* duplicate = new GlobalRoutingLSA ();
+  duplicate->SetLSType (GlobalRoutingLSA::RouterLSA);
+  duplicate->SetLinkStateId (Ipv4Address (2));
+  duplicate->AddLinkRecord (new GlobalRoutingLinkRecord (
+      GlobalRoutingLinkRecord::TransitNetwork, "10.1.5.1", "10.1.5.1", 1));
+  srmlsdb->Insert (duplicate->GetLinkStateId (), duplicate);
+  NS_TEST_EXPECT_MSG_EQ (srmlsdb->GetLSA (Ipv4Address (2)), lsas[1], "LSA replaced by a duplicate");
+  NS_TEST_EXPECT_MSG_EQ (srmlsdb->GetLSAByLinkData ("10.1.5.1"), 0, "Duplicate LSA indexed");
+  NS_TEST_EXPECT_MSG_EQ (lsas[1]->GetIndex (), 1, "LSA index changed by a duplicate");
+
+  delete duplicate;
+  delete srmlsdb;
+}
+
+
 static class GlobalRouteManagerImplTestSuite : public TestSuite
 {
 public:
@@ -221,5 +447,7 @@ public:
     : TestSuite ("global-route-manager-impl", UNIT)
   {
     AddTestCase (new GlobalRouteManagerImplTestCase (), TestCase::QUICK);
+    AddTestCase (new CandidateQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new GlobalRouteManagerLSDBTestCase (), TestCase::QUICK);
   }
 } g_globalRoutingManagerImplTestSuite;
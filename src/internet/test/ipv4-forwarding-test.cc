@@ -36,6 +36,7 @@
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
 
 #include "ns3/traffic-control-layer.h"
 
@@ -72,18 +73,20 @@ AddInternetStack (Ptr<Node> node)
 class Ipv4ForwardingTest : public TestCase
 {
   Ptr<Packet> m_receivedPacket;
+  bool m_forwardingCache;
   void DoSendData (Ptr<Socket> socket, std::string to);
   void SendData (Ptr<Socket> socket, std::string to);
 
 public:
   virtual void DoRun (void);
-  Ipv4ForwardingTest ();
+  Ipv4ForwardingTest (bool forwardingCache);
 
   void ReceivePkt (Ptr<Socket> socket);
 };
 
-Ipv4ForwardingTest::Ipv4ForwardingTest ()
-  : TestCase ("UDP socket implementation")
+Ipv4ForwardingTest::Ipv4ForwardingTest (bool forwardingCache)
+  : TestCase (forwardingCache ? "IPv4 forwarding with the forwarding cache" : "UDP socket implementation"),
+    m_forwardingCache (forwardingCache)
 {
 }
 
@@ -175,6 +178,8 @@ Ipv4ForwardingTest::DoRun (void)
     ipv4StaticRouting->SetDefaultRoute(Ipv4Address("10.1.0.1"), netdev_idx);
   }
 
+  fwNode->GetObject<Ipv4L3Protocol> ()->SetAttribute ("ForwardingCache", BooleanValue (m_forwardingCache));
+
   // link the two nodes
   Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel> ();
   rxDev->SetChannel (channel1);
@@ -203,6 +208,30 @@ Ipv4ForwardingTest::DoRun (void)
   m_receivedPacket->RemoveAllByteTags ();
   m_receivedPacket = 0;
 
+  if (m_forwardingCache)
+    {
+      // The route is found in the cache
+      SendData (txSocket, "10.0.0.2");
+      NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->GetSize (), 123, "IPv4 Forwarding with a cached route");
+
+      // A route change invalidates the cache
+      Ptr<Ipv4StaticRouting> fwRouting = fwNode->GetObject<Ipv4StaticRouting> ();
+      for (uint32_t i = 0; i < fwRouting->GetNRoutes (); i++)
+        {
+          if (fwRouting->GetRoute (i).GetDestNetwork () == Ipv4Address ("10.0.0.0"))
+            {
+              fwRouting->RemoveRoute (i);
+              break;
+            }
+        }
+      SendData (txSocket, "10.0.0.2");
+      NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->GetSize (), 0, "IPv4 Forwarding with a removed route");
+
+      fwRouting->AddNetworkRouteTo (Ipv4Address ("10.0.0.0"), Ipv4Mask (0xffff0000U), 1);
+      SendData (txSocket, "10.0.0.2");
+      NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->GetSize (), 123, "IPv4 Forwarding with a restored route");
+    }
+
   Ptr<Ipv4> ipv4 = fwNode->GetObject<Ipv4> ();
   ipv4->SetAttribute("IpForward", BooleanValue (false));
   SendData (txSocket, "10.0.0.2");
@@ -220,6 +249,7 @@ class Ipv4ForwardingTestSuite : public TestSuite
 public:
   Ipv4ForwardingTestSuite () : TestSuite ("ipv4-forwarding", UNIT)
   {
-    AddTestCase (new Ipv4ForwardingTest, TestCase::QUICK);
+    AddTestCase (new Ipv4ForwardingTest (false), TestCase::QUICK);
+    AddTestCase (new Ipv4ForwardingTest (true), TestCase::QUICK);
   }
 } g_ipv4forwardingTestSuite;
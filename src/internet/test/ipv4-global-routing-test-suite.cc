@@ -14,6 +14,8 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <sstream>
+#include <string>
 #include <vector>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
@@ -1167,6 +1169,107 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class ParallelSpfTest : public TestCase
+{
+public:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  ParallelSpfTest ();
+private:
+  /**
+   * \brief Get the routes of the global routing tables of the nodes
+   * \returns the destination, mask, gateway and interface of every route
+   */
+  std::vector<std::string> GetRoutes (void);
+
+  NodeContainer m_nodes;
+};
+
+ParallelSpfTest::ParallelSpfTest ()
+  : TestCase ("Global routing computed by several threads")
+{
+}
+
+void
+ParallelSpfTest::DoSetup ()
+{
+  // A binary tree of broadcast links, and a LAN between a leaf and two
+  // other nodes
+  m_nodes.Create (17);
+  SimpleNetDeviceHelper simpleHelper;
+  NetDeviceContainer net;
+  for (uint32_t i = 1; i < 15; i++)
+    {
+      Ptr<SimpleChannel> channel = CreateObject <SimpleChannel> ();
+      net.Add (simpleHelper.Install (m_nodes.Get ((i - 1) / 2), channel));
+      net.Add (simpleHelper.Install (m_nodes.Get (i), channel));
+    }
+  Ptr<SimpleChannel> lan = CreateObject <SimpleChannel> ();
+  NetDeviceContainer lanNet;
+  for (uint32_t i = 14; i < 17; i++)
+    {
+      lanNet.Add (simpleHelper.Install (m_nodes.Get (i), lan));
+    }
+
+  InternetStackHelper internet;
+  Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+  internet.SetRoutingHelper (ipv4RoutingHelper);
+  internet.Install (m_nodes);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.0");
+  for (uint32_t i = 0; i < net.GetN (); i += 2)
+    {
+      NetDeviceContainer link;
+      link.Add (net.Get (i));
+      link.Add (net.Get (i + 1));
+      ipv4.Assign (link);
+      ipv4.NewNetwork ();
+    }
+  ipv4.Assign (lanNet);
+}
+
+std::vector<std::string>
+ParallelSpfTest::GetRoutes (void)
+{
+  std::vector<std::string> routes;
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> globalRouting = m_nodes.Get (i)->GetObject<Ipv4L3Protocol> ()
+        ->GetRoutingProtocol ()->GetObject<Ipv4GlobalRouting> ();
+      for (uint32_t j = 0; j < globalRouting->GetNRoutes (); j++)
+        {
+          Ipv4RoutingTableEntry *route = globalRouting->GetRoute (j);
+          std::ostringstream oss;
+          oss << i << " " << route->GetDest () << " " << route->GetDestNetworkMask ()
+              << " " << route->GetGateway () << " " << route->GetInterface ();
+          routes.push_back (oss.str ());
+        }
+    }
+  return routes;
+}
+
+void
+ParallelSpfTest::DoRun ()
+{
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::vector<std::string> routes = GetRoutes ();
+  NS_TEST_ASSERT_MSG_GT (routes.size (), 17 * 14, "Error-- missing routes");
+
+  Config::SetGlobal ("GlobalRoutingNumThreads", UintegerValue (3));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  Config::SetGlobal ("GlobalRoutingNumThreads", UintegerValue (1));
+  std::vector<std::string> parallelRoutes = GetRoutes ();
+
+  NS_TEST_ASSERT_MSG_EQ (parallelRoutes.size (), routes.size (), "Error-- not the same number of routes");
+  for (uint32_t i = 0; i < routes.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (parallelRoutes[i], routes[i], "Error-- different route");
+    }
+
+  Simulator::Destroy ();
+}
+
 class Ipv4GlobalRoutingTestSuite : public TestSuite
 {
 public:
@@ -1184,6 +1287,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
     AddTestCase (new TwoBridgeTest, TestCase::QUICK);
     AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase (new ParallelSpfTest, TestCase::QUICK);
   }
 
 // Do not forget to allocate an instance of this TestSuite
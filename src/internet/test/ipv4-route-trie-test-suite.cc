@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <list>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ipv4-route-trie.h"
+#include "ns3/ipv4-routing-table-entry.h"
+
+using namespace ns3;
+
+/**
+ * Check that the trie finds the same routes as a scan of the route list.
+ */
+class Ipv4RouteTrieLookupTest : public TestCase
+{
+public:
+  Ipv4RouteTrieLookupTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Compare the lookup of an address in the trie with a scan of the routes.
+   *
+   * \param trie the trie
+   * \param routes the routes indexed by the trie, in insertion order
+   * \param dest the address
+   */
+  void CheckLookup (const Ipv4RouteTrie &trie, const std::list<Ipv4RoutingTableEntry *> &routes,
+                    Ipv4Address dest);
+};
+
+Ipv4RouteTrieLookupTest::Ipv4RouteTrieLookupTest ()
+  : TestCase ("Check the routes found by Ipv4RouteTrie")
+{
+}
+
+void
+Ipv4RouteTrieLookupTest::CheckLookup (const Ipv4RouteTrie &trie, const std::list<Ipv4RoutingTableEntry *> &routes,
+                                      Ipv4Address dest)
+{
+  std::vector<Ipv4RoutingTableEntry *> expected;
+  for (std::list<Ipv4RoutingTableEntry *>::const_iterator i = routes.begin (); i != routes.end (); i++)
+    {
+      if ((*i)->GetDestNetworkMask ().IsMatch (dest, (*i)->GetDestNetwork ()))
+        {
+          expected.push_back (*i);
+        }
+    }
+  std::vector<Ipv4RouteTrie::Route> found;
+  trie.Lookup (dest, found);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), expected.size (), "Wrong number of routes to " << dest);
+  for (uint32_t i = 0; i < found.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (found[i].entry, expected[i], "Wrong route " << i << " to " << dest);
+      NS_TEST_EXPECT_MSG_EQ (found[i].metric, expected[i]->GetInterface (), "Wrong metric of route " << i << " to " << dest);
+    }
+}
+
+void
+Ipv4RouteTrieLookupTest::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable> ();
+  rand->SetStream (1);
+  Ipv4RouteTrie trie;
+  std::list<Ipv4RoutingTableEntry *> routes;
+
+  // Overlapping routes of random prefix lengths, many of them with the
+  // same prefix and a few with a non-contiguous mask. The interface of
+  // a route is given as its metric to identify it.
+  for (uint32_t i = 0; i < 400; i++)
+    {
+      uint32_t length = rand->GetInteger (0, 32);
+      uint32_t mask = length == 0 ? 0 : 0xffffffff << (32 - length);
+      if (i % 50 == 0)
+        {
+          mask = 0xff00ff00;
+        }
+      // Keep the addresses within 10.0.0.0/12 to get overlapping prefixes
+      uint32_t network = (10 << 24) | rand->GetInteger (0, 0xfffff);
+      Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
+      *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (Ipv4Address (network & mask), Ipv4Mask (mask), i);
+      routes.push_back (route);
+      trie.Insert (route, i);
+    }
+
+  for (uint32_t round = 0; round < 3; round++)
+    {
+      for (std::list<Ipv4RoutingTableEntry *>::const_iterator i = routes.begin (); i != routes.end (); i++)
+        {
+          CheckLookup (trie, routes, (*i)->GetDestNetwork ());
+        }
+      for (uint32_t i = 0; i < 1000; i++)
+        {
+          CheckLookup (trie, routes, Ipv4Address ((10 << 24) | rand->GetInteger (0, 0xfffff)));
+        }
+      CheckLookup (trie, routes, Ipv4Address ("192.168.0.1"));
+
+      // Remove a third of the routes
+      for (std::list<Ipv4RoutingTableEntry *>::iterator i = routes.begin (); i != routes.end (); )
+        {
+          if (rand->GetInteger (0, 2) == 0)
+            {
+              trie.Remove (*i);
+              delete *i;
+              i = routes.erase (i);
+            }
+          else
+            {
+              i++;
+            }
+        }
+    }
+
+  trie.Clear ();
+  std::vector<Ipv4RouteTrie::Route> found;
+  trie.Lookup (Ipv4Address ("10.0.0.1"), found);
+  NS_TEST_EXPECT_MSG_EQ (found.size (), 0, "Routes found in a cleared trie");
+  for (std::list<Ipv4RoutingTableEntry *>::iterator i = routes.begin (); i != routes.end (); i++)
+    {
+      delete *i;
+    }
+}
+
+/**
+ * Ipv4RouteTrie TestSuite
+ */
+class Ipv4RouteTrieTestSuite : public TestSuite
+{
+public:
+  Ipv4RouteTrieTestSuite ();
+};
+
+Ipv4RouteTrieTestSuite::Ipv4RouteTrieTestSuite ()
+  : TestSuite ("ipv4-route-trie", UNIT)
+{
+  AddTestCase (new Ipv4RouteTrieLookupTest, TestCase::QUICK);
+}
+
+static Ipv4RouteTrieTestSuite g_ipv4RouteTrieTestSuite;
@@ -0,0 +1,275 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/ipv6-interface.h"
+#include "../model/ipv6-end-point.h"
+#include "../model/ipv6-end-point-demux.h"
+
+using namespace ns3;
+
+/**
+ * Check the precedence of the matches returned by Ipv6EndPointDemux::Lookup:
+ * the exact four-tuple over the wildcard peer, over the wildcard local
+ * address, over the local port only, and the endpoints bound to another
+ * device than the incoming one are skipped.
+ */
+class Ipv6EndPointDemuxLookupTest : public TestCase
+{
+public:
+  Ipv6EndPointDemuxLookupTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Check that a lookup returns a single endpoint.
+   *
+   * \param endPoints the result of the lookup
+   * \param expected the expected endpoint
+   * \param msg the message of the failed checks
+   */
+  void CheckSingle (const Ipv6EndPointDemux::EndPoints &endPoints, Ipv6EndPoint *expected, std::string msg);
+};
+
+Ipv6EndPointDemuxLookupTest::Ipv6EndPointDemuxLookupTest ()
+  : TestCase ("Ipv6EndPointDemux lookup precedence")
+{
+}
+
+void
+Ipv6EndPointDemuxLookupTest::CheckSingle (const Ipv6EndPointDemux::EndPoints &endPoints, Ipv6EndPoint *expected, std::string msg)
+{
+  NS_TEST_EXPECT_MSG_EQ (endPoints.size (), 1, msg << ": wrong number of endpoints");
+  if (!endPoints.empty ())
+    {
+      NS_TEST_EXPECT_MSG_EQ (endPoints.front (), expected, msg << ": wrong endpoint");
+    }
+}
+
+void
+Ipv6EndPointDemuxLookupTest::DoRun (void)
+{
+  Ptr<SimpleNetDevice> device1 = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> device2 = CreateObject<SimpleNetDevice> ();
+  Ptr<Ipv6Interface> interface1 = CreateObject<Ipv6Interface> ();
+  interface1->SetDevice (device1);
+  Ptr<Ipv6Interface> interface2 = CreateObject<Ipv6Interface> ();
+  interface2->SetDevice (device2);
+
+  Ipv6Address local ("2001:db8::1");
+  Ipv6Address other ("2001:db8::9");
+  Ipv6Address peer ("2001:db8::2");
+  Ipv6Address boundPeer ("2001:db8::3");
+
+  Ipv6EndPointDemux demux;
+  Ipv6EndPoint *portOnly = demux.Allocate (80);
+  Ipv6EndPoint *localOnly = demux.Allocate (local, 80);
+  Ipv6EndPoint *peerOnly = demux.Allocate (Ipv6Address::GetAny (), 80, peer, 1234);
+  Ipv6EndPoint *exact = demux.Allocate (local, 80, peer, 1234);
+  Ipv6EndPoint *bound = demux.Allocate (local, 80, boundPeer, 1234);
+  bound->BindToNetDevice (device2);
+  Ipv6EndPoint *otherPort = demux.Allocate (local, 81, peer, 1234);
+  NS_TEST_ASSERT_MSG_NE (portOnly, 0, "Allocation failed");
+  NS_TEST_ASSERT_MSG_NE (localOnly, 0, "Allocation failed");
+  NS_TEST_ASSERT_MSG_NE (peerOnly, 0, "Allocation failed");
+  NS_TEST_ASSERT_MSG_NE (exact, 0, "Allocation failed");
+  NS_TEST_ASSERT_MSG_NE (bound, 0, "Allocation failed");
+  NS_TEST_ASSERT_MSG_NE (otherPort, 0, "Allocation failed");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80, peer, 1234), 0, "Duplicate four-tuple allocated");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80), 0, "Duplicate local address and port allocated");
+
+  CheckSingle (demux.Lookup (local, 80, peer, 1234, interface1), exact, "exact match");
+  CheckSingle (demux.Lookup (other, 80, peer, 1234, interface1), peerOnly, "wildcard local address");
+  CheckSingle (demux.Lookup (local, 80, peer, 999, interface1), localOnly, "wildcard peer");
+  CheckSingle (demux.Lookup (other, 80, peer, 999, interface1), portOnly, "local port only");
+  CheckSingle (demux.Lookup (local, 81, peer, 1234, interface1), otherPort, "other local port");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 82, peer, 1234, interface1).size (), 0, "Match on an unused port");
+
+  // the bound endpoint only matches the packets received on its device
+  CheckSingle (demux.Lookup (local, 80, boundPeer, 1234, interface2), bound, "bound endpoint on its device");
+  CheckSingle (demux.Lookup (local, 80, boundPeer, 1234, interface1), localOnly, "bound endpoint on another device");
+
+  // an endpoint which cannot receive is skipped
+  exact->SetRxEnabled (false);
+  CheckSingle (demux.Lookup (local, 80, peer, 1234, interface1), peerOnly, "endpoint not receiving");
+  exact->SetRxEnabled (true);
+
+  // without a source port, the local port bucket is scanned
+  CheckSingle (demux.Lookup (local, 80, Ipv6Address::GetAny (), 0, interface1), localOnly, "wildcard source");
+  CheckSingle (demux.Lookup (other, 80, Ipv6Address::GetAny (), 0, interface1), portOnly, "wildcard source and other address");
+
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1234), exact, "SimpleLookup exact match");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 81, peer, 1234), otherPort, "SimpleLookup other local port");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 82, peer, 1234), 0, "SimpleLookup match on an unused port");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (81), true, "Port 81 not found");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupLocal (local, 80), true, "Local address and port not found");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupLocal (other, 80), false, "Unused local address found");
+
+  // once deallocated, an endpoint is no longer found
+  demux.DeAllocate (exact);
+  CheckSingle (demux.Lookup (local, 80, peer, 1234, interface1), peerOnly, "deallocated exact match");
+  demux.DeAllocate (otherPort);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (81), false, "Port 81 still found");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 81, peer, 1234, interface1).size (), 0, "Deallocated endpoint found");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetEndPoints ().size (), 4, "Wrong number of endpoints");
+}
+
+/**
+ * Check that the endpoints are indexed again when their four-tuple changes.
+ */
+class Ipv6EndPointDemuxReindexTest : public TestCase
+{
+public:
+  Ipv6EndPointDemuxReindexTest ();
+  virtual void DoRun (void);
+};
+
+Ipv6EndPointDemuxReindexTest::Ipv6EndPointDemuxReindexTest ()
+  : TestCase ("Ipv6EndPointDemux indexes after SetLocalAddress and SetPeer")
+{
+}
+
+void
+Ipv6EndPointDemuxReindexTest::DoRun (void)
+{
+  Ptr<Ipv6Interface> interface = CreateObject<Ipv6Interface> ();
+  interface->SetDevice (CreateObject<SimpleNetDevice> ());
+
+  Ipv6Address local ("2001:db8::1");
+  Ipv6Address other ("2001:db8::9");
+  Ipv6Address peer ("2001:db8::2");
+
+  Ipv6EndPointDemux demux;
+  Ipv6EndPoint *endPoint = demux.Allocate (80);
+  NS_TEST_ASSERT_MSG_NE (endPoint, 0, "Allocation failed");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (other, 80, peer, 1234, interface).size (), 1, "Wildcard endpoint not found");
+
+  endPoint->SetLocalAddress (local);
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (other, 80, peer, 1234, interface).size (), 0, "Endpoint found on its former address");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer, 1234, interface).size (), 1, "Endpoint not found on its new address");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupLocal (local, 80), true, "New local address not found");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupLocal (Ipv6Address::GetAny (), 80), false, "Former local address found");
+
+  endPoint->SetPeer (peer, 1234);
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer, 1234, interface).size (), 1, "Connected endpoint not found");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer, 999, interface).size (), 0, "Connected endpoint found for another peer");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1234), endPoint, "SimpleLookup after SetPeer");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80, peer, 1234), 0, "Four-tuple of a connected endpoint allocated");
+
+  // another endpoint can use the four-tuple once the peer changed
+  endPoint->SetPeer (peer, 4321);
+  Ipv6EndPoint *second = demux.Allocate (local, 80, peer, 1234);
+  NS_TEST_ASSERT_MSG_NE (second, 0, "Released four-tuple not allocated");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer, 1234, interface).front (), second, "Wrong endpoint for the released four-tuple");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer, 4321, interface).front (), endPoint, "Wrong endpoint for the new four-tuple");
+
+  // the port bucket follows the endpoints
+  demux.DeAllocate (second);
+  endPoint->SetPeer (Ipv6Address::GetAny (), 0);
+  endPoint->SetLocalAddress (Ipv6Address::GetAny ());
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (other, 80, peer, 1234, interface).front (), endPoint, "Endpoint not found after a reset");
+  demux.DeAllocate (endPoint);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), false, "Port still in use");
+}
+
+/**
+ * Check that destroying an indexed endpoint leaves no stale index entry,
+ * even when its destroy callback changes its four-tuple, and that
+ * destroying the demux destroys its endpoints.
+ */
+class Ipv6EndPointDemuxDestroyTest : public TestCase
+{
+public:
+  Ipv6EndPointDemuxDestroyTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Destroy callback of an endpoint, which changes its four-tuple as a
+   * socket may do when it is notified.
+   *
+   * \param endPoint the endpoint being destroyed
+   */
+  void Destroyed (Ipv6EndPoint *endPoint);
+
+  uint32_t m_destroyed; //!< number of destroyed endpoints
+};
+
+Ipv6EndPointDemuxDestroyTest::Ipv6EndPointDemuxDestroyTest ()
+  : TestCase ("Ipv6EndPointDemux endpoints destroyed while indexed"),
+    m_destroyed (0)
+{
+}
+
+void
+Ipv6EndPointDemuxDestroyTest::Destroyed (Ipv6EndPoint *endPoint)
+{
+  m_destroyed++;
+  endPoint->SetPeer (Ipv6Address ("2001:db8::7"), 7);
+  endPoint->SetLocalAddress (Ipv6Address ("2001:db8::8"));
+}
+
+void
+Ipv6EndPointDemuxDestroyTest::DoRun (void)
+{
+  Ptr<Ipv6Interface> interface = CreateObject<Ipv6Interface> ();
+  interface->SetDevice (CreateObject<SimpleNetDevice> ());
+
+  Ipv6Address local ("2001:db8::1");
+  Ipv6Address peer ("2001:db8::2");
+
+  Ipv6EndPointDemux *demux = new Ipv6EndPointDemux;
+  Ipv6EndPoint *listening = demux->Allocate (local, 80);
+  Ipv6EndPoint *connected = demux->Allocate (local, 80, peer, 1234);
+  connected->SetDestroyCallback (MakeCallback (&Ipv6EndPointDemuxDestroyTest::Destroyed, this).Bind (connected));
+  listening->SetDestroyCallback (MakeCallback (&Ipv6EndPointDemuxDestroyTest::Destroyed, this).Bind (listening));
+
+  demux->DeAllocate (connected);
+  NS_TEST_EXPECT_MSG_EQ (m_destroyed, 1, "Destroy callback not called");
+  NS_TEST_EXPECT_MSG_EQ (demux->GetEndPoints ().size (), 1, "Wrong number of endpoints");
+  NS_TEST_EXPECT_MSG_EQ (demux->Lookup (local, 80, peer, 1234, interface).front (), listening, "Destroyed endpoint found");
+  NS_TEST_EXPECT_MSG_EQ (demux->Lookup (Ipv6Address ("2001:db8::8"), 80, Ipv6Address ("2001:db8::7"), 7, interface).size (), 0,
+                         "Destroyed endpoint indexed with the four-tuple set by its destroy callback");
+  NS_TEST_EXPECT_MSG_EQ (demux->SimpleLookup (local, 80, peer, 1234), listening, "Destroyed endpoint found by SimpleLookup");
+  Ipv6EndPoint *reconnected = demux->Allocate (local, 80, peer, 1234);
+  NS_TEST_EXPECT_MSG_NE (reconnected, 0, "Four-tuple of a destroyed endpoint not released");
+  reconnected->SetDestroyCallback (MakeCallback (&Ipv6EndPointDemuxDestroyTest::Destroyed, this).Bind (reconnected));
+
+  // the destroy callbacks of the remaining endpoints must not index them
+  // in the demux being destroyed
+  delete demux;
+  NS_TEST_EXPECT_MSG_EQ (m_destroyed, 3, "Endpoints not destroyed with their demux");
+}
+
+/**
+ * IPv6 endpoint demux TestSuite
+ */
+class Ipv6EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  Ipv6EndPointDemuxTestSuite ();
+};
+
+Ipv6EndPointDemuxTestSuite::Ipv6EndPointDemuxTestSuite ()
+  : TestSuite ("ipv6-end-point-demux", UNIT)
+{
+  AddTestCase (new Ipv6EndPointDemuxLookupTest, TestCase::QUICK);
+  AddTestCase (new Ipv6EndPointDemuxReindexTest, TestCase::QUICK);
+  AddTestCase (new Ipv6EndPointDemuxDestroyTest, TestCase::QUICK);
+}
+
+static Ipv6EndPointDemuxTestSuite g_ipv6EndPointDemuxTestSuite;
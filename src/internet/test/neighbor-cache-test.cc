@@ -0,0 +1,420 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/ndisc-cache.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/packet.h"
+#include "ns3/simple-channel.h"
+#include "ns3/bridge-helper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the neighbor caches filled by NeighborCacheHelper
+ * resolve the addresses of the nodes on the same link without any
+ * ARP or NDISC exchange.
+ */
+class NeighborCachePopulateTest : public TestCase
+{
+public:
+  NeighborCachePopulateTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Send a packet
+   * \param socket the sending socket
+   * \param to the destination
+   */
+  void SendData (Ptr<Socket> socket, Address to);
+  /**
+   * \brief Receive the packets
+   * \param socket the receiving socket
+   */
+  void ReceivePkt (Ptr<Socket> socket);
+
+  uint32_t m_received;  //!< number of packets received
+  Time m_sent;          //!< time of the last transmission
+  Time m_delay;         //!< largest delay of a packet
+};
+
+NeighborCachePopulateTest::NeighborCachePopulateTest ()
+  : TestCase ("Check the static population of the ARP and NDISC caches"),
+    m_received (0)
+{
+}
+
+void
+NeighborCachePopulateTest::SendData (Ptr<Socket> socket, Address to)
+{
+  m_sent = Simulator::Now ();
+  NS_TEST_EXPECT_MSG_EQ (socket->SendTo (Create<Packet> (123), 0, to), 123, "Packet not sent");
+}
+
+void
+NeighborCachePopulateTest::ReceivePkt (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      m_received++;
+      m_delay = Max (m_delay, Simulator::Now () - m_sent);
+    }
+}
+
+void
+NeighborCachePopulateTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4Address;
+  ipv4Address.SetBase ("10.0.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer ipv4Interfaces = ipv4Address.Assign (devices);
+  Ipv6AddressHelper ipv6Address;
+  ipv6Address.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer ipv6Interfaces = ipv6Address.Assign (devices);
+
+  NeighborCacheHelper::PopulateNeighborCache ();
+
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4L3Protocol> ipv4 = nodes.Get (i)->GetObject<Ipv4L3Protocol> ();
+      Ptr<ArpCache> arpCache = ipv4->GetInterface (1)->GetArpCache ();
+      Ptr<Ipv6L3Protocol> ipv6 = nodes.Get (i)->GetObject<Ipv6L3Protocol> ();
+      Ptr<NdiscCache> ndiscCache = ipv6->GetInterface (1)->GetNdiscCache ();
+      for (uint32_t j = 0; j < nodes.GetN (); j++)
+        {
+          ArpCache::Entry *arpEntry = arpCache->Lookup (ipv4Interfaces.GetAddress (j));
+          NdiscCache::Entry *ndiscEntry = ndiscCache->Lookup (ipv6Interfaces.GetAddress (j, 1));
+          if (i == j)
+            {
+              NS_TEST_EXPECT_MSG_EQ (arpEntry, 0, "Node " << i << " has an ARP entry for itself");
+              NS_TEST_EXPECT_MSG_EQ (ndiscEntry, 0, "Node " << i << " has an NDISC entry for itself");
+              continue;
+            }
+          NS_TEST_ASSERT_MSG_NE (arpEntry, 0, "No ARP entry for node " << j << " in node " << i);
+          NS_TEST_EXPECT_MSG_EQ (arpEntry->IsPermanent (), true, "ARP entry not permanent");
+          NS_TEST_EXPECT_MSG_EQ (arpEntry->GetMacAddress (), devices.Get (j)->GetAddress (), "Wrong ARP entry");
+          NS_TEST_ASSERT_MSG_NE (ndiscEntry, 0, "No NDISC entry for node " << j << " in node " << i);
+          NS_TEST_EXPECT_MSG_EQ (ndiscEntry->IsPermanent (), true, "NDISC entry not permanent");
+          NS_TEST_EXPECT_MSG_EQ (ndiscEntry->GetMacAddress (), devices.Get (j)->GetAddress (), "Wrong NDISC entry");
+          // The link-local addresses are resolved as well
+          ndiscEntry = ndiscCache->Lookup (ipv6Interfaces.GetAddress (j, 0));
+          NS_TEST_ASSERT_MSG_NE (ndiscEntry, 0, "No link-local NDISC entry for node " << j << " in node " << i);
+        }
+    }
+
+  Ptr<Socket> rxSocket = Socket::CreateSocket (nodes.Get (2), UdpSocketFactory::GetTypeId ());
+  rxSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), 1234));
+  rxSocket->SetRecvCallback (MakeCallback (&NeighborCachePopulateTest::ReceivePkt, this));
+  Ptr<Socket> rxSocket6 = Socket::CreateSocket (nodes.Get (2), UdpSocketFactory::GetTypeId ());
+  rxSocket6->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 1234));
+  rxSocket6->SetRecvCallback (MakeCallback (&NeighborCachePopulateTest::ReceivePkt, this));
+
+  Ptr<Socket> txSocket = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  Ptr<Socket> txSocket6 = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  txSocket6->Bind6 ();
+
+  // The transmissions are not delayed by an address resolution
+  Simulator::Schedule (Seconds (1), &NeighborCachePopulateTest::SendData, this, txSocket,
+                       InetSocketAddress (ipv4Interfaces.GetAddress (2), 1234));
+  Simulator::Schedule (Seconds (5), &NeighborCachePopulateTest::SendData, this, txSocket6,
+                       Inet6SocketAddress (ipv6Interfaces.GetAddress (2, 1), 1234));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, 2, "Packets not received");
+  NS_TEST_EXPECT_MSG_EQ (m_delay, Seconds (0), "Packets delayed by an address resolution");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that NeighborCacheHelper treats the broadcast segments
+ * joined by a bridge as a single link, and no other.
+ *
+ * \verbatim
+     n0    n1         n3
+     |     |  10.0.1.0 |
+   ===========   ===========
+     10.0.0.0 |     |
+              br    |
+              |     |
+            ===========
+                   |
+                   n2
+   \endverbatim
+ *
+ * n0, n1 and n2 share 10.0.0.0/24 through the bridge br, which has no IP
+ * stack; n1 and n3 share 10.0.1.0/24 on another segment. Each segment
+ * has a delay of 1 ms.
+ */
+class NeighborCacheBridgeTest : public TestCase
+{
+public:
+  NeighborCacheBridgeTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Send a packet
+   * \param socket the sending socket
+   * \param to the destination
+   */
+  void SendData (Ptr<Socket> socket, Address to);
+  /**
+   * \brief Receive the packets
+   * \param socket the receiving socket
+   */
+  void ReceivePkt (Ptr<Socket> socket);
+
+  uint32_t m_received;  //!< number of packets received
+  Time m_sent;          //!< time of the last transmission
+  Time m_delay;         //!< largest delay of a packet
+};
+
+NeighborCacheBridgeTest::NeighborCacheBridgeTest ()
+  : TestCase ("Check the static population of the neighbor caches across a bridge"),
+    m_received (0)
+{
+}
+
+void
+NeighborCacheBridgeTest::SendData (Ptr<Socket> socket, Address to)
+{
+  m_sent = Simulator::Now ();
+  NS_TEST_EXPECT_MSG_EQ (socket->SendTo (Create<Packet> (123), 0, to), 123, "Packet not sent");
+}
+
+void
+NeighborCacheBridgeTest::ReceivePkt (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      m_received++;
+      m_delay = Max (m_delay, Simulator::Now () - m_sent);
+    }
+}
+
+void
+NeighborCacheBridgeTest::DoRun (void)
+{
+  NodeContainer hosts;
+  hosts.Create (4);
+  Ptr<Node> bridgeNode = CreateObject<Node> ();
+
+  SimpleNetDeviceHelper simple;
+  Ptr<SimpleChannel> channelA = CreateObject<SimpleChannel> ();
+  Ptr<SimpleChannel> channelB = CreateObject<SimpleChannel> ();
+  Ptr<SimpleChannel> channelC = CreateObject<SimpleChannel> ();
+  channelA->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+  channelB->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+  channelC->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+
+  NetDeviceContainer bridgedDevices;
+  bridgedDevices.Add (simple.Install (hosts.Get (0), channelA));
+  bridgedDevices.Add (simple.Install (hosts.Get (1), channelA));
+  bridgedDevices.Add (simple.Install (hosts.Get (2), channelB));
+  NetDeviceContainer switchDevices;
+  switchDevices.Add (simple.Install (bridgeNode, channelA));
+  switchDevices.Add (simple.Install (bridgeNode, channelB));
+  BridgeHelper bridge;
+  bridge.Install (bridgeNode, switchDevices);
+  NetDeviceContainer otherDevices;
+  otherDevices.Add (simple.Install (hosts.Get (1), channelC));
+  otherDevices.Add (simple.Install (hosts.Get (3), channelC));
+
+  InternetStackHelper internet;
+  internet.Install (hosts);
+  Ipv4AddressHelper ipv4Address;
+  ipv4Address.SetBase ("10.0.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer bridgedInterfaces = ipv4Address.Assign (bridgedDevices);
+  ipv4Address.SetBase ("10.0.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer otherInterfaces = ipv4Address.Assign (otherDevices);
+  Ipv6AddressHelper ipv6Address;
+  ipv6Address.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer bridgedInterfaces6 = ipv6Address.Assign (bridgedDevices);
+
+  NeighborCacheHelper::PopulateNeighborCache ();
+
+  // The hosts on both sides of the bridge know each other
+  for (uint32_t i = 0; i < bridgedDevices.GetN (); i++)
+    {
+      Ptr<Ipv4L3Protocol> ipv4 = hosts.Get (i)->GetObject<Ipv4L3Protocol> ();
+      Ptr<ArpCache> arpCache = ipv4->GetInterface (1)->GetArpCache ();
+      Ptr<Ipv6L3Protocol> ipv6 = hosts.Get (i)->GetObject<Ipv6L3Protocol> ();
+      Ptr<NdiscCache> ndiscCache = ipv6->GetInterface (1)->GetNdiscCache ();
+      for (uint32_t j = 0; j < bridgedDevices.GetN (); j++)
+        {
+          if (i == j)
+            {
+              continue;
+            }
+          ArpCache::Entry *arpEntry = arpCache->Lookup (bridgedInterfaces.GetAddress (j));
+          NS_TEST_ASSERT_MSG_NE (arpEntry, 0, "No ARP entry for host " << j << " in host " << i);
+          NS_TEST_EXPECT_MSG_EQ (arpEntry->IsPermanent (), true, "ARP entry not permanent");
+          NS_TEST_EXPECT_MSG_EQ (arpEntry->GetMacAddress (), bridgedDevices.Get (j)->GetAddress (), "Wrong ARP entry");
+          NdiscCache::Entry *ndiscEntry = ndiscCache->Lookup (bridgedInterfaces6.GetAddress (j, 1));
+          NS_TEST_ASSERT_MSG_NE (ndiscEntry, 0, "No NDISC entry for host " << j << " in host " << i);
+          NS_TEST_EXPECT_MSG_EQ (ndiscEntry->GetMacAddress (), bridgedDevices.Get (j)->GetAddress (), "Wrong NDISC entry");
+        }
+      // the host of the other segment is not on the link
+      NS_TEST_EXPECT_MSG_EQ (arpCache->Lookup (otherInterfaces.GetAddress (1)), 0,
+                             "Host " << i << " has an entry for a host of another link");
+    }
+  // Nor are the hosts of the bridged link on the other segment
+  Ptr<ArpCache> otherCache = hosts.Get (3)->GetObject<Ipv4L3Protocol> ()->GetInterface (1)->GetArpCache ();
+  NS_TEST_ASSERT_MSG_NE (otherCache->Lookup (otherInterfaces.GetAddress (0)), 0, "No ARP entry for host 1 in host 3");
+  NS_TEST_EXPECT_MSG_EQ (otherCache->Lookup (bridgedInterfaces.GetAddress (0)), 0,
+                         "Host 3 has an entry for a host of another link");
+
+  Ptr<Socket> rxSocket = Socket::CreateSocket (hosts.Get (2), UdpSocketFactory::GetTypeId ());
+  rxSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), 1234));
+  rxSocket->SetRecvCallback (MakeCallback (&NeighborCacheBridgeTest::ReceivePkt, this));
+  Ptr<Socket> rxSocket6 = Socket::CreateSocket (hosts.Get (2), UdpSocketFactory::GetTypeId ());
+  rxSocket6->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 1234));
+  rxSocket6->SetRecvCallback (MakeCallback (&NeighborCacheBridgeTest::ReceivePkt, this));
+
+  Ptr<Socket> txSocket = Socket::CreateSocket (hosts.Get (0), UdpSocketFactory::GetTypeId ());
+  Ptr<Socket> txSocket6 = Socket::CreateSocket (hosts.Get (0), UdpSocketFactory::GetTypeId ());
+  txSocket6->Bind6 ();
+
+  // The packets cross the two segments, without an address resolution
+  Simulator::Schedule (Seconds (1), &NeighborCacheBridgeTest::SendData, this, txSocket,
+                       InetSocketAddress (bridgedInterfaces.GetAddress (2), 1234));
+  Simulator::Schedule (Seconds (5), &NeighborCacheBridgeTest::SendData, this, txSocket6,
+                       Inet6SocketAddress (bridgedInterfaces6.GetAddress (2, 1), 1234));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, 2, "Packets not received");
+  NS_TEST_EXPECT_MSG_EQ (m_delay, MilliSeconds (2), "Packets delayed by an address resolution");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the reachability confirmations push back the
+ * expiration of the REACHABLE state of an NdiscCache entry.
+ */
+class NdiscCacheReachableTimerTest : public TestCase
+{
+public:
+  NdiscCacheReachableTimerTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Check the state of the entry
+   * \param reachable true if the entry should be reachable
+   */
+  void CheckReachable (bool reachable);
+
+  NdiscCache::Entry *m_entry;  //!< the entry
+};
+
+NdiscCacheReachableTimerTest::NdiscCacheReachableTimerTest ()
+  : TestCase ("Check the expiration of the reachable timer of the NdiscCache"),
+    m_entry (0)
+{
+}
+
+void
+NdiscCacheReachableTimerTest::CheckReachable (bool reachable)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_entry->IsReachable (), reachable, "Wrong state at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ (m_entry->IsStale (), !reachable, "Wrong state at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+NdiscCacheReachableTimerTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+  InternetStackHelper internet;
+  internet.SetIpv4StackInstall (false);
+  internet.Install (nodes);
+  Ptr<Ipv6L3Protocol> ipv6 = nodes.Get (0)->GetObject<Ipv6L3Protocol> ();
+  ipv6->AddInterface (devices.Get (0));
+  Ptr<NdiscCache> cache = ipv6->GetInterface (1)->GetNdiscCache ();
+
+  m_entry = cache->Add (Ipv6Address ("2001:1::1"));
+  m_entry->MarkReachable (Mac48Address::Allocate ());
+  m_entry->StartReachableTimer ();
+
+  Time reachableTime = MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME);
+  Time confirmation = Seconds (10);
+  Simulator::Schedule (confirmation, &NdiscCache::Entry::UpdateReachableTimer, m_entry);
+  Simulator::Schedule (reachableTime - Seconds (1), &NdiscCacheReachableTimerTest::CheckReachable, this, true);
+  Simulator::Schedule (reachableTime + Seconds (1), &NdiscCacheReachableTimerTest::CheckReachable, this, true);
+  Simulator::Schedule (confirmation + reachableTime - Seconds (1), &NdiscCacheReachableTimerTest::CheckReachable, this, true);
+  Simulator::Schedule (confirmation + reachableTime + Seconds (1), &NdiscCacheReachableTimerTest::CheckReachable, this, false);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Neighbor caches TestSuite
+ */
+class NeighborCacheTestSuite : public TestSuite
+{
+public:
+  NeighborCacheTestSuite ();
+};
+
+NeighborCacheTestSuite::NeighborCacheTestSuite ()
+  : TestSuite ("neighbor-cache", UNIT)
+{
+  AddTestCase (new NeighborCachePopulateTest, TestCase::QUICK);
+  AddTestCase (new NeighborCacheBridgeTest, TestCase::QUICK);
+  AddTestCase (new NdiscCacheReachableTimerTest, TestCase::QUICK);
+}
+
+static NeighborCacheTestSuite g_neighborCacheTestSuite;
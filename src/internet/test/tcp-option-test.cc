@@ -20,8 +20,11 @@
 #include "ns3/test.h"
 #include "ns3/core-module.h"
 #include "ns3/tcp-option.h"
+#include "ns3/tcp-header.h"
 #include "ns3/private/tcp-option-winscale.h"
 #include "ns3/private/tcp-option-ts.h"
+#include "ns3/tcp-option-sack-permitted.h"
+#include "ns3/tcp-option-sack.h"
 
 #include <string.h>
 
@@ -164,6 +167,179 @@ TcpOptionTSTestCase::DoTeardown ()
 {
 }
 
+class TcpOptionSackTestCase : public TestCase
+{
+public:
+  TcpOptionSackTestCase (std::string name);
+
+  void TestSerialize ();
+  void TestDeserialize ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  TcpOptionSack::SackList m_list;
+  Buffer m_buffer;
+};
+
+
+TcpOptionSackTestCase::TcpOptionSackTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+TcpOptionSackTestCase::DoRun ()
+{
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      m_list.clear ();
+      uint32_t blocks = x->GetInteger (1, 4);
+      for (uint32_t j = 0; j < blocks; ++j)
+        {
+          SequenceNumber32 start (x->GetInteger ());
+          m_list.push_back (TcpOptionSack::SackBlock (start, start + x->GetInteger (1, 65535)));
+        }
+      TestSerialize ();
+      TestDeserialize ();
+    }
+}
+
+void
+TcpOptionSackTestCase::TestSerialize ()
+{
+  TcpOptionSack opt;
+
+  for (TcpOptionSack::SackList::const_iterator it = m_list.begin (); it != m_list.end (); ++it)
+    {
+      opt.AddSackBlock (*it);
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (opt.GetNumSackBlocks (), m_list.size (), "Blocks aren't saved correctly");
+  NS_TEST_EXPECT_MSG_EQ (opt.GetSerializedSize (), 2 + 8 * m_list.size (), "Wrong serialized size");
+
+  m_buffer.AddAtStart (opt.GetSerializedSize ());
+
+  opt.Serialize (m_buffer.Begin ());
+}
+
+void
+TcpOptionSackTestCase::TestDeserialize ()
+{
+  TcpOptionSack opt;
+
+  Buffer::Iterator start = m_buffer.Begin ();
+  uint8_t kind = start.PeekU8 ();
+
+  NS_TEST_EXPECT_MSG_EQ (kind, TcpOption::SACK, "Different kind found");
+
+  opt.Deserialize (start);
+
+  TcpOptionSack::SackList list = opt.GetSackList ();
+  NS_TEST_ASSERT_MSG_EQ (list.size (), m_list.size (), "Different number of blocks found");
+  TcpOptionSack::SackList::const_iterator it = m_list.begin ();
+  for (TcpOptionSack::SackList::const_iterator jt = list.begin (); jt != list.end (); ++jt, ++it)
+    {
+      NS_TEST_EXPECT_MSG_EQ (jt->first, it->first, "Different block start found");
+      NS_TEST_EXPECT_MSG_EQ (jt->second, it->second, "Different block end found");
+    }
+}
+
+void
+TcpOptionSackTestCase::DoTeardown ()
+{
+}
+
+class TcpOptionSackPermittedTestCase : public TestCase
+{
+public:
+  TcpOptionSackPermittedTestCase (std::string name);
+
+private:
+  virtual void DoRun (void);
+  void TestOption ();
+  void TestMalformed ();
+  void TestHeader ();
+};
+
+
+TcpOptionSackPermittedTestCase::TcpOptionSackPermittedTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+TcpOptionSackPermittedTestCase::DoRun ()
+{
+  TestOption ();
+  TestMalformed ();
+  TestHeader ();
+}
+
+void
+TcpOptionSackPermittedTestCase::TestOption ()
+{
+  TcpOptionSackPermitted opt;
+  Buffer buffer;
+
+  NS_TEST_EXPECT_MSG_EQ (opt.GetKind (), TcpOption::SACKPERMITTED, "Wrong kind");
+  NS_TEST_EXPECT_MSG_EQ (opt.GetSerializedSize (), 2, "Wrong serialized size");
+
+  buffer.AddAtStart (opt.GetSerializedSize ());
+  opt.Serialize (buffer.Begin ());
+
+  Buffer::Iterator i = buffer.Begin ();
+  NS_TEST_EXPECT_MSG_EQ (i.ReadU8 (), TcpOption::SACKPERMITTED, "Different kind found");
+  NS_TEST_EXPECT_MSG_EQ (i.ReadU8 (), 2, "Different length found");
+
+  TcpOptionSackPermitted dest;
+  NS_TEST_EXPECT_MSG_EQ (dest.Deserialize (buffer.Begin ()), 2, "Wrong deserialized size");
+}
+
+void
+TcpOptionSackPermittedTestCase::TestMalformed ()
+{
+  TcpOptionSackPermitted opt;
+  Buffer buffer;
+  buffer.AddAtStart (2);
+
+  Buffer::Iterator i = buffer.Begin ();
+  i.WriteU8 (TcpOption::SACKPERMITTED);
+  i.WriteU8 (4);
+  NS_TEST_EXPECT_MSG_EQ (opt.Deserialize (buffer.Begin ()), 0, "Wrong length accepted");
+
+  i = buffer.Begin ();
+  i.WriteU8 (TcpOption::SACK);
+  i.WriteU8 (2);
+  NS_TEST_EXPECT_MSG_EQ (opt.Deserialize (buffer.Begin ()), 0, "Wrong kind accepted");
+}
+
+void
+TcpOptionSackPermittedTestCase::TestHeader ()
+{
+  // The option as carried by a SYN, along with the timestamps
+  TcpHeader source, destination;
+  source.SetFlags (TcpHeader::SYN);
+  source.AppendOption (CreateObject<TcpOptionSackPermitted> ());
+  source.AppendOption (CreateObject<TcpOptionTS> ());
+  NS_TEST_EXPECT_MSG_EQ (source.GetLength (), 5 + 3, "Wrong header length");
+
+  Buffer buffer;
+  buffer.AddAtStart (source.GetSerializedSize ());
+  source.Serialize (buffer.Begin ());
+  NS_TEST_EXPECT_MSG_EQ (destination.Deserialize (buffer.Begin ()), source.GetSerializedSize (),
+                         "Wrong deserialized size");
+
+  NS_TEST_EXPECT_MSG_EQ (destination.HasOption (TcpOption::SACKPERMITTED), true, "SACK permitted option lost");
+  NS_TEST_EXPECT_MSG_EQ (destination.HasOption (TcpOption::TS), true, "Timestamp option lost");
+  NS_TEST_EXPECT_MSG_EQ (destination.HasOption (TcpOption::SACK), false, "SACK option found");
+  NS_TEST_EXPECT_MSG_EQ (destination.GetOption (TcpOption::SACKPERMITTED)->GetSerializedSize (), 2,
+                         "Wrong size of the deserialized option");
+}
+
 static class TcpOptionTestSuite : public TestSuite
 {
 public:
@@ -176,6 +352,8 @@ public:
                                               "scale value", i), TestCase::QUICK);
       }
     AddTestCase (new TcpOptionTSTestCase ("Testing serialization of random values for timestamp"), TestCase::QUICK);
+    AddTestCase (new TcpOptionSackTestCase ("Testing serialization of random SACK blocks"), TestCase::QUICK);
+    AddTestCase (new TcpOptionSackPermittedTestCase ("Testing serialization of the SACK permitted option"), TestCase::QUICK);
   }
 
 } g_TcpOptionTestSuite;
@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-general-test.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/data-rate.h"
+#include "ns3/super-segment-tag.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpPacingTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the data segments are spaced by at least their
+ * transmission time at the maximum pacing rate
+ */
+class TcpPacingTestCase : public TcpGeneralTest
+{
+public:
+  TcpPacingTestCase (const std::string &desc);
+
+protected:
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void FinalChecks ();
+
+private:
+  DataRate m_maxRate;     //!< Maximum pacing rate
+  Time     m_lastTx;      //!< Time of the last data segment sent
+  uint32_t m_lastSize;    //!< Size of the last data segment sent
+  uint32_t m_dataSent;    //!< Bytes of data sent
+};
+
+TcpPacingTestCase::TcpPacingTestCase (const std::string &desc)
+  : TcpGeneralTest (desc),
+    m_maxRate ("100kbps"),
+    m_lastSize (0),
+    m_dataSent (0)
+{
+}
+
+Ptr<TcpSocketMsgBase>
+TcpPacingTestCase::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("Pacing", BooleanValue (true));
+  socket->SetAttribute ("MaxPacingRate", DataRateValue (m_maxRate));
+  return socket;
+}
+
+void
+TcpPacingTestCase::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || p->GetSize () == 0)
+    {
+      return;
+    }
+
+  if (m_lastSize > 0)
+    {
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (Simulator::Now () - m_lastTx,
+                                   m_maxRate.CalculateBytesTxTime (m_lastSize),
+                                   "Segment " << h.GetSequenceNumber () << " sent too early");
+    }
+  m_lastTx = Simulator::Now ();
+  m_lastSize = p->GetSize ();
+  m_dataSent += p->GetSize ();
+}
+
+void
+TcpPacingTestCase::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_EQ (m_dataSent, GetPktSize () * GetPktCount (),
+                         "Not all the data has been sent");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the sender hands down super-segments of at most
+ * SegmentBatch segments, and that the network carries the same segments
+ * as without super-segments
+ *
+ * Without losses, the data is carried by one segment per segment size, as
+ * in the run with a SegmentBatch of 1: the receiver must get exactly these
+ * segments, none of them larger than the segment size, over links with a
+ * regular MTU. Since fewer packets are handed down by the socket, fewer
+ * events must be scheduled than in the run with a SegmentBatch of 1.
+ */
+class TcpSegmentBatchTestCase : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   *
+   * \param desc the test description
+   * \param batch the SegmentBatch of the sender
+   * \param events the number of events scheduled in the run with a
+   *        SegmentBatch of 1, set by this run if batch is 1
+   */
+  TcpSegmentBatchTestCase (const std::string &desc, uint32_t batch, uint32_t *events);
+
+protected:
+  virtual void ConfigureEnvironment ();
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void FinalChecks ();
+
+private:
+  /**
+   * \brief Do nothing; scheduled to get the uid of a new event
+   */
+  static void NoOp (void);
+
+  uint32_t m_batch;            //!< Max number of segments in a packet
+  uint32_t *m_events;          //!< Number of events of the run with a SegmentBatch of 1
+  uint32_t m_superSegments;    //!< Number of super-segments sent
+  uint32_t m_segmentsReceived; //!< Number of data segments received
+  uint32_t m_dataReceived;     //!< Bytes of data received
+  SequenceNumber32 m_nextRx;   //!< Sequence number of the next data segment expected
+};
+
+TcpSegmentBatchTestCase::TcpSegmentBatchTestCase (const std::string &desc, uint32_t batch, uint32_t *events)
+  : TcpGeneralTest (desc),
+    m_batch (batch),
+    m_events (events),
+    m_superSegments (0),
+    m_segmentsReceived (0),
+    m_dataReceived (0),
+    m_nextRx (1)
+{
+}
+
+void
+TcpSegmentBatchTestCase::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (100);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSegmentBatchTestCase::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("SegmentBatch", UintegerValue (m_batch));
+  return socket;
+}
+
+void
+TcpSegmentBatchTestCase::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || p->GetSize () == 0)
+    {
+      return;
+    }
+
+  uint32_t segmentSize = GetSegSize (SENDER);
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (p->GetSize (), m_batch * segmentSize,
+                               "Super-segment larger than the batch");
+  bool isSuperSegment = p->GetSize () > segmentSize;
+  SuperSegmentTag tag;
+  NS_TEST_ASSERT_MSG_EQ (p->PeekPacketTag (tag), isSuperSegment,
+                         "Wrong tagging of a packet of " << p->GetSize () << " bytes");
+  if (isSuperSegment)
+    {
+      m_superSegments++;
+    }
+}
+
+void
+TcpSegmentBatchTestCase::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != RECEIVER || p->GetSize () == 0)
+    {
+      return;
+    }
+
+  SuperSegmentTag tag;
+  NS_TEST_ASSERT_MSG_EQ (p->PeekPacketTag (tag), false, "Super-segment received");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (p->GetSize (), GetSegSize (SENDER), "Segment larger than the segment size");
+  NS_TEST_ASSERT_MSG_EQ (h.GetSequenceNumber (), m_nextRx, "Segment received out of order");
+  m_nextRx = h.GetSequenceNumber () + SequenceNumber32 (p->GetSize ());
+  m_segmentsReceived++;
+  m_dataReceived += p->GetSize ();
+}
+
+void
+TcpSegmentBatchTestCase::NoOp (void)
+{
+}
+
+void
+TcpSegmentBatchTestCase::FinalChecks ()
+{
+  if (m_batch > 1)
+    {
+      NS_TEST_ASSERT_MSG_GT (m_superSegments, 0, "No super-segment has been sent");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_dataReceived, GetPktSize () * GetPktCount (),
+                         "Not all the data has been received");
+  // the segments of the run without super-segments
+  uint32_t segmentSize = GetSegSize (SENDER);
+  NS_TEST_ASSERT_MSG_EQ (m_segmentsReceived, (m_dataReceived + segmentSize - 1) / segmentSize,
+                         "Not the same number of segments as without super-segments");
+
+  // The uids of the events are allocated in sequence, from the same
+  // initial value in every run
+  uint32_t events = Simulator::ScheduleNow (&TcpSegmentBatchTestCase::NoOp).GetUid ();
+  NS_LOG_INFO ("SegmentBatch " << m_batch << ": " << events << " events scheduled");
+  if (m_batch == 1)
+    {
+      *m_events = events;
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_LT (events, *m_events, "Not fewer events than without super-segments");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP pacing and super-segments TestSuite
+ */
+static class TcpPacingTestSuite : public TestSuite
+{
+public:
+  TcpPacingTestSuite ()
+    : TestSuite ("tcp-pacing-test", UNIT),
+      m_events (0)
+  {
+    AddTestCase (new TcpPacingTestCase ("Pacing of the data segments"), TestCase::QUICK);
+    // the run without super-segments comes first: it sets the reference
+    // number of events of the other runs
+    AddTestCase (new TcpSegmentBatchTestCase ("Segments without super-segments", 1, &m_events), TestCase::QUICK);
+    AddTestCase (new TcpSegmentBatchTestCase ("Super-segments of 4 segments", 4, &m_events), TestCase::QUICK);
+    AddTestCase (new TcpSegmentBatchTestCase ("Super-segments of 16 segments", 16, &m_events), TestCase::QUICK);
+  }
+
+private:
+  uint32_t m_events; //!< Number of events scheduled without super-segments
+} g_tcpPacingTestSuite;
+
+} // namespace ns3
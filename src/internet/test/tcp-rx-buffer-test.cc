@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/tcp-rx-buffer.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the reassembly of reordered, duplicated and overlapping
+ * segments by TcpRxBuffer against a byte map of the stream.
+ */
+class TcpRxBufferReassemblyTest : public TestCase
+{
+public:
+  TcpRxBufferReassemblyTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param offset the offset of a byte in the stream
+   * \returns the value of the byte
+   */
+  static uint8_t GetByte (uint32_t offset);
+};
+
+TcpRxBufferReassemblyTest::TcpRxBufferReassemblyTest ()
+  : TestCase ("Check the reassembly of out-of-order segments by TcpRxBuffer")
+{
+}
+
+uint8_t
+TcpRxBufferReassemblyTest::GetByte (uint32_t offset)
+{
+  return offset % 251;
+}
+
+void
+TcpRxBufferReassemblyTest::DoRun (void)
+{
+  const uint32_t streamSize = 60000;
+  // Start close to the wrap around of the sequence numbers
+  const uint32_t isn = 0xffff0000;
+  std::vector<uint8_t> stream (streamSize);
+  for (uint32_t i = 0; i < streamSize; i++)
+    {
+      stream[i] = GetByte (i);
+    }
+
+  Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable> ();
+  rand->SetStream (1);
+  Ptr<TcpRxBuffer> buffer = CreateObject<TcpRxBuffer> (isn);
+  buffer->SetMaxBufferSize (20000);
+
+  // The bytes received, by offset in the stream
+  std::vector<bool> received (streamSize, false);
+  uint32_t readOffset = 0;
+  uint32_t nextOffset = 0;
+  uint32_t size = 0;
+  while (readOffset < streamSize)
+    {
+      // Receive a segment anywhere in the window, possibly overlapping the
+      // data already received or the data already read
+      uint32_t start = readOffset + rand->GetInteger (0, 22000);
+      if (start > readOffset + 1000 && rand->GetInteger (0, 3) == 0)
+        {
+          start -= 1000;
+        }
+      start = std::min (start, streamSize - 1);
+      uint32_t length = std::min (rand->GetInteger (1, 3000), streamSize - start);
+      TcpHeader tcph;
+      tcph.SetSequenceNumber (SequenceNumber32 (isn + start));
+      bool added = buffer->Add (Create<Packet> (&stream[start], length), tcph);
+
+      // The window starts at the first buffered byte, if any
+      uint32_t end = start + length;
+      uint32_t first = readOffset;
+      while (first < streamSize && !received[first])
+        {
+          first++;
+        }
+      if (first < streamSize)
+        {
+          end = std::min (end, first + 20000);
+        }
+      bool expectAdded = false;
+      for (uint32_t i = std::max (start, nextOffset); i < end; i++)
+        {
+          if (!received[i])
+            {
+              received[i] = true;
+              size++;
+              expectAdded = true;
+            }
+        }
+      while (nextOffset < streamSize && received[nextOffset])
+        {
+          nextOffset++;
+        }
+      NS_TEST_ASSERT_MSG_EQ (added, expectAdded, "Wrong result of Add for offset " << start << " length " << length);
+      NS_TEST_ASSERT_MSG_EQ (buffer->Size (), size, "Wrong buffer occupancy");
+      NS_TEST_ASSERT_MSG_EQ (buffer->Available (), nextOffset - readOffset, "Wrong available bytes");
+      NS_TEST_ASSERT_MSG_EQ (buffer->NextRxSequence (), SequenceNumber32 (isn + nextOffset), "Wrong next sequence number");
+
+      if (rand->GetInteger (0, 2) == 0)
+        {
+          uint32_t maxSize = rand->GetInteger (1, 15000);
+          Ptr<Packet> p = buffer->Extract (maxSize);
+          uint32_t extractSize = std::min (maxSize, nextOffset - readOffset);
+          if (extractSize == 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ (p, 0, "Data extracted from an empty buffer");
+              continue;
+            }
+          NS_TEST_ASSERT_MSG_EQ (p->GetSize (), extractSize, "Wrong extracted size");
+          std::vector<uint8_t> data (extractSize);
+          p->CopyData (&data[0], extractSize);
+          for (uint32_t i = 0; i < extractSize; i++)
+            {
+              NS_TEST_ASSERT_MSG_EQ (data[i], GetByte (readOffset + i), "Wrong byte at offset " << readOffset + i);
+            }
+          readOffset += extractSize;
+          size -= extractSize;
+          NS_TEST_ASSERT_MSG_EQ (buffer->Size (), size, "Wrong buffer occupancy after extraction");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), 0, "Data left in the buffer");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpRxBuffer TestSuite
+ */
+class TcpRxBufferTestSuite : public TestSuite
+{
+public:
+  TcpRxBufferTestSuite ();
+};
+
+TcpRxBufferTestSuite::TcpRxBufferTestSuite ()
+  : TestSuite ("tcp-rx-buffer", UNIT)
+{
+  AddTestCase (new TcpRxBufferReassemblyTest, TestCase::QUICK);
+}
+
+static TcpRxBufferTestSuite g_tcpRxBufferTestSuite;
@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <map>
+#include "tcp-general-test.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "tcp-error-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpSackRecoveryTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check a SACK based loss recovery (RFC 6675) with several losses
+ * in a window
+ *
+ * Twenty segments are sent in the first window, and the segments in the
+ * drop list are dropped once. The sender must recover in a single fast
+ * recovery, without a retransmission timeout, and retransmit each dropped
+ * segment once. When the holes are followed by enough SACKed data, they
+ * must all be retransmitted before the first one is acknowledged, instead
+ * of one per round trip as NewReno does with partial acknowledgments.
+ * When the last segments are dropped, nothing is SACKed above them and
+ * the rescue retransmission recovers them.
+ */
+class TcpSackRecoveryTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param desc the description of the test
+   * \param toDrop the sequence numbers of the segments to drop
+   * \param oneRtt whether all the dropped segments are expected to be
+   *        retransmitted before the first one is acknowledged
+   */
+  TcpSackRecoveryTest (const std::string &desc, const std::vector<uint32_t> &toDrop, bool oneRtt);
+
+protected:
+  virtual Ptr<TcpSocketMsgBase> CreateReceiverSocket (Ptr<Node> node);
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel ();
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                               const TcpSocketState::TcpCongState_t newValue);
+  virtual void RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who);
+  virtual void FinalChecks ();
+
+private:
+  std::vector<uint32_t> m_toDrop;                   //!< Sequence numbers of the segments to drop
+  bool m_oneRtt;                                    //!< Holes expected to be retransmitted in one round trip
+  std::map<SequenceNumber32, uint32_t> m_retx;      //!< Number of retransmissions of the dropped segments
+  SequenceNumber32 m_highTx;                        //!< Sequence number following the highest byte sent
+  bool m_firstHoleAcked;                            //!< The first dropped segment was acknowledged
+  uint32_t m_recoveries;                            //!< Number of entries into fast recovery
+  uint32_t m_rtos;                                  //!< Number of retransmission timeouts
+  uint32_t m_rxBytes;                               //!< Number of bytes received by the receiver
+};
+
+TcpSackRecoveryTest::TcpSackRecoveryTest (const std::string &desc,
+                                          const std::vector<uint32_t> &toDrop, bool oneRtt)
+  : TcpGeneralTest (desc),
+    m_toDrop (toDrop),
+    m_oneRtt (oneRtt),
+    m_highTx (0),
+    m_firstHoleAcked (false),
+    m_recoveries (0),
+    m_rtos (0),
+    m_rxBytes (0)
+{
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackRecoveryTest::CreateReceiverSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (true));
+  return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackRecoveryTest::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (true));
+  return socket;
+}
+
+Ptr<ErrorModel>
+TcpSackRecoveryTest::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  for (std::vector<uint32_t>::iterator it = m_toDrop.begin (); it != m_toDrop.end (); ++it)
+    {
+      errorModel->AddSeqToKill (SequenceNumber32 (*it));
+      m_retx[SequenceNumber32 (*it)] = 0;
+    }
+  return errorModel;
+}
+
+void
+TcpSackRecoveryTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (30);
+  SetPropagationDelay (MilliSeconds (50));
+  SetTransmitStart (Seconds (2.0));
+}
+
+void
+TcpSackRecoveryTest::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 20);
+}
+
+void
+TcpSackRecoveryTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || p->GetSize () == 0)
+    {
+      return;
+    }
+  SequenceNumber32 seq = h.GetSequenceNumber ();
+  if (seq < m_highTx)
+    {
+      NS_LOG_DEBUG ("Retransmission of seq " << seq);
+      std::map<SequenceNumber32, uint32_t>::iterator it = m_retx.find (seq);
+      if (it != m_retx.end ())
+        {
+          ++it->second;
+          if (m_oneRtt)
+            {
+              NS_TEST_ASSERT_MSG_EQ (m_firstHoleAcked, false,
+                                     "Segment " << seq << " retransmitted after the first hole was acknowledged");
+            }
+        }
+    }
+  m_highTx = std::max (m_highTx, seq + SequenceNumber32 (p->GetSize ()));
+}
+
+void
+TcpSackRecoveryTest::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == RECEIVER)
+    {
+      m_rxBytes += p->GetSize ();
+    }
+  else if (who == SENDER && (h.GetFlags () & TcpHeader::ACK) != 0
+           && h.GetAckNumber () > SequenceNumber32 (m_toDrop.front ()))
+    {
+      m_firstHoleAcked = true;
+    }
+}
+
+void
+TcpSackRecoveryTest::CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                                     const TcpSocketState::TcpCongState_t newValue)
+{
+  NS_LOG_DEBUG ("Congestion state " << TcpSocketState::TcpCongStateName[oldValue] <<
+                " -> " << TcpSocketState::TcpCongStateName[newValue]);
+  if (newValue == TcpSocketState::CA_RECOVERY)
+    {
+      ++m_recoveries;
+    }
+}
+
+void
+TcpSackRecoveryTest::RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+  if (who == SENDER)
+    {
+      ++m_rtos;
+    }
+}
+
+void
+TcpSackRecoveryTest::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_EQ (m_recoveries, 1, "The losses were not recovered in a single fast recovery");
+  NS_TEST_ASSERT_MSG_EQ (m_rtos, 0, "Retransmission timeout during the recovery");
+  for (std::map<SequenceNumber32, uint32_t>::iterator it = m_retx.begin (); it != m_retx.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (it->second, 1, "Dropped segment " << it->first << " not retransmitted once");
+    }
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_rxBytes, GetPktCount () * GetPktSize (), "Data not delivered");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP SACK loss recovery TestSuite
+ */
+class TcpSackRecoveryTestSuite : public TestSuite
+{
+public:
+  TcpSackRecoveryTestSuite ();
+};
+
+TcpSackRecoveryTestSuite::TcpSackRecoveryTestSuite ()
+  : TestSuite ("tcp-sack-recovery", UNIT)
+{
+  std::vector<uint32_t> toDrop;
+  toDrop.push_back (1001);
+  toDrop.push_back (3001);
+  toDrop.push_back (5001);
+  AddTestCase (new TcpSackRecoveryTest ("SACK recovery of three losses in a window", toDrop, true),
+               TestCase::QUICK);
+  toDrop.clear ();
+  toDrop.push_back (5001);
+  toDrop.push_back (14001);
+  toDrop.push_back (14501);
+  AddTestCase (new TcpSackRecoveryTest ("SACK recovery of the last segments with a rescue retransmission", toDrop, false),
+               TestCase::QUICK);
+}
+
+static TcpSackRecoveryTestSuite g_tcpSackRecoveryTestSuite;
+
+} // namespace ns3
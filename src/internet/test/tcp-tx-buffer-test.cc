@@ -0,0 +1,378 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-option-sack.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the segments copied from TcpTxBuffer against a byte map of
+ * the stream, across the boundaries of the application writes and after
+ * a partial acknowledgment of a write.
+ */
+class TcpTxBufferCopyTest : public TestCase
+{
+public:
+  TcpTxBufferCopyTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param offset the offset of a byte in the stream
+   * \returns the value of the byte
+   */
+  static uint8_t GetByte (uint32_t offset);
+  /**
+   * Write the next bytes of the stream into the buffer.
+   * \param buffer the buffer
+   * \param size the size of the write
+   */
+  void Write (Ptr<TcpTxBuffer> buffer, uint32_t size);
+  /**
+   * Copy a segment from the buffer and check its bytes.
+   * \param buffer the buffer
+   * \param offset the offset of the segment in the stream
+   * \param size the requested size
+   */
+  void CheckCopy (Ptr<TcpTxBuffer> buffer, uint32_t offset, uint32_t size);
+
+  SequenceNumber32 m_isn;  //!< the sequence number of the first byte
+  uint32_t m_written;      //!< the number of bytes written so far
+};
+
+TcpTxBufferCopyTest::TcpTxBufferCopyTest ()
+  : TestCase ("Check the segments copied from TcpTxBuffer"),
+    m_written (0)
+{
+}
+
+uint8_t
+TcpTxBufferCopyTest::GetByte (uint32_t offset)
+{
+  return offset % 251;
+}
+
+void
+TcpTxBufferCopyTest::Write (Ptr<TcpTxBuffer> buffer, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      data[i] = GetByte (m_written + i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer->Add (Create<Packet> (&data[0], size)), true, "Write of " << size << " bytes refused");
+  m_written += size;
+}
+
+void
+TcpTxBufferCopyTest::CheckCopy (Ptr<TcpTxBuffer> buffer, uint32_t offset, uint32_t size)
+{
+  SequenceNumber32 seq = m_isn + offset;
+  uint32_t expected = std::min (size, m_written - offset);
+  NS_TEST_ASSERT_MSG_EQ (buffer->SizeFromSequence (seq), m_written - offset, "Wrong size from offset " << offset);
+  Ptr<Packet> p = buffer->CopyFromSequence (size, seq);
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), expected, "Wrong segment size at offset " << offset);
+  std::vector<uint8_t> data (expected + 1);
+  p->CopyData (&data[0], expected);
+  for (uint32_t i = 0; i < expected; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t) data[i], (uint32_t) GetByte (offset + i),
+                             "Wrong byte " << i << " of the segment at offset " << offset);
+    }
+}
+
+void
+TcpTxBufferCopyTest::DoRun (void)
+{
+  // Start close to the wrap around of the sequence numbers
+  m_isn = SequenceNumber32 (0xfffff000);
+  m_written = 0;
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> (m_isn.GetValue ());
+  buffer->SetMaxBufferSize (100000);
+
+  // writes of very different sizes, whose boundaries are at
+  // 1000, 1001, 1537, 3037, 3137, 4137 and 5597
+  uint32_t writes[] = { 1000, 1, 536, 1500, 100, 1000, 1460 };
+  for (uint32_t i = 0; i < sizeof (writes) / sizeof (writes[0]); i++)
+    {
+      Write (buffer, writes[i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), m_written, "Wrong buffer size");
+  NS_TEST_ASSERT_MSG_EQ (buffer->TailSequence (), m_isn + m_written, "Wrong tail sequence");
+
+  // within a write, from and to the boundaries of a write, and across one
+  // or several boundaries
+  CheckCopy (buffer, 0, 1000);
+  CheckCopy (buffer, 10, 500);
+  CheckCopy (buffer, 1000, 1);
+  CheckCopy (buffer, 999, 3);
+  CheckCopy (buffer, 1001, 536);
+  CheckCopy (buffer, 500, 536);
+  CheckCopy (buffer, 900, 3000);
+  CheckCopy (buffer, 0, 5597);
+  // beyond the tail: the segment is truncated
+  CheckCopy (buffer, 5000, 1460);
+  // every segment of a transfer with an MSS which is not aligned on the
+  // writes
+  for (uint32_t offset = 0; offset < m_written; offset += 536)
+    {
+      CheckCopy (buffer, offset, 536);
+    }
+
+  // acknowledge up to the middle of a write: it is kept whole, but the
+  // acknowledged bytes are no longer in the buffer
+  buffer->DiscardUpTo (m_isn + 1300);
+  NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), m_isn + 1300, "Wrong head sequence");
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), m_written - 1300, "Wrong size after a partial acknowledgment");
+  NS_TEST_ASSERT_MSG_EQ (buffer->Available (), 100000 - (m_written - 1300), "Wrong available space");
+  CheckCopy (buffer, 1300, 100);
+  CheckCopy (buffer, 1300, 1000);
+  CheckCopy (buffer, 1536, 2);
+
+  // a second partial acknowledgment within the same write, then one that
+  // ends exactly at a boundary
+  buffer->DiscardUpTo (m_isn + 1500);
+  CheckCopy (buffer, 1500, 2000);
+  buffer->DiscardUpTo (m_isn + 3037);
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), m_written - 3037, "Wrong size after an acknowledgment at a boundary");
+  CheckCopy (buffer, 3037, 100);
+  CheckCopy (buffer, 3037, 5000);
+
+  // new writes after the acknowledgments
+  Write (buffer, 700);
+  Write (buffer, 3);
+  CheckCopy (buffer, 5000, 1300);
+  CheckCopy (buffer, 6290, 20);
+
+  // acknowledge everything
+  buffer->DiscardUpTo (m_isn + m_written);
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), 0, "Buffer not empty");
+  NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), m_isn + m_written, "Wrong head sequence");
+  NS_TEST_ASSERT_MSG_EQ (buffer->CopyFromSequence (100, m_isn + m_written)->GetSize (), 0, "Segment copied from an empty buffer");
+  Write (buffer, 10);
+  CheckCopy (buffer, m_written - 10, 10);
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the SACK scoreboard of TcpTxBuffer against \RFC{6675}: the
+ * lost data, the pipe and the rules of NextSeg ().
+ *
+ * Ten segments of 100 bytes are in flight, and DupThresh is 3.
+ */
+class TcpTxBufferScoreboardTest : public TestCase
+{
+public:
+  TcpTxBufferScoreboardTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * SACK a range of the stream.
+   * \param buffer the buffer
+   * \param start the offset of the first byte
+   * \param end the offset following the last byte
+   * \returns the number of bytes newly SACKed
+   */
+  uint32_t Sack (Ptr<TcpTxBuffer> buffer, uint32_t start, uint32_t end);
+  /**
+   * Check the segment returned by NextSeg ().
+   * \param buffer the buffer
+   * \param segmentSize the sender maximum segment size
+   * \param offset the expected offset of the segment
+   * \param length the expected length of the segment
+   * \param isLost whether the segment is expected to be lost
+   */
+  void CheckNextSeg (Ptr<TcpTxBuffer> buffer, uint32_t segmentSize,
+                     uint32_t offset, uint32_t length, bool isLost);
+  /**
+   * Check the segment returned by RescueSeg ().
+   * \param buffer the buffer
+   * \param highData the offset following the last byte sent
+   * \param segmentSize the sender maximum segment size
+   * \param offset the expected offset of the segment
+   * \param length the expected length of the segment
+   */
+  void CheckRescueSeg (Ptr<TcpTxBuffer> buffer, uint32_t highData, uint32_t segmentSize,
+                       uint32_t offset, uint32_t length);
+
+  SequenceNumber32 m_isn;       //!< the sequence number of the first byte
+  SequenceNumber32 m_highData;  //!< the sequence number following the last byte sent
+};
+
+TcpTxBufferScoreboardTest::TcpTxBufferScoreboardTest ()
+  : TestCase ("Check the SACK scoreboard of TcpTxBuffer")
+{
+}
+
+uint32_t
+TcpTxBufferScoreboardTest::Sack (Ptr<TcpTxBuffer> buffer, uint32_t start, uint32_t end)
+{
+  TcpOptionSack::SackList list;
+  list.push_back (TcpOptionSack::SackBlock (m_isn + start, m_isn + end));
+  return buffer->Update (list);
+}
+
+void
+TcpTxBufferScoreboardTest::CheckNextSeg (Ptr<TcpTxBuffer> buffer, uint32_t segmentSize,
+                                         uint32_t offset, uint32_t length, bool isLost)
+{
+  SequenceNumber32 seq;
+  uint32_t segLength;
+  bool segIsLost;
+  NS_TEST_ASSERT_MSG_EQ (buffer->NextSeg (m_highData, 3, segmentSize, seq, segLength, segIsLost), true,
+                         "No segment found, expected one at offset " << offset);
+  NS_TEST_ASSERT_MSG_EQ (seq, m_isn + offset, "Wrong segment");
+  NS_TEST_ASSERT_MSG_EQ (segLength, length, "Wrong length of the segment at offset " << offset);
+  NS_TEST_ASSERT_MSG_EQ (segIsLost, isLost, "Wrong loss of the segment at offset " << offset);
+}
+
+void
+TcpTxBufferScoreboardTest::CheckRescueSeg (Ptr<TcpTxBuffer> buffer, uint32_t highData, uint32_t segmentSize,
+                                           uint32_t offset, uint32_t length)
+{
+  SequenceNumber32 seq;
+  uint32_t segLength;
+  NS_TEST_ASSERT_MSG_EQ (buffer->RescueSeg (m_isn + highData, segmentSize, seq, segLength), true,
+                         "No rescue segment below " << highData);
+  NS_TEST_ASSERT_MSG_EQ (seq, m_isn + offset, "Wrong rescue segment below " << highData);
+  NS_TEST_ASSERT_MSG_EQ (segLength, length, "Wrong length of the rescue segment below " << highData);
+}
+
+void
+TcpTxBufferScoreboardTest::DoRun (void)
+{
+  m_isn = SequenceNumber32 (0xffffff00);
+  m_highData = m_isn + 1000;
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> (m_isn.GetValue ());
+  buffer->SetMaxBufferSize (100000);
+  buffer->Add (Create<Packet> (1000));
+  buffer->Add (Create<Packet> (500)); // not sent yet
+  SequenceNumber32 seq;
+  uint32_t length;
+  bool isLost;
+
+  NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (m_highData, 3, 100), 1000, "Wrong pipe without SACK");
+  NS_TEST_ASSERT_MSG_EQ (buffer->NextSeg (m_highData, 3, 100, seq, length, isLost), false,
+                         "Segment to retransmit without SACK");
+
+  // Blocks outside of the buffer are ignored
+  TcpOptionSack::SackList list;
+  list.push_back (TcpOptionSack::SackBlock (m_isn - 200, m_isn));
+  list.push_back (TcpOptionSack::SackBlock (m_isn + 1500, m_isn + 1700));
+  NS_TEST_ASSERT_MSG_EQ (buffer->Update (list), 0, "Blocks outside of the buffer SACKed");
+
+  // IsLost (): the unSACKed bytes below DupThresh blocks are lost
+  NS_TEST_ASSERT_MSG_EQ (Sack (buffer, 200, 300), 100, "Wrong newly SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (Sack (buffer, 200, 300), 0, "Duplicate block SACKed twice");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn, 3, 100), false, "Lost with one block");
+  NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (m_highData, 3, 100), 900, "Wrong pipe with one block");
+  NS_TEST_ASSERT_MSG_EQ (Sack (buffer, 400, 500), 100, "Wrong newly SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn, 3, 100), false, "Lost with two blocks");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn, 2, 100), true, "Not lost with two blocks and DupThresh 2");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn + 300, 2, 100), false, "Lost above the lowest of DupThresh blocks");
+  NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (m_highData, 3, 100), 800, "Wrong pipe with two blocks");
+  NS_TEST_ASSERT_MSG_EQ (Sack (buffer, 600, 700), 100, "Wrong newly SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (buffer->GetSacked (), 300, "Wrong SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn, 3, 100), true, "Not lost below three blocks");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn + 199, 3, 100), true, "Not lost below three blocks");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn + 200, 3, 100), false, "SACKed byte lost");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn + 300, 3, 100), false, "Lost above the lowest of three blocks");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn + 900, 3, 100), false, "Lost above the SACKed blocks");
+  // pipe: [300;400), [500;600) and [700;1000) are neither SACKed nor lost
+  NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (m_highData, 3, 100), 500, "Wrong pipe with three blocks");
+
+  // NextSeg () rule 1: the lost holes, up to the next SACKed block
+  CheckNextSeg (buffer, 1000, 0, 200, true);
+  CheckNextSeg (buffer, 100, 0, 100, true);
+  buffer->MarkRetransmitted (m_isn, 100);
+  // the retransmitted bytes count in the pipe
+  NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (m_highData, 3, 100), 600, "Wrong pipe after a retransmission");
+  CheckNextSeg (buffer, 100, 100, 100, true);
+  buffer->MarkRetransmitted (m_isn + 100, 100);
+  // NextSeg () rule 3: the holes above the lost data, below the highest
+  // SACKed byte, skipping the SACKed blocks
+  CheckNextSeg (buffer, 100, 300, 100, false);
+  buffer->MarkRetransmitted (m_isn + 300, 100);
+  NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (m_highData, 3, 100), 800, "Wrong pipe after three retransmissions");
+  CheckNextSeg (buffer, 100, 500, 100, false);
+  buffer->MarkRetransmitted (m_isn + 500, 100);
+  // NextSeg () rule 2 (new data) is left to the socket: nothing is left
+  // below the highest SACKed byte
+  NS_TEST_ASSERT_MSG_EQ (buffer->NextSeg (m_highData, 3, 100, seq, length, isLost), false,
+                         "Segment to retransmit above the highest SACKed byte");
+
+  // NextSeg () rule 4: the rescue retransmission holds the highest unSACKed
+  // byte, and does not overlap a SACKed block
+  CheckRescueSeg (buffer, 1000, 100, 900, 100);
+  CheckRescueSeg (buffer, 700, 100, 500, 100);
+  CheckRescueSeg (buffer, 750, 150, 700, 50);
+  CheckRescueSeg (buffer, 650, 150, 500, 100);
+  NS_TEST_ASSERT_MSG_EQ (buffer->RescueSeg (m_isn, 100, seq, length), false, "Rescue segment without data in flight");
+
+  // A cumulative acknowledgment above the first block: nothing is lost any
+  // more, and the pipe counts the retransmissions not acknowledged
+  buffer->DiscardUpTo (m_isn + 300);
+  NS_TEST_ASSERT_MSG_EQ (buffer->GetSacked (), 200, "Wrong SACKed bytes after an acknowledgment");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn + 300, 3, 100), false, "Lost with two blocks");
+  NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (m_highData, 3, 100), 700, "Wrong pipe after an acknowledgment");
+  // the blocks are merged, and the lost edge also follows from the number
+  // of SACKed bytes: more than (DupThresh - 1) * SMSS
+  NS_TEST_ASSERT_MSG_EQ (Sack (buffer, 450, 800), 200, "Wrong newly SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (buffer->GetSacked (), 400, "Wrong SACKed bytes after merging blocks");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn + 300, 3, 100), true, "Not lost below 400 SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (buffer->IsLost (m_isn + 300, 3, 200), false, "Lost below 400 SACKed bytes with a 200 bytes SMSS");
+  // pipe: [800;1000) is neither SACKed nor lost, [300;400) is lost but
+  // retransmitted
+  NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (m_highData, 3, 100), 300, "Wrong pipe after merging blocks");
+
+  // After a retransmission timeout, the scoreboard is forgotten
+  buffer->ResetScoreboard ();
+  NS_TEST_ASSERT_MSG_EQ (buffer->GetSacked (), 0, "SACKed bytes after a reset");
+  NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (m_highData, 3, 100), 700, "Wrong pipe after a reset");
+  NS_TEST_ASSERT_MSG_EQ (buffer->NextSeg (m_highData, 3, 100, seq, length, isLost), false,
+                         "Segment to retransmit after a reset");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpTxBuffer TestSuite
+ */
+class TcpTxBufferTestSuite : public TestSuite
+{
+public:
+  TcpTxBufferTestSuite ();
+};
+
+TcpTxBufferTestSuite::TcpTxBufferTestSuite ()
+  : TestSuite ("tcp-tx-buffer", UNIT)
+{
+  AddTestCase (new TcpTxBufferCopyTest, TestCase::QUICK);
+  AddTestCase (new TcpTxBufferScoreboardTest, TestCase::QUICK);
+}
+
+static TcpTxBufferTestSuite g_tcpTxBufferTestSuite;
@@ -37,9 +37,18 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/building-list.h>
+#include <ns3/antenna-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
 
 #include <fstream>
 #include <limits>
+#include <cmath>
 
 namespace ns3 {
 
@@ -48,6 +57,7 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
+  : m_maxLossDb (std::numeric_limits<double>::max ())
 {
 }
 
@@ -62,6 +72,9 @@ void
 RadioEnvironmentMapHelper::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_probe = 0;
+  m_propagationLoss = 0;
+  m_spectrumPropagationLoss = 0;
 }
 
 TypeId
@@ -144,6 +157,23 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("DirectComputation",
+                   "If true, the signals transmitted on the channel are captured once "
+                   "and the SINR of every point is computed directly from the propagation "
+                   "loss models of the channel, instead of simulating the reception "
+                   "at every point",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_directComputation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NumThreads",
+                   "Number of threads used by the direct computation. A single "
+                   "thread is used anyway unless every propagation loss model of "
+                   "the channel is deterministic and stateless, there are no "
+                   "buildings and there is no frequency-dependent propagation "
+                   "loss model",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1, 256))
   ;
   return tid;
 }
@@ -181,7 +211,7 @@ void
 RadioEnvironmentMapHelper::Install ()
 {
   NS_LOG_FUNCTION (this);
-  if (!m_rem.empty ())
+  if (!m_rem.empty () || m_probe != 0)
     {
       NS_FATAL_ERROR ("only one REM supported per instance of RadioEnvironmentMapHelper");
     }
@@ -220,6 +250,12 @@ RadioEnvironmentMapHelper::DelayedInstall ()
   NS_LOG_FUNCTION (this);
   m_xStep = (m_xMax - m_xMin)/(m_xRes-1);
   m_yStep = (m_yMax - m_yMin)/(m_yRes-1);
+
+  if (m_directComputation)
+    {
+      StartDirectComputation ();
+      return;
+    }
   
   if ((double)m_xRes * (double) m_yRes < (double) m_maxPointsPerIteration)
     {
@@ -340,6 +376,300 @@ RadioEnvironmentMapHelper::PrintAndReset ()
     }
 }
 
+void
+RadioEnvironmentMapHelper::StartDirectComputation ()
+{
+  NS_LOG_FUNCTION (this);
+  m_probe = CreateObject<RemSpectrumPhy> ();
+  m_probe->SetRxSpectrumModel (LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth));
+  m_probe->SetUseDataChannel (m_useDataChannel);
+  m_probe->SetRbId (m_rbId);
+  m_probe->SetRecordSignals (true);
+  m_channel->AddRx (m_probe);
+
+  // capture the same time window as the first iteration of the
+  // simulated map generation
+  Simulator::Schedule (Seconds (0.0001), &RemSpectrumPhy::Reset, m_probe);
+  Simulator::Schedule (Seconds (0.0006), &RadioEnvironmentMapHelper::RunDirectComputation, this);
+}
+
+void
+RadioEnvironmentMapHelper::RunDirectComputation ()
+{
+  NS_LOG_FUNCTION (this);
+  m_probe->Deactivate ();
+
+  std::vector<RemSource> sources;
+  std::vector<Ptr<SpectrumSignalParameters> > signals = m_probe->GetRecordedSignals ();
+  for (std::vector<Ptr<SpectrumSignalParameters> >::const_iterator it = signals.begin ();
+       it != signals.end ();
+       ++it)
+    {
+      RemSource source;
+      source.mobility = (*it)->txPhy->GetMobility ();
+      source.antenna = (*it)->txAntenna;
+      source.psd = (*it)->psd;
+      source.power = (m_rbId >= 0) ? (*(source.psd))[m_rbId] * 180000 : Integral (*(source.psd));
+      sources.push_back (source);
+    }
+  m_probe->Reset ();
+  NS_LOG_LOGIC ("captured " << sources.size () << " signals");
+
+  m_propagationLoss = m_channel->GetPropagationLossModel ();
+  m_spectrumPropagationLoss = m_channel->GetSpectrumPropagationLossModel ();
+  DoubleValue maxLossDb;
+  if (m_channel->GetAttributeFailSafe ("MaxLossDb", maxLossDb))
+    {
+      m_maxLossDb = maxLossDb.Get ();
+    }
+
+  // same sequence of coordinates as the simulated map generation
+  m_xPoints.clear ();
+  for (double x = m_xMin; x < m_xMax + 0.5*m_xStep; x += m_xStep)
+    {
+      m_xPoints.push_back (x);
+    }
+  m_yPoints.clear ();
+  for (double y = m_yMin; y < m_yMax + 0.5*m_yStep; y += m_yStep)
+    {
+      m_yPoints.push_back (y);
+    }
+  uint32_t numPoints = m_xPoints.size () * m_yPoints.size ();
+
+  uint32_t numThreads = m_numThreads;
+  if (numThreads > 1 && m_spectrumPropagationLoss != 0)
+    {
+      NS_LOG_WARN ("frequency-dependent propagation loss model on the channel, using a single thread");
+      numThreads = 1;
+    }
+  if (numThreads > 1 && !IsThreadSafe (m_propagationLoss))
+    {
+      NS_LOG_WARN ("random or stateful propagation loss model on the channel, using a single thread");
+      numThreads = 1;
+    }
+  if (numThreads > 1 && BuildingList::GetNBuildings () > 0)
+    {
+      NS_LOG_WARN ("buildings in the scenario, using a single thread");
+      numThreads = 1;
+    }
+#ifndef HAVE_PTHREAD_H
+  if (numThreads > 1)
+    {
+      NS_LOG_WARN ("threads are not supported in this build, using a single thread");
+      numThreads = 1;
+    }
+#endif
+
+  // One worker per thread. With more than one thread, every worker uses
+  // its own copies of the mobility models of the transmitters, since the
+  // reference counting of Ptr is not thread-safe.
+  std::vector<RemWorker> workers (numThreads);
+  for (uint32_t t = 0; t < numThreads; ++t)
+    {
+      RemWorker &worker = workers[t];
+      worker.m_helper = this;
+      worker.m_sources = sources;
+      if (numThreads > 1)
+        {
+          for (std::vector<RemSource>::iterator it = worker.m_sources.begin ();
+               it != worker.m_sources.end ();
+               ++it)
+            {
+              if (it->mobility != 0)
+                {
+                  Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+                  mobility->SetPosition (it->mobility->GetPosition ());
+                  mobility->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+                  BuildingsHelper::MakeConsistent (mobility);
+                  it->mobility = mobility;
+                }
+            }
+        }
+      worker.m_makeConsistent = (numThreads == 1);
+    }
+
+  // the map is evaluated and written in blocks of at most
+  // MaxPointsPerIteration points, so that the memory usage is bounded.
+  // As in the simulated map generation, the n-th point of every block
+  // is evaluated with the n-th listening point.
+  uint32_t blockSize = std::min (numPoints, m_maxPointsPerIteration);
+  std::vector<Ptr<MobilityModel> > rxMobilities (blockSize);
+  for (uint32_t i = 0; i < blockSize; ++i)
+    {
+      rxMobilities[i] = CreateObject<ConstantPositionMobilityModel> ();
+      Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+      rxMobilities[i]->AggregateObject (buildingInfo); // operation usually done by BuildingsHelper::Install
+      // without buildings, the building information of the listening
+      // point does not depend on its position
+      BuildingsHelper::MakeConsistent (rxMobilities[i]);
+    }
+  std::vector<double> sinr (blockSize);
+  for (uint32_t blockBegin = 0; blockBegin < numPoints; blockBegin += m_maxPointsPerIteration)
+    {
+      uint32_t blockEnd = std::min (numPoints, blockBegin + m_maxPointsPerIteration);
+      uint32_t pointsPerWorker = (blockEnd - blockBegin + numThreads - 1) / numThreads;
+      for (uint32_t t = 0; t < numThreads; ++t)
+        {
+          workers[t].m_begin = std::min (blockEnd, blockBegin + t * pointsPerWorker);
+          workers[t].m_end = std::min (blockEnd, workers[t].m_begin + pointsPerWorker);
+          workers[t].m_rxMobilities = rxMobilities.data () + (workers[t].m_begin - blockBegin);
+          workers[t].m_sinr = sinr.data () + (workers[t].m_begin - blockBegin);
+        }
+
+      if (numThreads == 1)
+        {
+          workers[0].Run ();
+        }
+#ifdef HAVE_PTHREAD_H
+      else
+        {
+          std::vector<Ptr<SystemThread> > threads;
+          for (uint32_t t = 0; t < numThreads; ++t)
+            {
+              threads.push_back (Create<SystemThread> (MakeCallback (&RemWorker::Run, &workers[t])));
+              threads.back ()->Start ();
+            }
+          for (uint32_t t = 0; t < numThreads; ++t)
+            {
+              threads[t]->Join ();
+            }
+        }
+#endif
+
+      for (uint32_t i = blockBegin; i < blockEnd; ++i)
+        {
+          Vector pos = GetPointPosition (i);
+          NS_LOG_LOGIC ("output: " << pos.x << "\t"
+                        << pos.y << "\t"
+                        << pos.z << "\t"
+                        << sinr[i - blockBegin]);
+          m_outFile << pos.x << "\t"
+                    << pos.y << "\t"
+                    << pos.z << "\t"
+                    << sinr[i - blockBegin]
+                    << std::endl;
+        }
+    }
+
+  Finalize ();
+}
+
+void
+RadioEnvironmentMapHelper::RemWorker::Run ()
+{
+  for (uint32_t i = m_begin; i < m_end; ++i)
+    {
+      Ptr<MobilityModel> rxMobility = m_rxMobilities[i - m_begin];
+      rxMobility->SetPosition (m_helper->GetPointPosition (i));
+      if (m_makeConsistent)
+        {
+          BuildingsHelper::MakeConsistent (rxMobility);
+        }
+      m_sinr[i - m_begin] = m_helper->ComputeDirectSinr (m_sources, rxMobility);
+    }
+}
+
+double
+RadioEnvironmentMapHelper::ComputeDirectSinr (const std::vector<RemSource> &sources,
+                                              Ptr<MobilityModel> rxMobility) const
+{
+  double referenceSignalPower = 0;
+  double sumPower = 0;
+  for (std::vector<RemSource>::const_iterator it = sources.begin ();
+       it != sources.end ();
+       ++it)
+    {
+      double power = it->power;
+      if (it->mobility != 0)
+        {
+          // same computation as the one done by the channel upon StartTx
+          double pathLossDb = 0;
+          if (it->antenna != 0)
+            {
+              Angles txAngles (rxMobility->GetPosition (), it->mobility->GetPosition ());
+              pathLossDb -= it->antenna->GetGainDb (txAngles);
+            }
+          if (m_propagationLoss != 0)
+            {
+              pathLossDb -= m_propagationLoss->CalcRxPower (0, it->mobility, rxMobility);
+            }
+          if (pathLossDb > m_maxLossDb)
+            {
+              // beyond range
+              continue;
+            }
+          double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+          if (m_spectrumPropagationLoss != 0)
+            {
+              Ptr<SpectrumValue> psd = Copy<SpectrumValue> (it->psd);
+              *psd *= pathGainLinear;
+              psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (psd, it->mobility, rxMobility);
+              power = (m_rbId >= 0) ? (*psd)[m_rbId] * 180000 : Integral (*psd);
+            }
+          else
+            {
+              power *= pathGainLinear;
+            }
+        }
+      sumPower += power;
+      if (power > referenceSignalPower)
+        {
+          referenceSignalPower = power;
+        }
+    }
+  return referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower);
+}
+
+bool
+RadioEnvironmentMapHelper::IsThreadSafe (Ptr<PropagationLossModel> model)
+{
+  // Models which neither draw random variables nor cache any state
+  // while computing the loss. The random and fading models are not, and
+  // neither are the buildings models, which cache the shadowing of every
+  // pair of nodes.
+  static const char *threadSafeModels[] = {
+    "ns3::FriisPropagationLossModel",
+    "ns3::TwoRayGroundPropagationLossModel",
+    "ns3::LogDistancePropagationLossModel",
+    "ns3::ThreeLogDistancePropagationLossModel",
+    "ns3::FixedRssLossModel",
+    "ns3::MatrixPropagationLossModel",
+    "ns3::RangePropagationLossModel",
+    "ns3::Cost231PropagationLossModel",
+    "ns3::OkumuraHataPropagationLossModel",
+    "ns3::ItuR1411LosPropagationLossModel",
+    "ns3::ItuR1411NlosOverRooftopPropagationLossModel",
+    "ns3::Kun2600MhzPropagationLossModel"
+  };
+  for (Ptr<PropagationLossModel> m = model; m != 0; m = m->GetNext ())
+    {
+      std::string name = m->GetInstanceTypeId ().GetName ();
+      bool found = false;
+      for (uint32_t i = 0; i < sizeof (threadSafeModels) / sizeof (threadSafeModels[0]); ++i)
+        {
+          if (name == threadSafeModels[i])
+            {
+              found = true;
+              break;
+            }
+        }
+      if (!found)
+        {
+          NS_LOG_LOGIC (name << " is not known to be thread-safe");
+          return false;
+        }
+    }
+  return true;
+}
+
+Vector
+RadioEnvironmentMapHelper::GetPointPosition (uint32_t index) const
+{
+  return Vector (m_xPoints[index / m_yPoints.size ()],
+                 m_yPoints[index % m_yPoints.size ()],
+                 m_z);
+}
+
 void 
 RadioEnvironmentMapHelper::Finalize ()
 {
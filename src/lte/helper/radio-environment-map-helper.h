@@ -24,7 +24,9 @@
 
 
 #include <ns3/object.h>
+#include <ns3/vector.h>
 #include <fstream>
+#include <vector>
 
 
 namespace ns3 {
@@ -35,6 +37,10 @@ class NetDevice;
 class SpectrumChannel;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class AntennaModel;
+class SpectrumValue;
+class PropagationLossModel;
+class SpectrumPropagationLossModel;
 
 /** 
  * \ingroup lte
@@ -108,6 +114,79 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /**
+   * Used when the `DirectComputation` attribute is true: capture the
+   * signals transmitted on the channel during one subframe by means of a
+   * single RemSpectrumPhy which has no mobility, hence which receives the
+   * signals before any propagation loss is applied. Afterwards, schedule a
+   * call to RunDirectComputation() in 0.6 milliseconds.
+   */
+  void StartDirectComputation ();
+
+  /**
+   * Compute the SINR of every point of the map from the captured signals
+   * and the propagation loss models of the channel, and write the map to
+   * the output file, without any further simulation event.
+   */
+  void RunDirectComputation ();
+
+  /// A transmitter whose signal has been captured for the direct computation.
+  struct RemSource
+  {
+    /// Position of the transmitter, or 0 if the channel does not apply loss.
+    Ptr<MobilityModel> mobility;
+    /// Antenna of the transmitter, or 0 if isotropic.
+    Ptr<AntennaModel> antenna;
+    /// Power spectral density of the signal before propagation loss.
+    Ptr<SpectrumValue> psd;
+    /// Power of the signal over the RBs of interest before propagation loss.
+    double power;
+  };
+
+  /**
+   * A set of consecutive points of the map evaluated by the direct
+   * computation. Each worker owns the mobility models it uses, so that
+   * several workers can run concurrently in separate threads.
+   */
+  struct RemWorker
+  {
+    /// Evaluate the SINR of every point in [m_begin, m_end).
+    void Run ();
+
+    RadioEnvironmentMapHelper *m_helper;  ///< Helper which owns the worker.
+    std::vector<RemSource> m_sources;     ///< Transmitters seen by the worker.
+    Ptr<MobilityModel> *m_rxMobilities;   ///< Listening points, one per point.
+    bool m_makeConsistent;                ///< Update the building info of the listening points.
+    uint32_t m_begin;                     ///< Index of the first point.
+    uint32_t m_end;                       ///< Index past the last point.
+    double *m_sinr;                       ///< Output, one value per point.
+  };
+
+  /**
+   * Compute the SINR with respect to the strongest transmitter at the
+   * current position of the listening point.
+   *
+   * \param sources the transmitters
+   * \param rxMobility the position of the listening point
+   * \return the SINR in linear units
+   */
+  double ComputeDirectSinr (const std::vector<RemSource> &sources,
+                            Ptr<MobilityModel> rxMobility) const;
+
+  /**
+   * \param model the first propagation loss model of a chain
+   * \return true if every model of the chain is deterministic and keeps
+   *         no state, so that the loss can be computed concurrently by
+   *         several threads
+   */
+  static bool IsThreadSafe (Ptr<PropagationLossModel> model);
+
+  /**
+   * \param index the index of a point of the map
+   * \return the coordinates of the point
+   */
+  Vector GetPointPosition (uint32_t index) const;
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -152,6 +231,22 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_directComputation;  ///< The `DirectComputation` attribute.
+  uint32_t m_numThreads;     ///< The `NumThreads` attribute.
+
+  /// Listener used to capture the signals for the direct computation.
+  Ptr<RemSpectrumPhy> m_probe;
+  /// X coordinates of the points of the map, in increasing order.
+  std::vector<double> m_xPoints;
+  /// Y coordinates of the points of the map, in increasing order.
+  std::vector<double> m_yPoints;
+  /// Loss model of the channel used by the direct computation.
+  Ptr<PropagationLossModel> m_propagationLoss;
+  /// Frequency-dependent loss model of the channel used by the direct computation.
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
+  /// Loss beyond which the channel does not deliver a signal, in dB.
+  double m_maxLossDb;
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
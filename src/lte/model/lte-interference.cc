@@ -53,6 +53,8 @@ LteInterference::DoDispose ()
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
+  m_interf = 0;
+  m_sinr = 0;
   Object::DoDispose ();
 } 
 
@@ -75,7 +77,15 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
   if (m_receiving == false)
     {
       NS_LOG_LOGIC ("first signal");
-      m_rxSignal = rxPsd->Copy ();
+      if (m_rxSignal != 0 && m_rxSignal->GetSpectrumModel () == rxPsd->GetSpectrumModel ())
+        {
+          // reuse the buffer of the previous reception
+          *m_rxSignal = *rxPsd;
+        }
+      else
+        {
+          m_rxSignal = rxPsd->Copy ();
+        }
       m_lastChangeTime = Now ();
       m_receiving = true;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
@@ -135,7 +145,15 @@ void
 LteInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
 {
   NS_LOG_FUNCTION (this << *spd << duration);
-  DoAddSignal (spd);
+  // restrict the additions and subtractions to the bands actually
+  // occupied by the signal (e.g., the RBs allocated to an UL transmission)
+  size_t start;
+  size_t end;
+  if (!spd->GetOccupiedBands (start, end))
+    {
+      start = end = 0;
+    }
+  DoAddSignal (spd, start, end);
   uint32_t signalId = ++m_lastSignalId;
   if (signalId == m_lastSignalIdBeforeReset)
     {
@@ -146,27 +164,27 @@ LteInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
       // boundary further.
       m_lastSignalIdBeforeReset += 0x10000000;
     }
-  Simulator::Schedule (duration, &LteInterference::DoSubtractSignal, this, spd, signalId);
+  Simulator::Schedule (duration, &LteInterference::DoSubtractSignal, this, spd, signalId, start, end);
 }
 
 
 void
-LteInterference::DoAddSignal  (Ptr<const SpectrumValue> spd)
+LteInterference::DoAddSignal  (Ptr<const SpectrumValue> spd, size_t start, size_t end)
 { 
   NS_LOG_FUNCTION (this << *spd);
   ConditionallyEvaluateChunk ();
-  (*m_allSignals) += (*spd);
+  m_allSignals->AddBands (*spd, start, end);
 }
 
 void
-LteInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId)
+LteInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId, size_t start, size_t end)
 { 
   NS_LOG_FUNCTION (this << *spd);
   ConditionallyEvaluateChunk ();   
   int32_t deltaSignalId = signalId - m_lastSignalIdBeforeReset;
   if (deltaSignalId > 0)
     {   
-      (*m_allSignals) -= (*spd);
+      m_allSignals->SubtractBands (*spd, start, end);
     }
   else
     {
@@ -188,17 +206,18 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
-
-      SpectrumValue sinr = (*m_rxSignal) / interf;
+      // compute the interference and the SINR in the preallocated buffers
+      m_interf->SetInterferencePlusNoise (*m_allSignals, *m_rxSignal, *m_noise);
+      *m_sinr = *m_rxSignal;
+      *m_sinr /= *m_interf;
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (sinr, duration);
+          (*it)->EvaluateChunk (*m_sinr, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (interf, duration);
+          (*it)->EvaluateChunk (*m_interf, duration);
         }
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
@@ -217,6 +236,8 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   // reset m_allSignals (will reset if already set previously)
   // this is needed since this method can potentially change the SpectrumModel
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_interf = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_sinr = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
   if (m_receiving == true)
     {
       // abort rx
@@ -116,8 +116,8 @@ public:
 
 private:
   void ConditionallyEvaluateChunk ();
-  void DoAddSignal  (Ptr<const SpectrumValue> spd);
-  void DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId);
+  void DoAddSignal  (Ptr<const SpectrumValue> spd, size_t start, size_t end);
+  void DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId, size_t start, size_t end);
 
 
 
@@ -135,6 +135,14 @@ private:
 
   Ptr<const SpectrumValue> m_noise;
 
+  Ptr<SpectrumValue> m_interf; /**< buffer where the interference plus
+                                * noise of each chunk is computed
+                                */
+
+  Ptr<SpectrumValue> m_sinr; /**< buffer where the SINR of each chunk
+                              * is computed
+                              */
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
@@ -43,7 +43,8 @@ RemSpectrumPhy::RemSpectrumPhy ()
     m_sumPower (0),
     m_active (true),
     m_useDataChannel (false),
-    m_rbId (-1)
+    m_rbId (-1),
+    m_recordSignals (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -60,6 +61,7 @@ RemSpectrumPhy::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_mobility = 0;
+  m_recordedSignals.clear ();
   SpectrumPhy::DoDispose ();
 }
 
@@ -134,21 +136,7 @@ RemSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
           if (lteDlDataRxParams != 0)
             {
               NS_LOG_DEBUG ("StartRx data");
-              double power = 0;
-              if (m_rbId >= 0)
-                {
-                  power = (*(params->psd))[m_rbId] * 180000;
-                }
-              else
-                {
-                  power = Integral (*(params->psd));
-                }
-
-              m_sumPower += power;
-              if (power > m_referenceSignalPower)
-                {
-                  m_referenceSignalPower = power;
-                }
+              ProcessSignal (params);
             }
         }
       else
@@ -157,26 +145,37 @@ RemSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
           if (lteDlCtrlRxParams != 0)
             {
               NS_LOG_DEBUG ("StartRx control");
-              double power = 0;
-              if (m_rbId >= 0)
-                {
-                  power = (*(params->psd))[m_rbId] * 180000;
-                }
-              else
-                {
-                  power = Integral (*(params->psd));
-                }
-
-              m_sumPower += power;
-              if (power > m_referenceSignalPower)
-                {
-                  m_referenceSignalPower = power;
-                }
+              ProcessSignal (params);
             }
         }
     }
 }
 
+void
+RemSpectrumPhy::ProcessSignal (Ptr<SpectrumSignalParameters> params)
+{
+  double power = 0;
+  if (m_rbId >= 0)
+    {
+      power = (*(params->psd))[m_rbId] * 180000;
+    }
+  else
+    {
+      power = Integral (*(params->psd));
+    }
+
+  m_sumPower += power;
+  if (power > m_referenceSignalPower)
+    {
+      m_referenceSignalPower = power;
+    }
+
+  if (m_recordSignals)
+    {
+      m_recordedSignals.push_back (params);
+    }
+}
+
 void
 RemSpectrumPhy::SetRxSpectrumModel (Ptr<const SpectrumModel> m)
 {
@@ -207,6 +206,7 @@ RemSpectrumPhy::Reset ()
 {
   m_referenceSignalPower = 0;
   m_sumPower = 0;
+  m_recordedSignals.clear ();
 }
 
 void
@@ -221,5 +221,17 @@ RemSpectrumPhy::SetRbId (int32_t rbId)
   m_rbId = rbId;
 }
 
+void
+RemSpectrumPhy::SetRecordSignals (bool value)
+{
+  m_recordSignals = value;
+}
+
+std::vector<Ptr<SpectrumSignalParameters> >
+RemSpectrumPhy::GetRecordedSignals () const
+{
+  return m_recordedSignals;
+}
+
 
 } // namespace ns3
@@ -30,6 +30,7 @@
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-channel.h>
 #include <string>
+#include <vector>
 #include <fstream>
 
 namespace ns3 {
@@ -114,7 +115,29 @@ public:
    */
   void SetRbId (int32_t rbId);
 
+  /**
+   * set whether the parameters of the processed signals are recorded
+   *
+   * \param value if true, the parameters of every signal which
+   * contributes to the SINR are stored until the next call to Reset ()
+   */
+  void SetRecordSignals (bool value);
+
+  /**
+   *
+   * \return the parameters of the signals recorded since the last Reset ()
+   */
+  std::vector<Ptr<SpectrumSignalParameters> > GetRecordedSignals () const;
+
 private:
+  /**
+   * account for the power of a received signal
+   *
+   * \param params the parameters of the received signal
+   */
+  void ProcessSignal (Ptr<SpectrumSignalParameters> params);
+
+
   Ptr<MobilityModel> m_mobility;
   Ptr<const SpectrumModel> m_rxSpectrumModel;
 
@@ -126,6 +149,9 @@ private:
   bool m_useDataChannel;
   int32_t m_rbId;
 
+  bool m_recordSignals;
+  std::vector<Ptr<SpectrumSignalParameters> > m_recordedSignals;
+
 };
 
 
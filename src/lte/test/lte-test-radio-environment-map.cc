@@ -0,0 +1,198 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/position-allocator.h"
+#include "ns3/buildings-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/radio-environment-map-helper.h"
+#include "ns3/spectrum-channel.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/random-variable-stream.h"
+
+#include <fstream>
+#include <vector>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestRadioEnvironmentMap");
+
+/**
+ * Generate the same REM with the simulated generation and with the
+ * direct computation using one or several threads, and check that the
+ * maps are the same. With a random propagation loss model on the
+ * channel, the direct computation must fall back to a single thread,
+ * so that the map does not depend on the NumThreads attribute either.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+public:
+  LteRadioEnvironmentMapTestCase (bool randomLoss);
+  virtual ~LteRadioEnvironmentMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// A point of the map: x, y, z and SINR.
+  struct Point
+  {
+    double x;
+    double y;
+    double z;
+    double sinr;
+  };
+
+  /**
+   * Generate a REM in a new simulation.
+   *
+   * \param directComputation the `DirectComputation` attribute
+   * \param numThreads the `NumThreads` attribute
+   * \param filename the output file
+   * \return the points of the map
+   */
+  std::vector<Point> GenerateRem (bool directComputation, uint32_t numThreads, std::string filename);
+
+  bool m_randomLoss;
+};
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase (bool randomLoss)
+  : TestCase (randomLoss ? "REM with a random propagation loss model" : "REM with a deterministic propagation loss model"),
+    m_randomLoss (randomLoss)
+{
+}
+
+LteRadioEnvironmentMapTestCase::~LteRadioEnvironmentMapTestCase ()
+{
+}
+
+std::vector<LteRadioEnvironmentMapTestCase::Point>
+LteRadioEnvironmentMapTestCase::GenerateRem (bool directComputation, uint32_t numThreads, std::string filename)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 10.0));
+  positionAlloc->Add (Vector (300.0, 0.0, 10.0));
+  positionAlloc->Add (Vector (150.0, 250.0, 10.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  BuildingsHelper::Install (enbNodes);
+  lteHelper->InstallEnbDevice (enbNodes);
+
+  Ptr<SpectrumChannel> channel = Config::LookupMatches ("/ChannelList/0").Get (0)->GetObject<SpectrumChannel> ();
+  if (m_randomLoss)
+    {
+      Ptr<RandomPropagationLossModel> randomLoss = CreateObject<RandomPropagationLossModel> ();
+      Ptr<UniformRandomVariable> variable = CreateObject<UniformRandomVariable> ();
+      variable->SetAttribute ("Max", DoubleValue (10.0));
+      randomLoss->SetAttribute ("Variable", PointerValue (variable));
+      randomLoss->AssignStreams (1);
+      channel->GetPropagationLossModel ()->SetNext (randomLoss);
+    }
+
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue ("/ChannelList/0"));
+  remHelper->SetAttribute ("OutputFile", StringValue (filename));
+  remHelper->SetAttribute ("XMin", DoubleValue (-100.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (400.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (21));
+  remHelper->SetAttribute ("YMin", DoubleValue (-100.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (350.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (17));
+  remHelper->SetAttribute ("Z", DoubleValue (1.5));
+  // several blocks of points, the last one being partial
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (100));
+  remHelper->SetAttribute ("DirectComputation", BooleanValue (directComputation));
+  remHelper->SetAttribute ("NumThreads", UintegerValue (numThreads));
+  remHelper->Install ();
+
+  BuildingsHelper::MakeMobilityModelConsistent ();
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::vector<Point> points;
+  std::ifstream in (filename.c_str ());
+  Point p;
+  while (in >> p.x >> p.y >> p.z >> p.sinr)
+    {
+      points.push_back (p);
+    }
+  return points;
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun (void)
+{
+  std::vector<Point> simulated = GenerateRem (false, 1, CreateTempDirFilename ("rem-simulated.out"));
+  std::vector<Point> direct = GenerateRem (true, 1, CreateTempDirFilename ("rem-direct.out"));
+  std::vector<Point> threads = GenerateRem (true, 4, CreateTempDirFilename ("rem-threads.out"));
+
+  NS_TEST_ASSERT_MSG_EQ (direct.size (), 21 * 17, "wrong number of points with the direct computation");
+  NS_TEST_ASSERT_MSG_EQ (threads.size (), direct.size (), "wrong number of points with several threads");
+  for (uint32_t i = 0; i < direct.size (); ++i)
+    {
+      // the same code computes every point, so the maps must be identical
+      NS_TEST_ASSERT_MSG_EQ (threads[i].x, direct[i].x, "different point " << i << " with several threads");
+      NS_TEST_ASSERT_MSG_EQ (threads[i].y, direct[i].y, "different point " << i << " with several threads");
+      NS_TEST_ASSERT_MSG_EQ (threads[i].sinr, direct[i].sinr, "different SINR at point " << i << " with several threads");
+    }
+
+  if (m_randomLoss)
+    {
+      // the random loss is drawn in a different order by the simulated
+      // generation, hence the SINR values cannot be compared
+      return;
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (simulated.size (), direct.size (), "the direct computation has a different number of points");
+  for (uint32_t i = 0; i < direct.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (direct[i].x, simulated[i].x, "different point " << i << " with the direct computation");
+      NS_TEST_ASSERT_MSG_EQ (direct[i].y, simulated[i].y, "different point " << i << " with the direct computation");
+      NS_TEST_ASSERT_MSG_EQ_TOL (direct[i].sinr, simulated[i].sinr, 1e-5 * simulated[i].sinr,
+                                 "different SINR at point " << i << " with the direct computation");
+    }
+}
+
+
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+public:
+  LteRadioEnvironmentMapTestSuite ();
+};
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite ()
+  : TestSuite ("lte-radio-environment-map", SYSTEM)
+{
+  AddTestCase (new LteRadioEnvironmentMapTestCase (false), TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase (true), TestCase::QUICK);
+}
+
+static LteRadioEnvironmentMapTestSuite g_lteRadioEnvironmentMapTestSuite;
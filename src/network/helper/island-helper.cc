@@ -0,0 +1,333 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "island-helper.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/simulator.h"
+#include "ns3/net-device.h"
+#include "ns3/channel.h"
+#include "ns3/core-config.h"
+#include <map>
+#include <set>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#if defined (HAVE_UNISTD_H) and defined (HAVE_SYS_TYPES_H) and defined (HAVE_SYS_WAIT_H)
+/** Do we have the \c fork and \c waitpid functions? */
+#define HAVE_FORK
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("IslandHelper");
+
+/**
+ * Find the representative of a set in a union-find forest.
+ *
+ * \param parents the parent of every element
+ * \param i the element
+ * \return the representative of the set of the element
+ */
+static uint32_t
+FindRoot (std::vector<uint32_t> &parents, uint32_t i)
+{
+  while (parents[i] != i)
+    {
+      parents[i] = parents[parents[i]];
+      i = parents[i];
+    }
+  return i;
+}
+
+IslandHelper::IslandHelper ()
+  : m_maxProcesses (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::vector<NodeContainer>
+IslandHelper::GetIslands (NodeContainer nodes)
+{
+  NS_LOG_FUNCTION (nodes.GetN ());
+
+  // position in the container of every node, by node id
+  std::map<uint32_t, uint32_t> positions;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      positions[nodes.Get (i)->GetId ()] = i;
+    }
+
+  std::vector<uint32_t> parents (nodes.GetN ());
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      parents[i] = i;
+    }
+
+  // Merge the nodes attached to every channel, visiting each channel once.
+  std::set<uint32_t> channels;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Node> node = nodes.Get (i);
+      for (uint32_t j = 0; j < node->GetNDevices (); j++)
+        {
+          Ptr<Channel> channel = node->GetDevice (j)->GetChannel ();
+          if (channel == 0 || !channels.insert (channel->GetId ()).second)
+            {
+              continue;
+            }
+          for (uint32_t k = 0; k < channel->GetNDevices (); k++)
+            {
+              Ptr<NetDevice> device = channel->GetDevice (k);
+              if (device == 0 || device->GetNode () == 0)
+                {
+                  continue;
+                }
+              std::map<uint32_t, uint32_t>::const_iterator it = positions.find (device->GetNode ()->GetId ());
+              if (it != positions.end ())
+                {
+                  parents[FindRoot (parents, it->second)] = FindRoot (parents, i);
+                }
+            }
+        }
+    }
+
+  std::vector<NodeContainer> islands;
+  std::map<uint32_t, uint32_t> islandOfRoot;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      uint32_t root = FindRoot (parents, i);
+      std::map<uint32_t, uint32_t>::const_iterator it = islandOfRoot.find (root);
+      if (it == islandOfRoot.end ())
+        {
+          it = islandOfRoot.insert (std::make_pair (root, islands.size ())).first;
+          islands.push_back (NodeContainer ());
+        }
+      islands[it->second].Add (nodes.Get (i));
+    }
+  NS_LOG_DEBUG (nodes.GetN () << " nodes in " << islands.size () << " islands");
+  return islands;
+}
+
+void
+IslandHelper::SetMaxProcesses (uint32_t maxProcesses)
+{
+  NS_LOG_FUNCTION (this << maxProcesses);
+  m_maxProcesses = maxProcesses;
+}
+
+void
+IslandHelper::SetIslandBuildCallback (IslandBuildCallback callback)
+{
+  NS_LOG_FUNCTION (this);
+  m_buildCallback = callback;
+}
+
+void
+IslandHelper::SetIslandStartCallback (IslandCallback callback)
+{
+  NS_LOG_FUNCTION (this);
+  m_startCallback = callback;
+}
+
+void
+IslandHelper::SetIslandEndCallback (IslandCallback callback)
+{
+  NS_LOG_FUNCTION (this);
+  m_endCallback = callback;
+}
+
+void
+IslandHelper::SetIslandResultsCallback (IslandResultsCallback callback)
+{
+  NS_LOG_FUNCTION (this);
+  m_resultsCallback = callback;
+}
+
+void
+IslandHelper::SetMergeCallback (MergeCallback callback)
+{
+  NS_LOG_FUNCTION (this);
+  m_mergeCallback = callback;
+}
+
+bool
+IslandHelper::Run (uint32_t nIslands, Time stopTime)
+{
+  NS_LOG_FUNCTION (this << nIslands << stopTime);
+  NS_ABORT_MSG_IF (m_buildCallback.IsNull (), "IslandHelper::Run(): no island build callback");
+
+#ifndef HAVE_FORK
+  if (nIslands > 1)
+    {
+      NS_LOG_WARN ("Processes are not supported in this build, simulating the " << nIslands << " islands together");
+    }
+#endif
+  if (nIslands <= 1 || !IsSupported ())
+    {
+      std::vector<NodeContainer> islands;
+      for (uint32_t i = 0; i < nIslands; i++)
+        {
+          islands.push_back (m_buildCallback (i));
+        }
+      for (uint32_t i = 0; i < nIslands && !m_startCallback.IsNull (); i++)
+        {
+          m_startCallback (i, islands[i]);
+        }
+      Simulator::Stop (stopTime);
+      Simulator::Run ();
+      for (uint32_t i = 0; i < nIslands && !m_endCallback.IsNull (); i++)
+        {
+          m_endCallback (i, islands[i]);
+        }
+      for (uint32_t i = 0; i < nIslands && !m_mergeCallback.IsNull (); i++)
+        {
+          m_mergeCallback (i, m_resultsCallback.IsNull () ? std::string () : m_resultsCallback (i, islands[i]));
+        }
+      return true;
+    }
+
+#ifdef HAVE_FORK
+
+  uint32_t maxProcesses = m_maxProcesses;
+  if (maxProcesses == 0)
+    {
+      long nProcessors = sysconf (_SC_NPROCESSORS_ONLN);
+      maxProcesses = nProcessors > 0 ? nProcessors : 1;
+    }
+
+  // Do not let every process flush what the caller has buffered so far.
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::fflush (0);
+
+  // The results of an island are written by its process to a temporary
+  // file, read once the process is over: unlike a pipe, the file never
+  // blocks the process when the results are large.
+  std::map<pid_t, std::pair<uint32_t, FILE *> > running;
+  std::vector<std::string> results (nIslands);
+  std::vector<bool> simulated (nIslands, false);
+  uint32_t next = 0;
+  bool success = true;
+  while (next < nIslands || !running.empty ())
+    {
+      if (next < nIslands && running.size () < maxProcesses)
+        {
+          FILE *file = std::tmpfile ();
+          NS_ABORT_MSG_IF (file == 0, "IslandHelper::Run(): tmpfile() fails, errno = " << std::strerror (errno));
+          pid_t pid = ::fork ();
+          NS_ABORT_MSG_IF (pid == -1, "IslandHelper::Run(): fork() fails, errno = " << std::strerror (errno));
+          if (pid == 0)
+            {
+              std::string islandResults = RunIsland (next, stopTime);
+              std::fwrite (islandResults.data (), 1, islandResults.size (), file);
+              bool written = std::fflush (file) == 0;
+              Simulator::Destroy ();
+              std::cout.flush ();
+              std::cerr.flush ();
+              std::fflush (0);
+              _exit (written ? 0 : 1);
+            }
+          NS_LOG_INFO ("Island " << next << " simulated by process " << pid);
+          running[pid] = std::make_pair (next++, file);
+          continue;
+        }
+
+      int st;
+      pid_t pid = waitpid (-1, &st, 0);
+      NS_ABORT_MSG_IF (pid == -1, "IslandHelper::Run(): waitpid() fails, errno = " << std::strerror (errno));
+      std::map<pid_t, std::pair<uint32_t, FILE *> >::iterator it = running.find (pid);
+      if (it == running.end ())
+        {
+          continue;
+        }
+      uint32_t index = it->second.first;
+      FILE *file = it->second.second;
+      if (!WIFEXITED (st) || WEXITSTATUS (st) != 0)
+        {
+          NS_LOG_WARN ("Simulation of island " << index << " failed");
+          success = false;
+        }
+      else
+        {
+          std::rewind (file);
+          char buffer[4096];
+          std::size_t n;
+          while ((n = std::fread (buffer, 1, sizeof (buffer), file)) > 0)
+            {
+              results[index].append (buffer, n);
+            }
+          simulated[index] = true;
+        }
+      std::fclose (file);
+      running.erase (it);
+    }
+
+  // Merge the results in the order of the islands, whatever the order in
+  // which their processes ended.
+  for (uint32_t i = 0; i < nIslands && !m_mergeCallback.IsNull (); i++)
+    {
+      if (simulated[i])
+        {
+          m_mergeCallback (i, results[i]);
+        }
+    }
+  return success;
+#else /* HAVE_FORK */
+  return false;
+#endif /* HAVE_FORK */
+}
+
+bool
+IslandHelper::IsSupported (void)
+{
+#ifdef HAVE_FORK
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::string
+IslandHelper::RunIsland (uint32_t index, Time stopTime)
+{
+  NS_LOG_FUNCTION (this << index << stopTime);
+
+  NodeContainer nodes = m_buildCallback (index);
+  NS_LOG_DEBUG ("Island " << index << ": " << nodes.GetN () << " nodes");
+  if (!m_startCallback.IsNull ())
+    {
+      m_startCallback (index, nodes);
+    }
+  Simulator::Stop (stopTime);
+  Simulator::Run ();
+  if (!m_endCallback.IsNull ())
+    {
+      m_endCallback (index, nodes);
+    }
+  if (m_resultsCallback.IsNull ())
+    {
+      return std::string ();
+    }
+  return m_resultsCallback (index, nodes);
+}
+
+} // namespace ns3
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ISLAND_HELPER_H
+#define ISLAND_HELPER_H
+
+#include <string>
+#include <vector>
+#include "ns3/callback.h"
+#include "ns3/nstime.h"
+#include "ns3/node-container.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Simulate independent groups of nodes in separate processes.
+ *
+ * Two nodes belong to the same island if they are attached, directly or
+ * through other nodes, to a common channel. For instance, a deployment
+ * made of BSSs that each use their own YansWifiChannel or SpectrumChannel
+ * instance, with no node attached to more than one of them and no wired
+ * link between them, is made of one island per channel. GetIslands ()
+ * finds the islands of a scenario.
+ *
+ * Packets never cross the boundary of an island, so the islands can be
+ * simulated separately. Run () forks one process per island, at most
+ * MaxProcesses at a time. The process of an island:
+ *  - invokes the island build callback, which creates the nodes, channels,
+ *    devices and applications of that island only;
+ *  - invokes the island start callback (e.g., to install a FlowMonitor on
+ *    the nodes of the island or to open per-island trace files);
+ *  - runs the simulation until the stop time;
+ *  - invokes the island end callback (e.g., to write per-island files);
+ *  - invokes the island results callback, and sends the string it returns
+ *    (e.g., FlowMonitor statistics) to the calling process.
+ *
+ * Once every island has been simulated, the calling process invokes the
+ * merge callback with the results of every island, in the order of the
+ * islands, to combine them.
+ *
+ * Nothing must be simulated in the calling process before Run () is
+ * called: the nodes created there would be simulated in every process.
+ * Since every process only builds its own island, the node identifiers
+ * start from zero in every process. The results of an island are the
+ * same as when all the islands are simulated together if the build
+ * callback assigns the random variable streams of the island (see, e.g.,
+ * WifiHelper::AssignStreams) from a base which only depends on the index
+ * of the island.
+ *
+ * Islands are simulated in separate processes only on systems which
+ * provide fork () and waitpid (). Elsewhere (see IsSupported ()), Run ()
+ * builds and simulates all the islands together in the calling process,
+ * and invokes the callbacks for every island in turn.
+ */
+class IslandHelper
+{
+public:
+  /**
+   * Callback invoked with the index of an island, which returns the nodes
+   * it created for that island.
+   */
+  typedef Callback<NodeContainer, uint32_t> IslandBuildCallback;
+  /**
+   * Callback invoked with the index of an island and its nodes.
+   */
+  typedef Callback<void, uint32_t, NodeContainer> IslandCallback;
+  /**
+   * Callback invoked with the index of an island and its nodes, which
+   * returns the results of that island.
+   */
+  typedef Callback<std::string, uint32_t, NodeContainer> IslandResultsCallback;
+  /**
+   * Callback invoked with the index of an island and its results.
+   */
+  typedef Callback<void, uint32_t, std::string> MergeCallback;
+
+  IslandHelper ();
+
+  /**
+   * Group the given nodes into islands. The nodes attached to a channel
+   * are in the same island as the other nodes of the given container
+   * attached to that channel; a node attached to no channel is an island
+   * by itself.
+   *
+   * \param nodes the nodes to group
+   * \return the islands, ordered by their first node in the given container
+   */
+  static std::vector<NodeContainer> GetIslands (NodeContainer nodes);
+
+  /**
+   * \param maxProcesses the maximum number of islands simulated at the
+   *        same time. If zero, the number of online processors is used.
+   */
+  void SetMaxProcesses (uint32_t maxProcesses);
+  /**
+   * \param callback the callback which builds an island in the process
+   *        of that island
+   */
+  void SetIslandBuildCallback (IslandBuildCallback callback);
+  /**
+   * \param callback the callback invoked in the process of an island,
+   *        before the simulation starts
+   */
+  void SetIslandStartCallback (IslandCallback callback);
+  /**
+   * \param callback the callback invoked in the process of an island,
+   *        after the simulation is over and before Simulator::Destroy
+   */
+  void SetIslandEndCallback (IslandCallback callback);
+  /**
+   * \param callback the callback invoked in the process of an island,
+   *        after the island end callback, whose result is passed to the
+   *        merge callback
+   */
+  void SetIslandResultsCallback (IslandResultsCallback callback);
+  /**
+   * \param callback the callback invoked in the calling process, once
+   *        every island has been simulated, with the results of every
+   *        island successfully simulated
+   */
+  void SetMergeCallback (MergeCallback callback);
+
+  /**
+   * \return true if the islands can be simulated in separate processes
+   */
+  static bool IsSupported (void);
+
+  /**
+   * Build and simulate the given number of islands until the given time.
+   * If there is a single island, or if separate processes are not
+   * supported, the islands are built and simulated together in the
+   * calling process. Otherwise, the calling process only waits for the
+   * island processes and merges their results.
+   * As after Simulator::Run, the caller is responsible for calling
+   * Simulator::Destroy.
+   *
+   * \param nIslands the number of islands of the scenario
+   * \param stopTime the time at which the simulation of every island stops
+   * \return true if all the islands were successfully simulated
+   */
+  bool Run (uint32_t nIslands, Time stopTime);
+
+private:
+  /**
+   * Simulate an island built in the current process.
+   *
+   * \param index the index of the island to simulate
+   * \param stopTime the time at which the simulation stops
+   * \return the results of the island
+   */
+  std::string RunIsland (uint32_t index, Time stopTime);
+
+  uint32_t m_maxProcesses;                  //!< maximum number of concurrent island processes
+  IslandBuildCallback m_buildCallback;      //!< builds an island
+  IslandCallback m_startCallback;           //!< invoked before the simulation of an island
+  IslandCallback m_endCallback;             //!< invoked after the simulation of an island
+  IslandResultsCallback m_resultsCallback;  //!< returns the results of an island
+  MergeCallback m_mergeCallback;            //!< merges the results of the islands
+};
+
+} // namespace ns3
+
+#endif /* ISLAND_HELPER_H */
@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/traced-callback.h"
+#include "ns3/packet.h"
+#include "ns3/island-helper.h"
+#include "ns3/packet-socket-helper.h"
+#include "ns3/packet-socket-client.h"
+#include "ns3/packet-socket-server.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/node-list.h"
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * Attach a new SimpleNetDevice of the given node to the given channel.
+ *
+ * \param node the node
+ * \param channel the channel
+ * \return the device
+ */
+static Ptr<SimpleNetDevice>
+AddSimpleDevice (Ptr<Node> node, Ptr<SimpleChannel> channel)
+{
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  node->AddDevice (device);
+  device->SetChannel (channel);
+  device->SetNode (node);
+  return device;
+}
+
+/**
+ * Check the grouping of nodes into islands.
+ */
+class IslandHelperGetIslandsTest : public TestCase
+{
+public:
+  IslandHelperGetIslandsTest ();
+  virtual void DoRun (void);
+};
+
+IslandHelperGetIslandsTest::IslandHelperGetIslandsTest ()
+  : TestCase ("Check the grouping of nodes into islands")
+{
+}
+
+void
+IslandHelperGetIslandsTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (7);
+
+  // Island of nodes 0 and 5, island of nodes 1, 2, 3 and 6 (node 2 is
+  // attached to both channels), and node 4 alone.
+  Ptr<SimpleChannel> a = CreateObject<SimpleChannel> ();
+  Ptr<SimpleChannel> b = CreateObject<SimpleChannel> ();
+  Ptr<SimpleChannel> c = CreateObject<SimpleChannel> ();
+  AddSimpleDevice (nodes.Get (0), a);
+  AddSimpleDevice (nodes.Get (5), a);
+  AddSimpleDevice (nodes.Get (1), b);
+  AddSimpleDevice (nodes.Get (2), b);
+  AddSimpleDevice (nodes.Get (2), c);
+  AddSimpleDevice (nodes.Get (3), c);
+  AddSimpleDevice (nodes.Get (6), c);
+
+  std::vector<NodeContainer> islands = IslandHelper::GetIslands (nodes);
+  NS_TEST_ASSERT_MSG_EQ (islands.size (), 3, "Wrong number of islands");
+  NS_TEST_ASSERT_MSG_EQ (islands[0].GetN (), 2, "Wrong size of the first island");
+  NS_TEST_EXPECT_MSG_EQ (islands[0].Get (0), nodes.Get (0), "Wrong node in the first island");
+  NS_TEST_EXPECT_MSG_EQ (islands[0].Get (1), nodes.Get (5), "Wrong node in the first island");
+  NS_TEST_ASSERT_MSG_EQ (islands[1].GetN (), 4, "Wrong size of the second island");
+  NS_TEST_EXPECT_MSG_EQ (islands[1].Get (0), nodes.Get (1), "Wrong node in the second island");
+  NS_TEST_EXPECT_MSG_EQ (islands[1].Get (1), nodes.Get (2), "Wrong node in the second island");
+  NS_TEST_EXPECT_MSG_EQ (islands[1].Get (2), nodes.Get (3), "Wrong node in the second island");
+  NS_TEST_EXPECT_MSG_EQ (islands[1].Get (3), nodes.Get (6), "Wrong node in the second island");
+  NS_TEST_ASSERT_MSG_EQ (islands[2].GetN (), 1, "Wrong size of the third island");
+  NS_TEST_EXPECT_MSG_EQ (islands[2].Get (0), nodes.Get (4), "Wrong node in the third island");
+
+  // Nodes outside the container do not merge islands.
+  NodeContainer subset (nodes.Get (1), nodes.Get (3), nodes.Get (6));
+  islands = IslandHelper::GetIslands (subset);
+  NS_TEST_EXPECT_MSG_EQ (islands.size (), 2, "Wrong number of islands of the subset");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that every island is built and simulated in its own process, and
+ * that the results of the islands are merged in the calling process.
+ */
+class IslandHelperRunTest : public TestCase
+{
+public:
+  IslandHelperRunTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Count a packet received by a server.
+   *
+   * \param counter the number of packets received by the server
+   * \param packet the packet
+   * \param from the sender
+   */
+  static void ReceivePkt (uint32_t *counter, Ptr<const Packet> packet, const Address &from);
+  /**
+   * Build an island made of a client sending 3 packets to a server.
+   *
+   * \param index the index of the island
+   * \return the nodes of the island
+   */
+  NodeContainer BuildIsland (uint32_t index);
+  /**
+   * \param index the index of the island
+   * \param nodes the nodes of the island
+   * \return the number of packets received by the server of the island and
+   *         the number of nodes created in the process
+   */
+  std::string GetResults (uint32_t index, NodeContainer nodes);
+  /**
+   * \param index the index of the island
+   * \param results the results of the island
+   */
+  void MergeResults (uint32_t index, std::string results);
+
+  std::vector<uint32_t> m_received; //!< number of packets received by every server
+  std::vector<uint32_t> m_merged;   //!< merged number of packets received by every server
+  std::vector<uint32_t> m_nNodes;   //!< number of nodes created in the process of every island
+};
+
+IslandHelperRunTest::IslandHelperRunTest ()
+  : TestCase ("Check the simulation of islands in separate processes")
+{
+}
+
+void
+IslandHelperRunTest::ReceivePkt (uint32_t *counter, Ptr<const Packet> packet, const Address &from)
+{
+  (*counter)++;
+}
+
+NodeContainer
+IslandHelperRunTest::BuildIsland (uint32_t index)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (nodes);
+
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  Ptr<SimpleNetDevice> txDev = AddSimpleDevice (nodes.Get (0), channel);
+  Ptr<SimpleNetDevice> rxDev = AddSimpleDevice (nodes.Get (1), channel);
+
+  PacketSocketAddress socketAddr;
+  socketAddr.SetSingleDevice (txDev->GetIfIndex ());
+  socketAddr.SetPhysicalAddress (rxDev->GetAddress ());
+  socketAddr.SetProtocol (1);
+
+  Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+  client->SetRemote (socketAddr);
+  client->SetAttribute ("PacketSize", UintegerValue (1000));
+  client->SetAttribute ("MaxPackets", UintegerValue (3));
+  nodes.Get (0)->AddApplication (client);
+
+  Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+  server->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&IslandHelperRunTest::ReceivePkt, &m_received[index]));
+  server->SetLocal (socketAddr);
+  nodes.Get (1)->AddApplication (server);
+  return nodes;
+}
+
+std::string
+IslandHelperRunTest::GetResults (uint32_t index, NodeContainer nodes)
+{
+  std::ostringstream oss;
+  oss << m_received[index] << " " << NodeList::GetNNodes ();
+  return oss.str ();
+}
+
+void
+IslandHelperRunTest::MergeResults (uint32_t index, std::string results)
+{
+  std::istringstream iss (results);
+  iss >> m_merged[index] >> m_nNodes[index];
+}
+
+void
+IslandHelperRunTest::DoRun (void)
+{
+  const uint32_t nIslands = 3;
+  m_received = std::vector<uint32_t> (nIslands, 0);
+  m_merged = std::vector<uint32_t> (nIslands, 0);
+  m_nNodes = std::vector<uint32_t> (nIslands, 0);
+
+  IslandHelper islandHelper;
+  islandHelper.SetMaxProcesses (2);
+  islandHelper.SetIslandBuildCallback (MakeCallback (&IslandHelperRunTest::BuildIsland, this));
+  islandHelper.SetIslandResultsCallback (MakeCallback (&IslandHelperRunTest::GetResults, this));
+  islandHelper.SetMergeCallback (MakeCallback (&IslandHelperRunTest::MergeResults, this));
+  bool success = islandHelper.Run (nIslands, Seconds (10));
+  NS_TEST_EXPECT_MSG_EQ (success, true, "An island was not simulated as expected");
+
+  for (uint32_t i = 0; i < nIslands; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_merged[i], 3, "Wrong number of packets received in island " << i);
+      if (IslandHelper::IsSupported ())
+        {
+          NS_TEST_EXPECT_MSG_EQ (m_nNodes[i], 2, "Nodes of other islands built in the process of island " << i);
+          NS_TEST_EXPECT_MSG_EQ (m_received[i], 0, "Packets received by the calling process");
+        }
+    }
+  if (IslandHelper::IsSupported ())
+    {
+      NS_TEST_EXPECT_MSG_EQ (NodeList::GetNNodes (), 0, "Nodes built in the calling process");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * IslandHelper TestSuite
+ */
+class IslandHelperTestSuite : public TestSuite
+{
+public:
+  IslandHelperTestSuite () : TestSuite ("island-helper", UNIT)
+  {
+    AddTestCase (new IslandHelperGetIslandsTest, TestCase::QUICK);
+    AddTestCase (new IslandHelperRunTest, TestCase::QUICK);
+  }
+} g_islandHelperTestSuite;
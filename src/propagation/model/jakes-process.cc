@@ -30,19 +30,6 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("JakesProcess");
 
-/// Represents a single oscillator
-JakesProcess::Oscillator::Oscillator (std::complex<double> amplitude, double initialPhase, double omega) :
-  m_amplitude (amplitude),
-  m_phase (initialPhase),
-  m_omega (omega)
-{}
-
-std::complex<double>
-JakesProcess::Oscillator::GetValueAt (Time at) const
-{
-  return (m_amplitude * std::cos (at.GetSeconds () * m_omega + m_phase));
-}
-
 NS_OBJECT_ENSURE_REGISTERED (JakesProcess);
 
 TypeId
@@ -109,11 +96,15 @@ JakesProcess::ConstructOscillators ()
       double psi = m_jakes->GetUniformRandomVariable ()->GetValue ();
       std::complex<double> amplitude = std::complex<double> (std::cos (psi), std::sin (psi)) * 2.0 / std::sqrt (m_nOscillators);
       /// 3. Construct oscillator:
-      m_oscillators.push_back (Oscillator (amplitude, phi, omega)); 
+      m_amplitudeRe.push_back (amplitude.real ());
+      m_amplitudeIm.push_back (amplitude.imag ());
+      m_omega.push_back (omega);
     }
+  m_phase = phi;
 }
 
 JakesProcess::JakesProcess () :
+  m_phase (0),
   m_omegaDopplerMax (0),
   m_nOscillators (0)
 {
@@ -121,7 +112,9 @@ JakesProcess::JakesProcess () :
 
 JakesProcess::~JakesProcess()
 {
-  m_oscillators.clear ();
+  m_amplitudeRe.clear ();
+  m_amplitudeIm.clear ();
+  m_omega.clear ();
 }
 
 void
@@ -133,19 +126,35 @@ JakesProcess::DoDispose ()
 std::complex<double>
 JakesProcess::GetComplexGain () const
 {
-  std::complex<double> sumAplitude = std::complex<double> (0, 0);
-  for (unsigned int i = 0; i < m_oscillators.size (); i++)
+  return GetComplexGainAt (Now ());
+}
+
+double
+JakesProcess::GetChannelGainDb () const
+{
+  return GetChannelGainDbAt (Now ());
+}
+
+std::complex<double>
+JakesProcess::GetComplexGainAt (Time at) const
+{
+  double t = at.GetSeconds ();
+  double sumRe = 0;
+  double sumIm = 0;
+  for (unsigned int i = 0; i < m_omega.size (); i++)
     {
-      sumAplitude += m_oscillators[i].GetValueAt (Now ());
+      double value = std::cos (t * m_omega[i] + m_phase);
+      sumRe += m_amplitudeRe[i] * value;
+      sumIm += m_amplitudeIm[i] * value;
     }
-  return sumAplitude;
+  return std::complex<double> (sumRe, sumIm);
 }
 
 double
-JakesProcess::GetChannelGainDb () const
+JakesProcess::GetChannelGainDbAt (Time at) const
 {
-  std::complex<double> complexGain = GetComplexGain ();
-  return (10 * std::log10 ((std::pow (complexGain.real (), 2) + std::pow (complexGain.imag (), 2)) / 2));
+  std::complex<double> complexGain = GetComplexGainAt (at);
+  return (10 * std::log10 ((complexGain.real () * complexGain.real () + complexGain.imag () * complexGain.imag ()) / 2));
 }
 
 } // namespace ns3
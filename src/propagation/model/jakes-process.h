@@ -24,6 +24,7 @@
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
 #include <complex>
+#include <vector>
 
 namespace ns3
 {
@@ -76,34 +77,23 @@ public:
   double GetChannelGainDb () const;
 
   /**
-   * Set the propagation model using this class
-   * \param model the propagation model using this class
+   * Get the channel complex gain at a given time
+   * \param at the time instant
+   * \return the channel complex gain
    */
-  void SetPropagationLossModel (Ptr<const PropagationLossModel> model);
-private:
+  std::complex<double> GetComplexGainAt (Time at) const;
   /**
-   * This class Represents a single oscillator
+   * Get the channel gain in dB at a given time
+   * \param at the time instant
+   * \return the channel gain [dB]
    */
-  struct Oscillator
-  {
-    /**
-     * Initiate oscillator with complex amplitude, initial phase and rotation speed
-     * \param amplitude initial complex amplitude
-     * \param initialPhase initial phase
-     * \param omega rotation speed
-     */
-    Oscillator (std::complex<double> amplitude, double initialPhase, double omega);
-    /**
-     * Get the complex amplitude at a given moment
-     * \param t time instant
-     * \returns the complex amplitude
-     */
-    std::complex<double> GetValueAt (Time t) const;
+  double GetChannelGainDbAt (Time at) const;
 
-    std::complex<double> m_amplitude; //!< Complex number \f$Re=\cos(\psi_n), Im = i\sin(\psi_n)]\f$
-    double m_phase; //!< Phase \f$\phi_n\f$ of the oscillator
-    double m_omega; //!< Rotation speed of the oscillator \f$\omega_d \cos(\alpha_n)\f$
-  };
+  /**
+   * Set the propagation model using this class
+   * \param model the propagation model using this class
+   */
+  void SetPropagationLossModel (Ptr<const PropagationLossModel> model);
 private:
 
   /**
@@ -123,7 +113,15 @@ private:
    */
   void ConstructOscillators ();
 private:
-  std::vector<Oscillator> m_oscillators; //!< Vector of oscillators
+  /*
+   * The oscillators are stored as a structure of arrays, so that the
+   * evaluation of the complex gain is a single loop over contiguous
+   * values which is free of complex arithmetic.
+   */
+  std::vector<double> m_amplitudeRe; //!< Real part \f$\cos(\psi_n)\f$ of the complex amplitudes
+  std::vector<double> m_amplitudeIm; //!< Imaginary part \f$\sin(\psi_n)\f$ of the complex amplitudes
+  std::vector<double> m_omega; //!< Rotation speeds \f$\omega_d \cos(\alpha_n)\f$ of the oscillators
+  double m_phase; //!< Phase \f$\phi\f$, common to all the oscillators
   double m_omegaDopplerMax; //!< max rotation speed Doppler frequency
   unsigned int m_nOscillators;  //!< number of oscillators
   Ptr<UniformRandomVariable> m_uniformVariable; //!< random stream
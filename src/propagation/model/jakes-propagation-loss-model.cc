@@ -21,6 +21,8 @@
 #include "jakes-propagation-loss-model.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
+#include <algorithm>
 
 namespace ns3
 {
@@ -47,6 +49,19 @@ JakesPropagationLossModel::GetTypeId ()
     .SetParent<PropagationLossModel> ()
     .SetGroupName ("Propagation")
     .AddConstructor<JakesPropagationLossModel> ()
+    .AddAttribute ("TraceDuration",
+                   "Duration of the fading trace shared by all the links. If zero, "
+                   "one Jakes process is run for every link; otherwise, the trace is "
+                   "precomputed from a single Jakes process and every link reads it "
+                   "from a random time offset.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&JakesPropagationLossModel::m_traceDuration),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("TraceSamplingInterval",
+                   "Time between two samples of the shared fading trace.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&JakesPropagationLossModel::m_traceSamplingInterval),
+                   MakeTimeChecker (NanoSeconds (1)))
   ;
   return tid;
 }
@@ -56,6 +71,10 @@ JakesPropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                           Ptr<MobilityModel> a,
                                           Ptr<MobilityModel> b) const
 {
+  if (m_traceDuration.IsStrictlyPositive ())
+    {
+      return txPowerDbm + GetTraceGainDb (a, b);
+    }
   Ptr<JakesProcess> pathData = m_propagationCache.GetPathData (a, b, 0 /**Spectrum model uid is not used in PropagationLossModel*/);
   if (pathData == 0)
     {
@@ -66,6 +85,44 @@ JakesPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + pathData->GetChannelGainDb ();
 }
 
+void
+JakesPropagationLossModel::ConstructTrace () const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<JakesProcess> process = CreateObject<JakesProcess> ();
+  process->SetPropagationLossModel (this);
+  int64_t nSamples = m_traceDuration.GetTimeStep () / m_traceSamplingInterval.GetTimeStep ();
+  nSamples = std::max<int64_t> (nSamples, 1);
+  m_trace.resize (nSamples);
+  for (int64_t i = 0; i < nSamples; i++)
+    {
+      m_trace[i] = process->GetChannelGainDbAt (m_traceSamplingInterval * i);
+    }
+  process->Dispose ();
+  NS_LOG_LOGIC ("shared fading trace of " << m_trace.size () << " samples");
+}
+
+double
+JakesPropagationLossModel::GetTraceGainDb (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  if (m_trace.empty ())
+    {
+      ConstructTrace ();
+    }
+  std::pair<Ptr<const MobilityModel>, Ptr<const MobilityModel> > key = std::make_pair (std::min<Ptr<const MobilityModel> > (a, b),
+                                                                                       std::max<Ptr<const MobilityModel> > (a, b));
+  TraceOffsetMap::const_iterator it = m_traceOffsets.find (key);
+  if (it == m_traceOffsets.end ())
+    {
+      // the random variable is uniform over [-pi, pi)
+      double u = (m_uniformVariable->GetValue () + M_PI) / (2 * M_PI);
+      uint32_t offset = std::min<uint32_t> (u * m_trace.size (), m_trace.size () - 1);
+      it = m_traceOffsets.insert (std::make_pair (key, offset)).first;
+    }
+  uint64_t sample = Simulator::Now ().GetTimeStep () / m_traceSamplingInterval.GetTimeStep ();
+  return m_trace[(it->second + sample) % m_trace.size ()];
+}
+
 Ptr<UniformRandomVariable>
 JakesPropagationLossModel::GetUniformRandomVariable () const
 {
@@ -23,6 +23,9 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-cache.h"
 #include "ns3/jakes-process.h"
+#include "ns3/nstime.h"
+#include <vector>
+#include <map>
 
 namespace ns3
 {
@@ -31,6 +34,13 @@ namespace ns3
  *
  * \brief a  Jakes narrowband propagation model.
  * Symmetrical cache for JakesProcess
+ *
+ * By default, one JakesProcess is run for every link. If the TraceDuration
+ * attribute is strictly positive, a single fading trace of that duration is
+ * instead precomputed from one JakesProcess, and shared by all the links:
+ * every link reads the trace from its own random time offset, so that the
+ * cost of a loss calculation does not depend on the number of oscillators
+ * and the memory used by the trace does not depend on the number of links.
  */
 
 class JakesPropagationLossModel : public PropagationLossModel
@@ -71,8 +81,27 @@ private:
    */
   Ptr<UniformRandomVariable> GetUniformRandomVariable () const;
 
+  /**
+   * Compute the shared fading trace.
+   */
+  void ConstructTrace () const;
+  /**
+   * Get the gain of a link from the shared fading trace at the current time.
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \return the channel gain [dB]
+   */
+  double GetTraceGainDb (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
   Ptr<UniformRandomVariable> m_uniformVariable; //!< random stream
   mutable PropagationCache<JakesProcess> m_propagationCache; //!< Propagation cache
+
+  Time m_traceDuration; //!< duration of the shared fading trace, 0 if disabled
+  Time m_traceSamplingInterval; //!< time between two samples of the shared fading trace
+  mutable std::vector<double> m_trace; //!< shared fading trace [dB]
+  /// Links are symmetrical: the key is the ordered pair of mobility models
+  typedef std::map<std::pair<Ptr<const MobilityModel>, Ptr<const MobilityModel> >, uint32_t> TraceOffsetMap;
+  mutable TraceOffsetMap m_traceOffsets; //!< offset of every link in the shared fading trace, in samples
 };
 
 } // namespace ns3
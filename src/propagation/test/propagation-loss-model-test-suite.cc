@@ -22,6 +22,7 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/jakes-propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
@@ -436,6 +437,74 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class JakesPropagationLossModelTestCase : public TestCase
+{
+public:
+  JakesPropagationLossModelTestCase ();
+  virtual ~JakesPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check the symmetry of the fading of a link and accumulate its power gain
+   * \param lossModel the loss model
+   * \param a the mobility model of one end of the link
+   * \param b the mobility model of the other end of the link
+   */
+  void Sample (Ptr<PropagationLossModel> lossModel, Ptr<MobilityModel> a, Ptr<MobilityModel> b);
+
+  double m_sumGain; //!< sum of the sampled power gains (linear)
+  uint32_t m_nSamples; //!< number of samples
+};
+
+JakesPropagationLossModelTestCase::JakesPropagationLossModelTestCase ()
+  : TestCase ("Test JakesPropagationLossModel")
+{
+}
+
+JakesPropagationLossModelTestCase::~JakesPropagationLossModelTestCase ()
+{
+}
+
+void
+JakesPropagationLossModelTestCase::Sample (Ptr<PropagationLossModel> lossModel, Ptr<MobilityModel> a, Ptr<MobilityModel> b)
+{
+  double gainDb = lossModel->CalcRxPower (0, a, b);
+  NS_TEST_ASSERT_MSG_EQ (gainDb, lossModel->CalcRxPower (0, b, a), "Fading is not symmetrical");
+  m_sumGain += std::pow (10.0, gainDb / 10.0);
+  m_nSamples++;
+}
+
+void
+JakesPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+
+  // The time average of the power gain of a Jakes process is 1, both with
+  // one process per link and with the shared fading trace
+  for (uint32_t mode = 0; mode < 2; ++mode)
+    {
+      Ptr<JakesPropagationLossModel> lossModel = CreateObject<JakesPropagationLossModel> ();
+      lossModel->AssignStreams (1);
+      if (mode == 1)
+        {
+          lossModel->SetAttribute ("TraceDuration", TimeValue (Seconds (10)));
+        }
+      m_sumGain = 0;
+      m_nSamples = 0;
+      for (uint32_t i = 0; i < 10000; ++i)
+        {
+          Simulator::Schedule (MilliSeconds (i), &JakesPropagationLossModelTestCase::Sample, this, lossModel, a, b);
+        }
+      Simulator::Run ();
+      Simulator::Destroy ();
+      NS_TEST_ASSERT_MSG_EQ (m_nSamples, 10000, "Unexpected number of samples");
+      NS_TEST_ASSERT_MSG_EQ_TOL (m_sumGain / m_nSamples, 1.0, 0.1, "Unexpected average power gain");
+    }
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +519,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new JakesPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
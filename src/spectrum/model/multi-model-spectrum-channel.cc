@@ -36,6 +36,7 @@
 #include <ns3/angles.h>
 #include <iostream>
 #include <utility>
+#include <algorithm>
 #include "multi-model-spectrum-channel.h"
 
 
@@ -159,10 +160,12 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
        rxInfoIterator !=  m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
     {
-      std::set<Ptr<SpectrumPhy> >::iterator phyIt = rxInfoIterator->second.m_rxPhySet.find (phy);
-      if (phyIt !=  rxInfoIterator->second.m_rxPhySet.end ())
+      std::vector<Ptr<SpectrumPhy> >::iterator phyIt = std::find (rxInfoIterator->second.m_rxPhys.begin (),
+                                                                  rxInfoIterator->second.m_rxPhys.end (),
+                                                                  phy);
+      if (phyIt !=  rxInfoIterator->second.m_rxPhys.end ())
         {
-          rxInfoIterator->second.m_rxPhySet.erase (phyIt);
+          rxInfoIterator->second.m_rxPhys.erase (phyIt);
           --m_numDevices;
           break; // there should be at most one entry
         }       
@@ -178,9 +181,8 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       std::pair<RxSpectrumModelInfoMap_t::iterator, bool> ret;
       ret = m_rxSpectrumModelInfoMap.insert (std::make_pair (rxSpectrumModelUid, RxSpectrumModelInfo (rxSpectrumModel)));
       NS_ASSERT (ret.second);
-      // also add the phy to the newly created set of SpectrumPhy for this RxSpectrumModel
-      std::pair<std::set<Ptr<SpectrumPhy> >::iterator, bool> ret2 = ret.first->second.m_rxPhySet.insert (phy);
-      NS_ASSERT (ret2.second);
+      // also add the phy to the newly created list of SpectrumPhy for this RxSpectrumModel
+      ret.first->second.m_rxPhys.push_back (phy);
 
       // and create the necessary converters for all the TX spectrum models that we know of
       for (TxSpectrumModelInfoMap_t::iterator txInfoIterator = m_txSpectrumModelInfoMap.begin ();
@@ -203,8 +205,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
   else
     {
       // spectrum model is already known, just add the device to the corresponding list
-      std::pair<std::set<Ptr<SpectrumPhy> >::iterator, bool> ret2 = rxInfoIterator->second.m_rxPhySet.insert (phy);
-      NS_ASSERT (ret2.second);
+      rxInfoIterator->second.m_rxPhys.push_back (phy);
     }
 
 }
@@ -282,101 +283,122 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
       SpectrumModelUid_t rxSpectrumModelUid = rxInfoIterator->second.m_rxSpectrumModel->GetUid ();
       NS_LOG_LOGIC (" rxSpectrumModelUids " << rxSpectrumModelUid);
 
-      Ptr <SpectrumValue> convertedTxPowerSpectrum;
-      if (txSpectrumModelUid == rxSpectrumModelUid)
-        {
-          NS_LOG_LOGIC ("no spectrum conversion needed");
-          convertedTxPowerSpectrum = txParams->psd;
-        }
-      else
+      const SpectrumConverter *converter = 0;
+      if (txSpectrumModelUid != rxSpectrumModelUid)
         {
-          NS_LOG_LOGIC (" converting txPowerSpectrum SpectrumModelUids" << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
           SpectrumConverterMap_t::const_iterator rxConverterIterator = txInfoIteratorerator->second.m_spectrumConverterMap.find (rxSpectrumModelUid);
           if (rxConverterIterator == txInfoIteratorerator->second.m_spectrumConverterMap.end ())
             {
               // No converter means TX SpectrumModel is orthogonal to RX SpectrumModel
               continue;
             }
-          convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
+          converter = &rxConverterIterator->second;
         }
 
+      // The PSD is converted at most once per RX SpectrumModel and per
+      // transmission, and only when the first receiver within range is found,
+      // so that the receivers which are culled by the loss check below do
+      // not cost any conversion nor any copy of the PSD.
+      Ptr <SpectrumValue> convertedTxPowerSpectrum;
 
-      for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
-           rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
+      for (std::vector<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin ();
+           rxPhyIterator != rxInfoIterator->second.m_rxPhys.end ();
            ++rxPhyIterator)
         {
           NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
                          "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
 
-          if ((*rxPhyIterator) != txParams->txPhy)
+          if ((*rxPhyIterator) == txParams->txPhy)
             {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
+              continue;
+            }
 
-              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+          Time delay = MicroSeconds (0);
+          double pathGainLinear = 1.0;
+          Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+          bool applyLoss = txMobility && receiverMobility;
 
-              if (txMobility && receiverMobility)
+          if (applyLoss)
+            {
+              double pathLossDb = 0;
+              if (txParams->txAntenna != 0)
+                {
+                  Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
+                  double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
+                  NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+                  pathLossDb -= txAntennaGain;
+                }
+              Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
+              if (rxAntenna != 0)
                 {
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
-                    {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
-                    }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
-                    {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
-                    }
-                  if (m_propagationLoss)
-                    {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-                  if ( pathLossDb > m_maxLossDb)
-                    {
-                      // beyond range
-                      continue;
-                    }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
-
-                  if (m_spectrumPropagationLoss)
-                    {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
-                    }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
+                  Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
+                  double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+                  NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+                  pathLossDb -= rxAntennaGain;
                 }
+              if (m_propagationLoss)
+                {
+                  double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+                  NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+                  pathLossDb -= propagationGainDb;
+                }                    
+              NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
+              m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
+              if ( pathLossDb > m_maxLossDb)
+                {
+                  // beyond range
+                  continue;
+                }
+              pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+            }
 
-              Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-              if (netDev)
+          if (convertedTxPowerSpectrum == 0)
+            {
+              if (converter == 0)
                 {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode =  netDev->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
+                  NS_LOG_LOGIC ("no spectrum conversion needed");
+                  convertedTxPowerSpectrum = txParams->psd;
                 }
               else
                 {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
+                  NS_LOG_LOGIC (" converting txPowerSpectrum SpectrumModelUids" << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
+                  convertedTxPowerSpectrum = converter->Convert (txParams->psd);
                 }
             }
+
+          NS_LOG_LOGIC (" copying signal parameters " << txParams);
+          Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+          rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+
+          if (applyLoss)
+            {
+              *(rxParams->psd) *= pathGainLinear;              
+
+              if (m_spectrumPropagationLoss)
+                {
+                  rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+                }
+
+              if (m_propagationDelay)
+                {
+                  delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+                }
+            }
+
+          Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
+          if (netDev)
+            {
+              // the receiver has a NetDevice, so we expect that it is attached to a Node
+              uint32_t dstNode =  netDev->GetNode ()->GetId ();
+              Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
+                                              rxParams, *rxPhyIterator);
+            }
+          else
+            {
+              // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+              Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
+                                   rxParams, *rxPhyIterator);
+            }
         }
 
     }
@@ -404,22 +426,19 @@ Ptr<NetDevice>
 MultiModelSpectrumChannel::GetDevice (uint32_t i) const
 {
   NS_ASSERT (i < m_numDevices);
-  // this method implementation is computationally intensive. This
-  // method would be faster if we actually used a std::vector for
-  // storing devices, which we don't due to the need to have fast 
-  // SpectrumModel conversions and to allow PHY devices to changea
+  // this method implementation is linear in the number of devices,
+  // since devices are stored per RX SpectrumModel in order to have fast
+  // SpectrumModel conversions and to allow PHY devices to change
   // SpectrumModel at run time. Note that having this method slow is
   // acceptable as it is not used much at run time (often not at all).
-  // On the other hand, having slow SpectrumModel conversion would be
-  // less acceptable. 
   uint32_t j = 0;
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator !=  m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
     {
-      for (std::set<Ptr<SpectrumPhy> >::const_iterator phyIt = rxInfoIterator->second.m_rxPhySet.begin ();
-           phyIt != rxInfoIterator->second.m_rxPhySet.end ();
-           ++phyIt)        
+      for (std::vector<Ptr<SpectrumPhy> >::const_iterator phyIt = rxInfoIterator->second.m_rxPhys.begin ();
+           phyIt != rxInfoIterator->second.m_rxPhys.end ();
+           ++phyIt)
         {
           if (j == i)
             {
@@ -456,6 +475,13 @@ MultiModelSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel>
   m_propagationDelay = delay;
 }
 
+Ptr<PropagationLossModel>
+MultiModelSpectrumChannel::GetPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_propagationLoss;
+}
+
 Ptr<SpectrumPropagationLossModel>
 MultiModelSpectrumChannel::GetSpectrumPropagationLossModel (void)
 {
@@ -28,7 +28,7 @@
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
 #include <map>
-#include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -80,7 +80,7 @@ public:
   RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumModel);
 
   Ptr<const SpectrumModel> m_rxSpectrumModel;  //!< Rx Spectrum model.
-  std::set<Ptr<SpectrumPhy> > m_rxPhySet;      //!< Container of the Rx Spectrum phy objects.
+  std::vector<Ptr<SpectrumPhy> > m_rxPhys;     //!< Container of the Rx Spectrum phy objects.
 };
 
 /**
@@ -127,6 +127,12 @@ public:
   virtual uint32_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
 
+  /**
+   * Get the single-frequency propagation loss model.
+   * \returns a pointer to the propagation loss model.
+   */
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
+
   /**
    * Get the frequency-dependent propagation loss model.
    * \returns a pointer to the propagation loss model.
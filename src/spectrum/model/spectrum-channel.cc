@@ -19,6 +19,8 @@
  */
 
 #include "spectrum-channel.h"
+#include <ns3/propagation-loss-model.h>
+#include "spectrum-propagation-loss-model.h"
 
 
 namespace ns3 {
@@ -40,4 +42,16 @@ SpectrumChannel::~SpectrumChannel ()
 {
 }
 
+Ptr<PropagationLossModel>
+SpectrumChannel::GetPropagationLossModel (void)
+{
+  return 0;
+}
+
+Ptr<SpectrumPropagationLossModel>
+SpectrumChannel::GetSpectrumPropagationLossModel (void)
+{
+  return 0;
+}
+
 } // namespace
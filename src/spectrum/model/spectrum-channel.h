@@ -74,6 +74,27 @@ public:
    */
   virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay) = 0;
 
+  /**
+   * Get the single-frequency propagation loss model.
+   *
+   * The default implementation returns a null pointer; channel
+   * implementations which apply a propagation loss model should
+   * override it.
+   *
+   * \returns a pointer to the propagation loss model, or 0 if none is set.
+   */
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
+
+  /**
+   * Get the frequency-dependent propagation loss model.
+   *
+   * The default implementation returns a null pointer; channel
+   * implementations which apply a frequency-dependent propagation loss
+   * model should override it.
+   *
+   * \returns a pointer to the propagation loss model, or 0 if none is set.
+   */
+  virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
 
   /**
    * Used by attached PHY instances to transmit signals on the channel
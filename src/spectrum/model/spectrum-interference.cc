@@ -35,6 +35,7 @@ SpectrumInterference::SpectrumInterference ()
     m_rxSignal (0),
     m_allSignals (0),
     m_noise (0),
+    m_sinr (0),
     m_errorModel (0)
 {
   NS_LOG_FUNCTION (this);
@@ -63,6 +64,7 @@ SpectrumInterference::DoDispose ()
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
+  m_sinr = 0;
   m_errorModel = 0;
   Object::DoDispose ();
 }
@@ -97,26 +99,34 @@ void
 SpectrumInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
 {
   NS_LOG_FUNCTION (this << *spd << duration);
-  DoAddSignal (spd);
-  Simulator::Schedule (duration, &SpectrumInterference::DoSubtractSignal, this, spd);
+  // narrowband signals are only added to and subtracted from the
+  // bands they actually occupy
+  size_t start;
+  size_t end;
+  if (!spd->GetOccupiedBands (start, end))
+    {
+      start = end = 0;
+    }
+  DoAddSignal (spd, start, end);
+  Simulator::Schedule (duration, &SpectrumInterference::DoSubtractSignal, this, spd, start, end);
 }
 
 
 void
-SpectrumInterference::DoAddSignal  (Ptr<const SpectrumValue> spd)
+SpectrumInterference::DoAddSignal  (Ptr<const SpectrumValue> spd, size_t start, size_t end)
 {
   NS_LOG_FUNCTION (this << *spd);
   ConditionallyEvaluateChunk ();
-  (*m_allSignals) += (*spd);
+  m_allSignals->AddBands (*spd, start, end);
   m_lastChangeTime = Now ();
 }
 
 void
-SpectrumInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd)
+SpectrumInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd, size_t start, size_t end)
 {
   NS_LOG_FUNCTION (this << *spd);
   ConditionallyEvaluateChunk ();
-  (*m_allSignals) -= (*spd);
+  m_allSignals->SubtractBands (*spd, start, end);
   m_lastChangeTime = Now ();
 }
 
@@ -131,10 +141,10 @@ SpectrumInterference::ConditionallyEvaluateChunk ()
   NS_LOG_LOGIC ("if condition: " << condition);
   if (condition)
     {
-      SpectrumValue sinr = (*m_rxSignal) / ((*m_allSignals) - (*m_rxSignal) + (*m_noise));
+      m_sinr->SetSinr (*m_rxSignal, *m_allSignals, *m_noise);
       Time duration = Now () - m_lastChangeTime;
       NS_LOG_LOGIC ("calling m_errorModel->EvaluateChunk (sinr, duration)");
-      m_errorModel->EvaluateChunk (sinr, duration);
+      m_errorModel->EvaluateChunk (*m_sinr, duration);
     }
 }
 
@@ -148,6 +158,7 @@ SpectrumInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noi
   // we'll now create a zeroed SpectrumValue using the same
   // SpectrumModel which is being specified for the noise.
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_sinr = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
 }
 
 void
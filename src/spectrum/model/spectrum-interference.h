@@ -120,13 +120,17 @@ private:
   /**
    * Adds a signal perceived in the medium.
    * @param spd the power spectral density of the new signal
+   * @param start the index of the first band occupied by the signal
+   * @param end the index following the last band occupied by the signal
    */
-  void DoAddSignal  (Ptr<const SpectrumValue> spd);
+  void DoAddSignal  (Ptr<const SpectrumValue> spd, size_t start, size_t end);
   /**
     * Removes a signal perceived in the medium.
     * @param spd the power spectral density of the new signal
+    * @param start the index of the first band occupied by the signal
+    * @param end the index following the last band occupied by the signal
     */
-  void DoSubtractSignal  (Ptr<const SpectrumValue> spd);
+  void DoSubtractSignal  (Ptr<const SpectrumValue> spd, size_t start, size_t end);
 
   bool m_receiving; //!< True if in Rx status
 
@@ -143,6 +147,12 @@ private:
 
   Ptr<const SpectrumValue> m_noise; //!< Noise spectral power density
 
+  /**
+   * Buffer where the SINR of each chunk is computed, allocated once
+   * for all when the noise is set
+   */
+  Ptr<SpectrumValue> m_sinr;
+
   Time m_lastChangeTime;     //!< the time of the last change in m_TotalPower
 
   Ptr<SpectrumErrorModel> m_errorModel; //!< Error model
@@ -22,6 +22,8 @@
 #include <ns3/spectrum-value.h>
 #include <ns3/math.h>
 #include <ns3/log.h>
+#include <algorithm>
+#include <numeric>
 
 namespace ns3 {
 
@@ -103,20 +105,19 @@ SpectrumValue::ConstBandsEnd () const
 }
 
 
+// The element-wise kernels below are written as plain indexed loops
+// over contiguous storage, with all the checks hoisted out of the
+// loop, so that the compiler can vectorize them.
+
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
-      ++it1;
-      ++it2;
+      m_values[i] += x.m_values[i];
     }
 }
 
@@ -124,12 +125,10 @@ SpectrumValue::Add (const SpectrumValue& x)
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      *it1 += s;
-      ++it1;
+      m_values[i] += s;
     }
 }
 
@@ -138,17 +137,12 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
+      m_values[i] -= x.m_values[i];
     }
 }
 
@@ -164,17 +158,12 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
+      m_values[i] *= x.m_values[i];
     }
 }
 
@@ -182,12 +171,10 @@ SpectrumValue::Multiply (const SpectrumValue& x)
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      *it1 *= s;
-      ++it1;
+      m_values[i] *= s;
     }
 }
 
@@ -197,17 +184,12 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
+      m_values[i] /= x.m_values[i];
     }
 }
 
@@ -216,27 +198,114 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
+    {
+      m_values[i] /= s;
+    }
+}
 
-  while (it1 != m_values.end ())
+
+bool
+SpectrumValue::GetOccupiedBands (size_t &start, size_t &end) const
+{
+  const size_t n = m_values.size ();
+  size_t first = 0;
+  while (first < n && m_values[first] == 0)
     {
-      *it1 /= s;
-      ++it1;
+      ++first;
     }
+  if (first == n)
+    {
+      return false;
+    }
+  size_t last = n;
+  while (m_values[last - 1] == 0)
+    {
+      --last;
+    }
+  start = first;
+  end = last;
+  return true;
 }
 
 
+void
+SpectrumValue::AddBands (const SpectrumValue& x, size_t start, size_t end)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (start <= end && end <= m_values.size ());
+  for (size_t i = start; i < end; ++i)
+    {
+      m_values[i] += x.m_values[i];
+    }
+}
 
 
 void
-SpectrumValue::ChangeSign ()
+SpectrumValue::SubtractBands (const SpectrumValue& x, size_t start, size_t end)
 {
-  Values::iterator it1 = m_values.begin ();
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (start <= end && end <= m_values.size ());
+  for (size_t i = start; i < end; ++i)
+    {
+      m_values[i] -= x.m_values[i];
+    }
+}
 
-  while (it1 != m_values.end ())
+
+void
+SpectrumValue::AddScaled (const SpectrumValue& x, double s)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
     {
-      *it1 = -(*it1);
-      ++it1;
+      m_values[i] += x.m_values[i] * s;
+    }
+}
+
+
+void
+SpectrumValue::SetInterferencePlusNoise (const SpectrumValue& allSignals,
+                                         const SpectrumValue& signal,
+                                         const SpectrumValue& noise)
+{
+  NS_ASSERT (m_spectrumModel == allSignals.m_spectrumModel);
+  NS_ASSERT (m_spectrumModel == signal.m_spectrumModel);
+  NS_ASSERT (m_spectrumModel == noise.m_spectrumModel);
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
+    {
+      m_values[i] = allSignals.m_values[i] - signal.m_values[i] + noise.m_values[i];
+    }
+}
+
+
+void
+SpectrumValue::SetSinr (const SpectrumValue& signal,
+                        const SpectrumValue& allSignals,
+                        const SpectrumValue& noise)
+{
+  NS_ASSERT (m_spectrumModel == allSignals.m_spectrumModel);
+  NS_ASSERT (m_spectrumModel == signal.m_spectrumModel);
+  NS_ASSERT (m_spectrumModel == noise.m_spectrumModel);
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
+    {
+      m_values[i] = signal.m_values[i] / (allSignals.m_values[i] - signal.m_values[i] + noise.m_values[i]);
+    }
+}
+
+
+void
+SpectrumValue::ChangeSign ()
+{
+  const size_t n = m_values.size ();
+  for (size_t i = 0; i < n; ++i)
+    {
+      m_values[i] = -m_values[i];
     }
 }
 
@@ -361,14 +430,7 @@ Norm (const SpectrumValue& x)
 double
 Sum (const SpectrumValue& x)
 {
-  double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
-    {
-      s += (*it1);
-      ++it1;
-    }
-  return s;
+  return std::accumulate (x.ConstValuesBegin (), x.ConstValuesEnd (), 0.0);
 }
 
 
@@ -467,9 +529,8 @@ operator+ (double lhs, const SpectrumValue& rhs)
 SpectrumValue
 operator- (const SpectrumValue& lhs, const SpectrumValue& rhs)
 {
-  SpectrumValue res = rhs;
-  res.ChangeSign ();
-  res.Add (lhs);
+  SpectrumValue res = lhs;
+  res.Subtract (rhs);
   return res;
 }
 
@@ -664,13 +725,7 @@ SpectrumValue::operator/= (double rhs)
 SpectrumValue&
 SpectrumValue::operator= (double rhs)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 = rhs;
-      ++it1;
-    }
+  std::fill (m_values.begin (), m_values.end (), rhs);
   return *this;
 }
 
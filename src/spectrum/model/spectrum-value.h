@@ -503,6 +503,73 @@ public:
    */
   Ptr<SpectrumValue> Copy () const;
 
+  /**
+   * Find the smallest range of bands which contains all the non-zero
+   * values. This is typically used to restrict the arithmetic on
+   * narrowband signals to the bands they actually occupy.
+   *
+   * @param start the index of the first non-zero value
+   * @param end the index following the last non-zero value
+   *
+   * @return false if all the values are zero, true otherwise
+   */
+  bool GetOccupiedBands (size_t &start, size_t &end) const;
+
+  /**
+   * Add a SpectrumValue (element to element addition) restricted to
+   * the bands in [start, end). The caller guarantees that x is zero
+   * outside of this range, e.g. by using GetOccupiedBands.
+   *
+   * @param x the SpectrumValue to add
+   * @param start the index of the first band
+   * @param end the index following the last band
+   */
+  void AddBands (const SpectrumValue& x, size_t start, size_t end);
+
+  /**
+   * Subtract a SpectrumValue (element by element subtraction)
+   * restricted to the bands in [start, end). The caller guarantees
+   * that x is zero outside of this range, e.g. by using GetOccupiedBands.
+   *
+   * @param x the SpectrumValue to subtract
+   * @param start the index of the first band
+   * @param end the index following the last band
+   */
+  void SubtractBands (const SpectrumValue& x, size_t start, size_t end);
+
+  /**
+   * Add x * s to each value (element by element) in a single pass,
+   * without allocating any temporary SpectrumValue.
+   *
+   * @param x the SpectrumValue to scale and add
+   * @param s the scaling factor
+   */
+  void AddScaled (const SpectrumValue& x, double s);
+
+  /**
+   * Set each value to allSignals - signal + noise in a single pass,
+   * without allocating any temporary SpectrumValue.
+   *
+   * @param allSignals the sum of all the signals being received
+   * @param signal the signal of interest
+   * @param noise the noise
+   */
+  void SetInterferencePlusNoise (const SpectrumValue& allSignals,
+                                 const SpectrumValue& signal,
+                                 const SpectrumValue& noise);
+
+  /**
+   * Set each value to signal / (allSignals - signal + noise) in a
+   * single pass, without allocating any temporary SpectrumValue.
+   *
+   * @param signal the signal of interest
+   * @param allSignals the sum of all the signals being received
+   * @param noise the noise
+   */
+  void SetSinr (const SpectrumValue& signal,
+                const SpectrumValue& allSignals,
+                const SpectrumValue& noise);
+
   /**
    *  TracedCallback signature for SpectrumValue.
    *
@@ -334,9 +334,24 @@ WifiSpectrumValueHelper::CreateRfFilter (uint32_t centerFrequency, uint32_t chan
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth);
   Ptr<SpectrumValue> c = Create <SpectrumValue> (GetSpectrumModel (centerFrequency, channelWidth));
-  size_t numBands = c->GetSpectrumModel ()->GetNumBands ();
-  Bands::const_iterator bit = c->ConstBandsBegin ();
+  std::pair<uint32_t, uint32_t> range = GetRfFilterBandRange (centerFrequency, channelWidth);
   Values::iterator vit = c->ValuesBegin ();
+  vit += range.first;
+  for (size_t i = range.first; i < range.second; i++, vit++)
+    {
+      *vit = 1;
+    }
+  NS_LOG_DEBUG ("Added subbands " << range.first << " to " << range.second << " to filter");
+  return c;
+}
+
+std::pair<uint32_t, uint32_t>
+WifiSpectrumValueHelper::GetRfFilterBandRange (uint32_t centerFrequency, uint32_t channelWidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth);
+  Ptr<SpectrumModel> model = GetSpectrumModel (centerFrequency, channelWidth);
+  size_t numBands = model->GetNumBands ();
+  Bands::const_iterator bit = model->Begin ();
   uint32_t bandBandwidth = static_cast<uint32_t> (((bit->fh - bit->fl) + 0.5));
   NS_LOG_DEBUG ("Band bandwidth: " << bandBandwidth);
   size_t numBandsInFilter = static_cast<size_t> (channelWidth * 1e6 / bandBandwidth); 
@@ -345,17 +360,10 @@ WifiSpectrumValueHelper::CreateRfFilter (uint32_t centerFrequency, uint32_t chan
       numBandsInFilter += 1;
     }
   NS_LOG_DEBUG ("Num bands in filter: " << numBandsInFilter);
-  // Set the value of the filter to 1 for the center-most numBandsInFilter
+  // The filter is made of the center-most numBandsInFilter
   NS_ASSERT_MSG ((numBandsInFilter % 2 == 1) && (numBands % 2 == 1), "Should have odd number of bands");
   size_t startIndex = (numBands - numBandsInFilter) / 2;
-  vit += startIndex;
-  bit += startIndex;
-  for (size_t i = startIndex; i < startIndex + numBandsInFilter; i++, vit++, bit++)
-    {
-      *vit = 1;
-    }
-  NS_LOG_DEBUG ("Added subbands " << startIndex << " to " << startIndex + numBandsInFilter << " to filter");
-  return c;
+  return std::make_pair (startIndex, startIndex + numBandsInFilter);
 }
 
 static Ptr<SpectrumModel> g_WifiSpectrumModel5Mhz;
@@ -108,6 +108,15 @@ public:
    * to an received power spectral density
    */
   static Ptr<SpectrumValue> CreateRfFilter (uint32_t centerFrequency, uint32_t channelWidth);
+
+  /**
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \return the index of the first band of the RF filter (see CreateRfFilter)
+   * and the index past its last band, in the spectrum model returned by
+   * GetSpectrumModel for the same center frequency and channel width
+   */
+  static std::pair<uint32_t, uint32_t> GetRfFilterBandRange (uint32_t centerFrequency, uint32_t channelWidth);
 };
 
 /**
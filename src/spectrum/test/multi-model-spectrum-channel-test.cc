@@ -0,0 +1,271 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/object.h>
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <cmath>
+#include <vector>
+
+#include "spectrum-test.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MultiModelSpectrumChannelTest");
+
+/**
+ * SpectrumPhy which only records the PSDs it receives.
+ */
+class MultiModelTestSpectrumPhy : public SpectrumPhy
+{
+public:
+  MultiModelTestSpectrumPhy (Ptr<const SpectrumModel> rxSpectrumModel, Vector position);
+
+  virtual void SetDevice (Ptr<NetDevice> d);
+  virtual Ptr<NetDevice> GetDevice () const;
+  virtual void SetMobility (Ptr<MobilityModel> m);
+  virtual Ptr<MobilityModel> GetMobility ();
+  virtual void SetChannel (Ptr<SpectrumChannel> c);
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const;
+  virtual Ptr<AntennaModel> GetRxAntenna ();
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params);
+
+  std::vector<Ptr<SpectrumValue> > m_rxPsds;
+
+private:
+  virtual void DoDispose (void);
+
+  Ptr<const SpectrumModel> m_rxSpectrumModel;
+  Ptr<MobilityModel> m_mobility;
+};
+
+MultiModelTestSpectrumPhy::MultiModelTestSpectrumPhy (Ptr<const SpectrumModel> rxSpectrumModel, Vector position)
+  : m_rxSpectrumModel (rxSpectrumModel)
+{
+  m_mobility = CreateObject<ConstantPositionMobilityModel> ();
+  m_mobility->SetPosition (position);
+}
+
+void
+MultiModelTestSpectrumPhy::DoDispose (void)
+{
+  m_rxPsds.clear ();
+  m_rxSpectrumModel = 0;
+  m_mobility = 0;
+  SpectrumPhy::DoDispose ();
+}
+
+void
+MultiModelTestSpectrumPhy::SetDevice (Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+MultiModelTestSpectrumPhy::GetDevice () const
+{
+  return 0;
+}
+
+void
+MultiModelTestSpectrumPhy::SetMobility (Ptr<MobilityModel> m)
+{
+  m_mobility = m;
+}
+
+Ptr<MobilityModel>
+MultiModelTestSpectrumPhy::GetMobility ()
+{
+  return m_mobility;
+}
+
+void
+MultiModelTestSpectrumPhy::SetChannel (Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+MultiModelTestSpectrumPhy::GetRxSpectrumModel () const
+{
+  return m_rxSpectrumModel;
+}
+
+Ptr<AntennaModel>
+MultiModelTestSpectrumPhy::GetRxAntenna ()
+{
+  return 0;
+}
+
+void
+MultiModelTestSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  m_rxPsds.push_back (params->psd);
+}
+
+
+/**
+ * Check that MultiModelSpectrumChannel does not deliver anything to the
+ * receivers whose loss exceeds MaxLossDb, and that the PSDs delivered to
+ * the other receivers, which are converted lazily, match the PSD that is
+ * obtained by converting the transmitted PSD and then applying the path
+ * gain of each receiver.
+ */
+class MultiModelSpectrumChannelCullingTestCase : public TestCase
+{
+public:
+  MultiModelSpectrumChannelCullingTestCase ();
+  virtual ~MultiModelSpectrumChannelCullingTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MultiModelSpectrumChannelCullingTestCase::MultiModelSpectrumChannelCullingTestCase ()
+  : TestCase ("MultiModelSpectrumChannel receiver culling and lazy PSD conversion")
+{
+}
+
+MultiModelSpectrumChannelCullingTestCase::~MultiModelSpectrumChannelCullingTestCase ()
+{
+}
+
+void
+MultiModelSpectrumChannelCullingTestCase::DoRun (void)
+{
+  // TX model: 10 bands of 1 MHz; RX model: 5 bands of 2 MHz covering the
+  // same spectrum, so that a conversion is needed.
+  std::vector<double> txFreqs;
+  for (int i = 0; i < 10; ++i)
+    {
+      txFreqs.push_back (2.4005e9 + i * 1e6);
+    }
+  Ptr<SpectrumModel> txModel = Create<SpectrumModel> (txFreqs);
+  std::vector<double> rxFreqs;
+  for (int i = 0; i < 5; ++i)
+    {
+      rxFreqs.push_back (2.401e9 + i * 2e6);
+    }
+  Ptr<SpectrumModel> rxModel = Create<SpectrumModel> (rxFreqs);
+
+  Ptr<FriisPropagationLossModel> loss = CreateObject<FriisPropagationLossModel> ();
+  const double maxLossDb = 90;
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (loss);
+  channel->SetAttribute ("MaxLossDb", DoubleValue (maxLossDb));
+
+  Ptr<MultiModelTestSpectrumPhy> tx = CreateObject<MultiModelTestSpectrumPhy> (txModel, Vector (0, 0, 0));
+  // receivers with the RX model: two within range and two beyond range,
+  // added in an interleaved order
+  Ptr<MultiModelTestSpectrumPhy> near1 = CreateObject<MultiModelTestSpectrumPhy> (rxModel, Vector (10, 0, 0));
+  Ptr<MultiModelTestSpectrumPhy> far1 = CreateObject<MultiModelTestSpectrumPhy> (rxModel, Vector (1000, 0, 0));
+  Ptr<MultiModelTestSpectrumPhy> near2 = CreateObject<MultiModelTestSpectrumPhy> (rxModel, Vector (0, 50, 0));
+  Ptr<MultiModelTestSpectrumPhy> far2 = CreateObject<MultiModelTestSpectrumPhy> (rxModel, Vector (0, 5000, 0));
+  // receivers with the TX model, which need no conversion
+  Ptr<MultiModelTestSpectrumPhy> nearSame = CreateObject<MultiModelTestSpectrumPhy> (txModel, Vector (20, 0, 0));
+  Ptr<MultiModelTestSpectrumPhy> farSame = CreateObject<MultiModelTestSpectrumPhy> (txModel, Vector (2000, 0, 0));
+
+  std::vector<Ptr<MultiModelTestSpectrumPhy> > phys;
+  phys.push_back (tx);
+  phys.push_back (near1);
+  phys.push_back (far1);
+  phys.push_back (near2);
+  phys.push_back (far2);
+  phys.push_back (nearSame);
+  phys.push_back (farSame);
+  for (std::vector<Ptr<MultiModelTestSpectrumPhy> >::iterator it = phys.begin (); it != phys.end (); ++it)
+    {
+      channel->AddRx (*it);
+    }
+
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (txModel);
+  for (int i = 0; i < 10; ++i)
+    {
+      (*txPsd)[i] = 1e-9 * (i + 1);
+    }
+  Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters> ();
+  txParams->txPhy = tx;
+  txParams->psd = txPsd;
+  txParams->duration = MicroSeconds (100);
+
+  channel->StartTx (txParams);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (tx->m_rxPsds.size (), 0, "the transmitter received its own signal");
+  NS_TEST_ASSERT_MSG_EQ (far1->m_rxPsds.size (), 0, "a receiver beyond MaxLossDb received the signal");
+  NS_TEST_ASSERT_MSG_EQ (far2->m_rxPsds.size (), 0, "a receiver beyond MaxLossDb received the signal");
+  NS_TEST_ASSERT_MSG_EQ (farSame->m_rxPsds.size (), 0, "a receiver beyond MaxLossDb received the signal");
+  NS_TEST_ASSERT_MSG_EQ (near1->m_rxPsds.size (), 1, "a receiver within range did not receive the signal");
+  NS_TEST_ASSERT_MSG_EQ (near2->m_rxPsds.size (), 1, "a receiver within range did not receive the signal");
+  NS_TEST_ASSERT_MSG_EQ (nearSame->m_rxPsds.size (), 1, "a receiver within range did not receive the signal");
+
+  // eager path: convert the transmitted PSD and then scale it by the path
+  // gain of each receiver
+  SpectrumConverter converter (txModel, rxModel);
+  Ptr<SpectrumValue> convertedPsd = converter.Convert (txPsd);
+  std::vector<Ptr<MultiModelTestSpectrumPhy> > nearPhys;
+  nearPhys.push_back (near1);
+  nearPhys.push_back (near2);
+  nearPhys.push_back (nearSame);
+  for (std::vector<Ptr<MultiModelTestSpectrumPhy> >::iterator it = nearPhys.begin (); it != nearPhys.end (); ++it)
+    {
+      double gainDb = loss->CalcRxPower (0, tx->GetMobility (), (*it)->GetMobility ());
+      NS_TEST_ASSERT_MSG_LT (-gainDb, maxLossDb, "receiver is not within range");
+      SpectrumValue expected = ((*it) == nearSame) ? *txPsd : *convertedPsd;
+      expected *= std::pow (10.0, gainDb / 10.0);
+      NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL (*(*it)->m_rxPsds.front (), expected, 1e-25, "lazily converted PSD differs from the eager one");
+    }
+
+  // each receiver gets its own copy of the converted PSD, and the
+  // transmitted PSD is left untouched
+  NS_TEST_ASSERT_MSG_NE (near1->m_rxPsds.front (), near2->m_rxPsds.front (), "receivers share the same PSD");
+  NS_TEST_ASSERT_MSG_NE (nearSame->m_rxPsds.front (), txPsd, "receiver got the transmitted PSD itself");
+  for (int i = 0; i < 10; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL ((*txPsd)[i], 1e-9 * (i + 1), 1e-20, "the transmitted PSD was modified");
+    }
+
+  for (std::vector<Ptr<MultiModelTestSpectrumPhy> >::iterator it = phys.begin (); it != phys.end (); ++it)
+    {
+      (*it)->Dispose ();
+    }
+  Simulator::Destroy ();
+}
+
+
+class MultiModelSpectrumChannelTestSuite : public TestSuite
+{
+public:
+  MultiModelSpectrumChannelTestSuite ();
+};
+
+MultiModelSpectrumChannelTestSuite::MultiModelSpectrumChannelTestSuite ()
+  : TestSuite ("multi-model-spectrum-channel", UNIT)
+{
+  AddTestCase (new MultiModelSpectrumChannelCullingTestCase, TestCase::QUICK);
+}
+
+static MultiModelSpectrumChannelTestSuite g_multiModelSpectrumChannelTestSuite;
@@ -242,6 +242,40 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
 
 
+  // in-place fused operations must give the same result as the
+  // equivalent expressions using temporaries
+  SpectrumValue tv11 (f), tv12 (f), tv13 (f);
+  tv11 = v1;
+  tv11.AddScaled (v2, doubleValue);
+  AddTestCase (new SpectrumValueTestCase (tv11, v1 + v2 * doubleValue, "tv11.AddScaled (v2, doubleValue)"), TestCase::QUICK);
+
+  tv12.SetInterferencePlusNoise (v3, v1, v2);
+  AddTestCase (new SpectrumValueTestCase (tv12, v3 - v1 + v2, "tv12.SetInterferencePlusNoise (v3, v1, v2)"), TestCase::QUICK);
+
+  tv13.SetSinr (v1, v3, v7);
+  AddTestCase (new SpectrumValueTestCase (tv13, v1 / (v3 - v1 + v7), "tv13.SetSinr (v1, v3, v7)"), TestCase::QUICK);
+
+  // narrowband signal occupying bands 1 and 2 only
+  SpectrumValue nb (f), tv14 (f), tv15 (f), occupiedBands (f), expectedBands (f);
+  nb[1] = v2[1];
+  nb[2] = v2[2];
+  size_t start = 0;
+  size_t end = 0;
+  occupiedBands[0] = nb.GetOccupiedBands (start, end);
+  occupiedBands[1] = start;
+  occupiedBands[2] = end;
+  expectedBands[0] = 1;
+  expectedBands[1] = 1;
+  expectedBands[2] = 3;
+  AddTestCase (new SpectrumValueTestCase (occupiedBands, expectedBands, "nb.GetOccupiedBands ()"), TestCase::QUICK);
+  tv14 = v1;
+  tv14.AddBands (nb, start, end);
+  AddTestCase (new SpectrumValueTestCase (tv14, v1 + nb, "tv14.AddBands (nb, 1, 3)"), TestCase::QUICK);
+  tv15 = v1;
+  tv15.SubtractBands (nb, start, end);
+  AddTestCase (new SpectrumValueTestCase (tv15, v1 - nb, "tv15.SubtractBands (nb, 1, 3)"), TestCase::QUICK);
+
+
 }
 
 
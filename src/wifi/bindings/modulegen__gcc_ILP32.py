@@ -106,8 +106,8 @@ def register_types(module):
     module.add_class('GroupInfo')
     ## hash.h (module 'core'): ns3::Hasher [class]
     module.add_class('Hasher', import_from_module='ns.core')
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo [struct]
-    module.add_class('HtRateInfo')
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats [struct]
+    module.add_class('HtRateStats')
     ## interference-helper.h (module 'wifi'): ns3::InterferenceHelper [class]
     module.add_class('InterferenceHelper')
     ## interference-helper.h (module 'wifi'): ns3::InterferenceHelper::SnrPer [struct]
@@ -732,7 +732,8 @@ def register_types(module):
     module.add_class('ApWifiMac', parent=root_module['ns3::RegularWifiMac'])
     ## dca-txop.h (module 'wifi'): ns3::DcaTxop [class]
     module.add_class('DcaTxop', parent=root_module['ns3::Dcf'])
-    module.add_container('ns3::HtMinstrelRate', 'ns3::HtRateInfo', container_type=u'vector')
+    module.add_container('std::vector< unsigned int >', 'unsigned int', container_type=u'vector')
+    module.add_container('std::vector< unsigned long long >', 'long long unsigned int', container_type=u'vector')
     module.add_container('ns3::TxTime', 'std::pair< ns3::Time, ns3::WifiMode >', container_type=u'vector')
     module.add_container('ns3::WifiModeList', 'ns3::WifiMode', container_type=u'vector')
     module.add_container('ns3::MinstrelRate', 'ns3::RateInfo', container_type=u'vector')
@@ -781,9 +782,6 @@ def register_types(module):
     typehandlers.add_type_alias(u'std::vector< ns3::GroupInfo, std::allocator< ns3::GroupInfo > >', u'ns3::McsGroupData')
     typehandlers.add_type_alias(u'std::vector< ns3::GroupInfo, std::allocator< ns3::GroupInfo > >*', u'ns3::McsGroupData*')
     typehandlers.add_type_alias(u'std::vector< ns3::GroupInfo, std::allocator< ns3::GroupInfo > >&', u'ns3::McsGroupData&')
-    typehandlers.add_type_alias(u'std::vector< ns3::HtRateInfo, std::allocator< ns3::HtRateInfo > >', u'ns3::HtMinstrelRate')
-    typehandlers.add_type_alias(u'std::vector< ns3::HtRateInfo, std::allocator< ns3::HtRateInfo > >*', u'ns3::HtMinstrelRate*')
-    typehandlers.add_type_alias(u'std::vector< ns3::HtRateInfo, std::allocator< ns3::HtRateInfo > >&', u'ns3::HtMinstrelRate&')
     typehandlers.add_type_alias(u'ns3::Vector3DChecker', u'ns3::VectorChecker')
     typehandlers.add_type_alias(u'ns3::Vector3DChecker*', u'ns3::VectorChecker*')
     typehandlers.add_type_alias(u'ns3::Vector3DChecker&', u'ns3::VectorChecker&')
@@ -922,7 +920,7 @@ def register_methods(root_module):
     register_Ns3EventId_methods(root_module, root_module['ns3::EventId'])
     register_Ns3GroupInfo_methods(root_module, root_module['ns3::GroupInfo'])
     register_Ns3Hasher_methods(root_module, root_module['ns3::Hasher'])
-    register_Ns3HtRateInfo_methods(root_module, root_module['ns3::HtRateInfo'])
+    register_Ns3HtRateStats_methods(root_module, root_module['ns3::HtRateStats'])
     register_Ns3InterferenceHelper_methods(root_module, root_module['ns3::InterferenceHelper'])
     register_Ns3InterferenceHelperSnrPer_methods(root_module, root_module['ns3::InterferenceHelper::SnrPer'])
     register_Ns3Ipv4Address_methods(root_module, root_module['ns3::Ipv4Address'])
@@ -2231,6 +2229,16 @@ def register_Ns3DcfManager_methods(root_module, cls):
     cls.add_method('Add', 
                    'void', 
                    [param('ns3::DcfState *', 'dcf')])
+    ## dcf-manager.h (module 'wifi'): uint64_t ns3::DcfManager::GetAccessTimeoutCancelledCount() const [member function]
+    cls.add_method('GetAccessTimeoutCancelledCount', 
+                   'uint64_t', 
+                   [], 
+                   is_const=True)
+    ## dcf-manager.h (module 'wifi'): uint64_t ns3::DcfManager::GetAccessTimeoutScheduledCount() const [member function]
+    cls.add_method('GetAccessTimeoutScheduledCount', 
+                   'uint64_t', 
+                   [], 
+                   is_const=True)
     ## dcf-manager.h (module 'wifi'): ns3::Time ns3::DcfManager::GetEifsNoDifs() const [member function]
     cls.add_method('GetEifsNoDifs', 
                    'ns3::Time', 
@@ -2272,6 +2280,10 @@ def register_Ns3DcfManager_methods(root_module, cls):
     cls.add_method('NotifyRxEndOkNow', 
                    'void', 
                    [])
+    ## dcf-manager.h (module 'wifi'): void ns3::DcfManager::NotifyRxProcessedNow() [member function]
+    cls.add_method('NotifyRxProcessedNow', 
+                   'void', 
+                   [])
     ## dcf-manager.h (module 'wifi'): void ns3::DcfManager::NotifyRxStartNow(ns3::Time duration) [member function]
     cls.add_method('NotifyRxStartNow', 
                    'void', 
@@ -2627,8 +2639,8 @@ def register_Ns3GroupInfo_methods(root_module, cls):
     cls.add_instance_attribute('m_maxTpRate', 'uint32_t', is_const=False)
     ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::GroupInfo::m_maxTpRate2 [variable]
     cls.add_instance_attribute('m_maxTpRate2', 'uint32_t', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::GroupInfo::m_ratesTable [variable]
-    cls.add_instance_attribute('m_ratesTable', 'ns3::HtMinstrelRate', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::GroupInfo::m_offset [variable]
+    cls.add_instance_attribute('m_offset', 'uint32_t', is_const=False)
     ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::GroupInfo::m_supported [variable]
     cls.add_instance_attribute('m_supported', 'bool', is_const=False)
     return
@@ -2662,45 +2674,49 @@ def register_Ns3Hasher_methods(root_module, cls):
                    [])
     return
 
-def register_Ns3HtRateInfo_methods(root_module, cls):
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::HtRateInfo() [constructor]
+def register_Ns3HtRateStats_methods(root_module, cls):
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::HtRateStats() [constructor]
     cls.add_constructor([])
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::HtRateInfo(ns3::HtRateInfo const & arg0) [copy constructor]
-    cls.add_constructor([param('ns3::HtRateInfo const &', 'arg0')])
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::adjustedRetryCount [variable]
-    cls.add_instance_attribute('adjustedRetryCount', 'uint32_t', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::attemptHist [variable]
-    cls.add_instance_attribute('attemptHist', 'uint64_t', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::ewmaProb [variable]
-    cls.add_instance_attribute('ewmaProb', 'double', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::ewmsdProb [variable]
-    cls.add_instance_attribute('ewmsdProb', 'double', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::mcsIndex [variable]
-    cls.add_instance_attribute('mcsIndex', 'uint32_t', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::numRateAttempt [variable]
-    cls.add_instance_attribute('numRateAttempt', 'uint32_t', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::numRateSuccess [variable]
-    cls.add_instance_attribute('numRateSuccess', 'uint32_t', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::numSamplesSkipped [variable]
-    cls.add_instance_attribute('numSamplesSkipped', 'uint32_t', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::perfectTxTime [variable]
-    cls.add_instance_attribute('perfectTxTime', 'ns3::Time', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::prevNumRateAttempt [variable]
-    cls.add_instance_attribute('prevNumRateAttempt', 'uint32_t', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::prevNumRateSuccess [variable]
-    cls.add_instance_attribute('prevNumRateSuccess', 'uint32_t', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::prob [variable]
-    cls.add_instance_attribute('prob', 'double', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::retryCount [variable]
-    cls.add_instance_attribute('retryCount', 'uint32_t', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::retryUpdated [variable]
-    cls.add_instance_attribute('retryUpdated', 'bool', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::successHist [variable]
-    cls.add_instance_attribute('successHist', 'uint64_t', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::supported [variable]
-    cls.add_instance_attribute('supported', 'bool', is_const=False)
-    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateInfo::throughput [variable]
-    cls.add_instance_attribute('throughput', 'double', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::HtRateStats(ns3::HtRateStats const & arg0) [copy constructor]
+    cls.add_constructor([param('ns3::HtRateStats const &', 'arg0')])
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): void ns3::HtRateStats::Clear() [member function]
+    cls.add_method('Clear', 
+                   'void', 
+                   [])
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): void ns3::HtRateStats::Resize(uint32_t size) [member function]
+    cls.add_method('Resize', 
+                   'void', 
+                   [param('uint32_t', 'size')])
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::attemptHist [variable]
+    cls.add_instance_attribute('attemptHist', 'std::vector< unsigned long long >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::ewmaProb [variable]
+    cls.add_instance_attribute('ewmaProb', 'std::vector< double >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::ewmsdProb [variable]
+    cls.add_instance_attribute('ewmsdProb', 'std::vector< double >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::mcsIndex [variable]
+    cls.add_instance_attribute('mcsIndex', 'std::vector< unsigned char >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::numRateAttempt [variable]
+    cls.add_instance_attribute('numRateAttempt', 'std::vector< unsigned int >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::numRateSuccess [variable]
+    cls.add_instance_attribute('numRateSuccess', 'std::vector< unsigned int >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::numSamplesSkipped [variable]
+    cls.add_instance_attribute('numSamplesSkipped', 'std::vector< unsigned int >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::prevNumRateAttempt [variable]
+    cls.add_instance_attribute('prevNumRateAttempt', 'std::vector< unsigned int >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::prevNumRateSuccess [variable]
+    cls.add_instance_attribute('prevNumRateSuccess', 'std::vector< unsigned int >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::prob [variable]
+    cls.add_instance_attribute('prob', 'std::vector< double >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::retryCount [variable]
+    cls.add_instance_attribute('retryCount', 'std::vector< unsigned int >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::retryUpdated [variable]
+    cls.add_instance_attribute('retryUpdated', 'std::vector< unsigned char >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::successHist [variable]
+    cls.add_instance_attribute('successHist', 'std::vector< unsigned long long >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::supported [variable]
+    cls.add_instance_attribute('supported', 'std::vector< unsigned char >', is_const=False)
+    ## minstrel-ht-wifi-manager.h (module 'wifi'): ns3::HtRateStats::throughput [variable]
+    cls.add_instance_attribute('throughput', 'std::vector< double >', is_const=False)
     return
 
 def register_Ns3InterferenceHelper_methods(root_module, cls):
@@ -3407,6 +3423,11 @@ def register_Ns3MacLowDcfListener_methods(root_module, cls):
                    'void', 
                    [param('ns3::Time', 'duration')], 
                    is_pure_virtual=True, is_virtual=True)
+    ## mac-low.h (module 'wifi'): void ns3::MacLowDcfListener::RxProcessed() [member function]
+    cls.add_method('RxProcessed', 
+                   'void', 
+                   [], 
+                   is_pure_virtual=True, is_virtual=True)
     return
 
 def register_Ns3MacLowTransmissionListener_methods(root_module, cls):
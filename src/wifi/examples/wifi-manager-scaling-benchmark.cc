@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures how the cost of the per-frame decisions of a
+// WifiRemoteStationManager scales with the number of remote stations, as
+// seen for instance by an AP with many associated stations. For every
+// number of stations, the stations are first associated, and then the
+// manager is asked for the TXVECTOR of a data frame and notified of its
+// acknowledgment, for every station in turn.
+//
+// The rate control algorithm can be selected with --manager; it must be
+// a low-latency manager (e.g., ns3::ArfWifiManager, ns3::AarfWifiManager,
+// ns3::MinstrelWifiManager or ns3::IdealWifiManager).
+//
+// Example usage:
+//
+//   ./waf --run "wifi-manager-scaling-benchmark --maxStations=1000"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include <iostream>
+#include <iomanip>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WifiManagerScalingBenchmark");
+
+/**
+ * Run the benchmark for a given number of stations.
+ *
+ * \param factory the factory of the WifiRemoteStationManager
+ * \param nStations the number of remote stations
+ * \param nDecisions the number of data frames to process
+ * \return the average wall clock time per data frame, in nanoseconds
+ */
+static double
+RunBenchmark (ObjectFactory factory, uint32_t nStations, uint32_t nDecisions)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = factory.Create<WifiRemoteStationManager> ();
+  manager->SetupPhy (phy);
+
+  std::vector<Mac48Address> stations;
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      Mac48Address address = Mac48Address::Allocate ();
+      manager->RecordWaitAssocTxOk (address);
+      manager->RecordGotAssocTxOk (address);
+      stations.push_back (address);
+    }
+
+  WifiMacHeader header;
+  header.SetType (WIFI_MAC_DATA);
+  Ptr<Packet> packet = Create<Packet> (1000);
+  WifiMode ackMode = phy->GetMode (0);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nDecisions; i++)
+    {
+      Mac48Address address = stations[i % nStations];
+      header.SetAddr1 (address);
+      WifiTxVector txVector = manager->GetDataTxVector (address, &header, packet);
+      manager->ReportDataOk (address, &header, 100.0, ackMode, 100.0);
+      NS_LOG_LOGIC (address << " " << txVector.GetMode ());
+    }
+  int64_t elapsedMs = clock.End ();
+
+  manager->Dispose ();
+  phy->Dispose ();
+  return elapsedMs * 1e6 / nDecisions;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string managerType = "ns3::ArfWifiManager";
+  uint32_t minStations = 10;
+  uint32_t maxStations = 1000;
+  uint32_t nDecisions = 1000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("manager", "TypeId of the WifiRemoteStationManager", managerType);
+  cmd.AddValue ("minStations", "Smallest number of stations", minStations);
+  cmd.AddValue ("maxStations", "Largest number of stations", maxStations);
+  cmd.AddValue ("decisions", "Number of data frames processed for every number of stations", nDecisions);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (minStations == 0 || minStations > maxStations, "Invalid range of stations");
+
+  ObjectFactory factory;
+  factory.SetTypeId (managerType);
+
+  std::cout << "# manager: " << managerType << std::endl;
+  std::cout << "# stations\tns/frame" << std::endl;
+  // 1, 2, 5 steps per decade
+  uint32_t steps[] = {1, 2, 5};
+  for (uint32_t decade = 1; decade <= maxStations; decade *= 10)
+    {
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          uint32_t nStations = steps[i] * decade;
+          if (nStations < minStations || nStations > maxStations)
+            {
+              continue;
+            }
+          double ns = RunBenchmark (factory, nStations, nDecisions);
+          std::cout << nStations << "\t" << std::fixed << std::setprecision (1) << ns << std::endl;
+        }
+    }
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,426 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "wifi-saturation-extrapolation-helper.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/application.h"
+#include "ns3/mobility-model.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/ampdu-tag.h"
+#include "ns3/dcf.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WifiSaturationExtrapolationHelper");
+
+WifiSaturationExtrapolationHelper::Station::Station ()
+  : attempts (0),
+    failures (0),
+    bytes (0)
+{
+}
+
+void
+WifiSaturationExtrapolationHelper::Station::NotifyTxBegin (Ptr<const Packet> packet)
+{
+  AmpduTag ampdu;
+  if (packet->PeekPacketTag (ampdu))
+    {
+      //the subframes of an A-MPDU are not accounted for by the model
+      return;
+    }
+  WifiMacHeader hdr;
+  packet->PeekHeader (hdr);
+  if (hdr.IsData () && !hdr.GetAddr1 ().IsGroup ())
+    {
+      attempts++;
+      bytes += packet->GetSize ();
+    }
+}
+
+void
+WifiSaturationExtrapolationHelper::Station::NotifyTxDataFailed (Mac48Address address)
+{
+  failures++;
+}
+
+WifiSaturationExtrapolationHelper::WifiSaturationExtrapolationHelper ()
+  : m_interval (Seconds (1)),
+    m_tolerance (0.02),
+    m_modelTolerance (0.1),
+    m_minAttempts (1000),
+    m_cwMin (0),
+    m_cwMax (0),
+    m_nNodes (0),
+    m_startAttempts (0),
+    m_startFailures (0),
+    m_startBytes (0),
+    m_intervalFailures (0),
+    m_intervalBytes (0),
+    m_lastEstimate (-1),
+    m_collisionProbability (0),
+    m_truncated (false),
+    m_extraSuccesses (0),
+    m_extraBytes (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+WifiSaturationExtrapolationHelper::SetCheckInterval (Time interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  NS_ASSERT (interval.IsStrictlyPositive ());
+  m_interval = interval;
+}
+
+void
+WifiSaturationExtrapolationHelper::SetTolerance (double tolerance)
+{
+  NS_LOG_FUNCTION (this << tolerance);
+  m_tolerance = tolerance;
+}
+
+void
+WifiSaturationExtrapolationHelper::SetModelTolerance (double tolerance)
+{
+  NS_LOG_FUNCTION (this << tolerance);
+  m_modelTolerance = tolerance;
+}
+
+void
+WifiSaturationExtrapolationHelper::SetMinAttempts (uint32_t minAttempts)
+{
+  NS_LOG_FUNCTION (this << minAttempts);
+  m_minAttempts = minAttempts;
+}
+
+void
+WifiSaturationExtrapolationHelper::Install (NetDeviceContainer devices)
+{
+  NS_LOG_FUNCTION (this << devices.GetN ());
+  for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); ++i)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (*i);
+      NS_ASSERT_MSG (device != 0, "WifiSaturationExtrapolationHelper: not a WifiNetDevice");
+      Ptr<WifiMac> mac = device->GetMac ();
+
+      BooleanValue qosSupported;
+      mac->GetAttribute ("QosSupported", qosSupported);
+      PointerValue dcf;
+      mac->GetAttribute (qosSupported.Get () ? "BE_EdcaTxopN" : "DcaTxop", dcf);
+      NS_ASSERT (dcf.Get<Dcf> () != 0);
+      if (m_stations.empty ())
+        {
+          m_cwMin = dcf.Get<Dcf> ()->GetMinCw ();
+          m_cwMax = dcf.Get<Dcf> ()->GetMaxCw ();
+        }
+      NS_ASSERT_MSG (dcf.Get<Dcf> ()->GetMinCw () == m_cwMin && dcf.Get<Dcf> ()->GetMaxCw () == m_cwMax,
+                     "WifiSaturationExtrapolationHelper: the devices do not have the same contention window");
+
+      Ptr<Station> station = Create<Station> ();
+      device->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&Station::NotifyTxBegin, station));
+      device->GetRemoteStationManager ()->TraceConnectWithoutContext ("MacTxDataFailed", MakeCallback (&Station::NotifyTxDataFailed, station));
+      m_stations.push_back (station);
+
+      Ptr<MobilityModel> mobility = device->GetNode ()->GetObject<MobilityModel> ();
+      if (mobility != 0)
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&WifiSaturationExtrapolationHelper::NotifyCourseChange, this));
+        }
+    }
+}
+
+void
+WifiSaturationExtrapolationHelper::Start (Time startTime, Time stopTime)
+{
+  NS_LOG_FUNCTION (this << startTime << stopTime);
+  NS_ASSERT (startTime <= stopTime);
+  m_startTime = startTime;
+  m_stopTime = stopTime;
+  m_checkEvent.Cancel ();
+  m_checkEvent = Simulator::Schedule (startTime - Simulator::Now (), &WifiSaturationExtrapolationHelper::Reset, this);
+}
+
+void
+WifiSaturationExtrapolationHelper::GetTotals (uint64_t &attempts, uint64_t &failures, uint64_t &bytes) const
+{
+  attempts = 0;
+  failures = 0;
+  bytes = 0;
+  for (std::vector<Ptr<Station> >::const_iterator i = m_stations.begin (); i != m_stations.end (); ++i)
+    {
+      attempts += (*i)->attempts;
+      failures += (*i)->failures;
+      bytes += (*i)->bytes;
+    }
+}
+
+void
+WifiSaturationExtrapolationHelper::Reset (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (Simulator::Now () == m_startTime)
+    {
+      GetTotals (m_startAttempts, m_startFailures, m_startBytes);
+    }
+  uint64_t attempts;
+  GetTotals (attempts, m_intervalFailures, m_intervalBytes);
+  m_intervalAttempts.clear ();
+  for (std::vector<Ptr<Station> >::const_iterator i = m_stations.begin (); i != m_stations.end (); ++i)
+    {
+      m_intervalAttempts.push_back ((*i)->attempts);
+    }
+  m_intervalStart = Simulator::Now ();
+  m_nNodes = NodeList::GetNNodes ();
+  m_lastEstimate = -1;
+  m_checkEvent.Cancel ();
+  if (Simulator::Now () + m_interval < m_stopTime)
+    {
+      m_checkEvent = Simulator::Schedule (m_interval, &WifiSaturationExtrapolationHelper::Check, this);
+    }
+}
+
+void
+WifiSaturationExtrapolationHelper::NotifyCourseChange (Ptr<const MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  if (Simulator::Now () >= m_startTime && !m_truncated)
+    {
+      NS_LOG_DEBUG ("Topology change, discarding the current estimates");
+      Reset ();
+    }
+}
+
+bool
+WifiSaturationExtrapolationHelper::IsTrafficChanging (void) const
+{
+  Time now = Simulator::Now ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      for (uint32_t j = 0; j < (*i)->GetNApplications (); j++)
+        {
+          TimeValue start, stop;
+          (*i)->GetApplication (j)->GetAttribute ("StartTime", start);
+          (*i)->GetApplication (j)->GetAttribute ("StopTime", stop);
+          if ((start.Get () > now && start.Get () < m_stopTime)
+              || (stop.Get () > now && stop.Get () < m_stopTime))
+            {
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+void
+WifiSaturationExtrapolationHelper::Check (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (NodeList::GetNNodes () != m_nNodes)
+    {
+      NS_LOG_DEBUG ("Topology change, discarding the current estimates");
+      Reset ();
+      return;
+    }
+
+  uint64_t attempts, failures, bytes;
+  GetTotals (attempts, failures, bytes);
+  uint64_t intervalAttempts = 0;
+  bool saturated = true;
+  for (uint32_t i = 0; i < m_stations.size (); i++)
+    {
+      saturated = saturated && m_stations[i]->attempts > m_intervalAttempts[i];
+      intervalAttempts += m_stations[i]->attempts - m_intervalAttempts[i];
+    }
+  if (intervalAttempts < m_minAttempts && saturated)
+    {
+      //extend the interval
+      if (Simulator::Now () + m_interval < m_stopTime)
+        {
+          m_checkEvent = Simulator::Schedule (m_interval, &WifiSaturationExtrapolationHelper::Check, this);
+        }
+      return;
+    }
+
+  double estimate = 0;
+  if (intervalAttempts > 0)
+    {
+      estimate = static_cast<double> (failures - m_intervalFailures) / intervalAttempts;
+      m_collisionProbability = estimate;
+    }
+  double model = ComputeCollisionProbability (m_stations.size (), m_cwMin, m_cwMax);
+  NS_LOG_DEBUG ("Collision probability: estimated " << estimate << ", previous " << m_lastEstimate << ", model " << model);
+
+  bool steady = saturated
+    && m_lastEstimate >= 0
+    && std::fabs (estimate - m_lastEstimate) <= m_tolerance
+    && std::fabs (estimate - model) <= m_modelTolerance
+    && !IsTrafficChanging ();
+  if (!steady)
+    {
+      double lastEstimate = saturated ? estimate : -1;
+      Reset ();
+      m_lastEstimate = lastEstimate;
+      return;
+    }
+
+  //Extrapolate the rates of the last interval until the stop time.
+  double elapsed = (Simulator::Now () - m_intervalStart).GetSeconds ();
+  double remaining = (m_stopTime - Simulator::Now ()).GetSeconds ();
+  uint64_t intervalFailures = failures - m_intervalFailures;
+  m_extraSuccesses = (intervalAttempts - intervalFailures) / elapsed * remaining;
+  m_extraBytes = (bytes - m_intervalBytes) * (1 - estimate) / elapsed * remaining;
+  m_truncated = true;
+  m_truncationTime = Simulator::Now ();
+  NS_LOG_INFO ("Steady state reached, truncating the simulation at " << m_truncationTime.GetSeconds ()
+               << "s and extrapolating until " << m_stopTime.GetSeconds () << "s");
+  Simulator::Stop ();
+}
+
+bool
+WifiSaturationExtrapolationHelper::IsTruncated (void) const
+{
+  return m_truncated;
+}
+
+Time
+WifiSaturationExtrapolationHelper::GetTruncationTime (void) const
+{
+  return m_truncated ? m_truncationTime : Simulator::Now ();
+}
+
+double
+WifiSaturationExtrapolationHelper::GetCollisionProbability (void) const
+{
+  return m_collisionProbability;
+}
+
+double
+WifiSaturationExtrapolationHelper::GetSuccesses (void) const
+{
+  uint64_t attempts, failures, bytes;
+  GetTotals (attempts, failures, bytes);
+  return static_cast<double> (attempts - m_startAttempts) - (failures - m_startFailures) + m_extraSuccesses;
+}
+
+double
+WifiSaturationExtrapolationHelper::GetThroughput (void) const
+{
+  uint64_t attempts, failures, bytes;
+  GetTotals (attempts, failures, bytes);
+  Time end = m_truncated ? m_stopTime : Simulator::Now ();
+  if (end <= m_startTime || attempts == m_startAttempts)
+    {
+      return 0;
+    }
+  //the bytes of the failed transmissions are not counted, assuming that
+  //failures do not depend on the size of the frames
+  double failureRatio = static_cast<double> (failures - m_startFailures) / (attempts - m_startAttempts);
+  double sent = (bytes - m_startBytes) * (1 - failureRatio) + m_extraBytes;
+  return sent * 8 / (end - m_startTime).GetSeconds ();
+}
+
+Time
+WifiSaturationExtrapolationHelper::GetMeanAccessDelay (void) const
+{
+  Time end = m_truncated ? m_stopTime : Simulator::Now ();
+  double successes = GetSuccesses ();
+  if (end <= m_startTime || successes <= 0)
+    {
+      return Seconds (0);
+    }
+  return Seconds ((end - m_startTime).GetSeconds () * m_stations.size () / successes);
+}
+
+double
+WifiSaturationExtrapolationHelper::ComputeTransmissionProbability (double collisionProbability, uint32_t cwMin, uint32_t cwMax)
+{
+  double p = collisionProbability;
+  double w = cwMin + 1;
+  //number of backoff stages: the contention window doubles up to cwMax
+  uint32_t m = 0;
+  for (uint32_t cw = cwMin; cw < cwMax; cw = 2 * cw + 1)
+    {
+      m++;
+    }
+  //tau = 2 (1 - 2p) / ((1 - 2p) (W + 1) + p W (1 - (2p)^m)), written with
+  //the sum of (2p)^k for k < m so as not to divide by zero at p = 0.5
+  double sum = 0;
+  double power = 1;
+  for (uint32_t k = 0; k < m; k++)
+    {
+      sum += power;
+      power *= 2 * p;
+    }
+  return 2 / (w + 1 + p * w * sum);
+}
+
+double
+WifiSaturationExtrapolationHelper::ComputeCollisionProbability (uint32_t nStations, uint32_t cwMin, uint32_t cwMax)
+{
+  if (nStations <= 1)
+    {
+      return 0;
+    }
+  //p - (1 - (1 - tau (p))^(n - 1)) increases with p: bisection
+  double low = 0;
+  double high = 1;
+  for (uint32_t i = 0; i < 64; i++)
+    {
+      double p = (low + high) / 2;
+      double tau = ComputeTransmissionProbability (p, cwMin, cwMax);
+      if (p < 1 - std::pow (1 - tau, static_cast<double> (nStations - 1)))
+        {
+          low = p;
+        }
+      else
+        {
+          high = p;
+        }
+    }
+  return (low + high) / 2;
+}
+
+double
+WifiSaturationExtrapolationHelper::ComputeThroughput (uint32_t nStations, uint32_t cwMin, uint32_t cwMax,
+                                                      uint32_t payloadSize, Time slot,
+                                                      Time successDuration, Time collisionDuration)
+{
+  double p = ComputeCollisionProbability (nStations, cwMin, cwMax);
+  double tau = ComputeTransmissionProbability (p, cwMin, cwMax);
+  //probability that at least one station transmits in a slot
+  double ptr = 1 - std::pow (1 - tau, static_cast<double> (nStations));
+  //probability that such a transmission is successful
+  double ps = nStations * tau * std::pow (1 - tau, static_cast<double> (nStations - 1)) / ptr;
+  double slotDuration = (1 - ptr) * slot.GetSeconds ()
+    + ptr * ps * successDuration.GetSeconds ()
+    + ptr * (1 - ps) * collisionDuration.GetSeconds ();
+  return ps * ptr * payloadSize * 8 / slotDuration;
+}
+
+} // namespace ns3
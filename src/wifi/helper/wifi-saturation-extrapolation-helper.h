@@ -0,0 +1,259 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WIFI_SATURATION_EXTRAPOLATION_HELPER_H
+#define WIFI_SATURATION_EXTRAPOLATION_HELPER_H
+
+#include <vector>
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mac48-address.h"
+
+namespace ns3 {
+
+class Packet;
+class MobilityModel;
+
+/**
+ * \ingroup wifi
+ *
+ * \brief Truncate a saturated Wi-Fi simulation as soon as it reaches its
+ * steady state and extrapolate its statistics until the stop time.
+ *
+ * In saturation, the DCF settles into a repeating backoff/DATA/SIFS/ACK
+ * cycle whose statistics no longer change over time. This helper monitors
+ * the data frames sent by the installed devices and, every check interval,
+ * estimates the probability that a transmission fails (i.e., the
+ * conditional collision probability of the Bianchi model). The steady
+ * state is reached when the estimates of two consecutive intervals agree
+ * with each other. The estimates must also be close to the fixed point of
+ * the Bianchi model for the number of installed devices and their
+ * contention window; the model ignores the retry limit and the EIFS, so
+ * the DCF of the simulator deviates from it by a few percent, but a
+ * larger deviation means that the devices are not in the situation the
+ * model describes (e.g., hidden stations or a lossy channel). The helper
+ * then calls Simulator::Stop and extrapolates the success rate and the
+ * number of bytes sent during the last interval until the stop time.
+ *
+ * Nothing is simulated after the truncation time: the events that remain
+ * scheduled are never executed, and only the statistics returned by this
+ * helper (GetSuccesses, GetThroughput and GetMeanAccessDelay) account for
+ * the remaining time. The traces, the counters of the applications and
+ * the state of the nodes (e.g., FlowMonitor statistics or the packets
+ * received by a sink) are those at the truncation time, and the
+ * simulated time returned by Simulator::Now is the truncation time.
+ *
+ * The simulation keeps on being run event by event as long as:
+ * - an installed device did not transmit during the last interval (it is
+ *   not saturated),
+ * - an application is started or stopped before the stop time,
+ * - a node is added or an installed node moves (the estimates of the
+ *   interval are then discarded).
+ *
+ * Only the devices that contend for the channel must be installed (e.g.,
+ * the stations in an uplink scenario, not the access point). The model
+ * assumes the basic access (no RTS/CTS) and MPDUs that are not
+ * aggregated; any other exchange makes the estimates disagree with the
+ * model, so that the simulation is not truncated.
+ *
+ * The helper schedules events and is connected to trace sources: it must
+ * not be destroyed before the end of the simulation.
+ */
+class WifiSaturationExtrapolationHelper
+{
+public:
+  WifiSaturationExtrapolationHelper ();
+
+  /**
+   * \param interval the duration of the intervals over which the
+   *        collision probability is estimated
+   */
+  void SetCheckInterval (Time interval);
+  /**
+   * \param tolerance the maximum difference between two estimates of the
+   *        collision probability that are deemed to agree
+   */
+  void SetTolerance (double tolerance);
+  /**
+   * \param tolerance the maximum difference between the estimated collision
+   *        probability and the one of the Bianchi model
+   */
+  void SetModelTolerance (double tolerance);
+  /**
+   * \param minAttempts the minimum number of transmissions over which the
+   *        collision probability is estimated. An interval with fewer
+   *        transmissions is extended by another check interval.
+   */
+  void SetMinAttempts (uint32_t minAttempts);
+
+  /**
+   * Monitor the transmissions of the given devices, which must be
+   * WifiNetDevices with the same contention window.
+   *
+   * \param devices the devices contending for the channel
+   */
+  void Install (NetDeviceContainer devices);
+  /**
+   * Start monitoring the installed devices.
+   *
+   * \param startTime the time at which the statistics start being
+   *        collected, e.g., once the applications are started
+   * \param stopTime the time at which the simulation is stopped
+   */
+  void Start (Time startTime, Time stopTime);
+
+  /**
+   * \return true if the simulation was stopped before the stop time and
+   *         its statistics extrapolated
+   */
+  bool IsTruncated (void) const;
+  /**
+   * \return the time at which the simulation was stopped, if it was
+   *         truncated, and the current time otherwise
+   */
+  Time GetTruncationTime (void) const;
+  /**
+   * \return the collision probability estimated over the last interval
+   */
+  double GetCollisionProbability (void) const;
+  /**
+   * \return the number of successful transmissions of the installed devices
+   *         since the start time, including the extrapolated ones
+   */
+  double GetSuccesses (void) const;
+  /**
+   * \return the throughput of the installed devices in bit/s, computed on
+   *         the successfully sent MPDUs since the start time
+   */
+  double GetThroughput (void) const;
+  /**
+   * \return the mean time between the successful transmissions of an
+   *         installed device, i.e., its mean access delay in saturation
+   */
+  Time GetMeanAccessDelay (void) const;
+
+  /**
+   * Solve the fixed point of the Bianchi model.
+   *
+   * \param nStations the number of saturated stations
+   * \param cwMin the minimum contention window, as in DcaTxop::SetMinCw
+   * \param cwMax the maximum contention window, as in DcaTxop::SetMaxCw
+   * \return the probability that a transmission collides
+   */
+  static double ComputeCollisionProbability (uint32_t nStations, uint32_t cwMin, uint32_t cwMax);
+  /**
+   * \param collisionProbability the probability that a transmission collides
+   * \param cwMin the minimum contention window
+   * \param cwMax the maximum contention window
+   * \return the probability that a station transmits in a slot
+   */
+  static double ComputeTransmissionProbability (double collisionProbability, uint32_t cwMin, uint32_t cwMax);
+  /**
+   * Compute the saturation throughput of the Bianchi model.
+   *
+   * \param nStations the number of saturated stations
+   * \param cwMin the minimum contention window
+   * \param cwMax the maximum contention window
+   * \param payloadSize the payload size in bytes
+   * \param slot the slot duration
+   * \param successDuration the duration of a successful transmission,
+   *        including the ACK and the interframe spaces
+   * \param collisionDuration the duration of a collision, including the
+   *        ACK timeout
+   * \return the throughput in bit/s
+   */
+  static double ComputeThroughput (uint32_t nStations, uint32_t cwMin, uint32_t cwMax,
+                                   uint32_t payloadSize, Time slot,
+                                   Time successDuration, Time collisionDuration);
+
+private:
+  /**
+   * Transmission counters of an installed device.
+   */
+  struct Station : public SimpleRefCount<Station>
+  {
+    Station ();
+    /**
+     * \param packet the packet whose transmission begins
+     */
+    void NotifyTxBegin (Ptr<const Packet> packet);
+    /**
+     * \param address the destination of the failed data frame
+     */
+    void NotifyTxDataFailed (Mac48Address address);
+
+    uint64_t attempts; //!< number of data frames sent
+    uint64_t failures; //!< number of data frames not acknowledged
+    uint64_t bytes;    //!< number of bytes of the data frames sent
+  };
+
+  /**
+   * Discard the estimates of the current interval, on a topology change.
+   */
+  void Reset (void);
+  /**
+   * \param model the mobility model whose course changed
+   */
+  void NotifyCourseChange (Ptr<const MobilityModel> model);
+  /**
+   * Estimate the collision probability over the current interval and
+   * truncate the simulation if the steady state is reached.
+   */
+  void Check (void);
+  /**
+   * \return true if an application is started or stopped before the stop time
+   */
+  bool IsTrafficChanging (void) const;
+  /**
+   * Take a snapshot of the counters of the installed devices.
+   *
+   * \param attempts the number of data frames sent
+   * \param failures the number of data frames not acknowledged
+   * \param bytes the number of bytes of the data frames sent
+   */
+  void GetTotals (uint64_t &attempts, uint64_t &failures, uint64_t &bytes) const;
+
+  Time m_interval;                     //!< duration of the intervals
+  double m_tolerance;                  //!< maximum difference between agreeing estimates
+  double m_modelTolerance;             //!< maximum difference between the estimates and the model
+  uint32_t m_minAttempts;              //!< minimum number of transmissions of an interval
+  std::vector<Ptr<Station> > m_stations; //!< counters of the installed devices
+  uint32_t m_cwMin;                    //!< minimum contention window of the installed devices
+  uint32_t m_cwMax;                    //!< maximum contention window of the installed devices
+  uint32_t m_nNodes;                   //!< number of nodes when the interval started
+  Time m_startTime;                    //!< start time of the statistics
+  Time m_stopTime;                     //!< stop time of the simulation
+  Time m_intervalStart;                //!< start time of the current interval
+  std::vector<uint64_t> m_intervalAttempts; //!< attempts of every device when the interval started
+  uint64_t m_startAttempts;            //!< attempts at the start time
+  uint64_t m_startFailures;            //!< failures at the start time
+  uint64_t m_startBytes;               //!< bytes at the start time
+  uint64_t m_intervalFailures;         //!< failures when the interval started
+  uint64_t m_intervalBytes;            //!< bytes when the interval started
+  double m_lastEstimate;               //!< collision probability of the previous interval, negative if none
+  double m_collisionProbability;       //!< collision probability of the last interval
+  bool m_truncated;                    //!< whether the simulation was truncated
+  Time m_truncationTime;               //!< time at which the simulation was truncated
+  double m_extraSuccesses;             //!< extrapolated successful transmissions
+  double m_extraBytes;                 //!< extrapolated bytes successfully sent
+  EventId m_checkEvent;                //!< next check
+};
+
+} // namespace ns3
+
+#endif /* WIFI_SATURATION_EXTRAPOLATION_HELPER_H */
@@ -24,6 +24,7 @@
 #include "ns3/propagation-delay-model.h"
 #include "ns3/yans-wifi-phy.h"
 #include "ns3/names.h"
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 
 namespace ns3 {
@@ -147,6 +148,12 @@ YansWifiPhyHelper::SetChannel (std::string channelName)
   m_channel = channel;
 }
 
+void
+YansWifiPhyHelper::SetFastPhy (bool enable)
+{
+  m_phy.Set ("FastPhy", BooleanValue (enable));
+}
+
 Ptr<WifiPhy>
 YansWifiPhyHelper::Create (Ptr<Node> node, Ptr<NetDevice> device) const
 {
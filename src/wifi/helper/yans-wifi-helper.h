@@ -182,6 +182,15 @@ public:
    * Every PHY created by a call to Install is associated to this channel.
    */
   void SetChannel (std::string channelName);
+  /**
+   * \param enable whether the fast PHY abstraction should be used
+   *
+   * Every PHY created by a call to Install uses a single effective SINR
+   * per frame, computed from the aggregate interference at the start of
+   * the frame, instead of integrating the PER over every interference
+   * change. See the FastPhy attribute of ns3::WifiPhy.
+   */
+  void SetFastPhy (bool enable);
 
 private:
   /**
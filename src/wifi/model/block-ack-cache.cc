@@ -23,6 +23,7 @@
 #include "wifi-mac-header.h"
 #include "qos-utils.h"
 #include "ns3/log.h"
+#include <algorithm>
 
 #define WINSIZE_ASSERT NS_ASSERT ((m_winEnd - m_winStart + 4096) % 4096 == m_winSize - 1)
 
@@ -37,7 +38,8 @@ BlockAckCache::Init (uint16_t winStart, uint16_t winSize)
   m_winStart = winStart;
   m_winSize = winSize <= 64 ? winSize : 64;
   m_winEnd = (m_winStart + m_winSize - 1) % 4096;
-  memset (m_bitmap, 0, sizeof (m_bitmap));
+  memset (m_firstFragments, 0, sizeof (m_firstFragments));
+  memset (m_otherFragments, 0, sizeof (m_otherFragments));
 }
 
 uint16_t
@@ -65,7 +67,15 @@ BlockAckCache::UpdateWithMpdu (const WifiMacHeader *hdr)
 
           WINSIZE_ASSERT;
         }
-      m_bitmap[seqNumber] |= (0x0001 << hdr->GetFragmentNumber ());
+      uint64_t bit = uint64_t (1) << (seqNumber % 64);
+      if (hdr->GetFragmentNumber () == 0)
+        {
+          m_firstFragments[seqNumber / 64] |= bit;
+        }
+      else
+        {
+          m_otherFragments[seqNumber / 64] |= bit;
+        }
     }
 }
 
@@ -102,12 +112,35 @@ void
 BlockAckCache::ResetPortionOfBitmap (uint16_t start, uint16_t end)
 {
   NS_LOG_FUNCTION (this << start << end);
+  uint32_t n = (end - start + 4096) % 4096 + 1;
   uint16_t i = start;
-  for (; i != end; i = (i + 1) % 4096)
+  while (n > 0)
+    {
+      //clear the bits of the range which are in the word of sequence number i
+      uint32_t offset = i % 64;
+      uint32_t nBits = std::min (64 - offset, n);
+      uint64_t mask = nBits == 64 ? ~uint64_t (0) : ((uint64_t (1) << nBits) - 1) << offset;
+      m_firstFragments[i / 64] &= ~mask;
+      m_otherFragments[i / 64] &= ~mask;
+      i = (i + nBits) % 4096;
+      n -= nBits;
+    }
+}
+
+uint64_t
+BlockAckCache::GetCompressedBits (uint16_t start) const
+{
+  NS_LOG_FUNCTION (this << start);
+  //a packet is acknowledged in a compressed block ack only if it was received unfragmented
+  uint32_t word = start / 64;
+  uint32_t offset = start % 64;
+  uint64_t bits = (m_firstFragments[word] & ~m_otherFragments[word]) >> offset;
+  if (offset != 0)
     {
-      m_bitmap[i] = 0;
+      uint32_t next = (word + 1) % 64;
+      bits |= (m_firstFragments[next] & ~m_otherFragments[next]) << (64 - offset);
     }
-  m_bitmap[i] = 0;
+  return bits;
 }
 
 bool
@@ -127,19 +160,12 @@ BlockAckCache::FillBlockAckBitmap (CtrlBAckResponseHeader *blockAckHeader)
     }
   else if (blockAckHeader->IsCompressed ())
     {
-      uint16_t i = blockAckHeader->GetStartingSequence ();
-      uint16_t end = (i + m_winSize - 1) % 4096;
-      for (; i != end; i = (i + 1) % 4096)
-        {
-          if (m_bitmap[i] == 1)
-            {
-              blockAckHeader->SetReceivedPacket (i);
-            }
-        }
-      if (m_bitmap[i] == 1)
+      uint64_t receivedPackets = GetCompressedBits (blockAckHeader->GetStartingSequence ());
+      if (m_winSize < 64)
         {
-          blockAckHeader->SetReceivedPacket (i);
+          receivedPackets &= (uint64_t (1) << m_winSize) - 1;
         }
+      blockAckHeader->SetReceivedPackets (receivedPackets);
     }
   else if (blockAckHeader->IsMultiTid ())
     {
@@ -53,12 +53,23 @@ public:
 private:
   void ResetPortionOfBitmap (uint16_t start, uint16_t end);
   bool IsInWindow (uint16_t seq) const;
+  /**
+   * \param start the sequence number of the first bit to return
+   * \return the 64 bits of the compressed bitmap starting at the given sequence number
+   */
+  uint64_t GetCompressedBits (uint16_t start) const;
 
   uint16_t m_winStart;
   uint8_t m_winSize;
   uint16_t m_winEnd;
 
-  uint16_t m_bitmap[4096];
+  /*
+   * Received fragments, indexed by sequence number, one bit per sequence
+   * number: m_firstFragments tracks the reception of the first fragment
+   * and m_otherFragments the reception of any other fragment.
+   */
+  uint64_t m_firstFragments[64];
+  uint64_t m_otherFragments[64];
 };
 
 } //namespace ns3
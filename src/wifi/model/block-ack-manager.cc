@@ -138,11 +138,12 @@ BlockAckManager::DestroyAgreement (Mac48Address recipient, uint8_t tid)
   AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
   if (it != m_agreements.end ())
     {
-      for (std::list<PacketQueueI>::iterator i = m_retryPackets.begin (); i != m_retryPackets.end (); )
+      for (std::list<PacketQueueI>::iterator i = m_retryPackets.begin ();
+           i != m_retryPackets.end () && it->second.first.m_nRetryPackets > 0; )
         {
           if ((*i)->hdr.GetAddr1 () == recipient && (*i)->hdr.GetQosTid () == tid)
             {
-              i = m_retryPackets.erase (i);
+              i = RemoveFromRetryQueue (it, i);
             }
           else
             {
@@ -210,6 +211,14 @@ BlockAckManager::StorePacket (Ptr<const Packet> packet, const WifiMacHeader &hdr
   Item item (packet, hdr, tStamp);
   AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
   NS_ASSERT (it != m_agreements.end ());
+  PacketQueue &queue = it->second.second;
+  //packets are usually stored in increasing order of sequence numbers
+  if (queue.empty ()
+      || ((hdr.GetSequenceNumber () - queue.back ().hdr.GetSequenceNumber () + 4096) % 4096) <= 2047)
+    {
+      queue.push_back (item);
+      return;
+    }
   PacketQueueI queueIt = it->second.second.begin ();
   for (; queueIt != it->second.second.end (); )
     {
@@ -267,8 +276,9 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr)
             {
               //Standard says the originator should not send a packet with seqnum < winstart
               NS_LOG_DEBUG ("The Retry packet have sequence number < WinStartO --> Discard " << (*it)->hdr.GetSequenceNumber () << " " << agreement->second.first.GetStartingSequence ());
-              agreement->second.second.erase ((*it));
-              it = m_retryPackets.erase (it);
+              PacketQueueI item = *it;
+              it = RemoveFromRetryQueue (agreement, it);
+              agreement->second.second.erase (item);
               continue;
             }
           else if ((*it)->hdr.GetSequenceNumber () > (agreement->second.first.GetStartingSequence () + 63) % 4096)
@@ -293,6 +303,7 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr)
                   || SwitchToBlockAckIfNeeded (recipient, tid, hdr.GetSequenceNumber ())))
             {
               hdr.SetQosAckPolicy (WifiMacHeader::BLOCK_ACK);
+              it = RemoveFromRetryQueue (agreement, it);
             }
           else
             {
@@ -305,9 +316,10 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr)
                */
               hdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
               AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
-              i->second.second.erase (*it);
+              PacketQueueI item = *it;
+              it = RemoveFromRetryQueue (agreement, it);
+              i->second.second.erase (item);
             }
-          it = m_retryPackets.erase (it);
           NS_LOG_DEBUG ("Removed one packet, retry buffer size = " << m_retryPackets.size () );
           break;
         }
@@ -383,6 +395,10 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address
   CleanupBuffers ();
   AgreementsI agreement = m_agreements.find (std::make_pair (recipient, tid));
   NS_ASSERT (agreement != m_agreements.end ());
+  if (agreement->second.first.m_nRetryPackets == 0)
+    {
+      return packet;
+    }
   std::list<PacketQueueI>::iterator it = m_retryPackets.begin ();
   for (; it != m_retryPackets.end (); it++)
     {
@@ -396,8 +412,9 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address
             {
               //standard says the originator should not send a packet with seqnum < winstart
               NS_LOG_DEBUG ("The Retry packet have sequence number < WinStartO --> Discard " << (*it)->hdr.GetSequenceNumber () << " " << agreement->second.first.GetStartingSequence ());
-              agreement->second.second.erase ((*it));
-              it = m_retryPackets.erase (it);
+              PacketQueueI item = *it;
+              it = RemoveFromRetryQueue (agreement, it);
+              agreement->second.second.erase (item);
               it--;
               continue;
             }
@@ -438,7 +455,10 @@ BlockAckManager::PeekNextPacketByTidAndAddress (WifiMacHeader &hdr, Mac48Address
 bool
 BlockAckManager::RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seqnumber)
 {
-
+  if (!AlreadyExists (seqnumber, recipient, tid))
+    {
+      return false;
+    }
   std::list<PacketQueueI>::iterator it = m_retryPackets.begin ();
   for (; it != m_retryPackets.end (); it++)
     {
@@ -453,9 +473,10 @@ BlockAckManager::RemovePacket (uint8_t tid, Mac48Address recipient, uint16_t seq
           Mac48Address recipient = hdr.GetAddr1 ();
 
           AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
-          i->second.second.erase ((*it));
+          PacketQueueI item = *it;
+          RemoveFromRetryQueue (i, it);
+          i->second.second.erase (item);
 
-          m_retryPackets.erase (it);
           NS_LOG_DEBUG ("Removed Packet from retry queue = " << hdr.GetSequenceNumber () << " " << (uint16_t)tid << " " << recipient << " Buffer Size = " << m_retryPackets.size ());
           return true;
         }
@@ -514,7 +535,8 @@ BlockAckManager::GetNRetryNeededPackets (Mac48Address recipient, uint8_t tid) co
   NS_LOG_FUNCTION (this << recipient << (uint16_t)tid);
   uint32_t nPackets = 0;
   uint16_t currentSeq = 0;
-  if (ExistsAgreement (recipient, tid))
+  AgreementsCI agreement = m_agreements.find (std::make_pair (recipient, tid));
+  if (agreement != m_agreements.end () && agreement->second.first.m_nRetryPackets > 0)
     {
       std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
       while (it != m_retryPackets.end ())
@@ -560,21 +582,13 @@ BlockAckManager::SetWifiRemoteStationManager (Ptr<WifiRemoteStationManager> mana
 bool
 BlockAckManager::AlreadyExists (uint16_t currentSeq, Mac48Address recipient, uint8_t tid) const
 {
-  std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
-  while (it != m_retryPackets.end ())
+  NS_LOG_FUNCTION (this << currentSeq << recipient << (uint16_t)tid);
+  AgreementsCI it = m_agreements.find (std::make_pair (recipient, tid));
+  if (it == m_agreements.end ())
     {
-      NS_LOG_FUNCTION (this << (*it)->hdr.GetType ());
-      if (!(*it)->hdr.IsQosData ())
-        {
-          NS_FATAL_ERROR ("Packet in blockAck manager retry queue is not Qos Data");
-        }
-      if ((*it)->hdr.GetAddr1 () == recipient && (*it)->hdr.GetQosTid () == tid && currentSeq == (*it)->hdr.GetSequenceNumber ())
-        {
-          return true;
-        }
-      it++;
+      return false;
     }
-  return false;
+  return it->second.first.m_retrySeqs.test (currentSeq % 4096);
 }
 
 void
@@ -893,13 +907,17 @@ BlockAckManager::CleanupBuffers (void)
           else
             {
               /* remove retry packet iterator if it's present in retry queue */
+              if (!j->second.first.m_retrySeqs.test (i->hdr.GetSequenceNumber ()))
+                {
+                  continue;
+                }
               for (std::list<PacketQueueI>::iterator it = m_retryPackets.begin (); it != m_retryPackets.end (); )
                 {
                   if ((*it)->hdr.GetAddr1 () == j->second.first.GetPeer ()
                       && (*it)->hdr.GetQosTid () == j->second.first.GetTid ()
                       && (*it)->hdr.GetSequenceNumber () == i->hdr.GetSequenceNumber ())
                     {
-                      it = m_retryPackets.erase (it);
+                      it = RemoveFromRetryQueue (j, it);
                     }
                   else
                     {
@@ -952,6 +970,11 @@ uint16_t
 BlockAckManager::GetSeqNumOfNextRetryPacket (Mac48Address recipient, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << recipient << (uint16_t)tid);
+  AgreementsCI agreement = m_agreements.find (std::make_pair (recipient, tid));
+  if (agreement == m_agreements.end () || agreement->second.first.m_nRetryPackets == 0)
+    {
+      return 4096;
+    }
   std::list<PacketQueueI>::const_iterator it = m_retryPackets.begin ();
   while (it != m_retryPackets.end ())
     {
@@ -984,6 +1007,11 @@ void
 BlockAckManager::InsertInRetryQueue (PacketQueueI item)
 {
   NS_LOG_INFO ("Adding to retry queue " << (*item).hdr.GetSequenceNumber ());
+  AgreementsI agreement = m_agreements.find (std::make_pair (item->hdr.GetAddr1 (), item->hdr.GetQosTid ()));
+  NS_ASSERT (agreement != m_agreements.end ());
+  NS_ASSERT (!agreement->second.first.m_retrySeqs.test (item->hdr.GetSequenceNumber ()));
+  agreement->second.first.m_retrySeqs.set (item->hdr.GetSequenceNumber ());
+  agreement->second.first.m_nRetryPackets++;
   if (m_retryPackets.size () == 0)
     {
       m_retryPackets.push_back (item);
@@ -1009,4 +1037,14 @@ BlockAckManager::InsertInRetryQueue (PacketQueueI item)
     }
 }
 
+std::list<BlockAckManager::PacketQueueI>::iterator
+BlockAckManager::RemoveFromRetryQueue (AgreementsI agreement, std::list<PacketQueueI>::iterator it)
+{
+  NS_LOG_FUNCTION (this << (*it)->hdr.GetSequenceNumber ());
+  NS_ASSERT (agreement->second.first.m_nRetryPackets > 0);
+  agreement->second.first.m_retrySeqs.reset ((*it)->hdr.GetSequenceNumber ());
+  agreement->second.first.m_nRetryPackets--;
+  return m_retryPackets.erase (it);
+}
+
 } //namespace ns3
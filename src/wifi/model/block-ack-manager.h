@@ -427,6 +427,15 @@ private:
    * This method ensures packets are retransmitted in the correct order.
    */
   void InsertInRetryQueue (PacketQueueI item);
+  /**
+   * Remove an element of the retransmission queue.
+   *
+   * \param agreement the agreement of the packet
+   * \param it the element of the retransmission queue
+   *
+   * \return the element following the removed one
+   */
+  std::list<PacketQueueI>::iterator RemoveFromRetryQueue (AgreementsI agreement, std::list<PacketQueueI>::iterator it);
 
   /**
    * This data structure contains, for each block ack agreement (recipient, tid), a set of packets
@@ -618,6 +618,33 @@ CtrlBAckResponseHeader::SetReceivedFragment (uint16_t seq, uint8_t frag)
     }
 }
 
+void
+CtrlBAckResponseHeader::SetReceivedPackets (uint64_t receivedPackets)
+{
+  if (!m_multiTid)
+    {
+      if (!m_compressed)
+        {
+          NS_FATAL_ERROR ("Only the compressed bitmap can be set as a whole.");
+        }
+      else
+        {
+          bitmap.m_compressedBitmap |= receivedPackets;
+        }
+    }
+  else
+    {
+      if (m_compressed)
+        {
+          NS_FATAL_ERROR ("Multi-tid block ack is not supported.");
+        }
+      else
+        {
+          NS_FATAL_ERROR ("Reserved configuration.");
+        }
+    }
+}
+
 bool
 CtrlBAckResponseHeader::IsPacketReceived (uint16_t seq) const
 {
@@ -279,6 +279,16 @@ public:
    * \param frag
    */
   void SetReceivedFragment (uint16_t seq, uint8_t frag);
+  /**
+   * Set the compressed bitmap that the packets indicated by the given
+   * bitmap were received. Bit i of the given bitmap corresponds to the
+   * packet with sequence number equal to the starting sequence plus i.
+   * This is equivalent to, but faster than, calling SetReceivedPacket
+   * for every bit set in the given bitmap.
+   *
+   * \param receivedPackets the bitmap of the received packets
+   */
+  void SetReceivedPackets (uint64_t receivedPackets);
   /**
    * Check if the packet with the given sequence number
    * was ACKed in this Block ACK response.
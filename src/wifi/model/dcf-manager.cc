@@ -253,6 +253,10 @@ public:
   {
     m_dcf->NotifyCtsTimeoutResetNow ();
   }
+  virtual void RxProcessed ()
+  {
+    m_dcf->NotifyRxProcessedNow ();
+  }
 
 private:
   ns3::DcfManager *m_dcf;  //!< DcfManager to forward events to
@@ -339,7 +343,10 @@ DcfManager::DcfManager ()
     m_slotTimeUs (0),
     m_sifs (Seconds (0.0)),
     m_phyListener (0),
-    m_lowListener (0)
+    m_lowListener (0),
+    m_accessTimeoutAfterRx (false),
+    m_accessTimeoutScheduled (0),
+    m_accessTimeoutCancelled (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -570,12 +577,13 @@ void
 DcfManager::DoGrantAccess (void)
 {
   NS_LOG_FUNCTION (this);
+  Time accessGrantStart = GetAccessGrantStart ();
   uint32_t k = 0;
   for (States::const_iterator i = m_states.begin (); i != m_states.end (); k++)
     {
       DcfState *state = *i;
       if (state->IsAccessRequested ()
-          && GetBackoffEndFor (state) <= Simulator::Now () )
+          && GetBackoffEndFor (state, accessGrantStart) <= Simulator::Now () )
         {
           /**
            * This is the first dcf we find with an expired backoff and which
@@ -589,7 +597,7 @@ DcfManager::DoGrantAccess (void)
             {
               DcfState *otherState = *j;
               if (otherState->IsAccessRequested ()
-                  && GetBackoffEndFor (otherState) <= Simulator::Now ())
+                  && GetBackoffEndFor (otherState, accessGrantStart) <= Simulator::Now ())
                 {
                   MY_DEBUG ("dcf " << k << " needs access. backoff expired. internal collision. slots=" <<
                             otherState->GetBackoffSlots ());
@@ -672,9 +680,15 @@ DcfManager::GetAccessGrantStart (void) const
 Time
 DcfManager::GetBackoffStartFor (DcfState *state)
 {
-  NS_LOG_FUNCTION (this << state);
+  return GetBackoffStartFor (state, GetAccessGrantStart ());
+}
+
+Time
+DcfManager::GetBackoffStartFor (DcfState *state, Time accessGrantStart) const
+{
+  NS_LOG_FUNCTION (this << state << accessGrantStart);
   Time mostRecentEvent = MostRecent (state->GetBackoffStart (),
-                                     GetAccessGrantStart () + MicroSeconds (state->GetAifsn () * m_slotTimeUs));
+                                     accessGrantStart + MicroSeconds (state->GetAifsn () * m_slotTimeUs));
 
   return mostRecentEvent;
 }
@@ -682,23 +696,31 @@ DcfManager::GetBackoffStartFor (DcfState *state)
 Time
 DcfManager::GetBackoffEndFor (DcfState *state)
 {
-  NS_LOG_FUNCTION (this << state);
-  NS_LOG_DEBUG ("Backoff start: " << GetBackoffStartFor (state).As (Time::US) <<
-    " end: " << (GetBackoffStartFor (state) + 
-    MicroSeconds (state->GetBackoffSlots () * m_slotTimeUs)).As (Time::US)); 
-  return GetBackoffStartFor (state) + MicroSeconds (state->GetBackoffSlots () * m_slotTimeUs);
+  return GetBackoffEndFor (state, GetAccessGrantStart ());
+}
+
+Time
+DcfManager::GetBackoffEndFor (DcfState *state, Time accessGrantStart) const
+{
+  NS_LOG_FUNCTION (this << state << accessGrantStart);
+  Time backoffStart = GetBackoffStartFor (state, accessGrantStart);
+  Time backoffEnd = backoffStart + MicroSeconds (state->GetBackoffSlots () * m_slotTimeUs);
+  NS_LOG_DEBUG ("Backoff start: " << backoffStart.As (Time::US) <<
+                " end: " << backoffEnd.As (Time::US));
+  return backoffEnd;
 }
 
 void
 DcfManager::UpdateBackoff (void)
 {
   NS_LOG_FUNCTION (this);
+  Time accessGrantStart = GetAccessGrantStart ();
   uint32_t k = 0;
   for (States::const_iterator i = m_states.begin (); i != m_states.end (); i++, k++)
     {
       DcfState *state = *i;
 
-      Time backoffStart = GetBackoffStartFor (state);
+      Time backoffStart = GetBackoffStartFor (state, accessGrantStart);
       if (backoffStart <= Simulator::Now ())
         {
           uint32_t nus = (Simulator::Now () - backoffStart).GetMicroSeconds ();
@@ -730,18 +752,30 @@ void
 DcfManager::DoRestartAccessTimeoutIfNeeded (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_rxing)
+    {
+      /**
+       * No backoff can end before the end of the reception, and the
+       * access timeout is restarted then, once the NAV set by the
+       * received packet is known, rather than at a time the NAV would
+       * push back.
+       */
+      return;
+    }
+  m_accessTimeoutAfterRx = false;
   /**
    * Is there a DcfState which needs to access the medium, and,
    * if there is one, how many slots for AIFS+backoff does it require ?
    */
   bool accessTimeoutNeeded = false;
   Time expectedBackoffEnd = Simulator::GetMaximumSimulationTime ();
+  Time accessGrantStart = GetAccessGrantStart ();
   for (States::const_iterator i = m_states.begin (); i != m_states.end (); i++)
     {
       DcfState *state = *i;
       if (state->IsAccessRequested ())
         {
-          Time tmp = GetBackoffEndFor (state);
+          Time tmp = GetBackoffEndFor (state, accessGrantStart);
           if (tmp > Simulator::Now ())
             {
               accessTimeoutNeeded = true;
@@ -753,20 +787,38 @@ DcfManager::DoRestartAccessTimeoutIfNeeded (void)
   if (accessTimeoutNeeded)
     {
       MY_DEBUG ("expected backoff end=" << expectedBackoffEnd);
-      Time expectedBackoffDelay = expectedBackoffEnd - Simulator::Now ();
-      if (m_accessTimeout.IsRunning ()
-          && Simulator::GetDelayLeft (m_accessTimeout) > expectedBackoffDelay)
+      /**
+       * A single access timeout is kept pending. It is left untouched if
+       * it expires at or before the earliest backoff end: when it expires,
+       * the backoffs are re-evaluated and the timeout is restarted if needed.
+       */
+      if (m_accessTimeout.IsRunning ())
         {
+          if (m_accessTimeout.GetTs () <= static_cast<uint64_t> (expectedBackoffEnd.GetTimeStep ()))
+            {
+              return;
+            }
           m_accessTimeout.Cancel ();
+          m_accessTimeoutCancelled++;
         }
-      if (m_accessTimeout.IsExpired ())
-        {
-          m_accessTimeout = Simulator::Schedule (expectedBackoffDelay,
-                                                 &DcfManager::AccessTimeout, this);
-        }
+      m_accessTimeout = Simulator::Schedule (expectedBackoffEnd - Simulator::Now (),
+                                             &DcfManager::AccessTimeout, this);
+      m_accessTimeoutScheduled++;
     }
 }
 
+uint64_t
+DcfManager::GetAccessTimeoutScheduledCount (void) const
+{
+  return m_accessTimeoutScheduled;
+}
+
+uint64_t
+DcfManager::GetAccessTimeoutCancelledCount (void) const
+{
+  return m_accessTimeoutCancelled;
+}
+
 void
 DcfManager::NotifyRxStartNow (Time duration)
 {
@@ -776,6 +828,12 @@ DcfManager::NotifyRxStartNow (Time duration)
   m_lastRxStart = Simulator::Now ();
   m_lastRxDuration = duration;
   m_rxing = true;
+  /**
+   * The end of the reception may move the backoff ends earlier (e.g.,
+   * when it ends an EIFS) or later (e.g., with the NAV set by the
+   * received packet): the access timeout is restarted then.
+   */
+  m_accessTimeoutAfterRx = true;
 }
 
 void
@@ -788,6 +846,16 @@ DcfManager::NotifyRxEndOkNow (void)
   m_rxing = false;
 }
 
+void
+DcfManager::NotifyRxProcessedNow (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_accessTimeoutAfterRx)
+    {
+      DoRestartAccessTimeoutIfNeeded ();
+    }
+}
+
 void
 DcfManager::NotifyRxEndErrorNow (void)
 {
@@ -796,6 +864,11 @@ DcfManager::NotifyRxEndErrorNow (void)
   m_lastRxEnd = Simulator::Now ();
   m_lastRxReceivedOk = false;
   m_rxing = false;
+  //the MAC does not handle the packet, and the NAV is left unchanged
+  if (m_accessTimeoutAfterRx)
+    {
+      DoRestartAccessTimeoutIfNeeded ();
+    }
 }
 
 void
@@ -816,6 +889,11 @@ DcfManager::NotifyTxStartNow (Time duration)
   UpdateBackoff ();
   m_lastTxStart = Simulator::Now ();
   m_lastTxDuration = duration;
+  //a reception aborted by this transmission is not handled by the MAC
+  if (m_accessTimeoutAfterRx)
+    {
+      DoRestartAccessTimeoutIfNeeded ();
+    }
 }
 
 void
@@ -865,7 +943,9 @@ DcfManager::NotifySwitchingStartNow (Time duration)
   if (m_accessTimeout.IsRunning ())
     {
       m_accessTimeout.Cancel ();
+      m_accessTimeoutCancelled++;
     }
+  m_accessTimeoutAfterRx = false;
 
   //Reset backoffs
   for (States::iterator i = m_states.begin (); i != m_states.end (); i++)
@@ -897,7 +977,9 @@ DcfManager::NotifySleepNow (void)
   if (m_accessTimeout.IsRunning ())
     {
       m_accessTimeout.Cancel ();
+      m_accessTimeoutCancelled++;
     }
+  m_accessTimeoutAfterRx = false;
 
   //Reset backoffs
   for (States::iterator i = m_states.begin (); i != m_states.end (); i++)
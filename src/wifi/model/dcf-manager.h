@@ -357,8 +357,22 @@ public:
   /**
    * Notify the DCF that a packet reception was just
    * completed successfully.
+   *
+   * The MAC must then call NotifyRxProcessedNow once it has
+   * handled the received packet.
    */
   void NotifyRxEndOkNow (void);
+  /**
+   * Notify the DCF that the MAC has handled the packet whose
+   * reception was just completed successfully, and has updated
+   * the NAV accordingly.
+   *
+   * The access timeout is not restarted while a packet is being
+   * received, because no backoff can end before the end of the
+   * reception and the NAV set by the received packet is not known
+   * yet. It is restarted here instead.
+   */
+  void NotifyRxProcessedNow (void);
   /**
    * Notify the DCF that a packet reception was just
    * completed unsuccessfully.
@@ -427,6 +441,15 @@ public:
    */
   void NotifyCtsTimeoutResetNow ();
 
+  /**
+   * \return the number of access timeouts scheduled so far
+   */
+  uint64_t GetAccessTimeoutScheduledCount (void) const;
+  /**
+   * \return the number of access timeouts cancelled before they expired
+   */
+  uint64_t GetAccessTimeoutCancelledCount (void) const;
+
 
 private:
   /**
@@ -506,6 +529,16 @@ private:
    * \return the time when the backoff procedure started
    */
   Time GetBackoffStartFor (DcfState *state);
+  /**
+   * Return the time when the backoff procedure
+   * started for the given DcfState.
+   *
+   * \param state
+   * \param accessGrantStart the value returned by GetAccessGrantStart
+   *
+   * \return the time when the backoff procedure started
+   */
+  Time GetBackoffStartFor (DcfState *state, Time accessGrantStart) const;
   /**
    * Return the time when the backoff procedure
    * ended (or will ended) for the given DcfState.
@@ -515,7 +548,22 @@ private:
    * \return the time when the backoff procedure ended (or will ended)
    */
   Time GetBackoffEndFor (DcfState *state);
+  /**
+   * Return the time when the backoff procedure
+   * ended (or will ended) for the given DcfState.
+   *
+   * \param state
+   * \param accessGrantStart the value returned by GetAccessGrantStart
+   *
+   * \return the time when the backoff procedure ended (or will ended)
+   */
+  Time GetBackoffEndFor (DcfState *state, Time accessGrantStart) const;
 
+  /**
+   * Make sure that the access timeout expires no later than the earliest
+   * backoff end of the DcfStates which requested access. During a
+   * reception, this is deferred to the end of the reception.
+   */
   void DoRestartAccessTimeoutIfNeeded (void);
 
   /**
@@ -572,6 +620,9 @@ private:
   Time m_sifs;
   PhyListener* m_phyListener;
   LowDcfListener* m_lowListener;
+  bool m_accessTimeoutAfterRx; //!< whether the access timeout must be restarted at the end of the reception
+  uint64_t m_accessTimeoutScheduled; //!< number of access timeouts scheduled
+  uint64_t m_accessTimeoutCancelled; //!< number of access timeouts cancelled
 };
 
 } //namespace ns3
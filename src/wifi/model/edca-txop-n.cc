@@ -661,12 +661,21 @@ void EdcaTxopN::NotifyInternalCollision (void)
   NS_LOG_FUNCTION (this);
   bool resetDcf = false;
   // If an internal collision is experienced, the frame involved may still
-  // be sitting in the queue, and m_currentPacket may still be null.
+  // be sitting in the queue, or be a retransmission still held by the
+  // block ack manager, and m_currentPacket may still be null. The block
+  // ack manager comes first, as in RestartAccessIfNeeded.
   Ptr<const Packet> packet;
   WifiMacHeader header;
   if (m_currentPacket == 0)
     {
-      packet = m_queue->Peek (&header);
+      if (m_baManager->HasPackets ())
+        {
+          packet = m_baManager->PeekNextPacket (header);
+        }
+      if (packet == 0)
+        {
+          packet = m_queue->Peek (&header);
+        }
       NS_ASSERT_MSG (packet, "Internal collision but no packet in queue");
     }
   else
@@ -127,7 +127,8 @@ InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_numRxAntennas (1),
     m_firstPower (0.0),
-    m_rxing (false)
+    m_rxing (false),
+    m_fastPhy (false)
 {
 }
 
@@ -186,6 +187,18 @@ InterferenceHelper::SetNumberOfReceiveAntennas (uint8_t rx)
   m_numRxAntennas = rx;
 }
 
+void
+InterferenceHelper::SetFastPhy (bool enable)
+{
+  m_fastPhy = enable;
+}
+
+bool
+InterferenceHelper::GetFastPhy (void) const
+{
+  return m_fastPhy;
+}
+
 Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
@@ -791,19 +804,79 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
   return per;
 }
 
+double
+InterferenceHelper::CalculateEffectivePlcpPayloadPer (Ptr<const InterferenceHelper::Event> event, double snir) const
+{
+  NS_LOG_FUNCTION (this << snir);
+  WifiTxVector txVector = event->GetTxVector ();
+  WifiPreamble preamble = txVector.GetPreambleType ();
+  Time plcpPayloadStart = event->GetStartTime ()
+    + WifiPhy::GetPlcpPreambleDuration (txVector)
+    + WifiPhy::GetPlcpHeaderDuration (txVector)
+    + WifiPhy::GetPlcpHtSigHeaderDuration (preamble)
+    + WifiPhy::GetPlcpVhtSigA1Duration (preamble)
+    + WifiPhy::GetPlcpVhtSigA2Duration (preamble)
+    + WifiPhy::GetPlcpHtTrainingSymbolDuration (txVector)
+    + WifiPhy::GetPlcpVhtSigBDuration (preamble);
+  double psr = CalculateChunkSuccessRate (snir, event->GetEndTime () - plcpPayloadStart,
+                                          event->GetPayloadMode (), txVector);
+  return 1 - psr;
+}
+
+double
+InterferenceHelper::CalculateEffectivePlcpHeaderPer (Ptr<const InterferenceHelper::Event> event, double snir) const
+{
+  NS_LOG_FUNCTION (this << snir);
+  WifiTxVector txVector = event->GetTxVector ();
+  WifiPreamble preamble = txVector.GetPreambleType ();
+  //L-SIG (or DSSS PLCP header) sent with the PLCP header mode
+  double psr = CalculateChunkSuccessRate (snir, WifiPhy::GetPlcpHeaderDuration (txVector),
+                                          WifiPhy::GetPlcpHeaderMode (txVector), txVector);
+  if (preamble == WIFI_PREAMBLE_HT_MF || preamble == WIFI_PREAMBLE_HT_GF || preamble == WIFI_PREAMBLE_VHT)
+    {
+      //HT-SIG or VHT-SIG-A, (V)HT training and VHT-SIG-B sent with (V)HT modulation
+      WifiMode htHeaderMode = (preamble == WIFI_PREAMBLE_VHT)
+        ? WifiPhy::GetVhtPlcpHeaderMode (event->GetPayloadMode ())
+        : WifiPhy::GetHtPlcpHeaderMode (event->GetPayloadMode ());
+      Time htHeaderDuration = WifiPhy::GetPlcpHtSigHeaderDuration (preamble)
+        + WifiPhy::GetPlcpVhtSigA1Duration (preamble)
+        + WifiPhy::GetPlcpVhtSigA2Duration (preamble)
+        + WifiPhy::GetPlcpHtTrainingSymbolDuration (txVector)
+        + WifiPhy::GetPlcpVhtSigBDuration (preamble);
+      psr *= CalculateChunkSuccessRate (snir, htHeaderDuration, htHeaderMode, txVector);
+    }
+  return 1 - psr;
+}
+
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
-  double snr = CalculateSnr (event->GetRxPowerW (),
-                             noiseInterferenceW,
-                             event->GetTxVector ().GetChannelWidth ());
-
-  /* calculate the SNIR at the start of the packet and accumulate
-   * all SNIR changes in the snir vector.
-   */
-  double per = CalculatePlcpPayloadPer (event, &ni);
+  double per;
+  double snr;
+  if (m_fastPhy)
+    {
+      /* use the aggregate noise and interference at the start of the
+       * packet as the effective SNIR of the whole payload.
+       */
+      NS_ASSERT (m_rxing);
+      snr = CalculateSnr (event->GetRxPowerW (),
+                          m_firstPower,
+                          event->GetTxVector ().GetChannelWidth ());
+      per = CalculateEffectivePlcpPayloadPer (event, snr);
+    }
+  else
+    {
+      NiChanges ni;
+      double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+      snr = CalculateSnr (event->GetRxPowerW (),
+                          noiseInterferenceW,
+                          event->GetTxVector ().GetChannelWidth ());
+
+      /* calculate the SNIR at the start of the packet and accumulate
+       * all SNIR changes in the snir vector.
+       */
+      per = CalculatePlcpPayloadPer (event, &ni);
+    }
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -814,16 +887,29 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> e
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
-  double snr = CalculateSnr (event->GetRxPowerW (),
-                             noiseInterferenceW,
-                             event->GetTxVector ().GetChannelWidth ());
-
-  /* calculate the SNIR at the start of the plcp header and accumulate
-   * all SNIR changes in the snir vector.
-   */
-  double per = CalculatePlcpHeaderPer (event, &ni);
+  double per;
+  double snr;
+  if (m_fastPhy)
+    {
+      NS_ASSERT (m_rxing);
+      snr = CalculateSnr (event->GetRxPowerW (),
+                          m_firstPower,
+                          event->GetTxVector ().GetChannelWidth ());
+      per = CalculateEffectivePlcpHeaderPer (event, snr);
+    }
+  else
+    {
+      NiChanges ni;
+      double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+      snr = CalculateSnr (event->GetRxPowerW (),
+                          noiseInterferenceW,
+                          event->GetTxVector ().GetChannelWidth ());
+
+      /* calculate the SNIR at the start of the plcp header and accumulate
+       * all SNIR changes in the snir vector.
+       */
+      per = CalculatePlcpHeaderPer (event, &ni);
+    }
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
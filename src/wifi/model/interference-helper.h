@@ -147,6 +147,20 @@ private:
    * \param the number of RX antennas
    */
   void SetNumberOfReceiveAntennas (uint8_t rx);
+  /**
+   * Enable or disable the fast PHY abstraction. When enabled, a single
+   * effective SNIR is computed per frame from the aggregate noise and
+   * interference at the start of the frame, and the PER of each PLCP
+   * section is obtained from a single error rate model evaluation
+   * instead of being integrated over every interference change.
+   *
+   * \param enable true to enable the fast PHY abstraction
+   */
+  void SetFastPhy (bool enable);
+  /**
+   * \return true if the fast PHY abstraction is enabled, false otherwise
+   */
+  bool GetFastPhy (void) const;
 
   /**
    * \param energyW the minimum energy (W) requested
@@ -314,6 +328,26 @@ private:
    * \return the error rate of the packet
    */
   double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  /**
+   * Calculate the error rate of the plcp payload assuming the given SNIR
+   * holds for the whole payload (fast PHY abstraction).
+   *
+   * \param event
+   * \param snir the effective SINR of the frame
+   *
+   * \return the error rate of the packet
+   */
+  double CalculateEffectivePlcpPayloadPer (Ptr<const Event> event, double snir) const;
+  /**
+   * Calculate the error rate of the plcp header assuming the given SNIR
+   * holds for the whole header (fast PHY abstraction).
+   *
+   * \param event
+   * \param snir the effective SINR of the frame
+   *
+   * \return the error rate of the packet
+   */
+  double CalculateEffectivePlcpHeaderPer (Ptr<const Event> event, double snir) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
@@ -322,6 +356,7 @@ private:
   NiChanges m_niChanges;
   double m_firstPower;
   bool m_rxing;
+  bool m_fastPhy; /**< whether the fast PHY abstraction is enabled */
   /// Returns an iterator to the first nichange, which is later than moment
   NiChanges::iterator GetPosition (Time moment);
   /**
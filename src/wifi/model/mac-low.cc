@@ -784,11 +784,9 @@ MacLow::StartTransmission (Ptr<const Packet> packet,
       Ptr<Packet> aggregatedPacket = Create<Packet> ();
       for (uint32_t i = 0; i < sentMpdus; i++)
         {
-          Ptr<Packet> newPacket = (m_txPackets[GetTid(packet, *hdr)].at (i).packet)->Copy ();
-          newPacket->AddHeader (m_txPackets[GetTid(packet, *hdr)].at (i).hdr);
-          WifiMacTrailer fcs;
-          newPacket->AddTrailer (fcs);
-          listenerIt->second->GetMpduAggregator ()->Aggregate (newPacket, aggregatedPacket);
+          const Item &item = m_txPackets[GetTid(packet, *hdr)].at (i);
+          listenerIt->second->GetMpduAggregator ()->AggregateSize (item.packet->GetSize () + item.hdr.GetSize () + WIFI_MAC_FCS_LENGTH,
+                                                                   aggregatedPacket);
         }
       m_currentPacket = aggregatedPacket;
       m_currentHdr = (m_txPackets[GetTid(packet, *hdr)].at (0).hdr);
@@ -1522,6 +1520,15 @@ MacLow::NotifyCtsTimeoutResetNow ()
     }
 }
 
+void
+MacLow::NotifyRxProcessedNow ()
+{
+  for (DcfListenersCI i = m_dcfListeners.begin (); i != m_dcfListeners.end (); i++)
+    {
+      (*i)->RxProcessed ();
+    }
+}
+
 void
 MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr, WifiTxVector txVector)
 {
@@ -2673,6 +2680,7 @@ MacLow::DeaggregateAmpduAndReceive (Ptr<Packet> aggregatedPacket, double rxSnr,
     {
       ReceiveOk (aggregatedPacket, rxSnr, txVector, ampduSubframe);
     }
+  NotifyRxProcessedNow ();
 }
 
 bool
@@ -2767,14 +2775,12 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                       peekedHdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
                     }
                   currentSequenceNumber = peekedHdr.GetSequenceNumber ();
-                  newPacket->AddHeader (peekedHdr);
-                  AddWifiMacTrailer (newPacket);
-
-                  aggregated = listenerIt->second->GetMpduAggregator ()->Aggregate (newPacket, currentAggregatedPacket);
+                  uint32_t mpduSize = newPacket->GetSize () + peekedHdr.GetSize () + WIFI_MAC_FCS_LENGTH;
+                  aggregated = listenerIt->second->GetMpduAggregator ()->AggregateSize (mpduSize, currentAggregatedPacket);
 
                   if (aggregated)
                     {
-                      NS_LOG_DEBUG ("Adding packet with Sequence number " << currentSequenceNumber << " to A-MPDU, packet size = " << newPacket->GetSize () << ", A-MPDU size = " << currentAggregatedPacket->GetSize ());
+                      NS_LOG_DEBUG ("Adding packet with Sequence number " << currentSequenceNumber << " to A-MPDU, packet size = " << mpduSize << ", A-MPDU size = " << currentAggregatedPacket->GetSize ());
                       i++;
                       m_aggregateQueue[tid]->Enqueue (aggPacket, peekedHdr);
                     }
@@ -2833,12 +2839,9 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                       peekedHdr.SetQosAckPolicy (WifiMacHeader::BLOCK_ACK);
                     }
 
-                  newPacket = peekedPacket->Copy ();
-                  Ptr<Packet> aggPacket = newPacket->Copy ();
-
-                  newPacket->AddHeader (peekedHdr);
-                  AddWifiMacTrailer (newPacket);
-                  aggregated = listenerIt->second->GetMpduAggregator ()->Aggregate (newPacket, currentAggregatedPacket);
+                  Ptr<Packet> aggPacket = peekedPacket->Copy ();
+                  uint32_t mpduSize = peekedPacket->GetSize () + peekedHdr.GetSize () + WIFI_MAC_FCS_LENGTH;
+                  aggregated = listenerIt->second->GetMpduAggregator ()->AggregateSize (mpduSize, currentAggregatedPacket);
                   if (aggregated)
                     {
                       m_aggregateQueue[tid]->Enqueue (aggPacket, peekedHdr);
@@ -2853,7 +2856,7 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                               InsertInTxQueue (packet, hdr, tstamp, tid);
                             }
                         }
-                      NS_LOG_DEBUG ("Adding packet with Sequence number " << peekedHdr.GetSequenceNumber () << " to A-MPDU, packet size = " << newPacket->GetSize () << ", A-MPDU size = " << currentAggregatedPacket->GetSize ());
+                      NS_LOG_DEBUG ("Adding packet with Sequence number " << peekedHdr.GetSequenceNumber () << " to A-MPDU, packet size = " << mpduSize << ", A-MPDU size = " << currentAggregatedPacket->GetSize ());
                       i++;
                       isAmpdu = true;
                       if (!m_txParams.MustSendRts ())
@@ -2932,13 +2935,11 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                 {
                   if (hdr.IsBlockAckReq ())
                     {
-                      newPacket = packet->Copy ();
                       peekedHdr = hdr;
-                      Ptr<Packet> aggPacket = newPacket->Copy ();
+                      Ptr<Packet> aggPacket = packet->Copy ();
                       m_aggregateQueue[tid]->Enqueue (aggPacket, peekedHdr);
-                      newPacket->AddHeader (peekedHdr);
-                      AddWifiMacTrailer (newPacket);
-                      listenerIt->second->GetMpduAggregator ()->Aggregate (newPacket, currentAggregatedPacket);
+                      listenerIt->second->GetMpduAggregator ()->AggregateSize (packet->GetSize () + peekedHdr.GetSize () + WIFI_MAC_FCS_LENGTH,
+                                                                               currentAggregatedPacket);
                       currentAggregatedPacket->AddHeader (blockAckReq);
                     }
 
@@ -182,6 +182,11 @@ public:
    * Notify that CTS timeout has resetted.
    */
   virtual void CtsTimeoutReset () = 0;
+  /**
+   * Notify that a packet received successfully has been handled,
+   * after any NAV update it caused.
+   */
+  virtual void RxProcessed () = 0;
 };
 
 /**
@@ -1070,6 +1075,11 @@ private:
    * CTS timer should be resetted.
    */
   void NotifyCtsTimeoutResetNow ();
+  /**
+   * Notify DcfManager (via DcfListener) that
+   * the packet just received has been handled.
+   */
+  void NotifyRxProcessedNow ();
   /**
    * Reset NAV after CTS was missed when the NAV was
    * setted with RTS.
@@ -66,6 +66,7 @@ struct MinstrelHtWifiRemoteStation : MinstrelWifiRemoteStation
   uint32_t m_ampduPacketCount; //!< Number of A-MPDUs transmitted.
 
   McsGroupData m_groupsTable;  //!< Table of groups with stats.
+  HtRateStats m_ratesStats;    //!< Statistics of the rates of the supported groups.
   bool m_isHt;                 //!< If the station is HT capable.
 
   std::ofstream m_statsFile;   //!< File where statistics table is written.
@@ -77,15 +78,52 @@ MinstrelHtWifiRemoteStation::DisposeStation ()
   if (m_isHt)
     {
       std::vector<std::vector<uint32_t> > ().swap (m_sampleTable);
-      for (uint8_t j = 0; j < m_groupsTable.size (); j++)
-        {
-          std::vector<HtRateInfo> ().swap (m_groupsTable[j].m_ratesTable);
-        }
       std::vector<GroupInfo> ().swap (m_groupsTable);
+      m_ratesStats.Clear ();
       m_statsFile.close ();
     }
 }
 
+void
+HtRateStats::Resize (uint32_t size)
+{
+  supported.resize (size, 0);
+  mcsIndex.resize (size, 0);
+  retryUpdated.resize (size, 0);
+  retryCount.resize (size, 0);
+  numRateAttempt.resize (size, 0);
+  numRateSuccess.resize (size, 0);
+  prevNumRateAttempt.resize (size, 0);
+  prevNumRateSuccess.resize (size, 0);
+  numSamplesSkipped.resize (size, 0);
+  successHist.resize (size, 0);
+  attemptHist.resize (size, 0);
+  prob.resize (size, 0);
+  ewmaProb.resize (size, 0);
+  ewmsdProb.resize (size, 0);
+  throughput.resize (size, 0);
+}
+
+void
+HtRateStats::Clear (void)
+{
+  std::vector<uint8_t> ().swap (supported);
+  std::vector<uint8_t> ().swap (mcsIndex);
+  std::vector<uint8_t> ().swap (retryUpdated);
+  std::vector<uint32_t> ().swap (retryCount);
+  std::vector<uint32_t> ().swap (numRateAttempt);
+  std::vector<uint32_t> ().swap (numRateSuccess);
+  std::vector<uint32_t> ().swap (prevNumRateAttempt);
+  std::vector<uint32_t> ().swap (prevNumRateSuccess);
+  std::vector<uint32_t> ().swap (numSamplesSkipped);
+  std::vector<uint64_t> ().swap (successHist);
+  std::vector<uint64_t> ().swap (attemptHist);
+  std::vector<double> ().swap (prob);
+  std::vector<double> ().swap (ewmaProb);
+  std::vector<double> ().swap (ewmsdProb);
+  std::vector<double> ().swap (throughput);
+}
+
 NS_OBJECT_ENSURE_REGISTERED (MinstrelHtWifiManager);
 
 TypeId
@@ -219,6 +257,7 @@ MinstrelHtWifiManager::DoInitialize ()
        */
       NS_LOG_DEBUG ("Initialize MCS Groups:");
       m_minstrelGroups = MinstrelMcsGroups (m_numGroups);
+      m_perfectTxTimes = std::vector<Time> (m_numGroups * m_numRates);
 
       // Initialize all HT groups
       for (uint8_t chWidth = 20; chWidth <= MAX_HT_WIDTH; chWidth *= 2)
@@ -376,6 +415,15 @@ MinstrelHtWifiManager::AddFirstMpduTxTime (uint32_t groupId, WifiMode mode, Time
   NS_LOG_FUNCTION (this << groupId << mode << t);
 
   m_minstrelGroups[groupId].ratesFirstMpduTxTimeTable.push_back (std::make_pair (t, mode));
+
+  // Also index the time by rate, as it is the perfect TxTime used for the
+  // throughput estimation of that rate in every station.
+  uint32_t rateId = mode.GetMcsValue ();
+  if (mode.GetModulationClass () == WIFI_MOD_CLASS_HT)
+    {
+      rateId %= MAX_HT_GROUP_RATES;
+    }
+  m_perfectTxTimes[GetIndex (groupId, rateId)] = t;
 }
 
 Time
@@ -573,9 +621,7 @@ MinstrelHtWifiManager::DoReportDataFailed (WifiRemoteStation *st)
     {
       NS_LOG_DEBUG ("DoReportDataFailed " << station << "\t rate " << station->m_txrate << "\tlongRetry \t" << station->m_longRetry);
 
-      uint32_t rateId = GetRateId (station->m_txrate);
-      uint32_t groupId = GetGroupId (station->m_txrate);
-      station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt++; // Increment the attempts counter for the rate used.
+      station->m_ratesStats.numRateAttempt[GetStatsIndex (station, station->m_txrate)]++; // Increment the attempts counter for the rate used.
 
       UpdateRate (station);
     }
@@ -613,10 +659,9 @@ MinstrelHtWifiManager::DoReportDataOk (WifiRemoteStation *st,
     }
   else
     {
-      uint32_t rateId = GetRateId (station->m_txrate);
-      uint32_t groupId = GetGroupId (station->m_txrate);
-      station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess++;
-      station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt++;
+      uint32_t statsIndex = GetStatsIndex (station, station->m_txrate);
+      station->m_ratesStats.numRateSuccess[statsIndex]++;
+      station->m_ratesStats.numRateAttempt[statsIndex]++;
 
       UpdatePacketCounters (station, 1, 0);
 
@@ -710,10 +755,9 @@ MinstrelHtWifiManager::DoReportAmpduTxStatus (WifiRemoteStation *st, uint8_t nSu
 
   UpdatePacketCounters (station, nSuccessfulMpdus, nFailedMpdus);
 
-  uint32_t rateId = GetRateId (station->m_txrate);
-  uint32_t groupId = GetGroupId (station->m_txrate);
-  station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess += nSuccessfulMpdus;
-  station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt += nSuccessfulMpdus + nFailedMpdus;
+  uint32_t statsIndex = GetStatsIndex (station, station->m_txrate);
+  station->m_ratesStats.numRateSuccess[statsIndex] += nSuccessfulMpdus;
+  station->m_ratesStats.numRateAttempt[statsIndex] += nSuccessfulMpdus + nFailedMpdus;
 
   if (nSuccessfulMpdus == 0 && station->m_longRetry < CountRetries (station))
     {
@@ -786,24 +830,24 @@ MinstrelHtWifiManager::UpdateRate (MinstrelHtWifiRemoteStation *station)
   if (!station->m_isSampling)
     {
       /// Use best throughput rate.
-      if (station->m_longRetry <  station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].retryCount)
+      if (station->m_longRetry <  station->m_ratesStats.retryCount[GetStatsIndex (station, maxTpGroupId, maxTpRateId)])
         {
           NS_LOG_DEBUG ("Not Sampling; use the same rate again");
           station->m_txrate = station->m_maxTpRate;  //!<  There are still a few retries.
         }
 
       /// Use second best throughput rate.
-      else if (station->m_longRetry < ( station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].retryCount +
-                                        station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].retryCount))
+      else if (station->m_longRetry < ( station->m_ratesStats.retryCount[GetStatsIndex (station, maxTpGroupId, maxTpRateId)] +
+                                        station->m_ratesStats.retryCount[GetStatsIndex (station, maxTp2GroupId, maxTp2RateId)]))
         {
           NS_LOG_DEBUG ("Not Sampling; use the Max TP2");
           station->m_txrate = station->m_maxTpRate2;
         }
 
       /// Use best probability rate.
-      else if (station->m_longRetry <= ( station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].retryCount +
-                                         station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].retryCount +
-                                         station->m_groupsTable[maxProbGroupId].m_ratesTable[maxProbRateId].retryCount))
+      else if (station->m_longRetry <= ( station->m_ratesStats.retryCount[GetStatsIndex (station, maxTpGroupId, maxTpRateId)] +
+                                         station->m_ratesStats.retryCount[GetStatsIndex (station, maxTp2GroupId, maxTp2RateId)] +
+                                         station->m_ratesStats.retryCount[GetStatsIndex (station, maxProbGroupId, maxProbRateId)]))
         {
           NS_LOG_DEBUG ("Not Sampling; use Max Prob");
           station->m_txrate = station->m_maxProbRate;
@@ -819,15 +863,15 @@ MinstrelHtWifiManager::UpdateRate (MinstrelHtWifiRemoteStation *station)
     {
       /// Sample rate is used only once
       /// Use the best rate.
-      if (station->m_longRetry < 1 + station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTp2RateId].retryCount)
+      if (station->m_longRetry < 1 + station->m_ratesStats.retryCount[GetStatsIndex (station, maxTpGroupId, maxTp2RateId)])
         {
           NS_LOG_DEBUG ("Sampling use the MaxTP rate");
           station->m_txrate = station->m_maxTpRate2;
         }
 
       /// Use the best probability rate.
-      else if (station->m_longRetry <= 1 + station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTp2RateId].retryCount +
-               station->m_groupsTable[maxProbGroupId].m_ratesTable[maxProbRateId].retryCount)
+      else if (station->m_longRetry <= 1 + station->m_ratesStats.retryCount[GetStatsIndex (station, maxTpGroupId, maxTp2RateId)] +
+               station->m_ratesStats.retryCount[GetStatsIndex (station, maxProbGroupId, maxProbRateId)])
         {
           NS_LOG_DEBUG ("Sampling use the MaxProb rate");
           station->m_txrate = station->m_maxProbRate;
@@ -910,7 +954,7 @@ MinstrelHtWifiManager::DoGetDataTxVector (WifiRemoteStation *st)
 
       uint32_t rateId = GetRateId (station->m_txrate);
       uint32_t groupId = GetGroupId (station->m_txrate);
-      uint32_t mcsIndex = station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex;
+      uint32_t mcsIndex = station->m_ratesStats.mcsIndex[GetStatsIndex (station, groupId, rateId)];
 
       NS_LOG_DEBUG ("DoGetDataMode rateId= " << rateId << " groupId= " << groupId << " mode= " << GetMcsSupported (station, mcsIndex));
 
@@ -969,7 +1013,7 @@ MinstrelHtWifiManager::DoGetRtsTxVector (WifiRemoteStation *st)
       // As we are in Minstrel HT, assume the last rate was an HT rate.
       uint32_t rateId = GetRateId (station->m_txrate);
       uint32_t groupId = GetGroupId (station->m_txrate);
-      uint32_t mcsIndex = station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex;
+      uint32_t mcsIndex = station->m_ratesStats.mcsIndex[GetStatsIndex (station, groupId, rateId)];
 
       WifiMode lastRate = GetMcsSupported (station, mcsIndex);
       uint64_t lastDataRate = lastRate.GetNonHtReferenceRate ();
@@ -1058,14 +1102,14 @@ MinstrelHtWifiManager::CountRetries (MinstrelHtWifiRemoteStation *station)
 
   if (!station->m_isSampling)
     {
-      return station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].retryCount +
-             station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].retryCount +
-             station->m_groupsTable[maxProbGroupId].m_ratesTable[maxProbRateId].retryCount;
+      return station->m_ratesStats.retryCount[GetStatsIndex (station, maxTpGroupId, maxTpRateId)] +
+             station->m_ratesStats.retryCount[GetStatsIndex (station, maxTp2GroupId, maxTp2RateId)] +
+             station->m_ratesStats.retryCount[GetStatsIndex (station, maxProbGroupId, maxProbRateId)];
     }
   else
     {
-      return 1 + station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTp2RateId].retryCount +
-             station->m_groupsTable[maxProbGroupId].m_ratesTable[maxProbRateId].retryCount;
+      return 1 + station->m_ratesStats.retryCount[GetStatsIndex (station, maxTpGroupId, maxTp2RateId)] +
+             station->m_ratesStats.retryCount[GetStatsIndex (station, maxProbGroupId, maxProbRateId)];
     }
 }
 
@@ -1152,7 +1196,7 @@ MinstrelHtWifiManager::FindRate (MinstrelHtWifiRemoteStation *station)
       uint32_t sampleRateId = GetRateId (sampleIdx);
 
       // If the rate selected is not supported, then don't sample.
-      if (station->m_groupsTable[sampleGroupId].m_supported && station->m_groupsTable[sampleGroupId].m_ratesTable[sampleRateId].supported)
+      if (station->m_groupsTable[sampleGroupId].m_supported && station->m_ratesStats.supported[GetStatsIndex (station, sampleGroupId, sampleRateId)])
         {
           /**
            * Sampling might add some overhead to the frame.
@@ -1161,13 +1205,13 @@ MinstrelHtWifiManager::FindRate (MinstrelHtWifiRemoteStation *station)
            * Also do not sample if the probability is already higher than 95%
            * to avoid wasting airtime.
            */
-          HtRateInfo sampleRateInfo = station->m_groupsTable[sampleGroupId].m_ratesTable[sampleRateId];
+          uint32_t sampleStatsIndex = GetStatsIndex (station, sampleGroupId, sampleRateId);
 
           NS_LOG_DEBUG ("Use sample rate? MaxTpRate= " << station->m_maxTpRate << " CurrentRate= " << station->m_txrate <<
-                        " SampleRate= " << sampleIdx << " SampleProb= " << sampleRateInfo.ewmaProb);
+                        " SampleRate= " << sampleIdx << " SampleProb= " << station->m_ratesStats.ewmaProb[sampleStatsIndex]);
 
           if (sampleIdx != station->m_maxTpRate && sampleIdx != station->m_maxTpRate2
-              && sampleIdx != station->m_maxProbRate && sampleRateInfo.ewmaProb <= 95)
+              && sampleIdx != station->m_maxProbRate && station->m_ratesStats.ewmaProb[sampleStatsIndex] <= 95)
             {
 
               /**
@@ -1176,17 +1220,13 @@ MinstrelHtWifiManager::FindRate (MinstrelHtWifiRemoteStation *station)
                */
 
               uint32_t maxTpGroupId = GetGroupId (station->m_maxTpRate);
-              uint32_t maxTp2GroupId = GetGroupId (station->m_maxTpRate2);
-              uint32_t maxTp2RateId = GetRateId (station->m_maxTpRate2);
-              uint32_t maxProbGroupId = GetGroupId (station->m_maxProbRate);
-              uint32_t maxProbRateId = GetRateId (station->m_maxProbRate);
 
               uint8_t maxTpStreams = m_minstrelGroups[maxTpGroupId].streams;
               uint8_t sampleStreams = m_minstrelGroups[sampleGroupId].streams;
 
-              Time sampleDuration = sampleRateInfo.perfectTxTime;
-              Time maxTp2Duration = station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].perfectTxTime;
-              Time maxProbDuration = station->m_groupsTable[maxProbGroupId].m_ratesTable[maxProbRateId].perfectTxTime;
+              Time sampleDuration = m_perfectTxTimes[sampleIdx];
+              Time maxTp2Duration = m_perfectTxTimes[station->m_maxTpRate2];
+              Time maxProbDuration = m_perfectTxTimes[station->m_maxProbRate];
 
               NS_LOG_DEBUG ("Use sample rate? SampleDuration= " << sampleDuration << " maxTp2Duration= " << maxTp2Duration <<
                             " maxProbDuration= " << maxProbDuration << " sampleStreams= " << (uint16_t)sampleStreams <<
@@ -1206,7 +1246,7 @@ MinstrelHtWifiManager::FindRate (MinstrelHtWifiRemoteStation *station)
               else
                 {
                   station->m_numSamplesSlow++;
-                  if (sampleRateInfo.numSamplesSkipped >= 20 && station->m_numSamplesSlow <= 2)
+                  if (station->m_ratesStats.numSamplesSkipped[sampleStatsIndex] >= 20 && station->m_numSamplesSlow <= 2)
                     {
                       /// Set flag that we are currently sampling.
                       station->m_isSampling = true;
@@ -1244,8 +1284,6 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
   station->m_numSamplesSlow = 0;
   station->m_sampleCount = 0;
 
-  double tempProb;
-
   if (station->m_ampduPacketCount > 0)
     {
       double newLen = station->m_ampduLen / station->m_ampduPacketCount;
@@ -1254,11 +1292,6 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
       station->m_ampduPacketCount = 0;
     }
 
-  /* Initialize global rate indexes */
-  station->m_maxTpRate = GetLowestIndex (station);
-  station->m_maxTpRate2 = GetLowestIndex (station);
-  station->m_maxProbRate = GetLowestIndex (station);
-
   /// Update throughput and EWMA for each rate inside each group.
   for (uint32_t j = 0; j < m_numGroups; j++)
     {
@@ -1266,70 +1299,54 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
         {
           station->m_sampleCount++;
 
-          /* (re)Initialize group rate indexes */
-          station->m_groupsTable[j].m_maxTpRate = GetLowestIndex (station, j);
-          station->m_groupsTable[j].m_maxTpRate2 = GetLowestIndex (station, j);
-          station->m_groupsTable[j].m_maxProbRate = GetLowestIndex (station, j);
-
-          for (uint32_t i = 0; i < m_numRates; i++)
+          /**
+           * The best rates of a group only depend on the statistics of the
+           * group, so they only need to be searched again if a rate of the
+           * group has been attempted since the last update.
+           */
+          if (UpdateGroupStats (station, j))
             {
-              if (station->m_groupsTable[j].m_ratesTable[i].supported)
-                {
-                  station->m_groupsTable[j].m_ratesTable[i].retryUpdated = false;
-
-                  NS_LOG_DEBUG (i << " " << GetMcsSupported (station,  station->m_groupsTable[j].m_ratesTable[i].mcsIndex) <<
-                                "\t attempt=" << station->m_groupsTable[j].m_ratesTable[i].numRateAttempt <<
-                                "\t success=" << station->m_groupsTable[j].m_ratesTable[i].numRateSuccess);
-
-                  /// If we've attempted something.
-                  if (station->m_groupsTable[j].m_ratesTable[i].numRateAttempt > 0)
-                    {
-                      station->m_groupsTable[j].m_ratesTable[i].numSamplesSkipped = 0;
-                      /**
-                       * Calculate the probability of success.
-                       * Assume probability scales from 0 to 100.
-                       */
-                      tempProb = (100 * station->m_groupsTable[j].m_ratesTable[i].numRateSuccess) / station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
-
-                      /// Bookeeping.
-                      station->m_groupsTable[j].m_ratesTable[i].prob = tempProb;
+              GroupInfo *group = &station->m_groupsTable[j];
 
-                      if (station->m_groupsTable[j].m_ratesTable[i].successHist == 0)
-                        {
-                          station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
-                        }
-                      else
-                        {
-                          station->m_groupsTable[j].m_ratesTable[i].ewmsdProb = CalculateEwmsd (station->m_groupsTable[j].m_ratesTable[i].ewmsdProb,
-                                                                                                tempProb, station->m_groupsTable[j].m_ratesTable[i].ewmaProb,
-                                                                                                m_ewmaLevel);
-                          /// EWMA probability
-                          tempProb = (tempProb * (100 - m_ewmaLevel) + station->m_groupsTable[j].m_ratesTable[i].ewmaProb * m_ewmaLevel)  / 100;
-                          station->m_groupsTable[j].m_ratesTable[i].ewmaProb = tempProb;
-                        }
-
-                      station->m_groupsTable[j].m_ratesTable[i].throughput = CalculateThroughput (station, j, i, tempProb);
+              /* (re)Initialize group rate indexes */
+              group->m_maxTpRate = GetLowestIndex (station, j);
+              group->m_maxTpRate2 = group->m_maxTpRate;
+              group->m_maxProbRate = group->m_maxTpRate;
 
-                      station->m_groupsTable[j].m_ratesTable[i].successHist += station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                      station->m_groupsTable[j].m_ratesTable[i].attemptHist += station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
-                    }
-                  else
+              for (uint32_t i = 0; i < m_numRates; i++)
+                {
+                  uint32_t s = group->m_offset + i;
+                  if (station->m_ratesStats.supported[s] && station->m_ratesStats.throughput[s] != 0)
                     {
-                      station->m_groupsTable[j].m_ratesTable[i].numSamplesSkipped++;
+                      SetBestGroupThRates (station, GetIndex (j, i));
+                      SetBestGroupProbabilityRate (station, GetIndex (j, i));
                     }
+                }
+            }
+        }
+    }
 
-                  /// Bookeeping.
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateSuccess = station->m_groupsTable[j].m_ratesTable[i].numRateSuccess;
-                  station->m_groupsTable[j].m_ratesTable[i].prevNumRateAttempt = station->m_groupsTable[j].m_ratesTable[i].numRateAttempt;
-                  station->m_groupsTable[j].m_ratesTable[i].numRateSuccess = 0;
-                  station->m_groupsTable[j].m_ratesTable[i].numRateAttempt = 0;
-
-                  if (station->m_groupsTable[j].m_ratesTable[i].throughput != 0)
-                    {
-                      SetBestStationThRates (station, GetIndex (j, i));
-                      SetBestProbabilityRate (station, GetIndex (j, i));
-                    }
+  /* Initialize global rate indexes */
+  station->m_maxTpRate = GetLowestIndex (station);
+  station->m_maxTpRate2 = GetLowestIndex (station);
+  station->m_maxProbRate = GetLowestIndex (station);
 
+  /**
+   * The choice of the max probability rate depends on the order in which
+   * the rates are evaluated, so the best rates of the station are always
+   * searched over all the rates, in increasing index order.
+   */
+  for (uint32_t j = 0; j < m_numGroups; j++)
+    {
+      if (station->m_groupsTable[j].m_supported)
+        {
+          for (uint32_t i = 0; i < m_numRates; i++)
+            {
+              uint32_t s = station->m_groupsTable[j].m_offset + i;
+              if (station->m_ratesStats.supported[s] && station->m_ratesStats.throughput[s] != 0)
+                {
+                  SetBestStationThRates (station, GetIndex (j, i));
+                  SetBestProbabilityRate (station, GetIndex (j, i));
                 }
             }
         }
@@ -1350,6 +1367,77 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
     }
 }
 
+bool
+MinstrelHtWifiManager::UpdateGroupStats (MinstrelHtWifiRemoteStation *station, uint32_t groupId)
+{
+  NS_LOG_FUNCTION (this << station << groupId);
+
+  HtRateStats &stats = station->m_ratesStats;
+  uint32_t begin = station->m_groupsTable[groupId].m_offset;
+  uint32_t end = begin + m_numRates;
+  bool attempted = false;
+  double tempProb;
+
+  for (uint32_t s = begin; s < end; s++)
+    {
+      /// If we've attempted something.
+      if (stats.numRateAttempt[s] > 0)
+        {
+          attempted = true;
+
+          NS_LOG_DEBUG (s - begin << " " << GetMcsSupported (station, stats.mcsIndex[s]) <<
+                        "\t attempt=" << stats.numRateAttempt[s] <<
+                        "\t success=" << stats.numRateSuccess[s]);
+
+          stats.numSamplesSkipped[s] = 0;
+          /**
+           * Calculate the probability of success.
+           * Assume probability scales from 0 to 100.
+           */
+          tempProb = (100 * stats.numRateSuccess[s]) / stats.numRateAttempt[s];
+
+          /// Bookeeping.
+          stats.prob[s] = tempProb;
+
+          if (stats.successHist[s] == 0)
+            {
+              stats.ewmaProb[s] = tempProb;
+            }
+          else
+            {
+              stats.ewmsdProb[s] = CalculateEwmsd (stats.ewmsdProb[s], tempProb, stats.ewmaProb[s], m_ewmaLevel);
+              /// EWMA probability
+              tempProb = (tempProb * (100 - m_ewmaLevel) + stats.ewmaProb[s] * m_ewmaLevel)  / 100;
+              stats.ewmaProb[s] = tempProb;
+            }
+
+          stats.throughput[s] = CalculateThroughput (station, groupId, s - begin, tempProb);
+
+          stats.successHist[s] += stats.numRateSuccess[s];
+          stats.attemptHist[s] += stats.numRateAttempt[s];
+        }
+      else
+        {
+          stats.numSamplesSkipped[s]++;
+        }
+    }
+
+  /**
+   * Bookeeping. Unsupported rates are never attempted, so the counters can
+   * be reset over the whole group at once.
+   */
+  for (uint32_t s = begin; s < end; s++)
+    {
+      stats.retryUpdated[s] = 0;
+      stats.prevNumRateSuccess[s] = stats.numRateSuccess[s];
+      stats.prevNumRateAttempt[s] = stats.numRateAttempt[s];
+      stats.numRateSuccess[s] = 0;
+      stats.numRateAttempt[s] = 0;
+    }
+
+  return attempted;
+}
+
 double
 MinstrelHtWifiManager::CalculateThroughput (MinstrelHtWifiRemoteStation *station, uint32_t groupId, uint32_t rateId, double ewmaProb)
 {
@@ -1368,7 +1456,7 @@ MinstrelHtWifiManager::CalculateThroughput (MinstrelHtWifiRemoteStation *station
        * For the throughput calculation, limit the probability value to 90% to
        * account for collision related packet error rate fluctuation.
        */
-      Time txTime =  station->m_groupsTable[groupId].m_ratesTable[rateId].perfectTxTime;
+      Time txTime = m_perfectTxTimes[GetIndex (groupId, rateId)];
       if (ewmaProb > 90)
         {
           return 90 / txTime.GetSeconds ();
@@ -1383,51 +1471,45 @@ MinstrelHtWifiManager::CalculateThroughput (MinstrelHtWifiRemoteStation *station
 void
 MinstrelHtWifiManager::SetBestProbabilityRate (MinstrelHtWifiRemoteStation *station, uint32_t index)
 {
-  GroupInfo *group;
-  HtRateInfo rate;
-  uint32_t tmpGroupId, tmpRateId;
-  double tmpTh, tmpProb;
-  uint32_t groupId, rateId;
-  double currentTh;
-  // maximum group probability (GP) variables
-  uint32_t maxGPGroupId, maxGPRateId;
-  double maxGPTh;
-
-  groupId = GetGroupId (index);
-  rateId = GetRateId (index);
-  group = &station->m_groupsTable[groupId];
-  rate = group->m_ratesTable[rateId];
-
-  tmpGroupId = GetGroupId (station->m_maxProbRate);
-  tmpRateId = GetRateId (station->m_maxProbRate);
-  tmpProb = station->m_groupsTable[tmpGroupId].m_ratesTable[tmpRateId].ewmaProb;
-  tmpTh =  station->m_groupsTable[tmpGroupId].m_ratesTable[tmpRateId].throughput;
-
-  if (rate.ewmaProb > 75)
-    {
-      currentTh = station->m_groupsTable[groupId].m_ratesTable[rateId].throughput;
-      if (currentTh > tmpTh)
+  const HtRateStats &stats = station->m_ratesStats;
+  uint32_t s = GetStatsIndex (station, index);
+  uint32_t maxProb = GetStatsIndex (station, station->m_maxProbRate);
+
+  if (stats.ewmaProb[s] > 75)
+    {
+      if (stats.throughput[s] > stats.throughput[maxProb])
         {
           station->m_maxProbRate = index;
         }
+    }
+  else
+    {
+      if (stats.ewmaProb[s] > stats.ewmaProb[maxProb])
+        {
+          station->m_maxProbRate = index;
+        }
+    }
+}
 
-      maxGPGroupId = GetGroupId (group->m_maxProbRate);
-      maxGPRateId = GetRateId (group->m_maxProbRate);
-      maxGPTh = station->m_groupsTable[maxGPGroupId].m_ratesTable[maxGPRateId].throughput;
+void
+MinstrelHtWifiManager::SetBestGroupProbabilityRate (MinstrelHtWifiRemoteStation *station, uint32_t index)
+{
+  const HtRateStats &stats = station->m_ratesStats;
+  GroupInfo *group = &station->m_groupsTable[GetGroupId (index)];
+  uint32_t s = GetStatsIndex (station, index);
+  // maximum group probability (GP)
+  uint32_t maxGP = GetStatsIndex (station, group->m_maxProbRate);
 
-      if (currentTh > maxGPTh)
+  if (stats.ewmaProb[s] > 75)
+    {
+      if (stats.throughput[s] > stats.throughput[maxGP])
         {
           group->m_maxProbRate = index;
         }
     }
   else
     {
-      if (rate.ewmaProb > tmpProb)
-        {
-          station->m_maxProbRate = index;
-        }
-      maxGPRateId = GetRateId (group->m_maxProbRate);
-      if (rate.ewmaProb > group->m_ratesTable[maxGPRateId].ewmaProb)
+      if (stats.ewmaProb[s] > stats.ewmaProb[maxGP])
         {
           group->m_maxProbRate = index;
         }
@@ -1444,57 +1526,41 @@ MinstrelHtWifiManager::SetBestProbabilityRate (MinstrelHtWifiRemoteStation *stat
 void
 MinstrelHtWifiManager::SetBestStationThRates (MinstrelHtWifiRemoteStation *station, uint32_t index)
 {
-  uint32_t groupId, rateId;
-  double th, prob;
-  uint32_t maxTpGroupId, maxTpRateId;
-  uint32_t maxTp2GroupId, maxTp2RateId;
-  double maxTpTh, maxTpProb;
-  double maxTp2Th, maxTp2Prob;
-
-  groupId = GetGroupId (index);
-  rateId = GetRateId (index);
-  prob = station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb;
-  th = station->m_groupsTable[groupId].m_ratesTable[rateId].throughput;
+  const HtRateStats &stats = station->m_ratesStats;
+  uint32_t s = GetStatsIndex (station, index);
+  uint32_t maxTp = GetStatsIndex (station, station->m_maxTpRate);
+  uint32_t maxTp2 = GetStatsIndex (station, station->m_maxTpRate2);
+  double th = stats.throughput[s];
+  double prob = stats.ewmaProb[s];
 
-  maxTpGroupId = GetGroupId (station->m_maxTpRate);
-  maxTpRateId = GetRateId (station->m_maxTpRate);
-  maxTpProb = station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].ewmaProb;
-  maxTpTh = station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].throughput;
-
-  maxTp2GroupId = GetGroupId (station->m_maxTpRate2);
-  maxTp2RateId = GetRateId (station->m_maxTpRate2);
-  maxTp2Prob = station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].ewmaProb;
-  maxTp2Th = station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].throughput;
-
-  if (th > maxTpTh || (th == maxTpTh && prob > maxTpProb))
+  if (th > stats.throughput[maxTp] || (th == stats.throughput[maxTp] && prob > stats.ewmaProb[maxTp]))
     {
       station->m_maxTpRate2 = station->m_maxTpRate;
       station->m_maxTpRate = index;
     }
-  else if (th > maxTp2Th || (th == maxTp2Th && prob > maxTp2Prob))
+  else if (th > stats.throughput[maxTp2] || (th == stats.throughput[maxTp2] && prob > stats.ewmaProb[maxTp2]))
     {
       station->m_maxTpRate2 = index;
     }
+}
 
-  //Find best rates per group
-
-  GroupInfo *group = &station->m_groupsTable[groupId];
-  maxTpGroupId = GetGroupId (group->m_maxTpRate);
-  maxTpRateId = GetRateId (group->m_maxTpRate);
-  maxTpProb = group->m_ratesTable[maxTpRateId].ewmaProb;
-  maxTpTh = station->m_groupsTable[maxTpGroupId].m_ratesTable[maxTpRateId].throughput;
-
-  maxTp2GroupId = GetGroupId (group->m_maxTpRate2);
-  maxTp2RateId = GetRateId (group->m_maxTpRate2);
-  maxTp2Prob = group->m_ratesTable[maxTp2RateId].ewmaProb;
-  maxTp2Th = station->m_groupsTable[maxTp2GroupId].m_ratesTable[maxTp2RateId].throughput;
+void
+MinstrelHtWifiManager::SetBestGroupThRates (MinstrelHtWifiRemoteStation *station, uint32_t index)
+{
+  const HtRateStats &stats = station->m_ratesStats;
+  GroupInfo *group = &station->m_groupsTable[GetGroupId (index)];
+  uint32_t s = GetStatsIndex (station, index);
+  uint32_t maxTp = GetStatsIndex (station, group->m_maxTpRate);
+  uint32_t maxTp2 = GetStatsIndex (station, group->m_maxTpRate2);
+  double th = stats.throughput[s];
+  double prob = stats.ewmaProb[s];
 
-  if (th > maxTpTh || (th == maxTpTh && prob > maxTpProb))
+  if (th > stats.throughput[maxTp] || (th == stats.throughput[maxTp] && prob > stats.ewmaProb[maxTp]))
     {
       group->m_maxTpRate2 = group->m_maxTpRate;
       group->m_maxTpRate = index;
     }
-  else if (th > maxTp2Th || (th == maxTp2Th && prob > maxTp2Prob))
+  else if (th > stats.throughput[maxTp2] || (th == stats.throughput[maxTp2] && prob > stats.ewmaProb[maxTp2]))
     {
       group->m_maxTpRate2 = index;
     }
@@ -1507,6 +1573,8 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
   NS_LOG_DEBUG ("RateInit=" << station);
 
   station->m_groupsTable = McsGroupData (m_numGroups);
+  station->m_ratesStats.Clear ();
+  uint32_t nRates = 0;
 
   /**
   * Initialize groups supported by the receiver.
@@ -1530,11 +1598,9 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
               station->m_groupsTable[groupId].m_col = 0;
               station->m_groupsTable[groupId].m_index = 0;
 
-              station->m_groupsTable[groupId].m_ratesTable = HtMinstrelRate (m_numRates);        ///Create the rate list for the group.
-              for (uint32_t i = 0; i < m_numRates; i++)
-                {
-                  station->m_groupsTable[groupId].m_ratesTable[i].supported = false;
-                }
+              station->m_groupsTable[groupId].m_offset = nRates;                                 ///Append the rates of the group to the statistics.
+              nRates += m_numRates;
+              station->m_ratesStats.Resize (nRates);
 
               // Initialize all modes supported by the remote station that belong to the current group.
               for (uint32_t i = 0; i < station->m_nModes; i++)
@@ -1557,24 +1623,16 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
                     {
                       NS_LOG_DEBUG ("Mode " << i << ": " << mode << " isVht: " << m_minstrelGroups[groupId].isVht);
 
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].supported = true;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex = i;         ///Mapping between rateId and operationalMcsSet
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].prob = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateAttempt = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateSuccess = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].numSamplesSkipped = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].successHist = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].attemptHist = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].throughput = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].perfectTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, i));
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 0;
-                      station->m_groupsTable[groupId].m_ratesTable[rateId].adjustedRetryCount = 0;
+                      uint32_t statsIndex = GetStatsIndex (station, groupId, rateId);
+                      station->m_ratesStats.supported[statsIndex] = 1;
+                      station->m_ratesStats.mcsIndex[statsIndex] = i;         ///Mapping between rateId and operationalMcsSet
                       CalculateRetransmits (station, groupId, rateId);
                     }
                 }
+
+              station->m_groupsTable[groupId].m_maxTpRate = GetLowestIndex (station, groupId);
+              station->m_groupsTable[groupId].m_maxTpRate2 = station->m_groupsTable[groupId].m_maxTpRate;
+              station->m_groupsTable[groupId].m_maxProbRate = station->m_groupsTable[groupId].m_maxTpRate;
             }
         }
     }
@@ -1589,7 +1647,7 @@ MinstrelHtWifiManager::CalculateRetransmits (MinstrelHtWifiRemoteStation *statio
   NS_LOG_FUNCTION (this << station << index);
   uint32_t groupId = GetGroupId (index);
   uint32_t rateId = GetRateId (index);
-  if (!station->m_groupsTable[groupId].m_ratesTable[rateId].retryUpdated)
+  if (!station->m_ratesStats.retryUpdated[GetStatsIndex (station, index)])
     {
       CalculateRetransmits (station, groupId, rateId);
     }
@@ -1606,18 +1664,19 @@ MinstrelHtWifiManager::CalculateRetransmits (MinstrelHtWifiRemoteStation *statio
   Time cwTime, txTime, dataTxTime;
   Time slotTime = GetMac ()->GetSlot ();
   Time ackTime = GetMac ()->GetBasicBlockAckTimeout ();
+  uint32_t statsIndex = GetStatsIndex (station, groupId, rateId);
 
-  if (station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb < 1)
+  if (station->m_ratesStats.ewmaProb[statsIndex] < 1)
     {
-      station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 1;
+      station->m_ratesStats.retryCount[statsIndex] = 1;
     }
   else
     {
-      station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 2;
-      station->m_groupsTable[groupId].m_ratesTable[rateId].retryUpdated = true;
+      station->m_ratesStats.retryCount[statsIndex] = 2;
+      station->m_ratesStats.retryUpdated[statsIndex] = 1;
 
-      dataTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex)) +
-        GetMpduTxTime (groupId, GetMcsSupported (station, station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex)) * (station->m_avgAmpduLen - 1);
+      dataTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, station->m_ratesStats.mcsIndex[statsIndex])) +
+        GetMpduTxTime (groupId, GetMcsSupported (station, station->m_ratesStats.mcsIndex[statsIndex])) * (station->m_avgAmpduLen - 1);
 
       /* Contention time for first 2 tries */
       cwTime = (cw / 2) * slotTime;
@@ -1639,7 +1698,7 @@ MinstrelHtWifiManager::CalculateRetransmits (MinstrelHtWifiRemoteStation *statio
           txTime += cwTime + ackTime + dataTxTime;
         }
       while ((txTime < MilliSeconds (6))
-             && (++station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount < 7));
+             && (++station->m_ratesStats.retryCount[statsIndex] < 7));
     }
 }
 
@@ -1727,8 +1786,10 @@ MinstrelHtWifiManager::StatsDump (MinstrelHtWifiRemoteStation *station, uint32_t
     }
   for (uint32_t i = 0; i < numRates; i++)
     {
-      if (station->m_groupsTable[groupId].m_supported && station->m_groupsTable[groupId].m_ratesTable[i].supported)
+      if (station->m_groupsTable[groupId].m_supported && station->m_ratesStats.supported[GetStatsIndex (station, groupId, i)])
         {
+          uint32_t statsIndex = GetStatsIndex (station, groupId, i);
+
           if (!group.isVht)
             {
               of << "HT" << group.chWidth << "   " << giMode << "GI  " << (int)group.streams << "   ";
@@ -1780,19 +1841,19 @@ MinstrelHtWifiManager::StatsDump (MinstrelHtWifiRemoteStation *station, uint32_t
           of << "  " << std::setw (3) << idx << "  ";
 
           /* tx_time[rate(i)] in usec */
-          txTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, station->m_groupsTable[groupId].m_ratesTable[i].mcsIndex));
+          txTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, station->m_ratesStats.mcsIndex[statsIndex]));
           of << std::setw (6) << txTime.GetMicroSeconds () << "  ";
 
           of << std::setw (7) << CalculateThroughput (station, groupId, i, 100) / 100 << "   " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].throughput / 100 << "   " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].ewmaProb << "  " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].ewmsdProb << "  " <<
-            std::setw (7) << station->m_groupsTable[groupId].m_ratesTable[i].prob << "  " <<
-            std::setw (2) << station->m_groupsTable[groupId].m_ratesTable[i].retryCount << "   " <<
-            std::setw (3) << station->m_groupsTable[groupId].m_ratesTable[i].prevNumRateSuccess << "  " <<
-            std::setw (3) << station->m_groupsTable[groupId].m_ratesTable[i].prevNumRateAttempt << "   " <<
-            std::setw (9) << station->m_groupsTable[groupId].m_ratesTable[i].successHist << "   " <<
-            std::setw (9) << station->m_groupsTable[groupId].m_ratesTable[i].attemptHist << "\n";
+            std::setw (7) << station->m_ratesStats.throughput[statsIndex] / 100 << "   " <<
+            std::setw (7) << station->m_ratesStats.ewmaProb[statsIndex] << "  " <<
+            std::setw (7) << station->m_ratesStats.ewmsdProb[statsIndex] << "  " <<
+            std::setw (7) << station->m_ratesStats.prob[statsIndex] << "  " <<
+            std::setw (2) << station->m_ratesStats.retryCount[statsIndex] << "   " <<
+            std::setw (3) << station->m_ratesStats.prevNumRateSuccess[statsIndex] << "  " <<
+            std::setw (3) << station->m_ratesStats.prevNumRateAttempt[statsIndex] << "   " <<
+            std::setw (9) << station->m_ratesStats.successHist[statsIndex] << "   " <<
+            std::setw (9) << station->m_ratesStats.attemptHist[statsIndex] << "\n";
         }
     }
 }
@@ -1805,6 +1866,18 @@ MinstrelHtWifiManager::GetIndex (uint32_t groupId, uint32_t rateId)
   return index;
 }
 
+uint32_t
+MinstrelHtWifiManager::GetStatsIndex (MinstrelHtWifiRemoteStation *station, uint32_t groupId, uint32_t rateId) const
+{
+  return station->m_groupsTable[groupId].m_offset + rateId;
+}
+
+uint32_t
+MinstrelHtWifiManager::GetStatsIndex (MinstrelHtWifiRemoteStation *station, uint32_t index) const
+{
+  return GetStatsIndex (station, index / m_numRates, index % m_numRates);
+}
+
 uint32_t
 MinstrelHtWifiManager::GetRateId (uint32_t index)
 {
@@ -1850,11 +1923,11 @@ MinstrelHtWifiManager::GetLowestIndex (MinstrelHtWifiRemoteStation *station)
     {
       groupId++;
     }
-  while (rateId < m_numRates && !station->m_groupsTable[groupId].m_ratesTable[rateId].supported)
+  while (rateId < m_numRates && !station->m_ratesStats.supported[GetStatsIndex (station, groupId, rateId)])
     {
       rateId++;
     }
-  NS_ASSERT (station->m_groupsTable[groupId].m_supported && station->m_groupsTable[groupId].m_ratesTable[rateId].supported);
+  NS_ASSERT (station->m_groupsTable[groupId].m_supported && station->m_ratesStats.supported[GetStatsIndex (station, groupId, rateId)]);
   return GetIndex (groupId, rateId);
 }
 
@@ -1864,11 +1937,11 @@ MinstrelHtWifiManager::GetLowestIndex (MinstrelHtWifiRemoteStation *station, uin
   NS_LOG_FUNCTION (this << station);
 
   uint32_t rateId = 0;
-  while (rateId < m_numRates && !station->m_groupsTable[groupId].m_ratesTable[rateId].supported)
+  while (rateId < m_numRates && !station->m_ratesStats.supported[GetStatsIndex (station, groupId, rateId)])
     {
       rateId++;
     }
-  NS_ASSERT (station->m_groupsTable[groupId].m_supported && station->m_groupsTable[groupId].m_ratesTable[rateId].supported);
+  NS_ASSERT (station->m_groupsTable[groupId].m_supported && station->m_ratesStats.supported[GetStatsIndex (station, groupId, rateId)]);
   return GetIndex (groupId, rateId);
 }
 
@@ -65,51 +65,52 @@ typedef std::vector<McsGroup> MinstrelMcsGroups;
 
 struct MinstrelHtWifiRemoteStation;
 /**
- * A struct to contain all statistics information related to a data rate.
+ * A struct to contain all statistics information related to the data rates
+ * of a station.
+ *
+ * The statistics are kept as a structure of arrays, so that the periodic
+ * update of a group walks contiguous memory and no per-group allocation is
+ * needed. Only the groups supported by the station are given storage: the
+ * statistics of the rate rateId of such a group are at position
+ * GroupInfo::m_offset + rateId of every array.
  */
-struct HtRateInfo
+struct HtRateStats
 {
-  /**
-   * Perfect transmission time calculation, or frame calculation.
-   * Given a bit rate and a packet length n bytes.
-   */
-  Time perfectTxTime;
-
-  bool supported;               //!< If the rate is supported.
-
-  uint32_t mcsIndex;            //!< The index in the operationalMcsSet of the WifiRemoteStationManager.
-
-  uint32_t retryCount;          //!< Retry limit.
-  uint32_t adjustedRetryCount;  //!< Adjust the retry limit for this rate.
-  uint32_t numRateAttempt;      //!< Number of transmission attempts so far.
-  uint32_t numRateSuccess;      //!< Number of successful frames transmitted so far.
-  double prob;                  //!< Current probability within last time interval. (# frame success )/(# total frames)
-
-  bool retryUpdated;            //!< If number of retries was updated already.
-
+  std::vector<uint8_t> supported;           //!< If the rate is supported.
+  std::vector<uint8_t> mcsIndex;            //!< The index in the operationalMcsSet of the WifiRemoteStationManager.
+  std::vector<uint8_t> retryUpdated;        //!< If number of retries was updated already.
+
+  std::vector<uint32_t> retryCount;         //!< Retry limit.
+  std::vector<uint32_t> numRateAttempt;     //!< Number of transmission attempts so far.
+  std::vector<uint32_t> numRateSuccess;     //!< Number of successful frames transmitted so far.
+  std::vector<uint32_t> prevNumRateAttempt; //!< Number of transmission attempts with previous rate.
+  std::vector<uint32_t> prevNumRateSuccess; //!< Number of successful frames transmitted with previous rate.
+  std::vector<uint32_t> numSamplesSkipped;  //!< Number of times this rate statistics were not updated because no attempts have been made.
+  std::vector<uint64_t> successHist;        //!< Aggregate of all transmission successes.
+  std::vector<uint64_t> attemptHist;        //!< Aggregate of all transmission attempts.
+
+  std::vector<double> prob;                 //!< Current probability within last time interval. (# frame success )/(# total frames)
   /**
    * Exponential weighted moving average of probability.
    * EWMA calculation:
    * ewma_prob =[prob *(100 - ewma_level) + (ewma_prob_old * ewma_level)]/100
    */
-  double ewmaProb;
-
-  double ewmsdProb;             //!< Exponential weighted moving standard deviation of probability.
+  std::vector<double> ewmaProb;
+  std::vector<double> ewmsdProb;            //!< Exponential weighted moving standard deviation of probability.
+  std::vector<double> throughput;           //!< Throughput of this rate (in pkts per second).
 
-  uint32_t prevNumRateAttempt;  //!< Number of transmission attempts with previous rate.
-  uint32_t prevNumRateSuccess;  //!< Number of successful frames transmitted with previous rate.
-  uint32_t numSamplesSkipped;   //!< Number of times this rate statistics were not updated because no attempts have been made.
-  uint64_t successHist;         //!< Aggregate of all transmission successes.
-  uint64_t attemptHist;         //!< Aggregate of all transmission attempts.
-  double throughput;            //!< Throughput of this rate (in pkts per second).
+  /**
+   * Resize all the arrays.
+   *
+   * \param size the number of rates to hold statistics for
+   */
+  void Resize (uint32_t size);
+  /**
+   * Release the memory held by all the arrays.
+   */
+  void Clear (void);
 };
 
-/**
- * Data structure for a Minstrel Rate table.
- * A vector of a struct HtRateInfo.
- */
-typedef std::vector<HtRateInfo> HtMinstrelRate;
-
 /**
  * A struct to contain information of a group.
  */
@@ -127,7 +128,7 @@ struct GroupInfo
   uint32_t m_maxTpRate2;          //!< The second max throughput rate of this group.
   uint32_t m_maxProbRate;         //!< The highest success probability rate of this group.
 
-  HtMinstrelRate m_ratesTable;    //!< Information about rates of this group.
+  uint32_t m_offset;              //!< Position of the first rate of this group in the HtRateStats arrays of the station.
 };
 
 /**
@@ -294,12 +295,28 @@ private:
   /// Return the average throughput of the MCS defined by groupId and rateId.
   double CalculateThroughput (MinstrelHtWifiRemoteStation *station, uint32_t groupId, uint32_t rateId, double ewmaProb);
 
-  /// Set index rate as maxTpRate or maxTp2Rate if is better than current values.
+  /// Set index rate as maxTpRate or maxTp2Rate of the station if is better than current values.
   void SetBestStationThRates (MinstrelHtWifiRemoteStation *station, uint32_t index);
 
-  /// Set index rate as maxProbRate if it is better than current value.
+  /// Set index rate as maxTpRate or maxTp2Rate of its group if is better than current values.
+  void SetBestGroupThRates (MinstrelHtWifiRemoteStation *station, uint32_t index);
+
+  /// Set index rate as maxProbRate of the station if it is better than current value.
   void SetBestProbabilityRate (MinstrelHtWifiRemoteStation *station, uint32_t index);
 
+  /// Set index rate as maxProbRate of its group if it is better than current value.
+  void SetBestGroupProbabilityRate (MinstrelHtWifiRemoteStation *station, uint32_t index);
+
+  /**
+   * Update the statistics of all the rates of a group supported by the station
+   * at the end of an update interval.
+   *
+   * \param station the station
+   * \param groupId the group
+   * \return true if any rate of the group was attempted during the interval
+   */
+  bool UpdateGroupStats (MinstrelHtWifiRemoteStation *station, uint32_t groupId);
+
   /// Calculate the number of retransmissions to set for the index rate.
   void CalculateRetransmits (MinstrelHtWifiRemoteStation *station, uint32_t index);
 
@@ -363,6 +380,12 @@ private:
   /// Returns the global index corresponding to the groupId and rateId.
   uint32_t GetIndex (uint32_t groupId, uint32_t rateId);
 
+  /// Returns the position of the (groupId, rateId) rate in the HtRateStats arrays of the station.
+  uint32_t GetStatsIndex (MinstrelHtWifiRemoteStation *station, uint32_t groupId, uint32_t rateId) const;
+
+  /// Returns the position of the rate with the given global index in the HtRateStats arrays of the station.
+  uint32_t GetStatsIndex (MinstrelHtWifiRemoteStation *station, uint32_t index) const;
+
   /// Returns the groupId of a HT MCS with the given number of streams, if using sgi and the channel width used.
   uint32_t GetHtGroupId (uint8_t txstreams, uint8_t sgi, uint8_t chWidth);
 
@@ -398,6 +421,7 @@ private:
 
 
   MinstrelMcsGroups m_minstrelGroups;                 //!< Global array for groups information.
+  std::vector<Time> m_perfectTxTimes;                 //!< TxTime of the first MPDU of every rate, indexed by global index.
 
   Ptr<MinstrelWifiManager> m_legacyManager;           //!< Pointer to an instance of MinstrelWifiManager. Used when 802.11n/ac not supported.
 
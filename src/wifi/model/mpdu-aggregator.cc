@@ -45,7 +45,7 @@ MpduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
   DeaggregatedMpdus set;
 
   AmpduSubframeHeader hdr;
-  Ptr<Packet> extractedMpdu = Create<Packet> ();
+  Ptr<Packet> extractedMpdu;
   uint32_t maxSize = aggregatedPacket->GetSize ();
   uint16_t extractedLength;
   uint32_t padding;
@@ -55,9 +55,16 @@ MpduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
     {
       deserialized += aggregatedPacket->RemoveHeader (hdr);
       extractedLength = hdr.GetLength ();
+      deserialized += extractedLength;
+      if (deserialized == maxSize)
+        {
+          //The last subframe is the rest of the aggregate: reuse it rather
+          //than creating a fragment of it.
+          set.push_back (std::make_pair (aggregatedPacket, hdr));
+          break;
+        }
       extractedMpdu = aggregatedPacket->CreateFragment (0, static_cast<uint32_t> (extractedLength));
       aggregatedPacket->RemoveAtStart (extractedLength);
-      deserialized += extractedLength;
 
       padding = (4 - (extractedLength % 4 )) % 4;
 
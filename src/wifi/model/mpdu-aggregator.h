@@ -71,6 +71,18 @@ public:
    * specified how and if <i>packet</i> can be added to <i>aggregatedPacket</i>.
    */
   virtual bool Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket) const = 0;
+  /**
+   * \param packetSize size of the MPDU we want to account for in <i>aggregatedPacket</i>.
+   * \param aggregatedPacket packet whose size is the size of an A-MPDU.
+   *
+   * \return true if an MPDU of size <i>packetSize</i> can be aggregated to <i>aggregatedPacket</i>, false otherwise.
+   *
+   * Same as Aggregate, except that the A-MPDU subframe is not serialized: <i>aggregatedPacket</i>
+   * only grows by the size of the subframe and of the padding of its previous subframe, without
+   * copying any byte. This is used when the MPDUs of the A-MPDU are kept aside and each subframe
+   * is serialized only when it is sent (see AddHeaderAndPad).
+   */
+  virtual bool AggregateSize (uint32_t packetSize, Ptr<Packet> aggregatedPacket) const = 0;
   /**
   * This method performs a VHT single MPDU aggregation.
   */
@@ -92,6 +92,23 @@ MpduStandardAggregator::Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggrega
   return false;
 }
 
+bool
+MpduStandardAggregator::AggregateSize (uint32_t packetSize, Ptr<Packet> aggregatedPacket) const
+{
+  NS_LOG_FUNCTION (this << packetSize);
+  uint32_t padding = CalculatePadding (aggregatedPacket);
+  uint32_t actualSize = aggregatedPacket->GetSize ();
+
+  if ((4 + packetSize + actualSize + padding) <= m_maxAmpduLength)
+    {
+      //The added bytes are a zero-filled area: appending it to a packet that
+      //is itself made of such an area does not allocate nor copy any byte.
+      aggregatedPacket->AddAtEnd (Create<Packet> (padding + 4 + packetSize));
+      return true;
+    }
+  return false;
+}
+
 void
 MpduStandardAggregator::AggregateVhtSingleMpdu (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket) const
 {
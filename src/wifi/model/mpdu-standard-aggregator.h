@@ -62,6 +62,16 @@ public:
    * Returns true if <i>packet</i> can be aggregated to <i>aggregatedPacket</i>, false otherwise.
    */
   virtual bool Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket) const;
+  /**
+   * \param packetSize size of the MPDU we want to account for in <i>aggregatedPacket</i>.
+   * \param aggregatedPacket packet whose size is the size of an A-MPDU.
+   *
+   * \return true if an MPDU of size <i>packetSize</i> can be aggregated to <i>aggregatedPacket</i>,
+   *         false otherwise.
+   *
+   * This method accounts for an MPDU in the size of an A-MPDU, without serializing its subframe.
+   */
+  virtual bool AggregateSize (uint32_t packetSize, Ptr<Packet> aggregatedPacket) const;
   /**
   * This method performs a VHT single MPDU aggregation.
   */
@@ -44,7 +44,7 @@ MsduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
   DeaggregatedMsdus set;
 
   AmsduSubframeHeader hdr;
-  Ptr<Packet> extractedMsdu = Create<Packet> ();
+  Ptr<Packet> extractedMsdu;
   uint32_t maxSize = aggregatedPacket->GetSize ();
   uint16_t extractedLength;
   uint32_t padding;
@@ -54,9 +54,16 @@ MsduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
     {
       deserialized += aggregatedPacket->RemoveHeader (hdr);
       extractedLength = hdr.GetLength ();
+      deserialized += extractedLength;
+      if (deserialized == maxSize)
+        {
+          //The last subframe is the rest of the aggregate: reuse it rather
+          //than creating a fragment of it.
+          set.push_back (std::make_pair (aggregatedPacket, hdr));
+          break;
+        }
       extractedMsdu = aggregatedPacket->CreateFragment (0, static_cast<uint32_t> (extractedLength));
       aggregatedPacket->RemoveAtStart (extractedLength);
-      deserialized += extractedLength;
 
       padding = (4 - ((extractedLength + 14) % 4 )) % 4;
 
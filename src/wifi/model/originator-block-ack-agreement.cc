@@ -27,7 +27,8 @@ OriginatorBlockAckAgreement::OriginatorBlockAckAgreement ()
   : BlockAckAgreement (),
     m_state (PENDING),
     m_sentMpdus (0),
-    m_needBlockAckReq (false)
+    m_needBlockAckReq (false),
+    m_nRetryPackets (0)
 {
 }
 
@@ -35,7 +36,8 @@ OriginatorBlockAckAgreement::OriginatorBlockAckAgreement (Mac48Address recipient
   : BlockAckAgreement (recipient, tid),
     m_state (PENDING),
     m_sentMpdus (0),
-    m_needBlockAckReq (false)
+    m_needBlockAckReq (false),
+    m_nRetryPackets (0)
 {
 }
 
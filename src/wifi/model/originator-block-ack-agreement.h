@@ -22,6 +22,7 @@
 #define ORIGINATOR_BLOCK_ACK_AGREEMENT_H
 
 #include "block-ack-agreement.h"
+#include <bitset>
 
 namespace ns3 {
 
@@ -145,6 +146,12 @@ private:
   State m_state;
   uint16_t m_sentMpdus;
   bool m_needBlockAckReq;
+  /**
+   * Sequence numbers of the packets of this agreement that are in the
+   * retransmission queue of the BlockAckManager, indexed by sequence number.
+   */
+  std::bitset<4096> m_retrySeqs;
+  uint16_t m_nRetryPackets; //!< number of packets of this agreement in the retransmission queue
 };
 
 } //namespace ns3
@@ -27,8 +27,11 @@
 #include "ns3/wifi-spectrum-value-helper.h"
 #include "ns3/log.h"
 #include "ns3/boolean.h"
+#include "ns3/simulator.h"
 #include "wifi-spectrum-signal-parameters.h"
 #include "wifi-utils.h"
+#include <map>
+#include <deque>
 
 namespace ns3 {
 
@@ -56,6 +59,10 @@ SpectrumWifiPhy::GetTypeId (void)
 }
 
 SpectrumWifiPhy::SpectrumWifiPhy ()
+  : m_rxBandFrequency (0),
+    m_rxBandWidth (0),
+    m_rxBandStart (0),
+    m_rxBandStop (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -168,11 +175,10 @@ SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
   // Integrate over our receive bandwidth (i.e., all that the receive
   // spectral mask representing our filtering allows) to find the
   // total energy apparent to the "demodulator".
-  Ptr<SpectrumValue> filter = WifiSpectrumValueHelper::CreateRfFilter (GetFrequency (), GetChannelWidth ());
-  SpectrumValue filteredSignal = (*filter) * (*receivedSignalPsd);
+  double bandPowerW = GetBandPowerW (receivedSignalPsd);
   // Add receiver antenna gain
-  NS_LOG_DEBUG ("Signal power received (watts) before antenna gain: " << Integral (filteredSignal));
-  double rxPowerW = Integral (filteredSignal) * DbToRatio (GetRxGain ());
+  NS_LOG_DEBUG ("Signal power received (watts) before antenna gain: " << bandPowerW);
+  double rxPowerW = bandPowerW * DbToRatio (GetRxGain ());
   NS_LOG_DEBUG ("Signal power received after antenna gain: " << rxPowerW << " W (" << WToDbm (rxPowerW) << " dBm)");
 
   Ptr<WifiSpectrumSignalParameters> wifiRxParams = DynamicCast<WifiSpectrumSignalParameters> (rxParams);
@@ -227,10 +233,116 @@ SpectrumWifiPhy::CreateWifiSpectrumPhyInterface (Ptr<NetDevice> device)
   m_wifiSpectrumPhyInterface->SetDevice (device);
 }
 
+double
+SpectrumWifiPhy::GetBandPowerW (Ptr<const SpectrumValue> psd) const
+{
+  uint16_t frequency = GetFrequency ();
+  uint8_t channelWidth = GetChannelWidth ();
+  if (frequency != m_rxBandFrequency || channelWidth != m_rxBandWidth)
+    {
+      std::pair<uint32_t, uint32_t> range = WifiSpectrumValueHelper::GetRfFilterBandRange (frequency, channelWidth);
+      m_rxBandFrequency = frequency;
+      m_rxBandWidth = channelWidth;
+      m_rxBandStart = range.first;
+      m_rxBandStop = range.second;
+    }
+  NS_ASSERT_MSG (psd->GetSpectrumModel () == WifiSpectrumValueHelper::GetSpectrumModel (frequency, channelWidth),
+                 "Received PSD not in the spectrum model of the current channel");
+  // Same summation order as Integral (filter * psd): the bands outside
+  // the filter only add zeros.
+  double powerW = 0;
+  Values::const_iterator vit = psd->ConstValuesBegin () + m_rxBandStart;
+  Bands::const_iterator bit = psd->ConstBandsBegin () + m_rxBandStart;
+  for (uint32_t i = m_rxBandStart; i < m_rxBandStop; i++, vit++, bit++)
+    {
+      powerW += (*vit) * (bit->fh - bit->fl);
+    }
+  return powerW;
+}
+
+namespace {
+
+/**
+ * Key of a transmit PSD in the cache shared by all the SpectrumWifiPhys.
+ */
+struct TxPsdKey
+{
+  WifiPhyStandard standard; //!< the standard
+  uint16_t frequency;       //!< the center frequency (MHz)
+  uint8_t channelWidth;     //!< the channel width (MHz)
+  double txPowerW;          //!< the transmit power (W)
+
+  /**
+   * \param o the other key
+   * \return true if this key sorts before the other one
+   */
+  bool operator < (const TxPsdKey &o) const
+  {
+    if (standard != o.standard)
+      {
+        return standard < o.standard;
+      }
+    if (frequency != o.frequency)
+      {
+        return frequency < o.frequency;
+      }
+    if (channelWidth != o.channelWidth)
+      {
+        return channelWidth < o.channelWidth;
+      }
+    return txPowerW < o.txPowerW;
+  }
+};
+
+/// Maximum number of cached transmit PSDs
+const std::size_t g_maxTxPsds = 1024;
+
+/**
+ * Transmit PSDs shared by all the SpectrumWifiPhys of a simulation.
+ */
+struct TxPsdCache
+{
+  std::map<TxPsdKey, Ptr<SpectrumValue> > psds; //!< the PSDs
+  std::deque<TxPsdKey> order;                   //!< the keys in insertion order, oldest first
+};
+
+/**
+ * \return the transmit PSDs shared by all the SpectrumWifiPhys
+ */
+TxPsdCache &
+GetTxPsdCache (void)
+{
+  static TxPsdCache cache;
+  return cache;
+}
+
+/**
+ * Empty the transmit PSD cache, at Simulator::Destroy time.
+ */
+void
+ClearTxPsdCache (void)
+{
+  GetTxPsdCache ().psds.clear ();
+  GetTxPsdCache ().order.clear ();
+}
+
+} // anonymous namespace
+
 Ptr<SpectrumValue>
 SpectrumWifiPhy::GetTxPowerSpectralDensity (uint16_t centerFrequency, uint8_t channelWidth, double txPowerW) const
 {
   NS_LOG_FUNCTION (centerFrequency << (uint16_t)channelWidth << txPowerW);
+  TxPsdKey key;
+  key.standard = GetStandard ();
+  key.frequency = centerFrequency;
+  key.channelWidth = channelWidth;
+  key.txPowerW = txPowerW;
+  TxPsdCache &cache = GetTxPsdCache ();
+  std::map<TxPsdKey, Ptr<SpectrumValue> >::const_iterator it = cache.psds.find (key);
+  if (it != cache.psds.end ())
+    {
+      return it->second;
+    }
   Ptr<SpectrumValue> v;
   switch (GetStandard ())
     {
@@ -253,6 +365,19 @@ SpectrumWifiPhy::GetTxPowerSpectralDensity (uint16_t centerFrequency, uint8_t ch
       NS_FATAL_ERROR ("Standard unknown: " << GetStandard ());
       break;
     }
+  if (cache.psds.empty ())
+    {
+      // the PSDs must not outlive the simulation
+      Simulator::ScheduleDestroy (&ClearTxPsdCache);
+    }
+  else if (cache.psds.size () >= g_maxTxPsds)
+    {
+      // evict the oldest PSD only, rather than all the PSDs in use
+      cache.psds.erase (cache.order.front ());
+      cache.order.pop_front ();
+    }
+  cache.psds[key] = v;
+  cache.order.push_back (key);
   return v;
 }
 
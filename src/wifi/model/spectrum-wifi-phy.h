@@ -161,9 +161,24 @@ private:
    * \return Ptr to SpectrumValue
    *
    * This is a helper function to create the right Tx PSD corresponding
-   * to the standard in use.
+   * to the standard in use. The PSDs are cached and shared by all the
+   * PHYs transmitting with the same standard, center frequency, channel
+   * width and power: the returned PSD must not be modified (the spectrum
+   * channels copy it before applying the propagation loss). The cache is
+   * emptied by Simulator::Destroy; when it is full, the oldest PSD is
+   * evicted.
    */
   Ptr<SpectrumValue> GetTxPowerSpectralDensity (uint16_t centerFrequency, uint8_t channelWidth, double txPowerW) const;
+  /**
+   * Integrate a received PSD over the receive bandwidth, i.e. over the
+   * bands of the RF filter of the current channel. This gives the same
+   * result as the integral of the PSD multiplied by the RF filter,
+   * without creating the filter and the filtered PSD.
+   *
+   * \param psd the received PSD, in the spectrum model of this PHY
+   * \return the received power in W, before the receiver antenna gain
+   */
+  double GetBandPowerW (Ptr<const SpectrumValue> psd) const;
 
   Ptr<SpectrumChannel> m_channel;        //!< SpectrumChannel that this SpectrumWifiPhy is connected to
   std::vector<uint8_t> m_operationalChannelList; //!< List of possible channels
@@ -172,6 +187,10 @@ private:
   Ptr<AntennaModel> m_antenna;
   mutable Ptr<const SpectrumModel> m_rxSpectrumModel;
   bool m_disableWifiReception;          //!< forces this Phy to fail to sync on any signal
+  mutable uint16_t m_rxBandFrequency;   //!< center frequency (MHz) of the cached receive bands
+  mutable uint8_t m_rxBandWidth;        //!< channel width (MHz) of the cached receive bands
+  mutable uint32_t m_rxBandStart;       //!< index of the first receive band
+  mutable uint32_t m_rxBandStop;        //!< index past the last receive band
   TracedCallback<bool, uint32_t, double, Time> m_signalCb;
 
 };
@@ -35,7 +35,8 @@ WifiMacQueue::Item::Item (Ptr<const Packet> packet,
                           Time tstamp)
   : packet (packet),
     hdr (hdr),
-    tstamp (tstamp)
+    tstamp (tstamp),
+    seq (0)
 {
 }
 
@@ -64,7 +65,9 @@ WifiMacQueue::GetTypeId (void)
 }
 
 WifiMacQueue::WifiMacQueue ()
-  : m_size (0)
+  : m_size (0),
+    m_nextFrontSeq (-1),
+    m_nextBackSeq (0)
 {
 }
 
@@ -109,15 +112,71 @@ WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
         }
       else if (m_dropPolicy == DROP_OLDEST)
         {
-          m_queue.pop_front ();
-          m_size--;
+          DoErase (m_queue.begin ());
         }
     }
-  Time now = Simulator::Now ();
-  m_queue.push_back (Item (packet, hdr, now));
+  DoInsert (false, packet, hdr, Simulator::Now ());
+}
+
+void
+WifiMacQueue::DoInsert (bool front, Ptr<const Packet> packet, const WifiMacHeader &hdr, Time tstamp)
+{
+  PacketQueueI it;
+  if (front)
+    {
+      it = m_queue.insert (m_queue.begin (), Item (packet, hdr, tstamp));
+      it->seq = m_nextFrontSeq--;
+    }
+  else
+    {
+      it = m_queue.insert (m_queue.end (), Item (packet, hdr, tstamp));
+      it->seq = m_nextBackSeq++;
+    }
+  if (hdr.IsQosData ())
+    {
+      m_tidQueues[TidAddressKey (hdr.GetAddr1 (), hdr.GetQosTid ())][it->seq] = it;
+    }
+  else
+    {
+      m_nonQosQueue[it->seq] = it;
+    }
+  m_expiryIndex[std::make_pair (tstamp, it->seq)] = it;
+  m_packetIndex.insert (std::make_pair (PeekPointer (packet), it));
   m_size++;
 }
 
+void
+WifiMacQueue::DoErase (PacketQueueI it)
+{
+  if (it->hdr.IsQosData ())
+    {
+      std::map<TidAddressKey, PacketIndex>::iterator tidIt = m_tidQueues.find (TidAddressKey (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()));
+      NS_ASSERT (tidIt != m_tidQueues.end ());
+      tidIt->second.erase (it->seq);
+      if (tidIt->second.empty ())
+        {
+          m_tidQueues.erase (tidIt);
+        }
+    }
+  else
+    {
+      m_nonQosQueue.erase (it->seq);
+    }
+  m_expiryIndex.erase (std::make_pair (it->tstamp, it->seq));
+  std::pair<std::multimap<const Packet *, PacketQueueI>::iterator,
+            std::multimap<const Packet *, PacketQueueI>::iterator> range = m_packetIndex.equal_range (PeekPointer (it->packet));
+  for (std::multimap<const Packet *, PacketQueueI>::iterator i = range.first; i != range.second; i++)
+    {
+      if (i->second == it)
+        {
+          m_packetIndex.erase (i);
+          break;
+        }
+    }
+  m_queue.erase (it);
+  m_size--;
+}
+
 void
 WifiMacQueue::Cleanup (void)
 {
@@ -127,20 +186,11 @@ WifiMacQueue::Cleanup (void)
     }
 
   Time now = Simulator::Now ();
-  uint32_t n = 0;
-  for (PacketQueueI i = m_queue.begin (); i != m_queue.end (); )
+  while (!m_expiryIndex.empty ()
+         && m_expiryIndex.begin ()->first.first + m_maxDelay <= now)
     {
-      if (i->tstamp + m_maxDelay > now)
-        {
-          i++;
-        }
-      else
-        {
-          i = m_queue.erase (i);
-          n++;
-        }
+      DoErase (m_expiryIndex.begin ()->second);
     }
-  m_size -= n;
 }
 
 Ptr<const Packet>
@@ -150,8 +200,7 @@ WifiMacQueue::Dequeue (WifiMacHeader *hdr)
   if (!m_queue.empty ())
     {
       Item i = m_queue.front ();
-      m_queue.pop_front ();
-      m_size--;
+      DoErase (m_queue.begin ());
       *hdr = i.hdr;
       return i.packet;
     }
@@ -177,7 +226,18 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
 {
   Cleanup ();
   Ptr<const Packet> packet = 0;
-  if (!m_queue.empty ())
+  if (type == WifiMacHeader::ADDR1)
+    {
+      std::map<TidAddressKey, PacketIndex>::iterator tidIt = m_tidQueues.find (TidAddressKey (dest, tid));
+      if (tidIt != m_tidQueues.end ())
+        {
+          PacketQueueI it = tidIt->second.begin ()->second;
+          packet = it->packet;
+          *hdr = it->hdr;
+          DoErase (it);
+        }
+    }
+  else if (!m_queue.empty ())
     {
       PacketQueueI it;
       for (it = m_queue.begin (); it != m_queue.end (); ++it)
@@ -189,8 +249,7 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                 {
                   packet = it->packet;
                   *hdr = it->hdr;
-                  m_queue.erase (it);
-                  m_size--;
+                  DoErase (it);
                   break;
                 }
             }
@@ -204,7 +263,18 @@ WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                                    WifiMacHeader::AddressType type, Mac48Address dest, Time *timestamp)
 {
   Cleanup ();
-  if (!m_queue.empty ())
+  if (type == WifiMacHeader::ADDR1)
+    {
+      std::map<TidAddressKey, PacketIndex>::iterator tidIt = m_tidQueues.find (TidAddressKey (dest, tid));
+      if (tidIt != m_tidQueues.end ())
+        {
+          PacketQueueI it = tidIt->second.begin ()->second;
+          *hdr = it->hdr;
+          *timestamp = it->tstamp;
+          return it->packet;
+        }
+    }
+  else if (!m_queue.empty ())
     {
       PacketQueueI it;
       for (it = m_queue.begin (); it != m_queue.end (); ++it)
@@ -242,6 +312,10 @@ void
 WifiMacQueue::Flush (void)
 {
   m_queue.erase (m_queue.begin (), m_queue.end ());
+  m_tidQueues.clear ();
+  m_nonQosQueue.clear ();
+  m_expiryIndex.clear ();
+  m_packetIndex.clear ();
   m_size = 0;
 }
 
@@ -266,17 +340,23 @@ WifiMacQueue::GetAddressForPacket (WifiMacHeader::AddressType type, PacketQueueI
 bool
 WifiMacQueue::Remove (Ptr<const Packet> packet)
 {
-  PacketQueueI it = m_queue.begin ();
-  for (; it != m_queue.end (); it++)
+  std::pair<std::multimap<const Packet *, PacketQueueI>::iterator,
+            std::multimap<const Packet *, PacketQueueI>::iterator> range = m_packetIndex.equal_range (PeekPointer (packet));
+  if (range.first == range.second)
     {
-      if (it->packet == packet)
+      return false;
+    }
+  // if the packet is queued more than once, remove the first occurrence
+  PacketQueueI first = range.first->second;
+  for (std::multimap<const Packet *, PacketQueueI>::iterator i = range.first; i != range.second; i++)
+    {
+      if (i->second->seq < first->seq)
         {
-          m_queue.erase (it);
-          m_size--;
-          return true;
+          first = i->second;
         }
     }
-  return false;
+  DoErase (first);
+  return true;
 }
 
 void
@@ -287,9 +367,7 @@ WifiMacQueue::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
     {
       return;
     }
-  Time now = Simulator::Now ();
-  m_queue.push_front (Item (packet, hdr, now));
-  m_size++;
+  DoInsert (true, packet, hdr, Simulator::Now ());
 }
 
 uint32_t
@@ -298,7 +376,15 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
 {
   Cleanup ();
   uint32_t nPackets = 0;
-  if (!m_queue.empty ())
+  if (type == WifiMacHeader::ADDR1)
+    {
+      std::map<TidAddressKey, PacketIndex>::const_iterator tidIt = m_tidQueues.find (TidAddressKey (addr, tid));
+      if (tidIt != m_tidQueues.end ())
+        {
+          nPackets = tidIt->second.size ();
+        }
+    }
+  else if (!m_queue.empty ())
     {
       PacketQueueI it;
       for (it = m_queue.begin (); it != m_queue.end (); it++)
@@ -315,24 +401,40 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
   return nPackets;
 }
 
+WifiMacQueue::PacketQueueI
+WifiMacQueue::FindFirstAvailable (const QosBlockedDestinations *blockedPackets)
+{
+  PacketQueueI first = m_queue.end ();
+  if (!m_nonQosQueue.empty ())
+    {
+      first = m_nonQosQueue.begin ()->second;
+    }
+  for (std::map<TidAddressKey, PacketIndex>::const_iterator tidIt = m_tidQueues.begin ();
+       tidIt != m_tidQueues.end (); tidIt++)
+    {
+      PacketQueueI it = tidIt->second.begin ()->second;
+      if ((first == m_queue.end () || it->seq < first->seq)
+          && !blockedPackets->IsBlocked (tidIt->first.first, tidIt->first.second))
+        {
+          first = it;
+        }
+    }
+  return first;
+}
+
 Ptr<const Packet>
 WifiMacQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
                                      const QosBlockedDestinations *blockedPackets)
 {
   Cleanup ();
   Ptr<const Packet> packet = 0;
-  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
+  PacketQueueI it = FindFirstAvailable (blockedPackets);
+  if (it != m_queue.end ())
     {
-      if (!it->hdr.IsQosData ()
-          || !blockedPackets->IsBlocked (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()))
-        {
-          *hdr = it->hdr;
-          timestamp = it->tstamp;
-          packet = it->packet;
-          m_queue.erase (it);
-          m_size--;
-          return packet;
-        }
+      *hdr = it->hdr;
+      timestamp = it->tstamp;
+      packet = it->packet;
+      DoErase (it);
     }
   return packet;
 }
@@ -342,15 +444,12 @@ WifiMacQueue::PeekFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
                                   const QosBlockedDestinations *blockedPackets)
 {
   Cleanup ();
-  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
+  PacketQueueI it = FindFirstAvailable (blockedPackets);
+  if (it != m_queue.end ())
     {
-      if (!it->hdr.IsQosData ()
-          || !blockedPackets->IsBlocked (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()))
-        {
-          *hdr = it->hdr;
-          timestamp = it->tstamp;
-          return it->packet;
-        }
+      *hdr = it->hdr;
+      timestamp = it->tstamp;
+      return it->packet;
     }
   return 0;
 }
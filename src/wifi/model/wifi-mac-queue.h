@@ -25,6 +25,8 @@
 
 #include "ns3/packet.h"
 #include "wifi-mac-header.h"
+#include <list>
+#include <map>
 
 namespace ns3 {
 class QosBlockedDestinations;
@@ -43,6 +45,12 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * Besides the queue itself, the QoS data packets are indexed by receiver
+ * (Address1) and TID, and all the packets are indexed by expiry time and
+ * by address, so that the searches by receiver and TID, the removal of a
+ * given packet and the removal of the expired packets do not need to
+ * scan the whole queue.
  */
 class WifiMacQueue : public Object
 {
@@ -153,7 +161,7 @@ public:
   /**
    * If exists, removes <i>packet</i> from queue and returns true. Otherwise it
    * takes no effects and return false. Deletion of the packet is
-   * performed in linear time (O(n)).
+   * performed in logarithmic time (O(log n)).
    *
    * \param packet the packet to be removed
    *
@@ -245,6 +253,7 @@ protected:
     Ptr<const Packet> packet; //!< Actual packet
     WifiMacHeader hdr;        //!< Wifi MAC header associated with the packet
     Time tstamp;              //!< timestamp when the packet arrived at the queue
+    int64_t seq;              //!< position of the packet in the queue order
   };
 
   /**
@@ -269,11 +278,59 @@ protected:
    */
   Mac48Address GetAddressForPacket (WifiMacHeader::AddressType type, PacketQueueI it);
 
+  /**
+   * Insert a packet in the queue and in all the indexes.
+   *
+   * \param front true to insert the packet at the front of the queue,
+   *        false to insert it at the end
+   * \param packet the packet
+   * \param hdr the header of the packet
+   * \param tstamp the timestamp of the packet
+   */
+  void DoInsert (bool front, Ptr<const Packet> packet, const WifiMacHeader &hdr, Time tstamp);
+  /**
+   * Remove a packet from the queue and from all the indexes.
+   *
+   * \param it the packet to be removed
+   */
+  void DoErase (PacketQueueI it);
+  /**
+   * Return the first packet in the queue, among the packets which are not
+   * QoS data packets and the QoS data packets whose receiver and TID are
+   * not blocked.
+   *
+   * \param blockedPackets the blocked receivers and TIDs
+   *
+   * \return the packet, or m_queue.end () if there is none
+   */
+  PacketQueueI FindFirstAvailable (const QosBlockedDestinations *blockedPackets);
+
+  /**
+   * Packets ordered by their position in the queue.
+   */
+  typedef std::map<int64_t, PacketQueueI> PacketIndex;
+  /**
+   * Key of the per receiver and TID index: (Address1, TID).
+   */
+  typedef std::pair<Mac48Address, uint8_t> TidAddressKey;
+
   PacketQueue m_queue; //!< Packet (struct Item) queue
   uint32_t m_size;     //!< Current queue size
   uint32_t m_maxSize;  //!< Queue capacity
   Time m_maxDelay;     //!< Time to live for packets in the queue
   DropPolicy m_dropPolicy; //!< Drop behavior of queue
+  /**
+   * QoS data packets, for every receiver (Address1) and TID, in queue order.
+   * Every entry has at least one packet.
+   */
+  std::map<TidAddressKey, PacketIndex> m_tidQueues;
+  PacketIndex m_nonQosQueue; //!< Packets which are not QoS data, in queue order
+  /// Packets ordered by timestamp (hence by expiry time), then by queue order
+  std::map<std::pair<Time, int64_t>, PacketQueueI> m_expiryIndex;
+  /// Packets indexed by their address
+  std::multimap<const Packet *, PacketQueueI> m_packetIndex;
+  int64_t m_nextFrontSeq; //!< Position for the next packet inserted at the front
+  int64_t m_nextBackSeq;  //!< Position for the next packet inserted at the end
 };
 
 } //namespace ns3
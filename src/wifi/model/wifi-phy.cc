@@ -30,6 +30,7 @@
 #include "wifi-phy-tag.h"
 #include "ampdu-tag.h"
 #include "wifi-utils.h"
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -308,6 +309,17 @@ WifiPhy::GetTypeId (void)
                    MakeBooleanAccessor (&WifiPhy::GetShortPlcpPreambleSupported,
                                         &WifiPhy::SetShortPlcpPreambleSupported),
                    MakeBooleanChecker ())
+    .AddAttribute ("FastPhy",
+                   "Whether or not the fast PHY abstraction is enabled. "
+                   "If enabled, a single effective SINR is computed per frame from "
+                   "the aggregate interference at the start of the frame, and the "
+                   "PER of the PLCP header and payload is obtained from a single "
+                   "error rate model evaluation each, instead of being integrated "
+                   "over every interference change during the frame.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WifiPhy::GetFastPhy,
+                                        &WifiPhy::SetFastPhy),
+                   MakeBooleanChecker ())
     .AddTraceSource ("PhyTxBegin",
                      "Trace source indicating a packet "
                      "has begun transmitting over the channel medium",
@@ -638,6 +650,19 @@ WifiPhy::GetShortPlcpPreambleSupported (void) const
   return m_shortPreamble;
 }
 
+void
+WifiPhy::SetFastPhy (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_interference.SetFastPhy (enable);
+}
+
+bool
+WifiPhy::GetFastPhy (void) const
+{
+  return m_interference.GetFastPhy ();
+}
+
 void
 WifiPhy::SetDevice (Ptr<NetDevice> device)
 {
@@ -2136,11 +2161,140 @@ WifiPhy::CalculatePlcpPreambleAndHeaderDuration (WifiTxVector txVector)
   return duration;
 }
 
+/**
+ * Key of the transmission duration cache: every input which the duration
+ * of an MPDU that is not part of an A-MPDU depends on, packed in two words.
+ */
+struct TxDurationKey
+{
+  uint64_t packet; //!< size, frequency and payload mode
+  uint64_t vector; //!< other TXVECTOR parameters
+
+  /**
+   * \param o the other key
+   * \return true if both keys are equal
+   */
+  bool operator == (const TxDurationKey &o) const
+  {
+    return packet == o.packet && vector == o.vector;
+  }
+};
+
+/// Hash function of the transmission duration cache
+struct TxDurationKeyHash
+{
+  /**
+   * \param key the key
+   * \return the hash of the key
+   */
+  size_t operator () (const TxDurationKey &key) const
+  {
+    return std::hash<uint64_t> () (key.packet ^ (key.vector * 0x9e3779b97f4a7c15ULL));
+  }
+};
+
+/// The transmission duration cache, shared by all the PHYs
+struct TxDurationCache
+{
+  TxDurationCache ()
+    : maxSize (65536),
+      hits (0),
+      misses (0)
+  {
+  }
+  std::unordered_map<TxDurationKey, Time, TxDurationKeyHash> entries; //!< cached durations
+  uint32_t maxSize; //!< maximum number of entries
+  uint64_t hits;    //!< number of cache hits
+  uint64_t misses;  //!< number of cache misses
+};
+
+/**
+ * \return the transmission duration cache
+ */
+static TxDurationCache &
+GetTxDurationCache (void)
+{
+  static TxDurationCache cache;
+  return cache;
+}
+
+void
+WifiPhy::SetTxDurationCacheSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (size);
+  TxDurationCache &cache = GetTxDurationCache ();
+  cache.maxSize = size;
+  if (cache.entries.size () > size)
+    {
+      cache.entries.clear ();
+    }
+}
+
+uint32_t
+WifiPhy::GetTxDurationCacheSize (void)
+{
+  return GetTxDurationCache ().maxSize;
+}
+
+uint64_t
+WifiPhy::GetTxDurationCacheHits (void)
+{
+  return GetTxDurationCache ().hits;
+}
+
+uint64_t
+WifiPhy::GetTxDurationCacheMisses (void)
+{
+  return GetTxDurationCache ().misses;
+}
+
+void
+WifiPhy::ClearTxDurationCache (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  TxDurationCache &cache = GetTxDurationCache ();
+  cache.entries.clear ();
+  cache.hits = 0;
+  cache.misses = 0;
+}
+
 Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag)
 {
+  TxDurationCache &cache = GetTxDurationCache ();
+  //The duration of the MPDUs of an A-MPDU depends on the MPDUs that
+  //were previously aggregated, hence only single MPDUs are memoized.
+  if (mpdutype != NORMAL_MPDU || cache.maxSize == 0)
+    {
+      return CalculatePlcpPreambleAndHeaderDuration (txVector)
+             + GetPayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+    }
+  uint32_t modeUid = txVector.GetMode ().GetUid ();
+  NS_ASSERT (modeUid <= 0xffff);
+  TxDurationKey key;
+  key.packet = (static_cast<uint64_t> (size) << 32)
+    | (static_cast<uint64_t> (frequency) << 16)
+    | modeUid;
+  key.vector = static_cast<uint64_t> (txVector.GetPreambleType ())
+    | (static_cast<uint64_t> (txVector.GetChannelWidth ()) << 8)
+    | (static_cast<uint64_t> (txVector.GetNss ()) << 16)
+    | (static_cast<uint64_t> (txVector.GetNess ()) << 24)
+    | (static_cast<uint64_t> (txVector.IsShortGuardInterval ()) << 32)
+    | (static_cast<uint64_t> (txVector.IsStbc ()) << 33);
+  std::unordered_map<TxDurationKey, Time, TxDurationKeyHash>::const_iterator it = cache.entries.find (key);
+  if (it != cache.entries.end ())
+    {
+      cache.hits++;
+      return it->second;
+    }
+  cache.misses++;
   Time duration = CalculatePlcpPreambleAndHeaderDuration (txVector)
     + GetPayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+  if (cache.entries.size () >= cache.maxSize)
+    {
+      cache.entries.clear ();
+    }
+  cache.entries.insert (std::make_pair (key, duration));
   return duration;
 }
 
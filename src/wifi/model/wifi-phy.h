@@ -441,6 +441,36 @@ public:
    */
   Time GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag);
 
+  /**
+   * Set the maximum number of entries of the transmission duration cache.
+   *
+   * The durations returned by CalculateTxDuration for MPDUs that are not
+   * part of an A-MPDU only depend on the size of the packet, on the
+   * TXVECTOR and on the frequency, hence they are memoized in a cache which
+   * is shared by all the PHYs of the simulation. The cache is emptied when
+   * it reaches its maximum size. A size of zero disables the cache.
+   *
+   * \param size the maximum number of entries of the cache
+   */
+  static void SetTxDurationCacheSize (uint32_t size);
+  /**
+   * \return the maximum number of entries of the transmission duration cache
+   */
+  static uint32_t GetTxDurationCacheSize (void);
+  /**
+   * \return the number of transmission durations found in the cache
+   */
+  static uint64_t GetTxDurationCacheHits (void);
+  /**
+   * \return the number of transmission durations that had to be computed
+   */
+  static uint64_t GetTxDurationCacheMisses (void);
+  /**
+   * Remove all the entries of the transmission duration cache and reset
+   * its hit and miss counters.
+   */
+  static void ClearTxDurationCache (void);
+
   /**
    * The WifiPhy::GetNModes() and WifiPhy::GetMode() methods are used
    * (e.g., by a WifiRemoteStationManager) to determine the set of
@@ -1485,6 +1515,19 @@ public:
    * \returns if short PLCP preamble is supported or not
    */
   virtual bool GetShortPlcpPreambleSupported (void) const;
+  /**
+   * Enable or disable the fast PHY abstraction (see
+   * InterferenceHelper::SetFastPhy).
+   *
+   * \param enable true to enable the fast PHY abstraction
+   */
+  void SetFastPhy (bool enable);
+  /**
+   * Return whether the fast PHY abstraction is enabled.
+   *
+   * \return true if the fast PHY abstraction is enabled, false otherwise
+   */
+  bool GetFastPhy (void) const;
 
   /**
    * Sets the error rate model.
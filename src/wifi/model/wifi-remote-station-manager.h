@@ -25,6 +25,7 @@
 #include "ns3/packet.h"
 #include "ns3/object.h"
 #include "ns3/nstime.h"
+#include <unordered_map>
 #include "wifi-tx-vector.h"
 #include "ht-capabilities.h"
 #include "vht-capabilities.h"
@@ -1261,6 +1262,28 @@ private:
    * A vector of WifiRemoteStationStates
    */
   typedef std::vector <WifiRemoteStationState *> StationStates;
+  /**
+   * A hash table of WifiRemoteStations, indexed by the key returned by
+   * GetStationKey
+   */
+  typedef std::unordered_map <uint64_t, WifiRemoteStation *> StationIndex;
+  /**
+   * A hash table of WifiRemoteStationStates, indexed by the key returned
+   * by GetStationKey
+   */
+  typedef std::unordered_map <uint64_t, WifiRemoteStationState *> StationStateIndex;
+
+  /**
+   * Return the key which identifies a station in the station indexes: the
+   * 48 bits of the address are packed in the most significant bits, and
+   * the TID in the 8 least significant bits.
+   *
+   * \param address the address of the station
+   * \param tid the TID
+   *
+   * \return the key of the station
+   */
+  static uint64_t GetStationKey (Mac48Address address, uint8_t tid);
 
   /**
    * This is a pointer to the WifiPhy associated with this
@@ -1293,6 +1316,8 @@ private:
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
+  StationStateIndex m_stateIndex; //!< Index of m_states by address
+  StationIndex m_stationIndex;    //!< Index of m_stations by address and TID
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
@@ -22,6 +22,8 @@
 #include "ns3/log.h"
 #include "ns3/qos-utils.h"
 #include "ns3/ctrl-headers.h"
+#include "ns3/block-ack-cache.h"
+#include "ns3/wifi-mac-header.h"
 
 using namespace ns3;
 
@@ -294,6 +296,95 @@ CtrlBAckResponseHeaderTest::DoRun (void)
 }
 
 
+//Test for the block ack cache of the recipient
+class BlockAckCacheTest : public TestCase
+{
+public:
+  BlockAckCacheTest ();
+private:
+  virtual void DoRun ();
+  /**
+   * Notify the cache of the reception of an MPDU.
+   *
+   * \param seq the sequence number of the MPDU
+   * \param frag the fragment number of the MPDU
+   */
+  void ReceiveMpdu (uint16_t seq, uint8_t frag);
+  /**
+   * \param startingSeq the starting sequence of the block ack
+   * \return the compressed bitmap filled by the cache
+   */
+  uint64_t GetBitmap (uint16_t startingSeq);
+  BlockAckCache m_cache;
+};
+
+BlockAckCacheTest::BlockAckCacheTest ()
+  : TestCase ("Check the compressed bitmap filled by the block ack cache")
+{
+}
+
+void
+BlockAckCacheTest::ReceiveMpdu (uint16_t seq, uint8_t frag)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetSequenceNumber (seq);
+  hdr.SetFragmentNumber (frag);
+  m_cache.UpdateWithMpdu (&hdr);
+}
+
+uint64_t
+BlockAckCacheTest::GetBitmap (uint16_t startingSeq)
+{
+  CtrlBAckResponseHeader blockAckHdr;
+  blockAckHdr.SetType (COMPRESSED_BLOCK_ACK);
+  blockAckHdr.SetStartingSequence (startingSeq);
+  m_cache.FillBlockAckBitmap (&blockAckHdr);
+  return blockAckHdr.GetCompressedBitmap ();
+}
+
+void
+BlockAckCacheTest::DoRun (void)
+{
+  //Case 1: window wrapping around the sequence number space
+  //          4080       47
+  m_cache.Init (4080, 64);
+  for (uint16_t i = 4080; i < 4090; i++)
+    {
+      ReceiveMpdu (i, 0);
+    }
+  ReceiveMpdu (4095, 0);
+  for (uint16_t i = 0; i < 6; i++)
+    {
+      ReceiveMpdu (i, 0);
+    }
+  //fragmented packets are not acknowledged by a compressed block ack
+  ReceiveMpdu (10, 1);
+  NS_TEST_EXPECT_MSG_EQ (GetBitmap (4080), 0x00000000003f83ffLL, "error in compressed bitmap");
+
+  //Case 2: the window moves forward when an MPDU beyond its end is received
+  //          4093       60
+  ReceiveMpdu (60, 0);
+  NS_TEST_EXPECT_MSG_EQ (m_cache.GetWinStart (), 4093, "error in window start");
+  NS_TEST_EXPECT_MSG_EQ (GetBitmap (4093), 0x80000000000001fcULL, "error in compressed bitmap");
+
+  //Case 3: a block ack request outside the window resets the window
+  m_cache.UpdateWithBlockAckReq (100);
+  NS_TEST_EXPECT_MSG_EQ (m_cache.GetWinStart (), 100, "error in window start");
+  NS_TEST_EXPECT_MSG_EQ (GetBitmap (100), 0, "error in compressed bitmap");
+
+  //Case 4: window smaller than the bitmap
+  //          10         25
+  m_cache.Init (10, 16);
+  for (uint16_t i = 10; i <= 20; i++)
+    {
+      ReceiveMpdu (i, 0);
+    }
+  ReceiveMpdu (25, 0);
+  NS_TEST_EXPECT_MSG_EQ (GetBitmap (10), 0x00000000000087ffLL, "error in compressed bitmap");
+}
+
+
 class BlockAckTestSuite : public TestSuite
 {
 public:
@@ -306,6 +397,7 @@ BlockAckTestSuite::BlockAckTestSuite ()
   AddTestCase (new PacketBufferingCaseA, TestCase::QUICK);
   AddTestCase (new PacketBufferingCaseB, TestCase::QUICK);
   AddTestCase (new CtrlBAckResponseHeaderTest, TestCase::QUICK);
+  AddTestCase (new BlockAckCacheTest, TestCase::QUICK);
 }
 
 static BlockAckTestSuite g_blockAckTestSuite;
@@ -78,7 +78,15 @@ private:
   void EndTest (void);
   void ExpectInternalCollision (uint64_t time, uint32_t nSlots, uint32_t from);
   void ExpectCollision (uint64_t time, uint32_t nSlots, uint32_t from);
-  void AddRxOkEvt (uint64_t at, uint64_t duration);
+  ///\param scheduled the expected number of access timeouts scheduled by the DcfManager
+  ///\param cancelled the expected number of access timeouts cancelled by the DcfManager
+  void ExpectAccessTimeouts (uint64_t scheduled, uint64_t cancelled);
+  ///\param at the time the reception starts
+  ///\param duration the duration of the reception
+  ///\param nav the NAV duration set by the MAC at the end of the reception
+  void AddRxOkEvt (uint64_t at, uint64_t duration, uint64_t nav = 0);
+  ///\param nav the NAV duration set by the MAC
+  void DoRxEndOk (uint64_t nav);
   void AddRxErrorEvt (uint64_t at, uint64_t duration);
   void AddRxInsideSifsEvt (uint64_t at, uint64_t duration);
   void AddTxEvt (uint64_t at, uint64_t duration);
@@ -106,6 +114,9 @@ private:
   DcfManager *m_dcfManager;
   DcfStates m_dcfStates;
   uint32_t m_ackTimeoutValue;
+  bool m_checkAccessTimeouts;
+  uint64_t m_expectedScheduled;
+  uint64_t m_expectedCancelled;
 };
 
 DcfStateTest::DcfStateTest (DcfManagerTest *test, uint32_t i)
@@ -248,9 +259,18 @@ DcfManagerTest::ExpectCollision (uint64_t time, uint32_t nSlots, uint32_t from)
   state->m_expectedCollision.push_back (col);
 }
 
+void
+DcfManagerTest::ExpectAccessTimeouts (uint64_t scheduled, uint64_t cancelled)
+{
+  m_checkAccessTimeouts = true;
+  m_expectedScheduled = scheduled;
+  m_expectedCancelled = cancelled;
+}
+
 void
 DcfManagerTest::StartTest (uint64_t slotTime, uint64_t sifs, uint64_t eifsNoDifsNoSifs, uint32_t ackTimeoutValue)
 {
+  m_checkAccessTimeouts = false;
   m_dcfManager = new DcfManager ();
   m_dcfManager->SetSlot (MicroSeconds (slotTime));
   m_dcfManager->SetSifs (MicroSeconds (sifs));
@@ -281,17 +301,34 @@ DcfManagerTest::EndTest (void)
       delete state;
     }
   m_dcfStates.clear ();
+  if (m_checkAccessTimeouts)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_dcfManager->GetAccessTimeoutScheduledCount (), m_expectedScheduled, "Unexpected number of access timeouts scheduled");
+      NS_TEST_EXPECT_MSG_EQ (m_dcfManager->GetAccessTimeoutCancelledCount (), m_expectedCancelled, "Unexpected number of access timeouts cancelled");
+    }
   delete m_dcfManager;
 }
 
 void
-DcfManagerTest::AddRxOkEvt (uint64_t at, uint64_t duration)
+DcfManagerTest::AddRxOkEvt (uint64_t at, uint64_t duration, uint64_t nav)
 {
   Simulator::Schedule (MicroSeconds (at) - Now (),
                        &DcfManager::NotifyRxStartNow, m_dcfManager,
                        MicroSeconds (duration));
   Simulator::Schedule (MicroSeconds (at + duration) - Now (),
-                       &DcfManager::NotifyRxEndOkNow, m_dcfManager);
+                       &DcfManagerTest::DoRxEndOk, this, nav);
+}
+
+void
+DcfManagerTest::DoRxEndOk (uint64_t nav)
+{
+  m_dcfManager->NotifyRxEndOkNow ();
+  //the MAC handles the packet, and sets the NAV it carries
+  if (nav > 0)
+    {
+      m_dcfManager->NotifyNavStartNow (MicroSeconds (nav));
+    }
+  m_dcfManager->NotifyRxProcessedNow ();
 }
 
 void
@@ -447,6 +484,8 @@ DcfManagerTest::DoRun (void)
   AddRxOkEvt (80, 20);
   AddAccessRequest (30, 2, 118, 0);
   ExpectCollision (30, 4, 0); //backoff: 4 slots
+  // one access timeout expiring at 86 (during the second rx), and one at 118
+  ExpectAccessTimeouts (2, 0);
   EndTest ();
   // Test the case where the backoff slots is zero.
   //
@@ -728,6 +767,60 @@ DcfManagerTest::DoRun (void)
   AddAccessRequest (101, 2, 110, 0);
   ExpectCollision (101, 0, 0); //backoff: 0 slots
   EndTest ();
+
+  // Check that the access timeout is only started at the end of the
+  // reception when the DCFs request access during it.
+  //
+  //       20          60     66      70    72     78      90                             106
+  // DCF0   |    rx     | sifs | aifsn | tx | sifs |
+  // DCF1   |    rx     | sifs |  ...  |    | sifs | aifsn | bslot0 | bslot1 | bslot2 | bslot3 | tx |
+  //    |    |
+  //    |   40 DCF0 requests access: backoff end 70
+  //   30 DCF1 requests access: backoff end 94
+  StartTest (4, 6, 10);
+  AddDcfState (1); //high priority DCF
+  AddDcfState (3); //low priority DCF
+  AddRxOkEvt (20, 40);
+  AddAccessRequest (30, 30, 106, 1);
+  ExpectCollision (30, 4, 1); //backoff: 4 slots
+  AddAccessRequest (40, 2, 70, 0);
+  ExpectCollision (40, 0, 0); //backoff: 0 slots
+  // a timeout at 70 is started at 60; at 70, the timeout for DCF1 is bound
+  // by the ACK timeout (126), and replaced by one at 106 at the ACK (72).
+  // Restarting the timeout during the reception scheduled a timeout at 94
+  // at 30, and replaced it by one at 70 at 40: 4 timeouts and 2 cancelled.
+  ExpectAccessTimeouts (3, 1);
+  EndTest ();
+
+  // Check that the access timeout restarted at the end of a reception
+  // accounts for the NAV set by the received packet.
+  //
+  //       20    40     44     60     66    76     82      86     90    92     98      110                                   130
+  // DCF0   | rx  | sifs |  rx  | sifs | ack | sifs | aifsn | bslot0 | tx | sifs |
+  // DCF1   | rx  | sifs |  rx  | sifs | ack | sifs |      ...     |    | sifs | aifsn | bslot0 | ... | bslot4 | tx |
+  //     |                |
+  //     |               50 DCF0 requests access: 1 backoff slot
+  //    25 DCF1 requests access: 5 backoff slots, backoff end 78
+  //
+  // The second rx sets a NAV up to the end of the ack (76).
+  StartTest (4, 6, 10);
+  AddDcfState (1); //high priority DCF
+  AddDcfState (3); //low priority DCF
+  AddRxOkEvt (20, 20);
+  AddRxOkEvt (44, 16, 16);
+  AddRxOkEvt (66, 10);
+  AddAccessRequest (25, 2, 130, 1);
+  ExpectCollision (25, 5, 1); //backoff: 5 slots
+  AddAccessRequest (50, 2, 90, 0);
+  ExpectCollision (50, 1, 0); //backoff: 1 slot
+  // the timeout at 78 is kept when DCF0 requests access, since the NAV
+  // puts the backoff end of DCF0 at 90; at 78, a timeout at 90 is started;
+  // at 90, the timeout for DCF1 is bound by the ACK timeout (150), and
+  // replaced by one at 130 at the ACK (92). Restarting the timeout during
+  // the reception replaced the timeout at 78 by one at 74, without the
+  // NAV: 5 timeouts and 2 cancelled.
+  ExpectAccessTimeouts (4, 1);
+  EndTest ();
 }
 
 
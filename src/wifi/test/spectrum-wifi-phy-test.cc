@@ -21,10 +21,20 @@
 #include "ns3/wifi-spectrum-value-helper.h"
 #include "ns3/spectrum-wifi-phy.h"
 #include "ns3/nist-error-rate-model.h"
+#include "ns3/yans-wifi-phy.h"
 #include "ns3/wifi-mac-header.h"
 #include "ns3/wifi-mac-trailer.h"
 #include "ns3/wifi-phy-tag.h"
 #include "ns3/wifi-spectrum-signal-parameters.h"
+#include "ns3/interference-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/wifi-utils.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
 
 using namespace ns3;
 
@@ -247,6 +257,306 @@ SpectrumWifiPhyListenerTest::DoRun (void)
   delete m_listener;
 }
 
+class SpectrumWifiPhyFastPhyTest : public SpectrumWifiPhyBasicTest
+{
+public:
+  SpectrumWifiPhyFastPhyTest ();
+  virtual ~SpectrumWifiPhyFastPhyTest ();
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+};
+
+SpectrumWifiPhyFastPhyTest::SpectrumWifiPhyFastPhyTest ()
+  : SpectrumWifiPhyBasicTest ("SpectrumWifiPhy test reception with the fast PHY abstraction")
+{
+}
+
+SpectrumWifiPhyFastPhyTest::~SpectrumWifiPhyFastPhyTest ()
+{
+}
+
+void
+SpectrumWifiPhyFastPhyTest::DoSetup (void)
+{
+  SpectrumWifiPhyBasicTest::DoSetup ();
+  m_phy->SetFastPhy (true);
+}
+
+// Test that the fast PHY abstraction yields the same receptions as the
+// full interference model when frames do not overlap
+void
+SpectrumWifiPhyFastPhyTest::DoRun (void)
+{
+  double txPowerWatts = 0.010;
+  Simulator::Schedule (Seconds (1), &SpectrumWifiPhyFastPhyTest::SendSignal, this, txPowerWatts);
+  Simulator::Schedule (Seconds (2), &SpectrumWifiPhyFastPhyTest::SendSignal, this, txPowerWatts);
+  Simulator::Schedule (Seconds (3), &SpectrumWifiPhyFastPhyTest::SendSignal, this, txPowerWatts);
+  // Send packets spaced 1 microsecond second apart; only one should be received
+  Simulator::Schedule (MicroSeconds (4000000), &SpectrumWifiPhyFastPhyTest::SendSignal, this, txPowerWatts);
+  Simulator::Schedule (MicroSeconds (4000001), &SpectrumWifiPhyFastPhyTest::SendSignal, this, txPowerWatts);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_phy->GetFastPhy (), true, "Fast PHY abstraction not enabled");
+  NS_TEST_ASSERT_MSG_EQ (m_count, 4, "Didn't receive right number of packets");
+}
+
+class InterferenceHelperFastPhyTest : public TestCase
+{
+public:
+  InterferenceHelperFastPhyTest ();
+  virtual ~InterferenceHelperFastPhyTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Receive a frame with an interfering signal, and compute its SNR and PER
+   * \param fastPhy true to use the fast PHY abstraction
+   * \param interferenceStart start of the interference, relative to the frame
+   * \param header output, the SNR and PER of the PLCP header
+   * \param payload output, the SNR and PER of the PLCP payload
+   */
+  void Receive (bool fastPhy, Time interferenceStart,
+                InterferenceHelper::SnrPer &header, InterferenceHelper::SnrPer &payload);
+  /**
+   * Start the reception of the frame
+   * \param helper the interference helper
+   */
+  void StartRx (InterferenceHelper *helper);
+  /**
+   * End the reception of the frame
+   * \param helper the interference helper
+   */
+  void EndRx (InterferenceHelper *helper);
+
+  WifiTxVector m_txVector;                     ///< TXVECTOR of the frame
+  uint32_t m_size;                             ///< size of the frame
+  Time m_duration;                             ///< duration of the frame
+  Ptr<InterferenceHelper::Event> m_event;      ///< the frame being received
+  InterferenceHelper::SnrPer m_header;         ///< SNR and PER of the PLCP header
+  InterferenceHelper::SnrPer m_payload;        ///< SNR and PER of the PLCP payload
+};
+
+InterferenceHelperFastPhyTest::InterferenceHelperFastPhyTest ()
+  : TestCase ("InterferenceHelper fast PHY abstraction compared to the full interference model")
+{
+}
+
+InterferenceHelperFastPhyTest::~InterferenceHelperFastPhyTest ()
+{
+}
+
+void
+InterferenceHelperFastPhyTest::StartRx (InterferenceHelper *helper)
+{
+  m_event = helper->Add (m_size, m_txVector, m_duration, 1e-11);
+  helper->NotifyRxStart ();
+}
+
+void
+InterferenceHelperFastPhyTest::EndRx (InterferenceHelper *helper)
+{
+  m_header = helper->CalculatePlcpHeaderSnrPer (m_event);
+  m_payload = helper->CalculatePlcpPayloadSnrPer (m_event);
+  helper->NotifyRxEnd ();
+}
+
+void
+InterferenceHelperFastPhyTest::Receive (bool fastPhy, Time interferenceStart,
+                                        InterferenceHelper::SnrPer &header, InterferenceHelper::SnrPer &payload)
+{
+  InterferenceHelper helper;
+  helper.SetNoiseFigure (5.01); // 7 dB
+  helper.SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  helper.SetFastPhy (fastPhy);
+  Time start = Seconds (1);
+  // the interference lasts longer than the frame
+  Simulator::Schedule (start + interferenceStart, &InterferenceHelper::AddForeignSignal, &helper,
+                       NanoSeconds (m_duration.GetNanoSeconds () * 2), 4e-12);
+  Simulator::Schedule (start, &InterferenceHelperFastPhyTest::StartRx, this, &helper);
+  Simulator::Schedule (start + m_duration, &InterferenceHelperFastPhyTest::EndRx, this, &helper);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  header = m_header;
+  payload = m_payload;
+  m_event = 0;
+}
+
+// Compare the SNR and PER computed by the fast PHY abstraction and by the
+// full interference model for a frame overlapping an interfering signal
+void
+InterferenceHelperFastPhyTest::DoRun (void)
+{
+  m_txVector = WifiTxVector (WifiPhy::GetOfdmRate6Mbps (), 0, 0, WIFI_PREAMBLE_LONG, false, 1, 1, 0, 20, false, false);
+  m_size = 1000;
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  m_duration = phy->CalculateTxDuration (m_size, m_txVector, 5180);
+  InterferenceHelper::SnrPer fastHeader, fastPayload, fullHeader, fullPayload;
+
+  // The interference is present during the whole frame: the effective SINR
+  // is the SINR of every chunk, so both models agree
+  Receive (true, MicroSeconds (-10), fastHeader, fastPayload);
+  Receive (false, MicroSeconds (-10), fullHeader, fullPayload);
+  NS_TEST_EXPECT_MSG_EQ_TOL (fastHeader.snr, fullHeader.snr, fullHeader.snr * 1e-9, "Different header SNR");
+  NS_TEST_EXPECT_MSG_EQ_TOL (fastPayload.snr, fullPayload.snr, fullPayload.snr * 1e-9, "Different payload SNR");
+  NS_TEST_EXPECT_MSG_EQ_TOL (fastHeader.per, fullHeader.per, 1e-9, "Different header PER");
+  NS_TEST_EXPECT_MSG_EQ_TOL (fastPayload.per, fullPayload.per, 1e-9, "Different payload PER");
+  NS_TEST_EXPECT_MSG_GT (fullPayload.per, 0.01, "The interference should cause errors");
+  NS_TEST_EXPECT_MSG_LT (fullPayload.per, 0.99, "The interference should not cause certain loss");
+
+  // The interference starts during the payload: both models report the SNR
+  // at the start of the frame, but the fast model ignores the interference
+  // and underestimates the PER
+  Time middle = NanoSeconds (m_duration.GetNanoSeconds () / 2);
+  Receive (true, middle, fastHeader, fastPayload);
+  Receive (false, middle, fullHeader, fullPayload);
+  NS_TEST_EXPECT_MSG_EQ_TOL (fastPayload.snr, fullPayload.snr, fullPayload.snr * 1e-9, "Different payload SNR");
+  NS_TEST_EXPECT_MSG_EQ_TOL (fastHeader.per, fullHeader.per, 1e-9, "Different header PER");
+  NS_TEST_EXPECT_MSG_LT (fastPayload.per, 1e-3, "The fast model should not see the interference");
+  NS_TEST_EXPECT_MSG_GT (fullPayload.per, fastPayload.per + 0.01, "The full model should see the interference");
+}
+
+class SpectrumWifiPhyTxPsdCacheTest : public TestCase
+{
+public:
+  SpectrumWifiPhyTxPsdCacheTest ();
+  virtual ~SpectrumWifiPhyTxPsdCacheTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Send frames between SpectrumWifiPhys on a lossless channel and check
+   * the power of every received signal
+   * \param standard the standard of the PHYs
+   * \param mode the mode of the frames
+   */
+  void RunStandard (WifiPhyStandard standard, WifiMode mode);
+  /**
+   * Send a frame
+   * \param phy the sender
+   * \param txPowerDbm the transmit power
+   */
+  void Send (Ptr<WifiPhy> phy, double txPowerDbm);
+  /**
+   * Record the power of a received signal
+   * \param wifi whether the signal is a Wi-Fi signal
+   * \param senderNodeId the node ID of the sender
+   * \param rxPowerDbm the received power
+   * \param duration the duration of the signal
+   */
+  void SignalArrival (bool wifi, uint32_t senderNodeId, double rxPowerDbm, Time duration);
+
+  WifiMode m_mode;                 ///< mode of the frames
+  std::vector<double> m_txPowers;  ///< transmit power (dBm) of the sent frames
+  std::vector<double> m_rxPowers;  ///< power (dBm) of the received signals
+};
+
+SpectrumWifiPhyTxPsdCacheTest::SpectrumWifiPhyTxPsdCacheTest ()
+  : TestCase ("SpectrumWifiPhy cached transmit PSDs and received band power")
+{
+}
+
+SpectrumWifiPhyTxPsdCacheTest::~SpectrumWifiPhyTxPsdCacheTest ()
+{
+}
+
+void
+SpectrumWifiPhyTxPsdCacheTest::Send (Ptr<WifiPhy> phy, double txPowerDbm)
+{
+  phy->SetTxPowerStart (txPowerDbm);
+  phy->SetTxPowerEnd (txPowerDbm);
+  m_txPowers.push_back (txPowerDbm);
+  WifiTxVector txVector = WifiTxVector (m_mode, 0, 0, WIFI_PREAMBLE_LONG, false, 1, 1, 0, phy->GetChannelWidth (), false, false);
+  phy->SendPacket (Create<Packet> (1000), txVector);
+}
+
+void
+SpectrumWifiPhyTxPsdCacheTest::SignalArrival (bool wifi, uint32_t senderNodeId, double rxPowerDbm, Time duration)
+{
+  m_rxPowers.push_back (rxPowerDbm);
+}
+
+void
+SpectrumWifiPhyTxPsdCacheTest::RunStandard (WifiPhyStandard standard, WifiMode mode)
+{
+  m_mode = mode;
+  m_txPowers.clear ();
+  m_rxPowers.clear ();
+
+  NodeContainer nodes;
+  nodes.Create (3);
+  MobilityHelper mobility;
+  mobility.Install (nodes);
+
+  // no propagation loss: the received PSD is the transmitted one
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  SpectrumWifiPhyHelper phyHelper = SpectrumWifiPhyHelper::Default ();
+  phyHelper.SetChannel (channel);
+  phyHelper.Set ("TxGain", DoubleValue (0));
+  phyHelper.Set ("RxGain", DoubleValue (0));
+  WifiHelper wifi;
+  wifi.SetStandard (standard);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue (mode.GetUniqueName ()),
+                                "ControlMode", StringValue (mode.GetUniqueName ()));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phyHelper, mac, nodes);
+
+  Ptr<WifiPhy> phy0 = DynamicCast<WifiNetDevice> (devices.Get (0))->GetPhy ();
+  Ptr<WifiPhy> phy1 = DynamicCast<WifiNetDevice> (devices.Get (1))->GetPhy ();
+  Ptr<WifiPhy> rxPhy = DynamicCast<WifiNetDevice> (devices.Get (2))->GetPhy ();
+  rxPhy->TraceConnectWithoutContext ("SignalArrival", MakeCallback (&SpectrumWifiPhyTxPsdCacheTest::SignalArrival, this));
+
+  // the first frame creates the PSD, the next ones with the same power
+  // use the cached PSD, from the same PHY or from another PHY
+  Simulator::Schedule (Seconds (1), &SpectrumWifiPhyTxPsdCacheTest::Send, this, phy0, 16.0);
+  Simulator::Schedule (Seconds (2), &SpectrumWifiPhyTxPsdCacheTest::Send, this, phy0, 16.0);
+  Simulator::Schedule (Seconds (3), &SpectrumWifiPhyTxPsdCacheTest::Send, this, phy1, 16.0);
+  Simulator::Schedule (Seconds (4), &SpectrumWifiPhyTxPsdCacheTest::Send, this, phy1, 10.0);
+  Simulator::Schedule (Seconds (5), &SpectrumWifiPhyTxPsdCacheTest::Send, this, phy0, 10.0);
+  Simulator::Run ();
+
+  uint16_t frequency = rxPhy->GetFrequency ();
+  uint8_t channelWidth = rxPhy->GetChannelWidth ();
+  Ptr<SpectrumValue> filter = WifiSpectrumValueHelper::CreateRfFilter (frequency, channelWidth);
+  NS_TEST_ASSERT_MSG_EQ (m_rxPowers.size (), m_txPowers.size (), "Wrong number of received signals");
+  for (uint32_t i = 0; i < m_txPowers.size (); i++)
+    {
+      // the PSD created for this frame only, filtered by the RF filter
+      double txPowerW = DbmToW (m_txPowers[i]);
+      Ptr<SpectrumValue> psd;
+      switch (standard)
+        {
+        case WIFI_PHY_STANDARD_80211b:
+          psd = WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (frequency, txPowerW);
+          break;
+        case WIFI_PHY_STANDARD_80211n_5GHZ:
+          psd = WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (frequency, channelWidth, txPowerW);
+          break;
+        default:
+          psd = WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (frequency, channelWidth, txPowerW);
+          break;
+        }
+      double expected = WToDbm (Integral ((*filter) * (*psd)));
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_rxPowers[i], expected, 1e-9, "Wrong received power for frame " << i << " with standard " << standard);
+    }
+  Simulator::Destroy ();
+}
+
+// Compare the power of the signals sent with the cached transmit PSDs and
+// integrated over the receive band range with the power obtained with a
+// PSD created for each frame and filtered by the RF filter
+void
+SpectrumWifiPhyTxPsdCacheTest::DoRun (void)
+{
+  // the cache is emptied by Simulator::Destroy between the runs
+  RunStandard (WIFI_PHY_STANDARD_80211a, WifiPhy::GetOfdmRate6Mbps ());
+  RunStandard (WIFI_PHY_STANDARD_80211b, WifiPhy::GetDsssRate1Mbps ());
+  RunStandard (WIFI_PHY_STANDARD_80211n_5GHZ, WifiPhy::GetOfdmRate6Mbps ());
+  RunStandard (WIFI_PHY_STANDARD_80211a, WifiPhy::GetOfdmRate6Mbps ());
+}
+
 class SpectrumWifiPhyTestSuite : public TestSuite
 {
 public:
@@ -258,6 +568,9 @@ SpectrumWifiPhyTestSuite::SpectrumWifiPhyTestSuite ()
 {
   AddTestCase (new SpectrumWifiPhyBasicTest, TestCase::QUICK);
   AddTestCase (new SpectrumWifiPhyListenerTest, TestCase::QUICK);
+  AddTestCase (new SpectrumWifiPhyFastPhyTest, TestCase::QUICK);
+  AddTestCase (new InterferenceHelperFastPhyTest, TestCase::QUICK);
+  AddTestCase (new SpectrumWifiPhyTxPsdCacheTest, TestCase::QUICK);
 }
 
 static SpectrumWifiPhyTestSuite spectrumWifiPhyTestSuite;
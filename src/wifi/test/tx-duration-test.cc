@@ -331,6 +331,131 @@ TxDurationTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (retval, true, "an 802.11ac duration failed");
 }
 
+/**
+ * Check that the durations returned from the transmission duration cache
+ * are the same as the ones computed without the cache.
+ */
+class TxDurationCacheTest : public TestCase
+{
+public:
+  TxDurationCacheTest ();
+  virtual ~TxDurationCacheTest ();
+  virtual void DoRun (void);
+};
+
+TxDurationCacheTest::TxDurationCacheTest ()
+  : TestCase ("Wifi TX Duration cache")
+{
+}
+
+TxDurationCacheTest::~TxDurationCacheTest ()
+{
+}
+
+void
+TxDurationCacheTest::DoRun (void)
+{
+  uint32_t cacheSize = WifiPhy::GetTxDurationCacheSize ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+
+  std::vector<WifiTxVector> txVectors;
+  WifiTxVector txVector;
+  txVector.SetNss (1);
+  txVector.SetNess (0);
+  txVector.SetStbc (0);
+  txVector.SetShortGuardInterval (false);
+  txVector.SetChannelWidth (22);
+  txVector.SetMode (WifiPhy::GetDsssRate11Mbps ());
+  txVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+  txVectors.push_back (txVector);
+  txVector.SetPreambleType (WIFI_PREAMBLE_SHORT);
+  txVectors.push_back (txVector);
+  txVector.SetChannelWidth (20);
+  txVector.SetMode (WifiPhy::GetOfdmRate54Mbps ());
+  txVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+  txVectors.push_back (txVector);
+  txVector.SetChannelWidth (10);
+  txVector.SetMode (WifiPhy::GetOfdmRate6MbpsBW10MHz ());
+  txVectors.push_back (txVector);
+  txVector.SetChannelWidth (20);
+  txVector.SetMode (WifiPhy::GetHtMcs7 ());
+  txVector.SetPreambleType (WIFI_PREAMBLE_HT_MF);
+  txVectors.push_back (txVector);
+  txVector.SetShortGuardInterval (true);
+  txVectors.push_back (txVector);
+  txVector.SetPreambleType (WIFI_PREAMBLE_HT_GF);
+  txVectors.push_back (txVector);
+  txVector.SetChannelWidth (40);
+  txVector.SetMode (WifiPhy::GetHtMcs15 ());
+  txVector.SetNss (2);
+  txVector.SetPreambleType (WIFI_PREAMBLE_HT_MF);
+  txVectors.push_back (txVector);
+  txVector.SetStbc (1);
+  txVectors.push_back (txVector);
+  txVector.SetChannelWidth (80);
+  txVector.SetMode (WifiPhy::GetVhtMcs9 ());
+  txVector.SetNss (1);
+  txVector.SetStbc (0);
+  txVector.SetPreambleType (WIFI_PREAMBLE_VHT);
+  txVectors.push_back (txVector);
+  txVector.SetShortGuardInterval (false);
+  txVectors.push_back (txVector);
+
+  uint16_t frequencies[] = {2412, 5180};
+  uint32_t sizes[] = {14, 76, 1023, 1024, 1536};
+
+  //reference durations, without the cache
+  WifiPhy::SetTxDurationCacheSize (0);
+  WifiPhy::ClearTxDurationCache ();
+  std::vector<Time> durations;
+  for (std::vector<WifiTxVector>::const_iterator it = txVectors.begin (); it != txVectors.end (); it++)
+    {
+      for (uint32_t f = 0; f < 2; f++)
+        {
+          for (uint32_t s = 0; s < 5; s++)
+            {
+              durations.push_back (phy->CalculateTxDuration (sizes[s], *it, frequencies[f]));
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (WifiPhy::GetTxDurationCacheMisses (), 0, "the disabled cache should not be used");
+
+  //first pass fills the cache, second pass hits it
+  WifiPhy::SetTxDurationCacheSize (1024);
+  for (uint32_t pass = 0; pass < 2; pass++)
+    {
+      uint32_t i = 0;
+      for (std::vector<WifiTxVector>::const_iterator it = txVectors.begin (); it != txVectors.end (); it++)
+        {
+          for (uint32_t f = 0; f < 2; f++)
+            {
+              for (uint32_t s = 0; s < 5; s++)
+                {
+                  NS_TEST_EXPECT_MSG_EQ (phy->CalculateTxDuration (sizes[s], *it, frequencies[f]), durations[i],
+                                         "cached duration differs for " << *it << " size=" << sizes[s] << " frequency=" << frequencies[f]);
+                  i++;
+                }
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (WifiPhy::GetTxDurationCacheMisses (), durations.size (), "unexpected number of cache misses");
+  NS_TEST_EXPECT_MSG_EQ (WifiPhy::GetTxDurationCacheHits (), durations.size (), "unexpected number of cache hits");
+
+  //a small cache is emptied when full, but still returns exact durations
+  WifiPhy::SetTxDurationCacheSize (3);
+  WifiPhy::ClearTxDurationCache ();
+  for (uint32_t s = 0; s < 5; s++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (phy->CalculateTxDuration (sizes[s], txVectors[0], frequencies[0]), durations[s],
+                             "duration differs with a small cache");
+    }
+  NS_TEST_EXPECT_MSG_EQ (WifiPhy::GetTxDurationCacheMisses (), 5, "unexpected number of cache misses");
+
+  WifiPhy::SetTxDurationCacheSize (cacheSize);
+  WifiPhy::ClearTxDurationCache ();
+  phy->Dispose ();
+}
+
 
 class TxDurationTestSuite : public TestSuite
 {
@@ -342,6 +467,7 @@ TxDurationTestSuite::TxDurationTestSuite ()
   : TestSuite ("devices-wifi-tx-duration", UNIT)
 {
   AddTestCase (new TxDurationTest, TestCase::QUICK);
+  AddTestCase (new TxDurationCacheTest, TestCase::QUICK);
 }
 
 static TxDurationTestSuite g_txDurationTestSuite;
@@ -29,6 +29,8 @@
 #include "ns3/dcf-manager.h"
 #include "ns3/msdu-standard-aggregator.h"
 #include "ns3/mpdu-standard-aggregator.h"
+#include "ns3/wifi-mac-trailer.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -376,6 +378,135 @@ TwoLevelAggregationTest::DoRun (void)
 }
 
 
+/**
+ * Check that MpduAggregator::AggregateSize grows an A-MPDU exactly as
+ * Aggregate does, and that deaggregating an A-MPDU or an A-MSDU gives
+ * back the aggregated subframes.
+ */
+class AggregateSizeTest : public TestCase
+{
+public:
+  AggregateSizeTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param size the size of the MSDU
+   * \param seq the sequence number of the MPDU
+   * \return an MPDU, with its MAC header and FCS, whose payload bytes depend on its sequence number
+   */
+  Ptr<Packet> CreateMpdu (uint32_t size, uint16_t seq);
+};
+
+AggregateSizeTest::AggregateSizeTest ()
+  : TestCase ("Check the A-MPDU size accounting and the deaggregation of A-MPDUs and A-MSDUs")
+{
+}
+
+Ptr<Packet>
+AggregateSizeTest::CreateMpdu (uint32_t size, uint16_t seq)
+{
+  std::vector<uint8_t> payload (size, static_cast<uint8_t> (seq));
+  Ptr<Packet> mpdu = Create<Packet> (&payload[0], size);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (Mac48Address ("00:00:00:00:00:01"));
+  hdr.SetAddr2 (Mac48Address ("00:00:00:00:00:02"));
+  hdr.SetQosTid (0);
+  hdr.SetSequenceNumber (seq);
+  mpdu->AddHeader (hdr);
+  WifiMacTrailer fcs;
+  mpdu->AddTrailer (fcs);
+  return mpdu;
+}
+
+void
+AggregateSizeTest::DoRun (void)
+{
+  Ptr<MpduStandardAggregator> mpduAggregator = CreateObject<MpduStandardAggregator> ();
+  mpduAggregator->SetMaxAmpduSize (65535);
+  // MSDU sizes which need a padding of 0 to 3 bytes once in an MPDU
+  uint32_t msduSizes[] = {1500, 1, 1023, 300, 1502, 64, 8, 1455};
+  uint32_t nSubframes[] = {1, 2, 3, 5, 8};
+
+  for (uint32_t n = 0; n < sizeof (nSubframes) / sizeof (nSubframes[0]); n++)
+    {
+      Ptr<Packet> ampdu = Create<Packet> ();
+      Ptr<Packet> ampduSize = Create<Packet> ();
+      std::vector<Ptr<Packet> > mpdus;
+      for (uint32_t i = 0; i < nSubframes[n]; i++)
+        {
+          Ptr<Packet> mpdu = CreateMpdu (msduSizes[i], i);
+          mpdus.push_back (mpdu);
+          bool aggregated = mpduAggregator->Aggregate (mpdu, ampdu);
+          bool accounted = mpduAggregator->AggregateSize (mpdu->GetSize (), ampduSize);
+          NS_TEST_EXPECT_MSG_EQ (aggregated, true, "MPDU " << i << " not aggregated");
+          NS_TEST_EXPECT_MSG_EQ (accounted, true, "MPDU " << i << " not accounted for");
+          NS_TEST_EXPECT_MSG_EQ (ampduSize->GetSize (), ampdu->GetSize (),
+                                 "Wrong A-MPDU size after " << i + 1 << " subframes");
+        }
+
+      // Both methods refuse an MPDU which does not fit in the same way.
+      mpduAggregator->SetMaxAmpduSize (ampdu->GetSize () + 4 + 100);
+      Ptr<Packet> tooLarge = CreateMpdu (200, nSubframes[n]);
+      // MSDU size such that the MPDU and its padding take at most 100 bytes
+      Ptr<Packet> fits = CreateMpdu (96 - (tooLarge->GetSize () - 200), nSubframes[n]);
+      NS_TEST_EXPECT_MSG_EQ (mpduAggregator->Aggregate (tooLarge, ampdu->Copy ()),
+                             mpduAggregator->AggregateSize (tooLarge->GetSize (), ampduSize->Copy ()),
+                             "Aggregate and AggregateSize disagree on an MPDU which is too large");
+      NS_TEST_EXPECT_MSG_EQ (mpduAggregator->Aggregate (fits, ampdu->Copy ()),
+                             mpduAggregator->AggregateSize (fits->GetSize (), ampduSize->Copy ()),
+                             "Aggregate and AggregateSize disagree on an MPDU which fits");
+      mpduAggregator->SetMaxAmpduSize (65535);
+
+      MpduAggregator::DeaggregatedMpdus subframes = MpduAggregator::Deaggregate (ampdu->Copy ());
+      NS_TEST_ASSERT_MSG_EQ (subframes.size (), mpdus.size (), "Wrong number of deaggregated MPDUs");
+      uint32_t i = 0;
+      for (MpduAggregator::DeaggregatedMpdusCI it = subframes.begin (); it != subframes.end (); ++it, ++i)
+        {
+          NS_TEST_EXPECT_MSG_EQ (it->second.GetLength (), mpdus[i]->GetSize (), "Wrong length in subframe header " << i);
+          NS_TEST_ASSERT_MSG_EQ (it->first->GetSize (), mpdus[i]->GetSize (), "Wrong size of deaggregated MPDU " << i);
+          std::vector<uint8_t> expected (mpdus[i]->GetSize ());
+          std::vector<uint8_t> actual (it->first->GetSize ());
+          mpdus[i]->CopyData (&expected[0], expected.size ());
+          it->first->CopyData (&actual[0], actual.size ());
+          NS_TEST_EXPECT_MSG_EQ ((actual == expected), true, "Wrong content of deaggregated MPDU " << i);
+        }
+    }
+
+  // A-MSDU deaggregation
+  Ptr<MsduStandardAggregator> msduAggregator = CreateObject<MsduStandardAggregator> ();
+  msduAggregator->SetMaxAmsduSize (7935);
+  uint32_t nMsdus[] = {1, 2, 3};
+  for (uint32_t n = 0; n < sizeof (nMsdus) / sizeof (nMsdus[0]); n++)
+    {
+      Ptr<Packet> amsdu = Create<Packet> ();
+      std::vector<Ptr<Packet> > msdus;
+      for (uint32_t i = 0; i < nMsdus[n]; i++)
+        {
+          std::vector<uint8_t> payload (msduSizes[i], static_cast<uint8_t> (i + 1));
+          Ptr<Packet> msdu = Create<Packet> (&payload[0], msduSizes[i]);
+          msdus.push_back (msdu);
+          bool aggregated = msduAggregator->Aggregate (msdu, amsdu, Mac48Address ("00:00:00:00:00:02"),
+                                                       Mac48Address ("00:00:00:00:00:01"));
+          NS_TEST_EXPECT_MSG_EQ (aggregated, true, "MSDU " << i << " not aggregated");
+        }
+      MsduAggregator::DeaggregatedMsdus subframes = MsduAggregator::Deaggregate (amsdu);
+      NS_TEST_ASSERT_MSG_EQ (subframes.size (), msdus.size (), "Wrong number of deaggregated MSDUs");
+      uint32_t i = 0;
+      for (MsduAggregator::DeaggregatedMsdusCI it = subframes.begin (); it != subframes.end (); ++it, ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (it->first->GetSize (), msdus[i]->GetSize (), "Wrong size of deaggregated MSDU " << i);
+          std::vector<uint8_t> expected (msdus[i]->GetSize ());
+          std::vector<uint8_t> actual (it->first->GetSize ());
+          msdus[i]->CopyData (&expected[0], expected.size ());
+          it->first->CopyData (&actual[0], actual.size ());
+          NS_TEST_EXPECT_MSG_EQ ((actual == expected), true, "Wrong content of deaggregated MSDU " << i);
+        }
+    }
+}
+
+
 //-----------------------------------------------------------------------------
 class WifiAggregationTestSuite : public TestSuite
 {
@@ -388,6 +519,7 @@ WifiAggregationTestSuite::WifiAggregationTestSuite ()
 {
   AddTestCase (new AmpduAggregationTest, TestCase::QUICK);
   AddTestCase (new TwoLevelAggregationTest, TestCase::QUICK);
+  AddTestCase (new AggregateSizeTest, TestCase::QUICK);
 }
 
 static WifiAggregationTestSuite g_wifiAggregationTestSuite;
@@ -0,0 +1,238 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/test.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/packet-socket-helper.h"
+#include "ns3/packet-socket-address.h"
+#include "ns3/packet-socket-client.h"
+#include "ns3/wifi-saturation-extrapolation-helper.h"
+
+using namespace ns3;
+
+/**
+ * Check the fixed point of the Bianchi model used by WifiSaturationExtrapolationHelper.
+ */
+class BianchiModelTest : public TestCase
+{
+public:
+  BianchiModelTest ();
+  virtual void DoRun (void);
+};
+
+BianchiModelTest::BianchiModelTest ()
+  : TestCase ("Check the fixed point of the Bianchi model")
+{
+}
+
+void
+BianchiModelTest::DoRun (void)
+{
+  // A single station never collides and transmits in a slot with
+  // probability 2 / (W + 1).
+  NS_TEST_EXPECT_MSG_EQ (WifiSaturationExtrapolationHelper::ComputeCollisionProbability (1, 15, 1023), 0, "A single station collides");
+  NS_TEST_EXPECT_MSG_EQ_TOL (WifiSaturationExtrapolationHelper::ComputeTransmissionProbability (0, 15, 1023), 2.0 / 17, 1e-12, "Wrong transmission probability");
+
+  // With a constant contention window, the transmission probability does
+  // not depend on the collision probability.
+  NS_TEST_EXPECT_MSG_EQ_TOL (WifiSaturationExtrapolationHelper::ComputeTransmissionProbability (0.5, 15, 15), 2.0 / 17, 1e-12, "Wrong transmission probability");
+  double p = WifiSaturationExtrapolationHelper::ComputeCollisionProbability (5, 15, 15);
+  NS_TEST_EXPECT_MSG_EQ_TOL (p, 1 - std::pow (15.0 / 17, 4), 1e-9, "Wrong collision probability");
+
+  // The collision probability is the fixed point of p = 1 - (1 - tau (p))^(n - 1)
+  // and increases with the number of stations.
+  double previous = 0;
+  for (uint32_t n = 2; n <= 50; n++)
+    {
+      p = WifiSaturationExtrapolationHelper::ComputeCollisionProbability (n, 15, 1023);
+      double tau = WifiSaturationExtrapolationHelper::ComputeTransmissionProbability (p, 15, 1023);
+      NS_TEST_EXPECT_MSG_EQ_TOL (p, 1 - std::pow (1 - tau, static_cast<double> (n - 1)), 1e-9, "Not a fixed point for " << n << " stations");
+      NS_TEST_EXPECT_MSG_GT (p, previous, "Collision probability not increasing with " << n << " stations");
+      previous = p;
+    }
+
+  // A single station alternates idle slots and successful transmissions.
+  Time slot = MicroSeconds (9);
+  Time success = MicroSeconds (300);
+  double tau = 2.0 / 17;
+  double expected = tau * 1000 * 8 / ((1 - tau) * slot.GetSeconds () + tau * success.GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ_TOL (WifiSaturationExtrapolationHelper::ComputeThroughput (1, 15, 1023, 1000, slot, success, success), expected, expected * 1e-9, "Wrong throughput");
+}
+
+/**
+ * Run the same saturated scenario twice, once truncated by
+ * WifiSaturationExtrapolationHelper and once until the stop time, and
+ * check that the extrapolated statistics agree with the simulated ones.
+ */
+class SaturationExtrapolationTest : public TestCase
+{
+public:
+  SaturationExtrapolationTest ();
+  virtual void DoRun (void);
+
+private:
+  /// Statistics of a run
+  struct Result
+  {
+    bool truncated;           //!< whether the run was truncated
+    Time end;                 //!< simulated time at the end of the run
+    double successes;         //!< successful transmissions
+    double throughput;        //!< throughput in bit/s
+    Time accessDelay;         //!< mean access delay
+  };
+
+  /**
+   * \param truncate whether the helper may truncate the simulation
+   * \return the statistics of the run
+   */
+  Result RunScenario (bool truncate);
+
+  uint32_t m_nStations; //!< number of saturated stations
+  Time m_startTime;     //!< start time of the statistics
+  Time m_stopTime;      //!< stop time of the simulation
+};
+
+SaturationExtrapolationTest::SaturationExtrapolationTest ()
+  : TestCase ("Compare a truncated saturated run with a full run"),
+    m_nStations (4),
+    m_startTime (Seconds (1)),
+    m_stopTime (Seconds (15))
+{
+}
+
+SaturationExtrapolationTest::Result
+SaturationExtrapolationTest::RunScenario (bool truncate)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  // the stations send to the last node, which does not contend
+  NodeContainer nodes;
+  nodes.Create (m_nStations + 1);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate54Mbps"),
+                                "ControlMode", StringValue ("OfdmRate24Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 0);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (1.0),
+                                 "GridWidth", UintegerValue (m_nStations + 1));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (nodes);
+
+  NetDeviceContainer stations;
+  for (uint32_t i = 0; i < m_nStations; i++)
+    {
+      stations.Add (devices.Get (i));
+      PacketSocketAddress socket;
+      socket.SetSingleDevice (devices.Get (i)->GetIfIndex ());
+      socket.SetPhysicalAddress (devices.Get (m_nStations)->GetAddress ());
+      socket.SetProtocol (1);
+      // each station offers more than the capacity of the channel
+      Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+      client->SetAttribute ("PacketSize", UintegerValue (1000));
+      client->SetAttribute ("MaxPackets", UintegerValue (0));
+      client->SetAttribute ("Interval", TimeValue (MicroSeconds (250)));
+      client->SetRemote (socket);
+      client->SetStartTime (MilliSeconds (500));
+      client->SetStopTime (m_stopTime);
+      nodes.Get (i)->AddApplication (client);
+    }
+
+  WifiSaturationExtrapolationHelper helper;
+  if (!truncate)
+    {
+      // two estimates never agree
+      helper.SetTolerance (-1);
+    }
+  helper.Install (stations);
+  helper.Start (m_startTime, m_stopTime);
+
+  Simulator::Stop (m_stopTime);
+  Simulator::Run ();
+
+  Result result;
+  result.truncated = helper.IsTruncated ();
+  result.end = Simulator::Now ();
+  result.successes = helper.GetSuccesses ();
+  result.throughput = helper.GetThroughput ();
+  result.accessDelay = helper.GetMeanAccessDelay ();
+  Simulator::Destroy ();
+  return result;
+}
+
+void
+SaturationExtrapolationTest::DoRun (void)
+{
+  Result full = RunScenario (false);
+  Result truncated = RunScenario (true);
+
+  NS_TEST_ASSERT_MSG_EQ (full.truncated, false, "The full run was truncated");
+  NS_TEST_EXPECT_MSG_EQ (full.end, m_stopTime, "The full run did not reach the stop time");
+  NS_TEST_ASSERT_MSG_EQ (truncated.truncated, true, "The saturated run was not truncated");
+  NS_TEST_EXPECT_MSG_LT (truncated.end, m_stopTime, "The truncated run reached the stop time");
+  NS_TEST_ASSERT_MSG_GT (full.successes, 0, "No successful transmission");
+
+  NS_TEST_EXPECT_MSG_EQ_TOL (truncated.successes, full.successes, 0.03 * full.successes,
+                             "Extrapolated successes differ from the simulated ones");
+  NS_TEST_EXPECT_MSG_EQ_TOL (truncated.throughput, full.throughput, 0.03 * full.throughput,
+                             "Extrapolated throughput differs from the simulated one");
+  NS_TEST_EXPECT_MSG_EQ_TOL (truncated.accessDelay.GetSeconds (), full.accessDelay.GetSeconds (),
+                             0.03 * full.accessDelay.GetSeconds (),
+                             "Extrapolated access delay differs from the simulated one");
+}
+
+/**
+ * Wifi saturation extrapolation TestSuite
+ */
+class WifiSaturationExtrapolationTestSuite : public TestSuite
+{
+public:
+  WifiSaturationExtrapolationTestSuite ();
+};
+
+WifiSaturationExtrapolationTestSuite::WifiSaturationExtrapolationTestSuite ()
+  : TestSuite ("wifi-saturation-extrapolation", UNIT)
+{
+  AddTestCase (new BianchiModelTest, TestCase::QUICK);
+  AddTestCase (new SaturationExtrapolationTest, TestCase::QUICK);
+}
+
+static WifiSaturationExtrapolationTestSuite wifiSaturationExtrapolationTestSuite;
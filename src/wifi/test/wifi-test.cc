@@ -37,6 +37,8 @@
 #include "ns3/packet-socket-server.h"
 #include "ns3/packet-socket-client.h"
 #include "ns3/packet-socket-helper.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/qos-blocked-destinations.h"
 
 using namespace ns3;
 
@@ -211,6 +213,117 @@ public:
 };
 
 
+//-----------------------------------------------------------------------------
+/**
+ * Check that the indexed WifiMacQueue returns the packets in the same
+ * order as a search in the queue order
+ */
+class WifiMacQueueTest : public TestCase
+{
+public:
+  WifiMacQueueTest () : TestCase ("WifiMacQueue indexed operations")
+  {
+  }
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Enqueue a QoS data packet
+   * \param dest the receiver
+   * \param tid the TID
+   * \return the packet
+   */
+  Ptr<const Packet> EnqueueQos (Mac48Address dest, uint8_t tid);
+  /// Check that the packets enqueued at time 0 have expired
+  void CheckExpiry (void);
+
+  Ptr<WifiMacQueue> m_queue; ///< the queue
+};
+
+Ptr<const Packet>
+WifiMacQueueTest::EnqueueQos (Mac48Address dest, uint8_t tid)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (dest);
+  hdr.SetQosTid (tid);
+  Ptr<const Packet> packet = Create<Packet> (100);
+  m_queue->Enqueue (packet, hdr);
+  return packet;
+}
+
+void
+WifiMacQueueTest::CheckExpiry (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), 1, "Only the packet enqueued at 50 ms should be left");
+  WifiMacHeader hdr;
+  Time tstamp;
+  NS_TEST_EXPECT_MSG_EQ ((m_queue->PeekByTidAndAddress (&hdr, 1, WifiMacHeader::ADDR1, Mac48Address ("00:00:00:00:00:01"), &tstamp) == 0), true,
+                         "Expired packets should not be found by receiver and TID");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (2, WifiMacHeader::ADDR1, Mac48Address ("00:00:00:00:00:02")), 1,
+                         "Packet enqueued at 50 ms should be left");
+}
+
+void
+WifiMacQueueTest::DoRun (void)
+{
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxDelay (MilliSeconds (100));
+  Mac48Address a ("00:00:00:00:00:01");
+  Mac48Address b ("00:00:00:00:00:02");
+
+  Ptr<const Packet> a1 = EnqueueQos (a, 1);
+  Ptr<const Packet> b1 = EnqueueQos (b, 1);
+  Ptr<const Packet> a1bis = EnqueueQos (a, 1);
+  Ptr<const Packet> a2 = EnqueueQos (a, 2);
+  WifiMacHeader mgtHdr;
+  mgtHdr.SetType (WIFI_MAC_MGT_ACTION);
+  mgtHdr.SetAddr1 (b);
+  Ptr<const Packet> mgt = Create<Packet> (10);
+  m_queue->Enqueue (mgt, mgtHdr);
+
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), 5, "Unexpected queue size");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (1, WifiMacHeader::ADDR1, a), 2, "Unexpected number of packets for (a, 1)");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (2, WifiMacHeader::ADDR1, b), 0, "Unexpected number of packets for (b, 2)");
+
+  WifiMacHeader hdr;
+  Time tstamp;
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (&hdr, 1, WifiMacHeader::ADDR1, a, &tstamp), a1, "First packet for (a, 1) expected");
+
+  // the first available packet skips the blocked receiver and TID
+  QosBlockedDestinations blocked;
+  blocked.Block (a, 1);
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekFirstAvailable (&hdr, tstamp, &blocked), b1, "First packet for (b, 1) expected");
+  blocked.Block (b, 1);
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueFirstAvailable (&hdr, tstamp, &blocked), a2, "First packet for (a, 2) expected");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueFirstAvailable (&hdr, tstamp, &blocked), mgt, "Non-QoS packet expected");
+  NS_TEST_EXPECT_MSG_EQ ((m_queue->DequeueFirstAvailable (&hdr, tstamp, &blocked) == 0), true, "No available packet expected");
+
+  // a packet pushed at the front comes before all the others
+  Ptr<const Packet> front = Create<Packet> (100);
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (a);
+  hdr.SetQosTid (1);
+  m_queue->PushFront (front, hdr);
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (&hdr, 1, WifiMacHeader::ADDR1, a, &tstamp), front, "Packet pushed at the front expected");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (front), true, "Packet should be removed");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (front), false, "Packet was already removed");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (&hdr, 1, WifiMacHeader::ADDR1, a), a1, "First packet for (a, 1) expected");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Dequeue (&hdr), b1, "Packet for (b, 1) expected");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Dequeue (&hdr), a1bis, "Second packet for (a, 1) expected");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->IsEmpty (), true, "Queue should be empty");
+
+  // expired packets are removed
+  EnqueueQos (a, 1);
+  EnqueueQos (a, 1);
+  Simulator::Schedule (MilliSeconds (50), &WifiMacQueueTest::EnqueueQos, this, b, 2);
+  Simulator::Schedule (MilliSeconds (120), &WifiMacQueueTest::CheckExpiry, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_queue = 0;
+}
+
+
 //-----------------------------------------------------------------------------
 /**
  * See \bugid{991}
@@ -1104,6 +1217,7 @@ WifiTestSuite::WifiTestSuite ()
 {
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
   AddTestCase (new DcfImmediateAccessBroadcastTestCase, TestCase::QUICK);
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730